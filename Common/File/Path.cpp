@@ -20,6 +20,14 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#endif
+
+#if HOST_IS_CASE_SENSITIVE && PPSSPP_PLATFORM(LINUX)
+#include <sys/inotify.h>
 #endif
 
 Path::Path(std::string_view str) {
@@ -470,7 +478,9 @@ static bool FixFilenameCase(const std::string &path, std::string &filename) {
 	return retValue;
 }
 
-bool FixPathCase(const Path &realBasePath, std::string &path, FixPathCaseBehavior behavior) {
+// Walks the components of path, fixing the case of each with fixFilenameCase(directory, component).
+template <typename F>
+static bool FixPathCaseWith(const Path &realBasePath, std::string &path, FixPathCaseBehavior behavior, F fixFilenameCase) {
 	if (realBasePath.Type() == PathType::CONTENT_URI) {
 		// Nothing to do. These are already case insensitive, I think.
 		return true;
@@ -507,7 +517,7 @@ bool FixPathCase(const Path &realBasePath, std::string &path, FixPathCaseBehavio
 			std::string component = path.substr(start, i - start);
 
 			// Fix case and stop on nonexistant path component
-			if (FixFilenameCase(fullPath, component) == false) {
+			if (fixFilenameCase(fullPath, component) == false) {
 				// Still counts as success if partial matches allowed or if this
 				// is the last component and only the ones before it are required
 				return (behavior == FPC_PARTIAL_ALLOWED || (behavior == FPC_PATH_MUST_EXIST && i >= len));
@@ -525,4 +535,190 @@ bool FixPathCase(const Path &realBasePath, std::string &path, FixPathCaseBehavio
 	return true;
 }
 
+bool FixPathCase(const Path &realBasePath, std::string &path, FixPathCaseBehavior behavior) {
+	return FixPathCaseWith(realBasePath, path, behavior, &FixFilenameCase);
+}
+
+#if PPSSPP_PLATFORM(LINUX)
+
+struct PathCaseCache::Impl {
+	// The exact names, and the lowercased ones mapped to the name FixFilenameCase would pick.
+	struct Listing {
+		std::unordered_set<std::string> names;
+		std::unordered_map<std::string, std::string> folded;
+	};
+
+	// Past this, start over rather than track what's still useful. A memstick has far fewer.
+	static const size_t MAX_LISTINGS = 4096;
+
+	std::mutex lock;
+	int notifyFd = -1;
+	std::unordered_map<std::string, Listing> listings;
+	// The same directory can be reached by more than one path, through links.
+	std::unordered_map<int, std::vector<std::string>> watches;
+
+	Impl() {
+		notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (notifyFd < 0)
+			WARN_LOG(Log::IO, "inotify not available, directory listings won't be cached");
+	}
+	~Impl() {
+		if (notifyFd >= 0)
+			close(notifyFd);
+	}
+
+	void Reset() {
+		// Closing it drops all the watches at once.
+		if (notifyFd >= 0)
+			close(notifyFd);
+		notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		listings.clear();
+		watches.clear();
+	}
+
+	// For when a directory is moved or deleted: everything below it is gone from that path too.
+	void ForgetTree(const std::string &dir) {
+		auto under = [&](const std::string &path) {
+			return startsWith(path, dir) && (path.size() == dir.size() || path[dir.size()] == '/');
+		};
+		for (auto it = listings.begin(); it != listings.end(); ) {
+			if (under(it->first))
+				it = listings.erase(it);
+			else
+				++it;
+		}
+		for (auto it = watches.begin(); it != watches.end(); ) {
+			std::vector<std::string> &paths = it->second;
+			paths.erase(std::remove_if(paths.begin(), paths.end(), under), paths.end());
+			if (paths.empty()) {
+				inotify_rm_watch(notifyFd, it->first);
+				it = watches.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	void ProcessEvents() {
+		alignas(struct inotify_event) char buf[4096];
+		while (true) {
+			ssize_t len = read(notifyFd, buf, sizeof(buf));
+			if (len <= 0)
+				return;
+			for (const char *p = buf; p < buf + len; ) {
+				const struct inotify_event *event = (const struct inotify_event *)p;
+				p += sizeof(struct inotify_event) + event->len;
+				if (event->mask & IN_Q_OVERFLOW) {
+					// Lost track of what changed.
+					Reset();
+					return;
+				}
+				auto it = watches.find(event->wd);
+				if (it == watches.end())
+					continue;
+				if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+					std::vector<std::string> paths = it->second;
+					for (const std::string &path : paths)
+						ForgetTree(path);
+				} else {
+					for (const std::string &path : it->second)
+						listings.erase(path);
+				}
+			}
+		}
+	}
+
+	const Listing *GetListing(const std::string &dir) {
+		auto found = listings.find(dir);
+		if (found != listings.end())
+			return &found->second;
+		if (listings.size() >= MAX_LISTINGS)
+			Reset();
+
+		// Watch first, so a change while listing isn't missed.
+		const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+		int wd = inotify_add_watch(notifyFd, dir.c_str(), mask);
+		if (wd < 0) {
+			// Not a directory, or out of watches.
+			return nullptr;
+		}
+
+		DIR *dirp = opendir(dir.c_str());
+		if (!dirp) {
+			if (watches.find(wd) == watches.end())
+				inotify_rm_watch(notifyFd, wd);
+			return nullptr;
+		}
+		Listing &listing = listings[dir];
+		struct dirent *result;
+		while ((result = readdir(dirp))) {
+			std::string name = result->d_name;
+			std::string lower = name;
+			for (char &c : lower)
+				c = tolower(c);
+			listing.names.insert(name);
+			// FixFilenameCase ends up with the first match, as it compares to the name it found after that.
+			listing.folded.emplace(lower, name);
+		}
+		closedir(dirp);
+
+		std::vector<std::string> &paths = watches[wd];
+		if (std::find(paths.begin(), paths.end(), dir) == paths.end())
+			paths.push_back(dir);
+		return &listing;
+	}
+
+	bool FixFilenameCase(const std::string &path, std::string &filename) {
+		const Listing *listing = GetListing(path);
+		if (!listing)
+			return ::FixFilenameCase(path, filename);
+		if (listing->names.count(filename))
+			return true;
+
+		for (char &c : filename)
+			c = tolower(c);
+		auto it = listing->folded.find(filename);
+		if (it == listing->folded.end())
+			return false;
+		filename = it->second;
+		return true;
+	}
+};
+
+PathCaseCache::PathCaseCache() : impl_(new Impl()) {}
+
+PathCaseCache::~PathCaseCache() {
+	delete impl_;
+}
+
+bool PathCaseCache::FixPathCase(const Path &basePath, std::string &path, FixPathCaseBehavior behavior) {
+	std::lock_guard<std::mutex> guard(impl_->lock);
+	if (impl_->notifyFd < 0)
+		return ::FixPathCase(basePath, path, behavior);
+	impl_->ProcessEvents();
+	return FixPathCaseWith(basePath, path, behavior, [this](const std::string &dir, std::string &filename) {
+		return impl_->FixFilenameCase(dir, filename);
+	});
+}
+
+void PathCaseCache::Clear() {
+	std::lock_guard<std::mutex> guard(impl_->lock);
+	impl_->Reset();
+}
+
+#else
+
+struct PathCaseCache::Impl {};
+
+PathCaseCache::PathCaseCache() : impl_(nullptr) {}
+PathCaseCache::~PathCaseCache() {}
+
+bool PathCaseCache::FixPathCase(const Path &basePath, std::string &path, FixPathCaseBehavior behavior) {
+	return ::FixPathCase(basePath, path, behavior);
+}
+
+void PathCaseCache::Clear() {}
+
+#endif
+
 #endif
@@ -157,4 +157,23 @@ enum FixPathCaseBehavior {
 
 bool FixPathCase(const Path &basePath, std::string &path, FixPathCaseBehavior behavior);
 
+// Same as FixPathCase, but keeps case-folded listings of the directories it has looked in, so repeated
+// lookups don't have to list them again. Listings are dropped when inotify reports a change in the
+// directory, so this sees changes made by anyone. Without inotify, it just calls FixPathCase.
+class PathCaseCache {
+public:
+	PathCaseCache();
+	~PathCaseCache();
+
+	bool FixPathCase(const Path &basePath, std::string &path, FixPathCaseBehavior behavior);
+	void Clear();
+
+private:
+	PathCaseCache(const PathCaseCache &) = delete;
+	PathCaseCache &operator =(const PathCaseCache &) = delete;
+
+	struct Impl;
+	Impl *impl_;
+};
+
 #endif
@@ -15,7 +15,7 @@
 #include "Common/File/VFS/ZipFileReader.h"
 #include "Common/StringUtils.h"
 
-ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath, bool logErrors) {
+zip *ZipFileReader::OpenZip(const Path &zipFile, bool logErrors) {
 	int error = 0;
 	zip *zip_file;
 	if (zipFile.Type() == PathType::CONTENT_URI) {
@@ -37,6 +37,14 @@ ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath,
 		}
 		return nullptr;
 	}
+	return zip_file;
+}
+
+ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath, bool logErrors) {
+	zip *zip_file = OpenZip(zipFile, logErrors);
+	if (!zip_file) {
+		return nullptr;
+	}
 
 	// The inZipPath is supposed to be a folder, and internally in this class, we suffix
 	// folder paths with '/', matching how the zip library works.
@@ -49,27 +57,69 @@ ZipFileReader *ZipFileReader::Create(const Path &zipFile, const char *inZipPath,
 
 ZipFileReader::~ZipFileReader() {
 	std::lock_guard<std::mutex> guard(lock_);
-	zip_close(zip_file_);
+	_dbg_assert_(freeHandles_.size() == handles_.size());
+	for (zip *handle : handles_) {
+		zip_close(handle);
+	}
+}
+
+zip *ZipFileReader::AcquireHandle() {
+	std::unique_lock<std::mutex> guard(lock_);
+	while (freeHandles_.empty()) {
+		if (handles_.size() < maxHandles_ && !openingHandle_) {
+			// Opening reads the whole central directory, so don't hold up the others meanwhile.
+			openingHandle_ = true;
+			guard.unlock();
+			zip *handle = OpenZip(zipPath_, false);
+			guard.lock();
+			openingHandle_ = false;
+			handleFree_.notify_all();
+			if (handle) {
+				handles_.push_back(handle);
+				return handle;
+			}
+			WARN_LOG(Log::IO, "Couldn't open %s again, reading one file at a time", zipPath_.c_str());
+			maxHandles_ = handles_.size();
+			continue;
+		}
+		handleFree_.wait(guard);
+	}
+	zip *handle = freeHandles_.back();
+	freeHandles_.pop_back();
+	return handle;
+}
+
+void ZipFileReader::ReleaseHandle(zip *handle) {
+	std::lock_guard<std::mutex> guard(lock_);
+	freeHandles_.push_back(handle);
+	handleFree_.notify_one();
 }
 
 uint8_t *ZipFileReader::ReadFile(const char *path, size_t *size) {
 	std::string temp_path = inZipPath_ + path;
 
-	std::lock_guard<std::mutex> guard(lock_);
-	// Figure out the file size first.
-	struct zip_stat zstat;
-	zip_stat(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED, &zstat);
-	zip_file *file = zip_fopen(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED);
+	// The index knows the size, and saves zip_stat/zip_fopen going through every name.
+	int index = FindEntry(temp_path);
+	if (index < 0) {
+		ERROR_LOG(Log::IO, "Error opening %s from ZIP", temp_path.c_str());
+		return 0;
+	}
+	const size_t fileSize = (size_t)entries_[index].size;
+
+	zip *handle = AcquireHandle();
+	zip_file *file = zip_fopen_index(handle, index, ZIP_FL_UNCHANGED);
 	if (!file) {
+		ReleaseHandle(handle);
 		ERROR_LOG(Log::IO, "Error opening %s from ZIP", temp_path.c_str());
 		return 0;
 	}
-	uint8_t *contents = new uint8_t[zstat.size + 1];
-	zip_fread(file, contents, zstat.size);
+	uint8_t *contents = new uint8_t[fileSize + 1];
+	zip_fread(file, contents, fileSize);
 	zip_fclose(file);
-	contents[zstat.size] = 0;
+	ReleaseHandle(handle);
+	contents[fileSize] = 0;
 
-	*size = zstat.size;
+	*size = fileSize;
 	return contents;
 }
 
@@ -150,14 +200,13 @@ bool ZipFileReader::GetFileListing(const char *orig_path, std::vector<File::File
 bool ZipFileReader::GetZipListings(const std::string &path, std::set<std::string> &files, std::set<std::string> &directories) {
 	_dbg_assert_(path.empty() || path.back() == '/');
 
-	std::lock_guard<std::mutex> guard(lock_);
-	int numFiles = zip_get_num_files(zip_file_);
+	std::call_once(indexFlag_, [this] { BuildIndex(); });
 	bool anyPrefixMatched = false;
-	for (int i = 0; i < numFiles; i++) {
-		const char* name = zip_get_name(zip_file_, i, 0);
-		if (!name)
+	for (const Entry &entry : entries_) {
+		const char *name = entry.name.c_str();
+		if (entry.name.empty())
 			continue;  // shouldn't happen, I think
-		if (startsWith(name, path)) {
+		if (startsWith(entry.name, path)) {
 			if (strlen(name) == path.size()) {
 				// Don't want to return the same folder.
 				continue;
@@ -182,7 +231,6 @@ bool ZipFileReader::GetZipListings(const std::string &path, std::set<std::string
 }
 
 bool ZipFileReader::GetFileInfo(const char *path, File::FileInfo *info) {
-	struct zip_stat zstat;
 	std::string temp_path = inZipPath_ + path;
 
 	// Clear some things to start.
@@ -190,23 +238,18 @@ bool ZipFileReader::GetFileInfo(const char *path, File::FileInfo *info) {
 	info->isWritable = false;
 	info->size = 0;
 
-	{
-		std::lock_guard<std::mutex> guard(lock_);
-		if (0 != zip_stat(zip_file_, temp_path.c_str(), ZIP_FL_NOCASE | ZIP_FL_UNCHANGED, &zstat)) {
-			// ZIP files do not have real directories, so we'll end up here if we
-			// try to stat one. For now that's fine.
-			info->exists = false;
-			return false;
-		}
+	int index = FindEntry(temp_path);
+	if (index < 0) {
+		// ZIP files do not have real directories, so we'll end up here if we
+		// try to stat one. For now that's fine.
+		info->exists = false;
+		return false;
 	}
 
 	// Zips usually don't contain directory entries, but they may.
-	if ((zstat.valid & ZIP_STAT_NAME) != 0 && zstat.name) {
-		info->isDirectory = zstat.name[strlen(zstat.name) - 1] == '/';
-	}
-	if ((zstat.valid & ZIP_STAT_SIZE) != 0) {
-		info->size = zstat.size;
-	}
+	const Entry &entry = entries_[index];
+	info->isDirectory = entry.name.back() == '/';
+	info->size = entry.size;
 
 	info->fullName = Path(path);
 	info->exists = true;
@@ -225,32 +268,63 @@ class ZipFileReaderOpenFile : public VFSOpenFile {
 		_dbg_assert_(zf == nullptr);
 	}
 	ZipFileReaderFileReference *reference;
+	zip *handle = nullptr;
 	zip_file_t *zf = nullptr;
 };
 
+static std::string LowerZipName(const char *name) {
+	// Same as the strcasecmp that zip_name_locate uses with ZIP_FL_NOCASE.
+	std::string lower = name;
+	for (char &c : lower) {
+		c = (char)tolower((unsigned char)c);
+	}
+	return lower;
+}
+
+void ZipFileReader::BuildIndex() {
+	std::lock_guard<std::mutex> guard(lock_);
+	zip *handle = freeHandles_.empty() ? handles_[0] : freeHandles_.back();
+	int numFiles = zip_get_num_files(handle);
+	entries_.resize(std::max(numFiles, 0));
+	nameIndex_.reserve(entries_.size());
+	for (int i = 0; i < numFiles; i++) {
+		zip_stat_t zstat;
+		if (zip_stat_index(handle, i, ZIP_FL_UNCHANGED, &zstat) != 0 || (zstat.valid & ZIP_STAT_NAME) == 0 || !zstat.name || !zstat.name[0])
+			continue;
+		Entry &entry = entries_[i];
+		entry.name = zstat.name;
+		if (zstat.valid & ZIP_STAT_SIZE)
+			entry.size = zstat.size;
+		// Like zip_name_locate, the first one wins if several only differ in case.
+		nameIndex_.emplace(LowerZipName(zstat.name), i);
+	}
+}
+
+int ZipFileReader::FindEntry(const std::string &path) {
+	std::call_once(indexFlag_, [this] { BuildIndex(); });
+	auto iter = nameIndex_.find(LowerZipName(path.c_str()));
+	return iter == nameIndex_.end() ? -1 : iter->second;
+}
+
 VFSFileReference *ZipFileReader::GetFile(const char *path) {
-	int zi = zip_name_locate(zip_file_, path, ZIP_FL_NOCASE);  // this is EXPENSIVE
-	if (zi < 0) {
+	int index = FindEntry(path);
+	if (index < 0) {
 		// Not found.
 		return nullptr;
 	}
 	ZipFileReaderFileReference *ref = new ZipFileReaderFileReference();
-	ref->zi = zi;
+	ref->zi = index;
 	return ref;
 }
 
 bool ZipFileReader::GetFileInfo(VFSFileReference *vfsReference, File::FileInfo *fileInfo) {
 	ZipFileReaderFileReference *reference = (ZipFileReaderFileReference *)vfsReference;
-	// If you crash here, you called this while having the lock held by having the file open.
-	// Don't do that, check the info before you open the file.
-	zip_stat_t zstat;
-	if (zip_stat_index(zip_file_, reference->zi, 0, &zstat) != 0)
+	std::call_once(indexFlag_, [this] { BuildIndex(); });
+	if (reference->zi < 0 || reference->zi >= (int)entries_.size())
 		return false;
 	*fileInfo = File::FileInfo{};
-	fileInfo->size = 0;
-	if (zstat.valid & ZIP_STAT_SIZE)
-		fileInfo->size = zstat.size;
-	return zstat.size;
+	fileInfo->size = entries_[reference->zi].size;
+	return fileInfo->size;
 }
 
 void ZipFileReader::ReleaseFile(VFSFileReference *vfsReference) {
@@ -264,26 +338,24 @@ VFSOpenFile *ZipFileReader::OpenFileForRead(VFSFileReference *vfsReference, size
 	ZipFileReaderOpenFile *openFile = new ZipFileReaderOpenFile();
 	openFile->reference = reference;
 	*size = 0;
-	// We only allow one file to be open for read concurrently. It's possible that this can be improved,
-	// especially if we only access by index like this.
-	lock_.lock();
+	// libzip handles can't be used from several threads, so the file gets one to itself until it's closed.
+	openFile->handle = AcquireHandle();
 	zip_stat_t zstat;
-	if (zip_stat_index(zip_file_, reference->zi, 0, &zstat) != 0) {
-		lock_.unlock();
+	if (zip_stat_index(openFile->handle, reference->zi, 0, &zstat) != 0) {
+		ReleaseHandle(openFile->handle);
 		delete openFile;
 		return nullptr;
 	}
 
-	openFile->zf = zip_fopen_index(zip_file_, reference->zi, 0);
+	openFile->zf = zip_fopen_index(openFile->handle, reference->zi, 0);
 	if (!openFile->zf) {
 		WARN_LOG(Log::G3D, "File with index %d not found in zip", reference->zi);
-		lock_.unlock();
+		ReleaseHandle(openFile->handle);
 		delete openFile;
 		return nullptr;
 	}
 
 	*size = zstat.size;
-	// Intentionally leaving the mutex locked, will be closed in CloseFile.
 	return openFile;
 }
 
@@ -308,6 +380,6 @@ void ZipFileReader::CloseFile(VFSOpenFile *vfsOpenFile) {
 	zip_fclose(file->zf);
 	file->zf = nullptr;
 	vfsOpenFile = nullptr;
-	lock_.unlock();
+	ReleaseHandle(file->handle);
 	delete file;
 }
@@ -6,9 +6,12 @@
 #include "ext/libzip/zip.h"
 #endif
 
+#include <condition_variable>
 #include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/FileUtil.h"
@@ -19,7 +22,7 @@ class ZipFileReader : public VFSBackend {
 	static ZipFileReader *Create(const Path &zipFile, const char *inZipPath, bool logErrors = true);
 	~ZipFileReader();
 
-	bool IsValid() const { return zip_file_ != nullptr; }
+	bool IsValid() const { return !handles_.empty(); }
 
 	// use delete[] on the returned value.
 	uint8_t *ReadFile(const char *path, size_t *size) override;
@@ -45,12 +48,45 @@ class ZipFileReader : public VFSBackend {
 	}
 
 private:
-	ZipFileReader(zip *zip_file, const Path &zipPath, const std::string &inZipPath) : zip_file_(zip_file), zipPath_(zipPath), inZipPath_(inZipPath) {}
+	ZipFileReader(zip *zip_file, const Path &zipPath, const std::string &inZipPath) : zipPath_(zipPath), inZipPath_(inZipPath) {
+		handles_.push_back(zip_file);
+		freeHandles_.push_back(zip_file);
+	}
+	static zip *OpenZip(const Path &zipFile, bool logErrors);
 	// Path has to be either an empty string, or a string ending with a /.
 	bool GetZipListings(const std::string &path, std::set<std::string> &files, std::set<std::string> &directories);
 
-	zip *zip_file_ = nullptr;
+	// An open file keeps its handle until it's closed, so that several can be read at once (texture
+	// packs load from many threads.) More handles are opened as needed, up to MAX_HANDLES.
+	zip *AcquireHandle();
+	void ReleaseHandle(zip *handle);
+	// Names and sizes only need the central directory, which libzip keeps in memory. So this borrows a
+	// handle under the lock rather than waiting for one, which could be forever if the caller has a file open.
+	void BuildIndex();
+	int FindEntry(const std::string &path);
+
+	enum {
+		MAX_HANDLES = 4,
+	};
+
+	// All opened on the same file, so the indices are the same in each.
+	std::vector<zip *> handles_;
+	std::vector<zip *> freeHandles_;
+	size_t maxHandles_ = MAX_HANDLES;
+	bool openingHandle_ = false;
 	std::mutex lock_;
-	std::string inZipPath_;
+	std::condition_variable handleFree_;
+
+	struct Entry {
+		std::string name;
+		uint64_t size = 0;
+	};
+	// In zip order, so the position is the index in the zip. Listings are built from this.
+	std::vector<Entry> entries_;
+	// Lowercase names to indices, as zip_name_locate goes through every name when ignoring case.
+	std::unordered_map<std::string, int> nameIndex_;
+	std::once_flag indexFlag_;
+
 	Path zipPath_;
+	std::string inZipPath_;
 };
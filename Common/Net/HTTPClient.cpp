@@ -365,7 +365,7 @@ int Client::SendRequestWithData(const char *method, const RequestParams &req, co
 		"Host: %s\r\n"
 		"User-Agent: %s\r\n"
 		"Accept: %s\r\n"
-		"Connection: close\r\n"
+		"Connection: %s\r\n"
 		"%s"
 		"\r\n";
 
@@ -374,6 +374,7 @@ int Client::SendRequestWithData(const char *method, const RequestParams &req, co
 		host_.c_str(),
 		userAgent_.c_str(),
 		req.acceptMime,
+		keepAlive_ ? "keep-alive" : "close",
 		otherHeaders ? otherHeaders : "");
 	buffer.Append(data);
 	bool flushed = buffer.FlushSocket(sock(), dataTimeout_, progress->cancelled);
@@ -436,11 +437,21 @@ int Client::ReadResponseHeaders(net::Buffer *readbuf, std::vector<std::string> &
 	return code;
 }
 
+bool Client::ServerKeptAlive(const std::vector<std::string> &responseHeaders) {
+	std::string connection;
+	if (!GetHeaderValue(responseHeaders, "Connection", &connection)) {
+		// We always speak HTTP/1.1, where keep-alive is the default.
+		return true;
+	}
+	return !containsNoCase(connection, "close");
+}
+
 int Client::ReadResponseEntity(net::Buffer *readbuf, const std::vector<std::string> &responseHeaders, Buffer *output, net::RequestProgress *progress) {
 	_dbg_assert_(progress->cancelled);
 
 	bool gzip = false;
 	bool chunked = false;
+	bool knownLength = false;
 	int contentLength = 0;
 	for (std::string line : responseHeaders) {
 		if (startsWithNoCase(line, "Content-Length:")) {
@@ -450,6 +461,7 @@ int Client::ReadResponseEntity(net::Buffer *readbuf, const std::vector<std::stri
 			}
 			if (size_pos != line.npos) {
 				contentLength = atoi(&line[size_pos]);
+				knownLength = true;
 				chunked = false;
 			}
 		} else if (startsWithNoCase(line, "Content-Encoding:")) {
@@ -471,8 +483,13 @@ int Client::ReadResponseEntity(net::Buffer *readbuf, const std::vector<std::stri
 		contentLength = 0;
 	}
 
-	if (!readbuf->ReadAllWithProgress(sock(), contentLength, progress))
+	if (keepAlive_ && knownLength && !chunked) {
+		// The server won't close the connection for us, so stop at the end of the entity.
+		if (!readbuf->ReadExactWithProgress(sock(), contentLength, dataTimeout_, progress))
+			return -1;
+	} else if (!readbuf->ReadAllWithProgress(sock(), contentLength, progress)) {
 		return -1;
+	}
 
 	// output now contains the rest of the reply. Dechunk it.
 	if (!output->IsVoid()) {
@@ -83,9 +83,18 @@ class Client : public net::Connection {
 		userAgent_ = value;
 	}
 
+	// Ask the server to keep the connection open. Responses with a Content-Length are then
+	// read exactly, instead of until the server closes. Check ServerKeptAlive() afterwards.
+	void SetKeepAlive(bool keepAlive) {
+		keepAlive_ = keepAlive;
+	}
+
+	static bool ServerKeptAlive(const std::vector<std::string> &responseHeaders);
+
 protected:
 	std::string userAgent_;
 	double dataTimeout_ = 900.0;
+	bool keepAlive_ = false;
 };
 
 // Really an asynchronous request.
@@ -22,6 +22,27 @@ RequestHeader::~RequestHeader() {
 	delete [] params;
 }
 
+void RequestHeader::Reset() {
+	delete [] referer;
+	delete [] user_agent;
+	delete [] resource;
+	delete [] params;
+	referer = nullptr;
+	user_agent = nullptr;
+	resource = nullptr;
+	params = nullptr;
+
+	status = 100;
+	content_length = -1;
+	other.clear();
+	type = SIMPLE;
+	method = UNSUPPORTED;
+	ok = false;
+	keep_alive = false;
+	http11_ = false;
+	first_header_ = true;
+}
+
 bool RequestHeader::GetParamValue(const char *param_name, std::string *value) const {
 	if (!params)
 		return false;
@@ -97,6 +118,7 @@ int RequestHeader::ParseHttpHeader(const char *buffer) {
 			type = FULL;
 		else
 			type = SIMPLE;
+		http11_ = strstr(buffer, "HTTP/1.1") != nullptr;
 		return 0;
 	}
 
@@ -155,6 +177,14 @@ void RequestHeader::ParseHeaders(net::InputSink *sink) {
 
 	VERBOSE_LOG(Log::IO, "finished parsing request.");
 	ok = line_count > 1 && resource != nullptr;
+
+	std::string connection;
+	GetOther("connection", &connection);
+	if (http11_) {
+		keep_alive = strcasecmp(connection.c_str(), "close") != 0;
+	} else {
+		keep_alive = strcasecmp(connection.c_str(), "keep-alive") == 0;
+	}
 }
 
 }  // namespace http
@@ -38,12 +38,17 @@ class RequestHeader {
 	};
 	Method method = UNSUPPORTED;
 	bool ok = false;
+	// HTTP/1.1 without "Connection: close", or HTTP/1.0 with "Connection: keep-alive".
+	bool keep_alive = false;
 	void ParseHeaders(net::InputSink *sink);
+	// Forget everything, so the next request on a kept-alive connection can be parsed.
+	void Reset();
 	bool GetParamValue(const char *param_name, std::string *value) const;
 	bool GetOther(const char *name, std::string *value) const;
 private:
 	int ParseHttpHeader(const char *buffer);
 	bool first_header_ = true;
+	bool http11_ = false;
 
 	DISALLOW_COPY_AND_ASSIGN(RequestHeader);
 };
@@ -24,15 +24,22 @@
 
 #endif
 
+#if PPSSPP_PLATFORM(LINUX) || PPSSPP_PLATFORM(ANDROID)
+#include <sys/sendfile.h>
+#define HAVE_SENDFILE
+#endif
+
 #if PPSSPP_PLATFORM(UWP)
 #define in6addr_any IN6ADDR_ANY_INIT
 #endif
 
 #include <algorithm>
+#include <cerrno>
 #include <functional>
 
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
 #include <thread>
 
 #include "Common/Net/HTTPServer.h"
@@ -41,6 +48,7 @@
 #include "Common/File/FileDescriptor.h"
 
 #include "Common/Buffer.h"
+#include "Common/CommonFuncs.h"
 #include "Common/Log.h"
 
 
@@ -55,8 +63,62 @@ NewThreadExecutor::~NewThreadExecutor() {
 	threads_.clear();
 }
 
+ThreadPoolExecutor::ThreadPoolExecutor(int maxThreads) : maxThreads_(std::max(1, maxThreads)) {
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+	{
+		std::lock_guard<std::mutex> guard(mutex_);
+		stop_ = true;
+	}
+	cond_.notify_all();
+	// Workers drain the queue first, so no accepted connection is leaked.
+	for (auto &thread : threads_)
+		thread.join();
+	threads_.clear();
+}
+
+void ThreadPoolExecutor::Run(std::function<void()> func) {
+	std::lock_guard<std::mutex> guard(mutex_);
+	queue_.push_back(std::move(func));
+	// Threads are spawned lazily, when there's more queued than idle threads to pick it up.
+	// The busy ones may be held by keep-alive or websocket connections for a long time.
+	if ((int)queue_.size() > idle_ && (int)threads_.size() < maxThreads_) {
+		threads_.push_back(std::thread(&ThreadPoolExecutor::WorkerLoop, this));
+	}
+	cond_.notify_one();
+}
+
+bool ThreadPoolExecutor::Saturated() const {
+	std::lock_guard<std::mutex> guard(mutex_);
+	// A queued connection that an idle or just spawned thread is about to pick up doesn't count.
+	return (int)threads_.size() >= maxThreads_ && (int)queue_.size() > idle_;
+}
+
+void ThreadPoolExecutor::WorkerLoop() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		idle_++;
+		cond_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+		idle_--;
+		if (queue_.empty()) {
+			// Only get here when stopping.
+			break;
+		}
+
+		std::function<void()> func = std::move(queue_.front());
+		queue_.pop_front();
+		lock.unlock();
+		func();
+		lock.lock();
+	}
+}
+
 namespace http {
 
+// How long a kept-alive connection may sit idle between requests.
+static const double KEEPALIVE_TIMEOUT = 5.0;
+
 // Note: charset here helps prevent XSS.
 const char *const DEFAULT_MIME_TYPE = "text/html; charset=utf-8";
 
@@ -107,12 +169,17 @@ void ServerRequest::WriteHttpResponseHeader(const char *ver, int status, int64_t
 	default: statusStr = "OK"; break;
 	}
 
+	bool websocket = mimeType && strcmp(mimeType, "websocket") == 0;
+	// Without a size, the only way to mark the end of the body is closing the connection.
+	// A request body we haven't consumed would also be mistaken for the next request.
+	keepAlive_ = allowKeepAlive_ && header_.keep_alive && !websocket && size >= 0 && !strcmp(ver, "1.1") && header_.content_length <= 0;
+
 	net::OutputSink *buffer = Out();
 	buffer->Printf("HTTP/%s %03d %s\r\n", ver, status, statusStr);
 	buffer->Push("Server: PPSSPPServer v0.1\r\n");
-	if (!mimeType || strcmp(mimeType, "websocket") != 0) {
+	if (!websocket) {
 		buffer->Printf("Content-Type: %s\r\n", mimeType ? mimeType : DEFAULT_MIME_TYPE);
-		buffer->Push("Connection: close\r\n");
+		buffer->Push(keepAlive_ ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
 	}
 	if (size >= 0) {
 		buffer->Printf("Content-Length: %llu\r\n", size);
@@ -123,6 +190,79 @@ void ServerRequest::WriteHttpResponseHeader(const char *ver, int status, int64_t
 	buffer->Push("\r\n");
 }
 
+bool ServerRequest::SendFileRange(FILE *fp, int64_t offset, int64_t len) const {
+	_assert_(fd_);
+	// Whatever happens below, the client can't tell where this response ends anymore unless we succeed.
+	bool keepAlive = keepAlive_;
+	keepAlive_ = false;
+	if (!out_->Flush()) {
+		return false;
+	}
+
+#ifdef HAVE_SENDFILE
+	int fileFd = fileno(fp);
+	off_t pos = (off_t)offset;
+	while (len > 0) {
+		ssize_t sent = sendfile(fd_, fileFd, &pos, (size_t)std::min(len, (int64_t)0x7FFFF000));
+		if (sent > 0) {
+			len -= sent;
+		} else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			// The socket is non-blocking, wait for the client to catch up.
+			if (!fd_util::WaitUntilReady(fd_, 5.0, true))
+				return false;
+		} else if (sent < 0 && (errno == EINVAL || errno == ENOSYS) && pos == (off_t)offset) {
+			// Not supported for this file (some FUSE and network filesystems.) Use the copy below.
+			break;
+		} else {
+			return false;
+		}
+	}
+	if (len == 0) {
+		keepAlive_ = keepAlive;
+		return true;
+	}
+	offset = (int64_t)pos;
+#endif
+
+	if (fseeko(fp, offset, SEEK_SET) != 0) {
+		return false;
+	}
+
+	const size_t CHUNK_SIZE = 64 * 1024;
+	std::unique_ptr<char[]> buf(new char[CHUNK_SIZE]);
+	while (len > 0) {
+		size_t chunklen = (size_t)std::min(len, (int64_t)CHUNK_SIZE);
+		if (fread(buf.get(), chunklen, 1, fp) != 1)
+			return false;
+		if (!out_->Push(buf.get(), chunklen))
+			return false;
+		len -= chunklen;
+	}
+	if (!out_->Flush()) {
+		return false;
+	}
+	keepAlive_ = keepAlive;
+	return true;
+}
+
+bool ServerRequest::ReadNextRequest(double timeout) {
+	_assert_(fd_);
+	header_.Reset();
+	keepAlive_ = false;
+	// The client may have pipelined the next request already.
+	if (in_->Empty() && !fd_util::WaitUntilReady(fd_, timeout, false)) {
+		Close();
+		return false;
+	}
+
+	header_.ParseHeaders(in_);
+	if (!header_.ok) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
 void ServerRequest::WritePartial() const {
 	_assert_(fd_);
 	out_->Flush();
@@ -141,7 +281,7 @@ void ServerRequest::Close() {
 	}
 }
 
-Server::Server(NewThreadExecutor *executor)
+Server::Server(Executor *executor)
 	: port_(0), executor_(executor) {
 	RegisterHandler("/", std::bind(&Server::HandleListing, this, std::placeholders::_1));
 	SetFallbackHandler(std::bind(&Server::Handle404, this, std::placeholders::_1));
@@ -316,19 +456,54 @@ void Server::Stop() {
 	closesocket(listener_);
 }
 
+ServerStats Server::GetStats() const {
+	ServerStats stats;
+	stats.activeConnections = activeConnections_;
+	stats.peakConnections = peakConnections_;
+	stats.totalConnections = totalConnections_;
+	stats.totalRequests = totalRequests_;
+	stats.keepAliveRequests = keepAliveRequests_;
+	return stats;
+}
+
 void Server::HandleConnection(int conn_fd) {
+	int active = ++activeConnections_;
+	int peak = peakConnections_;
+	while (active > peak && !peakConnections_.compare_exchange_weak(peak, active)) {
+	}
+	totalConnections_++;
+
 	ServerRequest request(conn_fd);
 	if (!request.IsOK()) {
 		WARN_LOG(Log::IO, "Bad request, ignoring.");
+		activeConnections_--;
 		return;
 	}
-	HandleRequest(request);
 
-	// TODO: Way to mark the content body as read, read it here if never read.
-	// This allows the handler to stream if need be.
+	while (true) {
+		// Don't keep idle connections around while others are waiting for a thread.
+		if (executor_->Saturated()) {
+			request.DisallowKeepAlive();
+		}
+		totalRequests_++;
+		HandleRequest(request);
+
+		// TODO: Way to mark the content body as read, read it here if never read.
+		// This allows the handler to stream if need be.
+		if (!request.IsOK() || !request.KeepAlive()) {
+			break;
+		}
+
+		request.WritePartial();
+		if (!request.ReadNextRequest(KEEPALIVE_TIMEOUT)) {
+			activeConnections_--;
+			return;
+		}
+		keepAliveRequests_++;
+	}
 
-	// TODO: Could handle keep alive here.
 	request.Write();
+	activeConnections_--;
 }
 
 void Server::HandleRequest(const ServerRequest &request) {
@@ -1,19 +1,53 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <thread>
 
 #include "Common/Net/HTTPHeaders.h"
 #include "Common/Net/Resolve.h"
 
-class NewThreadExecutor {
+class Executor {
+public:
+	virtual ~Executor() {}
+	virtual void Run(std::function<void()> func) = 0;
+	// True if work is waiting for a thread. Used to stop holding on to idle connections.
+	virtual bool Saturated() const { return false; }
+};
+
+// Spawns a thread per call, all kept until destruction.
+class NewThreadExecutor : public Executor {
 public:
 	~NewThreadExecutor();
-	void Run(std::function<void()> func);
+	void Run(std::function<void()> func) override;
+
+private:
+	std::vector<std::thread> threads_;
+};
+
+// Runs work on at most maxThreads reused threads, queueing the rest.
+class ThreadPoolExecutor : public Executor {
+public:
+	explicit ThreadPoolExecutor(int maxThreads);
+	~ThreadPoolExecutor();
+	void Run(std::function<void()> func) override;
+	bool Saturated() const override;
 
 private:
+	void WorkerLoop();
+
 	std::vector<std::thread> threads_;
+	std::deque<std::function<void()>> queue_;
+	mutable std::mutex mutex_;
+	std::condition_variable cond_;
+	int maxThreads_;
+	int idle_ = 0;
+	bool stop_ = false;
 };
 
 namespace net {
@@ -59,20 +93,43 @@ class ServerRequest {
 	bool IsOK() const { return fd_ > 0; }
 
 	// If size is negative, no Content-Length: line is written.
+	// The connection is kept alive only for "1.1" responses with a known size, if the client asked for it.
 	void WriteHttpResponseHeader(const char *ver, int status, int64_t size = -1, const char *mimeType = nullptr, const char *otherHeaders = nullptr) const;
 
+	// Sends len bytes of fp starting at offset, after flushing what's pushed so far.
+	// Uses sendfile where available, so the data never passes through userspace.
+	// On failure the promised length can't be met, so the connection won't be kept alive.
+	bool SendFileRange(FILE *fp, int64_t offset, int64_t len) const;
+
+	// Whether the last response header allowed another request on this connection.
+	bool KeepAlive() const { return keepAlive_; }
+	void DisallowKeepAlive() { allowKeepAlive_ = false; }
+	// Waits up to timeout for the next request on a kept-alive connection. Closes on failure.
+	bool ReadNextRequest(double timeout);
+
 private:
 	net::InputSink *in_;
 	net::OutputSink *out_;
 	RequestHeader header_;
 	int fd_;
+	bool allowKeepAlive_ = true;
+	mutable bool keepAlive_ = false;
+};
+
+struct ServerStats {
+	int activeConnections;
+	int peakConnections;
+	int64_t totalConnections;
+	int64_t totalRequests;
+	// Requests served on an already open connection.
+	int64_t keepAliveRequests;
 };
 
 // Register handlers on this class to serve stuff.
 class Server {
 public:
 	// Takes ownership.
-	Server(NewThreadExecutor *executor);
+	Server(Executor *executor);
 	virtual ~Server();
 
 	typedef std::function<void(const ServerRequest &)> UrlHandlerFunc;
@@ -100,6 +157,8 @@ class Server {
 		return port_;
 	}
 
+	ServerStats GetStats() const;
+
 private:
 	bool Listen6(int port, bool ipv6_only);
 	bool Listen4(int port);
@@ -119,7 +178,13 @@ class Server {
 	UrlHandlerMap handlers_;
 	UrlHandlerFunc fallback_;
 
-	NewThreadExecutor *executor_;
+	Executor *executor_;
+
+	std::atomic<int> activeConnections_{};
+	std::atomic<int> peakConnections_{};
+	std::atomic<int64_t> totalConnections_{};
+	std::atomic<int64_t> totalRequests_{};
+	std::atomic<int64_t> keepAliveRequests_{};
 };
 
 }  // namespace http
@@ -121,6 +121,51 @@ bool Buffer::ReadAllWithProgress(int fd, int knownSize, RequestProgress *progres
 	return true;
 }
 
+bool Buffer::ReadExactWithProgress(int fd, size_t size, double timeout, RequestProgress *progress) {
+	static constexpr float CANCEL_INTERVAL = 0.25f;
+	std::vector<char> buf(65536);
+
+	double st = time_now_d();
+	double lastData = st;
+	// Some of it may already have arrived along with the headers.
+	while (this->size() < size) {
+		if (progress && progress->cancelled && *progress->cancelled)
+			return false;
+		if (!fd_util::WaitUntilReady(fd, CANCEL_INTERVAL, false)) {
+			if (time_now_d() > lastData + timeout) {
+				ERROR_LOG(Log::IO, "Timed out reading %d bytes", (int)size);
+				return false;
+			}
+			continue;
+		}
+
+		int retval = recv(fd, &buf[0], std::min(size - this->size(), buf.size()), MSG_NOSIGNAL);
+		if (retval == 0) {
+			ERROR_LOG(Log::IO, "Connection closed with %d of %d bytes read", (int)this->size(), (int)size);
+			return false;
+		} else if (retval < 0) {
+#if PPSSPP_PLATFORM(WINDOWS)
+			if (WSAGetLastError() != WSAEWOULDBLOCK) {
+#else
+			if (errno != EWOULDBLOCK) {
+#endif
+				ERROR_LOG(Log::IO, "Error reading from buffer: %i", retval);
+				return false;
+			}
+			continue;
+		}
+
+		char *p = Append((size_t)retval);
+		memcpy(p, &buf[0], retval);
+		lastData = time_now_d();
+		if (progress) {
+			progress->Update(this->size(), size, false);
+			progress->kBps = (float)(this->size() / (lastData - st)) / 1024.0f;
+		}
+	}
+	return true;
+}
+
 int Buffer::Read(int fd, size_t sz) {
 	char buf[4096];
 	int retval;
@@ -24,6 +24,9 @@ class Buffer : public ::Buffer {
 	bool FlushSocket(uintptr_t sock, double timeout, bool *cancelled = nullptr);
 
 	bool ReadAllWithProgress(int fd, int knownSize, RequestProgress *progress);
+	// Reads until size bytes are buffered, without waiting for the connection to close.
+	// Fails on timeout, or if the connection closes early.
+	bool ReadExactWithProgress(int fd, size_t size, double timeout, RequestProgress *progress);
 
 	// < 0: error
 	// >= 0: number of bytes read
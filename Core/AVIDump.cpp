@@ -8,9 +8,15 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
 
 #ifdef USE_FFMPEG
 
@@ -26,6 +32,7 @@ extern "C" {
 #include "Common/Data/Convert/ColorConv.h"
 #include "Common/File/FileUtil.h"
 #include "Common/File/Path.h"
+#include "Common/Thread/ThreadUtil.h"
 
 #include "Core/Config.h"
 #include "Core/AVIDump.h"
@@ -50,20 +57,66 @@ extern "C" {
 static AVFormatContext *s_format_context = nullptr;
 static AVCodecContext *s_codec_context = nullptr;
 static AVStream *s_stream = nullptr;
-static AVFrame *s_src_frame = nullptr;
+static AVStream *s_audio_stream = nullptr;
 static AVFrame *s_scaled_frame = nullptr;
 static SwsContext *s_sws_context = nullptr;
 
 #endif
 
-static int s_bytes_per_pixel;
+// Frames are read back on the emulator thread straight into a small pool of buffers, and converted,
+// encoded and written on a worker thread. If the worker falls behind, frames are dropped rather than
+// stalling the game. Dropped frames still count towards the timestamps, so audio stays in sync.
+enum {
+	FRAME_POOL_SIZE = 4,
+	AUDIO_SAMPLE_RATE = 44100,
+	// In stereo samples, about 1.5 seconds.
+	AUDIO_RING_SIZE = 65536,
+};
+
+struct CapturedFrame {
+	GPUDebugBuffer buf;
+	u32 w;
+	u32 h;
+	s64 number;
+};
+
 static int s_width;
 static int s_height;
-static bool s_start_dumping = false;
 static int s_current_width;
 static int s_current_height;
 static int s_file_index = 0;
-static GPUDebugBuffer buf;
+
+// Slot n % FRAME_POOL_SIZE holds frame n. The worker owns [s_queueHead, s_queueTail), the emulator
+// thread everything else. Both counters are protected by s_queueLock.
+static CapturedFrame s_frames[FRAME_POOL_SIZE];
+static std::mutex s_queueLock;
+static std::condition_variable s_queueCond;
+static s64 s_queueHead;
+static s64 s_queueTail;
+static bool s_stopping;
+static std::thread s_encoderThread;
+static std::atomic<bool> s_recording;
+
+// Numbers of the frames captured so far (dropped or not), and of the first one in the current file.
+static s64 s_frameNumber;
+static s64 s_fileFirstFrame;
+// Audio written to the current file, in stereo samples.
+static s64 s_fileAudioSamples;
+
+// Filled by __AudioUpdate, drained by the worker. Single producer, single consumer.
+// s_audioLock is held by the producer, so Start() and Stop() can't reset or stop under a write.
+static std::mutex s_audioLock;
+static s16 s_audioRing[AUDIO_RING_SIZE * 2];
+static std::atomic<u32> s_audioWritePos;
+static std::atomic<u32> s_audioReadPos;
+// Samples dropped while the ring was full, and the ring position they belong at. The worker writes
+// silence in their place, so the audio after them doesn't come early.
+static std::atomic<u32> s_audioGapPos;
+static std::atomic<int> s_audioGapSamples;
+
+static std::atomic<int> s_maxQueueDepth;
+static std::atomic<int> s_framesDropped;
+static std::atomic<int> s_audioSamplesDropped;
 
 static void InitAVCodec() {
 	static bool first_run = true;
@@ -86,9 +139,31 @@ bool AVIDump::Start(int w, int h)
 
 	InitAVCodec();
 	bool success = CreateAVI();
-	if (!success)
+	if (!success) {
 		CloseFile();
-	return success;
+		return false;
+	}
+
+	s_queueHead = 0;
+	s_queueTail = 0;
+	s_stopping = false;
+	s_frameNumber = 0;
+	s_fileFirstFrame = 0;
+	s_fileAudioSamples = 0;
+	s_maxQueueDepth = 0;
+	s_framesDropped = 0;
+	{
+		std::lock_guard<std::mutex> guard(s_audioLock);
+		s_audioWritePos = 0;
+		s_audioReadPos = 0;
+		s_audioSamplesDropped = 0;
+		s_audioGapPos = 0;
+		s_audioGapSamples = 0;
+	}
+	s_encoderThread = std::thread(&EncoderThread);
+	std::lock_guard<std::mutex> guard(s_audioLock);
+	s_recording = true;
+	return true;
 }
 
 bool AVIDump::CreateAVI() {
@@ -141,6 +216,8 @@ bool AVIDump::CreateAVI() {
 	s_codec_context->time_base.den = 60000;
 	s_codec_context->gop_size = 12;
 	s_codec_context->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
+	// We're already off the emulator thread, but let the encoder spread out further. 0 is automatic.
+	s_codec_context->thread_count = 0;
 
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 48, 101)
 	if (avcodec_parameters_from_context(s_stream->codecpar, s_codec_context) < 0)
@@ -153,7 +230,28 @@ bool AVIDump::CreateAVI() {
 	if (avcodec_open2(s_codec_context, codec, nullptr) < 0)
 		return false;
 
-	s_src_frame = av_frame_alloc();
+	// The mixed audio goes in as plain 16-bit PCM, which needs no encoder.
+	s_audio_stream = avformat_new_stream(s_format_context, nullptr);
+	if (!s_audio_stream)
+		return false;
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 48, 101)
+	AVCodecParameters *audioParams = s_audio_stream->codecpar;
+	audioParams->format = AV_SAMPLE_FMT_S16;
+#else
+	AVCodecContext *audioParams = s_audio_stream->codec;
+	audioParams->sample_fmt = AV_SAMPLE_FMT_S16;
+#endif
+	audioParams->codec_type = AVMEDIA_TYPE_AUDIO;
+	audioParams->codec_id = AV_CODEC_ID_PCM_S16LE;
+	audioParams->sample_rate = AUDIO_SAMPLE_RATE;
+	audioParams->channels = 2;
+	audioParams->channel_layout = AV_CH_LAYOUT_STEREO;
+	audioParams->bits_per_coded_sample = 16;
+	audioParams->block_align = 4;
+	audioParams->bit_rate = AUDIO_SAMPLE_RATE * 32;
+	s_audio_stream->time_base.num = 1;
+	s_audio_stream->time_base.den = AUDIO_SAMPLE_RATE;
+
 	s_scaled_frame = av_frame_alloc();
 
 	s_scaled_frame->format = s_codec_context->pix_fmt;
@@ -188,53 +286,19 @@ static void PreparePacket(AVPacket* pkt) {
 	pkt->size = 0;
 }
 
-#endif
-
-void AVIDump::AddFrame() {
-	u32 w = 0;
-	u32 h = 0;
-	if (g_Config.bDumpVideoOutput) {
-		gpuDebug->GetOutputFramebuffer(buf);
-		w = buf.GetStride();
-		h = buf.GetHeight();
-	} else {
-		gpuDebug->GetCurrentFramebuffer(buf, GPU_DBG_FRAMEBUF_RENDER);
-		w = PSP_CoreParameter().renderWidth;
-		h = PSP_CoreParameter().renderHeight;
-	}
-	CheckResolution(w, h);
-	u8 *flipbuffer = nullptr;
-	const u8 *buffer = ConvertBufferToScreenshot(buf, false, flipbuffer, w, h);
-
-#ifdef USE_FFMPEG
-
-	s_src_frame->data[0] = const_cast<u8*>(buffer);
-	s_src_frame->linesize[0] = w * 3;
-	s_src_frame->format = AV_PIX_FMT_RGB24;
-	s_src_frame->width = s_width;
-	s_src_frame->height = s_height;
-
-	// Convert image from BGR24 to desired pixel format, and scale to initial width and height
-	if ((s_sws_context = sws_getCachedContext(s_sws_context, w, h, AV_PIX_FMT_RGB24, s_width, s_height, s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr))) {
-		sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, h, s_scaled_frame->data, s_scaled_frame->linesize);
-	}
-
-	s_scaled_frame->format = s_codec_context->pix_fmt;
-	s_scaled_frame->width = s_width;
-	s_scaled_frame->height = s_height;
-
-	// Encode and write the image.
+// Encodes frame (nullptr to flush out delayed frames) and writes whatever packets come out.
+static void EncodeAndWrite(AVFrame *frame) {
 	AVPacket pkt;
 	PreparePacket(&pkt);
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 48, 101)
-	int error = avcodec_send_frame(s_codec_context, s_scaled_frame);
+	int error = avcodec_send_frame(s_codec_context, frame);
 	int got_packet = 0;
 	if (avcodec_receive_packet(s_codec_context, &pkt) >= 0) {
 		got_packet = 1;
 	}
 #else
 	int got_packet;
-	int error = avcodec_encode_video2(s_codec_context, &pkt, s_scaled_frame, &got_packet);
+	int error = avcodec_encode_video2(s_codec_context, &pkt, frame, &got_packet);
 #endif
 	while (error >= 0 && got_packet) {
 		// Write the compressed frame in the media file.
@@ -269,25 +333,258 @@ void AVIDump::AddFrame() {
 	if (error < 0)
 		ERROR_LOG(Log::G3D, "Error while encoding video: %d", error);
 #endif
+}
+
+static void WriteAudioPacket(const s16 *samples, int count) {
+	AVPacket pkt;
+	PreparePacket(&pkt);
+	// Not reference counted, so the muxer makes its own copy.
+	pkt.data = (uint8_t *)samples;
+	pkt.size = count * 2 * sizeof(s16);
+	AVRational sampleTimeBase = { 1, AUDIO_SAMPLE_RATE };
+	pkt.pts = av_rescale_q(s_fileAudioSamples, sampleTimeBase, s_audio_stream->time_base);
+	pkt.dts = pkt.pts;
+	pkt.duration = (int)av_rescale_q(count, sampleTimeBase, s_audio_stream->time_base);
+	pkt.flags |= AV_PKT_FLAG_KEY;
+	pkt.stream_index = s_audio_stream->index;
+	av_interleaved_write_frame(s_format_context, &pkt);
+	s_fileAudioSamples += count;
+}
+
+static void WriteAudioSilence(int count) {
+	static const s16 silence[1024 * 2] = {};
+	while (count > 0) {
+		int chunk = std::min(count, 1024);
+		WriteAudioPacket(silence, chunk);
+		count -= chunk;
+	}
+}
+
 #endif
-	delete[] flipbuffer;
+
+// Writes out everything __AudioUpdate has queued up. Worker thread only.
+void AVIDump::DrainAudio() {
+	u32 readPos = s_audioReadPos.load(std::memory_order_relaxed);
+	u32 writePos = s_audioWritePos.load(std::memory_order_acquire);
+	while (true) {
+		u32 end = writePos;
+		if (s_audioGapSamples.load(std::memory_order_acquire) != 0) {
+			u32 gapPos = s_audioGapPos.load(std::memory_order_relaxed);
+			if ((s32)(readPos - gapPos) >= 0) {
+				int gap = s_audioGapSamples.exchange(0);
+#ifdef USE_FFMPEG
+				if (s_format_context)
+					WriteAudioSilence(gap);
+#endif
+			} else if ((s32)(writePos - gapPos) > 0) {
+				end = gapPos;
+			}
+		}
+		if (readPos == writePos)
+			break;
+		u32 offset = readPos % AUDIO_RING_SIZE;
+		u32 count = std::min(end - readPos, (u32)AUDIO_RING_SIZE - offset);
+#ifdef USE_FFMPEG
+		if (s_format_context)
+			WriteAudioPacket(&s_audioRing[offset * 2], (int)count);
+#endif
+		readPos += count;
+	}
+	s_audioReadPos.store(readPos, std::memory_order_release);
 }
 
-void AVIDump::Stop() {
+void AVIDump::AddAudio(const s16 *samples, int count) {
+	if (!s_recording)
+		return;
+	std::lock_guard<std::mutex> audioGuard(s_audioLock);
+	if (!s_recording)
+		return;
+
+	u32 writePos = s_audioWritePos.load(std::memory_order_relaxed);
+	u32 readPos = s_audioReadPos.load(std::memory_order_acquire);
+	u32 space = AUDIO_RING_SIZE - (writePos - readPos);
+	if ((u32)count > space) {
+		s_audioSamplesDropped += count - (int)space;
+		// If an earlier gap hasn't been written yet, this one joins it, a little early.
+		if (s_audioGapSamples.load(std::memory_order_relaxed) == 0)
+			s_audioGapPos.store(writePos + space, std::memory_order_relaxed);
+		s_audioGapSamples.fetch_add(count - (int)space, std::memory_order_release);
+		count = (int)space;
+	}
+	while (count > 0) {
+		u32 offset = writePos % AUDIO_RING_SIZE;
+		u32 chunk = std::min((u32)count, (u32)AUDIO_RING_SIZE - offset);
+		memcpy(&s_audioRing[offset * 2], samples, chunk * 2 * sizeof(s16));
+		samples += chunk * 2;
+		writePos += chunk;
+		count -= (int)chunk;
+	}
+	s_audioWritePos.store(writePos, std::memory_order_release);
+}
+
+void AVIDump::AddFrame() {
+	if (!s_recording)
+		return;
+
+	s64 number = s_frameNumber++;
+	s64 slot;
+	{
+		std::lock_guard<std::mutex> guard(s_queueLock);
+		if (s_queueTail - s_queueHead >= FRAME_POOL_SIZE) {
+			s_framesDropped++;
+			return;
+		}
+		slot = s_queueTail;
+	}
+
+	// Read back straight into the pool. After the first few frames, this reuses the same memory.
+	CapturedFrame &frame = s_frames[slot % FRAME_POOL_SIZE];
+	if (g_Config.bDumpVideoOutput) {
+		gpuDebug->GetOutputFramebuffer(frame.buf);
+		frame.w = frame.buf.GetStride();
+		frame.h = frame.buf.GetHeight();
+	} else {
+		gpuDebug->GetCurrentFramebuffer(frame.buf, GPU_DBG_FRAMEBUF_RENDER);
+		frame.w = PSP_CoreParameter().renderWidth;
+		frame.h = PSP_CoreParameter().renderHeight;
+	}
+	frame.number = number;
+
+	{
+		std::lock_guard<std::mutex> guard(s_queueLock);
+		s_queueTail++;
+		int depth = (int)(s_queueTail - s_queueHead);
+		if (depth > s_maxQueueDepth)
+			s_maxQueueDepth = depth;
+	}
+	s_queueCond.notify_one();
+}
+
+void AVIDump::EncodeFrame(const CapturedFrame &frame) {
+	u32 w = frame.w;
+	u32 h = frame.h;
+	CheckResolution(w, h, frame.number);
+
 #ifdef USE_FFMPEG
+	if (!s_format_context)
+		return;
+
+	// The formats readbacks usually come in can go to swscale as is, flipped using a negative stride.
+	const GPUDebugBuffer &buf = frame.buf;
+	AVPixelFormat srcFormat = AV_PIX_FMT_NONE;
+	switch (buf.GetFormat()) {
+	case GPU_DBG_FORMAT_888_RGB: srcFormat = AV_PIX_FMT_RGB24; break;
+	case GPU_DBG_FORMAT_8888: srcFormat = AV_PIX_FMT_RGBA; break;
+	case GPU_DBG_FORMAT_8888_BGRA: srcFormat = AV_PIX_FMT_BGRA; break;
+	default: break;
+	}
+
+	u8 *flipbuffer = nullptr;
+	const u8 *srcData[4]{};
+	int srcLinesize[4]{};
+	if (srcFormat != AV_PIX_FMT_NONE && buf.GetData()) {
+		w = std::min(w, buf.GetStride());
+		h = std::min(h, buf.GetHeight());
+		int pitch = (int)(buf.GetStride() * buf.PixelSize());
+		if (buf.GetFlipped()) {
+			srcData[0] = buf.GetData() + (buf.GetHeight() - 1) * pitch;
+			srcLinesize[0] = -pitch;
+		} else {
+			srcData[0] = buf.GetData();
+			srcLinesize[0] = pitch;
+		}
+	} else {
+		srcFormat = AV_PIX_FMT_RGB24;
+		srcData[0] = ConvertBufferToScreenshot(buf, false, flipbuffer, w, h);
+		srcLinesize[0] = w * 3;
+	}
+
+	// Convert image to desired pixel format, and scale to initial width and height
+	if (srcData[0] && (s_sws_context = sws_getCachedContext(s_sws_context, w, h, srcFormat, s_width, s_height, s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr))) {
+		sws_scale(s_sws_context, srcData, srcLinesize, 0, h, s_scaled_frame->data, s_scaled_frame->linesize);
+	}
+	delete[] flipbuffer;
+
+	s_scaled_frame->format = s_codec_context->pix_fmt;
+	s_scaled_frame->width = s_width;
+	s_scaled_frame->height = s_height;
+	s_scaled_frame->pts = frame.number - s_fileFirstFrame;
 
-	av_write_trailer(s_format_context);
+	EncodeAndWrite(s_scaled_frame);
+#endif
+}
+
+void AVIDump::EncoderThread() {
+	SetCurrentThreadName("AVIDump");
+
+	std::unique_lock<std::mutex> guard(s_queueLock);
+	while (true) {
+		s_queueCond.wait(guard, [] { return s_queueTail != s_queueHead || s_stopping; });
+		if (s_queueTail == s_queueHead)
+			break;
+		const CapturedFrame &frame = s_frames[s_queueHead % FRAME_POOL_SIZE];
+		guard.unlock();
+
+		DrainAudio();
+		EncodeFrame(frame);
+
+		guard.lock();
+		s_queueHead++;
+	}
+	guard.unlock();
+	DrainAudio();
+}
+
+void AVIDump::FinishFile() {
+#ifdef USE_FFMPEG
+	if (s_format_context) {
+		EncodeAndWrite(nullptr);
+		av_write_trailer(s_format_context);
+	}
 	CloseFile();
-	s_file_index = 0;
 #endif
-	NOTICE_LOG(Log::G3D, "Stopping frame dump");
+}
+
+void AVIDump::Stop() {
+	{
+		std::lock_guard<std::mutex> guard(s_audioLock);
+		s_recording = false;
+	}
+	if (s_encoderThread.joinable()) {
+		{
+			std::lock_guard<std::mutex> guard(s_queueLock);
+			s_stopping = true;
+		}
+		s_queueCond.notify_one();
+		s_encoderThread.join();
+	}
+
+	FinishFile();
+	s_file_index = 0;
+	NOTICE_LOG(Log::G3D, "Stopping frame dump (%d frames, %d dropped, max queue depth %d, %d audio samples dropped)", (int)s_frameNumber, (int)s_framesDropped, (int)s_maxQueueDepth, (int)s_audioSamplesDropped);
+}
+
+bool AVIDump::IsRecording() {
+	return s_recording;
+}
+
+AVIDumpStats AVIDump::GetStats() {
+	AVIDumpStats stats{};
+	{
+		std::lock_guard<std::mutex> guard(s_queueLock);
+		stats.queueDepth = (int)(s_queueTail - s_queueHead);
+	}
+	stats.maxQueueDepth = s_maxQueueDepth;
+	stats.framesDropped = s_framesDropped;
+	stats.audioSamplesDropped = s_audioSamplesDropped;
+	return stats;
 }
 
 void AVIDump::CloseFile() {
 #ifdef USE_FFMPEG
 	if (s_codec_context) {
 #if LIBAVCODEC_VERSION_MAJOR < 55
-		avcodec_default_release_buffer(s_codec_context, s_src_frame);
+		avcodec_default_release_buffer(s_codec_context, s_scaled_frame);
 #endif
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(57, 48, 101)
 		avcodec_free_context(&s_codec_context);
@@ -297,8 +594,8 @@ void AVIDump::CloseFile() {
 #endif
 	}
 	av_freep(&s_stream);
+	av_freep(&s_audio_stream);
 
-	av_frame_free(&s_src_frame);
 	av_frame_free(&s_scaled_frame);
 
 	if (s_format_context)
@@ -316,20 +613,24 @@ void AVIDump::CloseFile() {
 #endif
 }
 
-void AVIDump::CheckResolution(int width, int height) {
+void AVIDump::CheckResolution(int width, int height, s64 frameNumber) {
 #ifdef USE_FFMPEG
 	// We check here to see if the requested width and height have changed since the last frame which
 	// was dumped, then create a new file accordingly. However, is it possible for the width and height
 	// to have a value of zero. If this is the case, simply keep the last known resolution of the video
-	// for the added frame.
+	// for the added frame. This runs on the worker, which owns the file.
 	if ((width != s_current_width || height != s_current_height) && (width > 0 && height > 0))
 	{
-		int temp_file_index = s_file_index;
-		Stop();
-		s_file_index = temp_file_index + 1;
-		Start(width, height);
+		FinishFile();
+		s_file_index++;
+		s_width = width;
+		s_height = height;
 		s_current_width = width;
 		s_current_height = height;
+		s_fileFirstFrame = frameNumber;
+		s_fileAudioSamples = 0;
+		if (!CreateAVI())
+			CloseFile();
 	}
 #endif // USE_FFMPEG
 }
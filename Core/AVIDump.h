@@ -7,16 +7,37 @@
 
 #include "Common/CommonTypes.h"
 
+struct CapturedFrame;
+
+struct AVIDumpStats {
+	// Frames captured but not yet encoded.
+	int queueDepth;
+	int maxQueueDepth;
+	// Because the encoder fell behind.
+	int framesDropped;
+	int audioSamplesDropped;
+};
+
 class AVIDump
 {
 private:
 	static bool CreateAVI();
+	static void FinishFile();
 	static void CloseFile();
-	static void CheckResolution(int width, int height);
+	static void CheckResolution(int width, int height, s64 frameNumber);
+	static void EncoderThread();
+	static void EncodeFrame(const CapturedFrame &frame);
+	static void DrainAudio();
 
 public:
 	static bool Start(int w, int h);
+	// Emulator thread. The frame is only read back here, the encoding happens on a worker.
 	static void AddFrame();
+	// From __AudioUpdate, stereo. Ignored when not recording.
+	static void AddAudio(const s16 *samples, int count);
 	static void Stop();
+
+	static bool IsRecording();
+	static AVIDumpStats GetStats();
 };
 #endif
@@ -122,6 +122,8 @@ struct Config {
 	int iLockedCPUSpeed;
 	bool bAutoSaveSymbolMap;
 	bool bCacheFullIsoInRam;
+	// Off by default: if the file shrinks or its storage goes away while mapped, reads crash with SIGBUS.
+	bool bMemoryMapDiscImages;
 	int iRemoteISOPort;
 	std::string sLastRemoteISOServer;
 	int iLastRemoteISOPort;
@@ -133,6 +135,7 @@ struct Config {
 	bool bRemoteDebuggerOnStartup;
 	bool bRemoteTab;
 	bool bMemStickInserted;
+	bool bMemStickWriteCache;
 	int iMemStickSizeGB;
 	bool bLoadPlugins;
 
@@ -224,6 +227,7 @@ struct Config {
 	bool bReplaceTextures;
 	bool bSaveNewTextures;
 	bool bIgnoreTextureFilenames;
+	bool bTranscodeReplacementTextures;
 	int iTexScalingLevel; // 0 = auto, 1 = off, 2 = 2x, ..., 5 = 5x
 	int iTexScalingType; // 0 = xBRZ, 1 = Hybrid
 	bool bTexDeposterize;
@@ -280,6 +284,8 @@ struct Config {
 	int iAltSpeedVolume;
 	int iAchievementSoundVolume;
 	bool bExtraAudioBuffering;  // For bluetooth
+	int iAudioResampler;
+	int iDecodedAudioCacheMB;  // 0 is off.
 	std::string sAudioDevice;
 	bool bAutoAudioDevice;
 	bool bUseExperimentalAtrac;
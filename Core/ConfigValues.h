@@ -99,6 +99,13 @@ enum AudioBackendType {
 	AUDIO_BACKEND_WASAPI,
 };
 
+// For iAudioResampler.
+enum AudioResamplerQuality {
+	AUDIO_RESAMPLER_LINEAR = 0,
+	AUDIO_RESAMPLER_SINC8 = 1,
+	AUDIO_RESAMPLER_SINC16 = 2,
+};
+
 // For iIOTimingMethod.
 enum IOTimingMethods {
 	IOTIMING_FAST = 0,
@@ -26,6 +26,7 @@
 #include "Core/MIPS/MIPSAnalyst.h"
 #include "Core/MIPS/MIPSDebugInterface.h"
 #include "Core/MIPS/MIPSStackWalk.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HLE/sceKernelThread.h"
 #include "Core/Reporting.h"
 
@@ -41,6 +42,7 @@ DebuggerSubscriber *WebSocketHLEInit(DebuggerEventHandlerMap &map) {
 	map["hle.func.scan"] = &WebSocketHLEFuncScan;
 	map["hle.module.list"] = &WebSocketHLEModuleList;
 	map["hle.backtrace"] = &WebSocketHLEBacktrace;
+	map["hle.syscall.stats"] = &WebSocketHLESyscallStats;
 
 	return nullptr;
 }
@@ -601,3 +603,40 @@ void WebSocketHLEBacktrace(DebuggerRequest &req) {
 	}
 	json.pop();
 }
+
+// List call counts and time spent per syscall (hle.syscall.stats)
+//
+// Parameters:
+//  - reset: optional boolean, pass true to clear the totals after responding.
+//
+// Response (same event name):
+//  - syscalls: array of objects, each with properties:
+//     - module: name of the HLE module, e.g. 'sceCtrl'.
+//     - name: name of the function.
+//     - calls: number of times called.
+//     - seconds: total time spent in the function, in seconds.
+//
+// Note: only counted while debug stats are collected (e.g. during gpu.stats.feed or with the debug overlay.)
+void WebSocketHLESyscallStats(DebuggerRequest &req) {
+	if (!PSP_IsInited())
+		return req.Fail("CPU not started");
+	bool reset = false;
+	if (!req.ParamBool("reset", &reset, DebuggerParamType::OPTIONAL))
+		return;
+
+	std::vector<HLESyscallStat> stats = hleGetSyscallStats();
+	if (reset)
+		hleResetSyscallStats();
+
+	JsonWriter &json = req.Respond();
+	json.pushArray("syscalls");
+	for (const auto &stat : stats) {
+		json.pushDict();
+		json.writeString("module", stat.module);
+		json.writeString("name", stat.name);
+		json.writeFloat("calls", (double)stat.calls);
+		json.writeFloat("seconds", stat.seconds);
+		json.pop();
+	}
+	json.pop();
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/Swap.h"
+#include "Common/TimeUtil.h"
+#include "Core/FileLoaders/AccessProfile.h"
+#include "Core/System.h"
+
+static const char * const PROFILE_MAGIC = "ppssppAP";
+
+struct AccessProfileHeader {
+	char magic[8];
+	u32_le version;
+	u32_le count;
+	s64_le filesize;
+};
+
+struct AccessProfileEntry {
+	u32_le block;
+	u32_le count;
+	u32_le timeMs;
+};
+
+Path AccessProfile::profileDir_;
+std::map<Path, std::weak_ptr<AccessProfile>> AccessProfile::profiles_;
+std::mutex AccessProfile::profilesMutex_;
+
+std::shared_ptr<AccessProfile> AccessProfile::Get(const Path &path, s64 filesize) {
+	std::lock_guard<std::mutex> guard(profilesMutex_);
+	std::shared_ptr<AccessProfile> profile = profiles_[path].lock();
+	if (!profile || profile->filesize_ != filesize) {
+		profile.reset(new AccessProfile(path, filesize));
+		profiles_[path] = profile;
+	}
+	return profile;
+}
+
+AccessProfile::AccessProfile(const Path &path, s64 filesize)
+	: path_(path), filesize_(filesize), startTime_(time_now_d()) {
+	seen_.resize((size_t)((filesize + BLOCK_SIZE - 1) >> BLOCK_SHIFT));
+	Load();
+}
+
+AccessProfile::~AccessProfile() {
+	Save();
+}
+
+u32 AccessProfile::ElapsedMs() const {
+	return (u32)((time_now_d() - startTime_) * 1000.0);
+}
+
+void AccessProfile::RecordRead(s64 pos, size_t bytes) {
+	if (bytes == 0 || pos < 0 || seen_.empty())
+		return;
+	const u32 timeMs = ElapsedMs();
+	if (timeMs >= RECORD_MS)
+		return;
+
+	std::lock_guard<std::mutex> guard(lock_);
+	const size_t first = (size_t)(pos >> BLOCK_SHIFT);
+	const size_t last = std::min((size_t)((pos + bytes - 1) >> BLOCK_SHIFT), seen_.size() - 1);
+	for (size_t block = first; block <= last; ++block) {
+		if (seen_[block])
+			continue;
+		seen_[block] = true;
+
+		// Most reads continue where the last one ended.
+		if (!recorded_.empty()) {
+			Entry &prev = recorded_.back();
+			if (prev.block + prev.count == block) {
+				prev.count++;
+				continue;
+			}
+		}
+		if (recorded_.size() >= MAX_ENTRIES)
+			return;
+		recorded_.push_back(Entry{ (u32)block, 1, timeMs });
+	}
+}
+
+Path AccessProfile::MakeProfilePath() const {
+	Path dir = profileDir_;
+	if (dir.empty()) {
+		dir = GetSysDirectory(DIRECTORY_CACHE);
+	}
+	if (!File::Exists(dir)) {
+		File::CreateFullPath(dir);
+	}
+
+	static const char *const invalidChars = "?*:/\\^|<>\"'";
+	std::string filename = path_.ToString();
+	for (size_t i = 0; i < filename.size(); ++i) {
+		if (strchr(invalidChars, filename[i]) != nullptr) {
+			filename[i] = '_';
+		}
+	}
+	return dir / (filename + ".ppap");
+}
+
+void AccessProfile::Load() {
+	FILE *fp = File::OpenCFile(MakeProfilePath(), "rb");
+	if (!fp)
+		return;
+
+	AccessProfileHeader header;
+	bool valid = fread(&header, sizeof(header), 1, fp) == 1;
+	valid = valid && memcmp(header.magic, PROFILE_MAGIC, sizeof(header.magic)) == 0;
+	// A different size means it's a different image, or a different dump of it.
+	valid = valid && header.version == PROFILE_VERSION && header.filesize == filesize_ && header.count <= MAX_ENTRIES;
+	if (valid) {
+		std::vector<AccessProfileEntry> entries(header.count);
+		valid = header.count == 0 || fread(&entries[0], sizeof(AccessProfileEntry), header.count, fp) == header.count;
+		for (size_t i = 0; valid && i < entries.size(); ++i) {
+			const Entry entry{ entries[i].block, entries[i].count, entries[i].timeMs };
+			if ((u64)entry.block + entry.count > seen_.size()) {
+				valid = false;
+				break;
+			}
+			previous_.push_back(entry);
+		}
+	}
+	fclose(fp);
+
+	if (valid) {
+		INFO_LOG(Log::Loader, "Loaded access profile for %s: %d ranges", path_.c_str(), (int)previous_.size());
+	} else {
+		WARN_LOG(Log::Loader, "Ignoring invalid access profile for %s", path_.c_str());
+		previous_.clear();
+	}
+}
+
+void AccessProfile::Save() {
+	std::lock_guard<std::mutex> guard(lock_);
+	if (saved_ || recorded_.empty())
+		return;
+	// Closing the game early shouldn't throw away a profile of a longer session.
+	if (!previous_.empty() && ElapsedMs() < RECORD_MS && recorded_.back().timeMs < previous_.back().timeMs)
+		return;
+
+	FILE *fp = File::OpenCFile(MakeProfilePath(), "wb");
+	if (!fp) {
+		return;
+	}
+	AccessProfileHeader header{};
+	memcpy(header.magic, PROFILE_MAGIC, sizeof(header.magic));
+	header.version = PROFILE_VERSION;
+	header.count = (u32)recorded_.size();
+	header.filesize = filesize_;
+	std::vector<AccessProfileEntry> entries;
+	entries.reserve(recorded_.size());
+	for (const Entry &entry : recorded_) {
+		AccessProfileEntry out;
+		out.block = entry.block;
+		out.count = entry.count;
+		out.timeMs = entry.timeMs;
+		entries.push_back(out);
+	}
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	success = success && fwrite(&entries[0], sizeof(AccessProfileEntry), entries.size(), fp) == entries.size();
+	fclose(fp);
+	if (!success) {
+		File::Delete(MakeProfilePath());
+		return;
+	}
+	saved_ = true;
+	INFO_LOG(Log::Loader, "Saved access profile for %s: %d ranges", path_.c_str(), (int)recorded_.size());
+}
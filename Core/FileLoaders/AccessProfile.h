@@ -0,0 +1,88 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
+
+// Records which parts of a file the game reads in its first minutes, in order, so that on the next
+// boot the caching loaders can fetch them before they're asked for. All loaders of a file share one.
+class AccessProfile {
+public:
+	enum {
+		// Same as the blocks of the RAM and disk caches.
+		BLOCK_SHIFT = 16,
+		BLOCK_SIZE = 1 << BLOCK_SHIFT,
+	};
+
+	struct Entry {
+		u32 block;
+		u32 count;
+		// Since the file was opened.
+		u32 timeMs;
+	};
+
+	~AccessProfile();
+
+	static std::shared_ptr<AccessProfile> Get(const Path &path, s64 filesize);
+	static void SetProfileDir(const Path &path) {
+		profileDir_ = path;
+	}
+
+	// Only reads the game asked for, not read-ahead or prefetching.
+	void RecordRead(s64 pos, size_t bytes);
+	// What was recorded the last time, in the order it was first read.
+	const std::vector<Entry> &Previous() const {
+		return previous_;
+	}
+	u32 ElapsedMs() const;
+
+	// Writes out what was recorded, unless it's shorter than what was there. Also done on destruction.
+	void Save();
+
+private:
+	AccessProfile(const Path &path, s64 filesize);
+	Path MakeProfilePath() const;
+	void Load();
+
+	enum {
+		PROFILE_VERSION = 1,
+		// Boot and the menus are what's worth prefetching, after this it's the game's own business.
+		RECORD_MS = 120 * 1000,
+		MAX_ENTRIES = 16384,
+	};
+
+	Path path_;
+	s64 filesize_;
+	double startTime_;
+	std::vector<Entry> previous_;
+
+	std::mutex lock_;
+	std::vector<Entry> recorded_;
+	std::vector<bool> seen_;
+	bool saved_ = false;
+
+	static Path profileDir_;
+	static std::map<Path, std::weak_ptr<AccessProfile>> profiles_;
+	static std::mutex profilesMutex_;
+};
@@ -84,6 +84,11 @@ size_t CachingFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flag
 		readSize = ReadFromCache(absolutePos, bytes, data);
 		// While in case the cache size is too small for the entire read.
 		while (readSize < bytes) {
+			size_t bytesInPlace = ReadIntoPlace(absolutePos + readSize, bytes - readSize, (u8 *)data + readSize, flags);
+			if (bytesInPlace != 0) {
+				readSize += bytesInPlace;
+				continue;
+			}
 			SaveIntoCache(absolutePos + readSize, bytes - readSize, flags);
 			size_t bytesFromCache = ReadFromCache(absolutePos + readSize, bytes - readSize, (u8 *)data + readSize);
 			readSize += bytesFromCache;
@@ -149,6 +154,48 @@ size_t CachingFileLoader::ReadFromCache(s64 pos, size_t bytes, void *data) {
 	return readSize;
 }
 
+size_t CachingFileLoader::ReadIntoPlace(s64 pos, size_t bytes, void *data, Flags flags) {
+	// Only worth it for a few blocks at once, otherwise the cache is filled the usual way.
+	if ((pos & (BLOCK_SIZE - 1)) != 0 || bytes < 2 * BLOCK_SIZE) {
+		return 0;
+	}
+
+	s64 cacheStartPos = pos >> BLOCK_SHIFT;
+	size_t blocksToRead = std::min(bytes >> BLOCK_SHIFT, (size_t)MAX_BLOCKS_PER_READ);
+	{
+		std::lock_guard<std::recursive_mutex> guard(blocksMutex_);
+		for (size_t i = 0; i < blocksToRead; ++i) {
+			if (blocks_.find(cacheStartPos + i) != blocks_.end()) {
+				blocksToRead = i;
+				break;
+			}
+		}
+	}
+	if (blocksToRead < 2) {
+		return 0;
+	}
+
+	size_t readSize = backend_->ReadAt(pos, blocksToRead << BLOCK_SHIFT, data, flags);
+	size_t blocksRead = readSize >> BLOCK_SHIFT;
+	if (blocksRead == 0 || !MakeCacheSpaceFor(blocksRead, false)) {
+		return readSize;
+	}
+
+	std::lock_guard<std::recursive_mutex> guard(blocksMutex_);
+	for (size_t i = 0; i < blocksRead; ++i) {
+		if (blocks_.find(cacheStartPos + i) != blocks_.end()) {
+			// Read ahead got there first.
+			continue;
+		}
+		u8 *buf = new u8[BLOCK_SIZE];
+		memcpy(buf, (const u8 *)data + (i << BLOCK_SHIFT), BLOCK_SIZE);
+		blocks_[cacheStartPos + i] = BlockInfo(buf);
+		++cacheSize_;
+	}
+	++generation_;
+	return readSize;
+}
+
 void CachingFileLoader::SaveIntoCache(s64 pos, size_t bytes, Flags flags, bool readingAhead) {
 	s64 cacheStartPos = pos >> BLOCK_SHIFT;
 	s64 cacheEndPos = (pos + bytes - 1) >> BLOCK_SHIFT;
@@ -279,7 +326,7 @@ void CachingFileLoader::StartReadAhead(s64 pos) {
 			auto block = blocks_.find(i);
 			if (block == blocks_.end()) {
 				guard.unlock();
-				SaveIntoCache(i << BLOCK_SHIFT, BLOCK_SIZE * BLOCK_READAHEAD, Flags::NONE, true);
+				SaveIntoCache(i << BLOCK_SHIFT, BLOCK_SIZE * BLOCK_READAHEAD, Flags::HINT_PREFETCH, true);
 				break;
 			}
 		}
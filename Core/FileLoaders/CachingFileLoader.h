@@ -44,6 +44,9 @@ class CachingFileLoader : public ProxiedFileLoader {
 	void InitCache();
 	void ShutdownCache();
 	size_t ReadFromCache(s64 pos, size_t bytes, void *data);
+	// Reads whole blocks the cache doesn't have straight into data, then keeps a copy.
+	// Returns 0 if the read isn't suitable.
+	size_t ReadIntoPlace(s64 pos, size_t bytes, void *data, Flags flags);
 	// Guaranteed to read at least one block into the cache.
 	void SaveIntoCache(s64 pos, size_t bytes, Flags flags, bool readingAhead = false);
 	bool MakeCacheSpaceFor(size_t blocks, bool readingAhead);
@@ -30,6 +30,9 @@
 #include "Common/File/Path.h"
 #include "Common/Log.h"
 #include "Common/CommonWindows.h"
+#include "Common/Thread/ThreadUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/FileLoaders/AccessProfile.h"
 #include "Core/FileLoaders/DiskCachingFileLoader.h"
 #include "Core/System.h"
 
@@ -46,6 +49,9 @@ static const char * const CACHEFILE_MAGIC = "ppssppDC";
 static const s64 SAFETY_FREE_DISK_SPACE = 768 * 1024 * 1024; // 768 MB
 // Aim to allow this many files cached at once.
 static const u32 CACHE_SPACE_FLEX = 4;
+// How far ahead of the game's recorded reads prefetching may run. Further would risk pushing out
+// blocks the game still needs, on small caches.
+static const u32 PREFETCH_LOOKAHEAD_MS = 15000;
 
 Path DiskCachingFileLoaderCache::cacheDir_;
 
@@ -98,6 +104,10 @@ size_t DiskCachingFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data,
 		bytes = (size_t)(filesize_ - absolutePos);
 	}
 
+	if (profile_ && (flags & Flags::HINT_PREFETCH) == 0) {
+		profile_->RecordRead(absolutePos, bytes);
+	}
+
 	if (cache_ && cache_->IsValid() && (flags & Flags::HINT_UNCACHED) == 0) {
 		readSize = cache_->ReadFromCache(absolutePos, bytes, data);
 		// While in case the cache size is too small for the entire read.
@@ -149,7 +159,51 @@ void DiskCachingFileLoader::InitCache() {
 	cache_->AddRef();
 }
 
+void DiskCachingFileLoader::PrepareForBoot() {
+	Prepare();
+	// Only the game's own reads are worth profiling, not the game list's or anything else's.
+	if (cache_ && cache_->IsValid() && !profile_) {
+		profile_ = AccessProfile::Get(ProxiedFileLoader::GetPath(), filesize_);
+		if (!profile_->Previous().empty()) {
+			StartPrefetch();
+		}
+	}
+	ProxiedFileLoader::PrepareForBoot();
+}
+
+void DiskCachingFileLoader::StartPrefetch() {
+	prefetchThread_ = std::thread([this] {
+		SetCurrentThreadName("DiskCachePrefetch");
+
+		AndroidJNIThreadContext jniContext;
+
+		int fetched = 0;
+		for (const AccessProfile::Entry &entry : profile_->Previous()) {
+			// Keep a little ahead of where the game was at this point last time.
+			while (!prefetchCancel_ && entry.timeMs > profile_->ElapsedMs() + PREFETCH_LOOKAHEAD_MS) {
+				sleep_ms(20, "disk-cache-prefetch");
+			}
+			for (u32 i = 0; i < entry.count && !prefetchCancel_; ++i) {
+				const s64 pos = (s64)(entry.block + i) << AccessProfile::BLOCK_SHIFT;
+				const size_t size = (size_t)std::min((s64)AccessProfile::BLOCK_SIZE, filesize_ - pos);
+				if (!cache_->IsCached(pos, size)) {
+					fetched += (int)cache_->PrefetchIntoCache(backend_, pos, size);
+				}
+			}
+			if (prefetchCancel_) {
+				break;
+			}
+		}
+		INFO_LOG(Log::Loader, "Prefetched %d blocks from the access profile in %0.1f s", fetched, profile_->ElapsedMs() / 1000.0);
+	});
+}
+
 void DiskCachingFileLoader::ShutdownCache() {
+	prefetchCancel_ = true;
+	if (prefetchThread_.joinable()) {
+		prefetchThread_.join();
+	}
+
 	std::lock_guard<std::mutex> guard(cachesMutex_);
 
 	if (cache_->Release()) {
@@ -338,6 +392,63 @@ size_t DiskCachingFileLoaderCache::SaveIntoCache(FileLoader *backend, s64 pos, s
 	return readSize;
 }
 
+bool DiskCachingFileLoaderCache::IsCached(s64 pos, size_t bytes) {
+	std::lock_guard<std::mutex> guard(lock_);
+
+	if (!f_ || bytes == 0) {
+		return false;
+	}
+
+	size_t cacheStartPos = (size_t)(pos / blockSize_);
+	size_t cacheEndPos = (size_t)((pos + bytes - 1) / blockSize_);
+	for (size_t i = cacheStartPos; i <= cacheEndPos; ++i) {
+		if (index_[i].block == INVALID_BLOCK) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t DiskCachingFileLoaderCache::PrefetchIntoCache(FileLoader *backend, s64 pos, size_t bytes) {
+	if (bytes == 0) {
+		return 0;
+	}
+
+	size_t cacheStartPos = (size_t)(pos / blockSize_);
+	size_t cacheEndPos = (size_t)((pos + bytes - 1) / blockSize_);
+	std::vector<u8> buf(blockSize_);
+	size_t stored = 0;
+	for (size_t i = cacheStartPos; i <= cacheEndPos; ++i) {
+		if (IsCached(i * (u64)blockSize_, 1)) {
+			continue;
+		}
+
+		// Unlocked, so the game's reads of cached blocks don't wait on the backend.
+		size_t readBytes = backend->ReadAt(i * (u64)blockSize_, blockSize_, &buf[0], FileLoader::Flags::HINT_PREFETCH);
+		if (readBytes == 0) {
+			break;
+		}
+
+		std::lock_guard<std::mutex> guard(lock_);
+		auto &info = index_[i];
+		// The game may have read it meanwhile.
+		if (!f_ || info.block != INVALID_BLOCK) {
+			continue;
+		}
+		if (!MakeCacheSpaceFor(1)) {
+			break;
+		}
+		info.block = AllocateBlock((u32)i);
+		// It's wanted soon, so it shouldn't be the first to go.
+		info.generation = generation_;
+		WriteBlockData(info, &buf[0]);
+		WriteIndexData((u32)i, info);
+		++cacheSize_;
+		++stored;
+	}
+	return stored;
+}
+
 bool DiskCachingFileLoaderCache::MakeCacheSpaceFor(size_t blocks) {
 	size_t goal = (size_t)maxBlocks_ - blocks;
 
@@ -17,15 +17,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <map>
 #include <mutex>
+#include <thread>
 
 #include "Common/CommonTypes.h"
 #include "Common/File/Path.h"
 #include "Common/Swap.h"
 #include "Core/Loaders.h"
 
+class AccessProfile;
 class DiskCachingFileLoaderCache;
 
 class DiskCachingFileLoader : public ProxiedFileLoader {
@@ -42,17 +46,24 @@ class DiskCachingFileLoader : public ProxiedFileLoader {
 	}
 	size_t ReadAt(s64 absolutePos, size_t bytes, void *data, Flags flags = Flags::NONE) override;
 
+	void PrepareForBoot() override;
+
 	static std::vector<Path> GetCachedPathsInUse();
 
 private:
 	void Prepare();
 	void InitCache();
 	void ShutdownCache();
+	void StartPrefetch();
 
 	std::once_flag preparedFlag_;
 	s64 filesize_ = 0;
 	DiskCachingFileLoaderCache *cache_ = nullptr;
 
+	std::shared_ptr<AccessProfile> profile_;
+	std::thread prefetchThread_;
+	std::atomic<bool> prefetchCancel_{};
+
 	// We don't support concurrent disk cache access (we use memory cached indexes.)
 	// So we have to ensure there's only one of these per.
 	static std::map<Path, DiskCachingFileLoaderCache *> caches_;
@@ -83,6 +94,11 @@ class DiskCachingFileLoaderCache {
 	size_t ReadFromCache(s64 pos, size_t bytes, void *data);
 	// Guaranteed to read at least one block into the cache.
 	size_t SaveIntoCache(FileLoader *backend, s64 pos, size_t bytes, void *data, FileLoader::Flags flags);
+	// Checks that the whole range is cached, without counting it as a use.
+	bool IsCached(s64 pos, size_t bytes);
+	// Stores whichever blocks of the range aren't cached yet, without holding the lock while reading
+	// them from the backend. Returns the number of blocks stored.
+	size_t PrefetchIntoCache(FileLoader *backend, s64 pos, size_t bytes);
 
 	bool HasData() const;
 
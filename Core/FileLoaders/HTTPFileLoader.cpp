@@ -16,14 +16,32 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 #include "Common/Log.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ThreadUtil.h"
 #include "Core/Config.h"
 #include "Core/FileLoaders/HTTPFileLoader.h"
 
 HTTPFileLoader::HTTPFileLoader(const ::Path &filename)
-	: url_(filename.ToString()), progress_(&cancel_), filename_(filename) {
+	: url_(filename.ToString()), progress_(&prepareCancel_), filename_(filename) {
+}
+
+void HTTPFileLoader::SetLatestError(const char *error) {
+	std::lock_guard<std::mutex> guard(errorLock_);
+	latestError_ = error;
+}
+
+void HTTPFileLoader::Cancel() {
+	cancel_ = true;
+	prepareCancel_ = true;
+	std::lock_guard<std::mutex> guard(blocksLock_);
+	for (Connection *conn : connections_) {
+		conn->abort = true;
+	}
+	blockCond_.notify_all();
 }
 
 void HTTPFileLoader::Prepare() {
@@ -51,7 +69,7 @@ void HTTPFileLoader::Prepare() {
 
 					if (url.ToString() == url_.ToString() || url.ToString() == resourceURL.ToString()) {
 						ERROR_LOG(Log::Loader, "HTTP request failed, hit a redirect loop");
-						latestError_ = "Could not connect (redirect loop)";
+						SetLatestError("Could not connect (redirect loop)");
 						return;
 					}
 
@@ -62,14 +80,14 @@ void HTTPFileLoader::Prepare() {
 
 				// No Location header?
 				ERROR_LOG(Log::Loader, "HTTP request failed, invalid redirect");
-				latestError_ = "Could not connect (invalid response)";
+				SetLatestError("Could not connect (invalid response)");
 				return;
 			}
 
 			if (code != 200) {
 				// Leave size at 0, invalid.
 				ERROR_LOG(Log::Loader, "HTTP request failed, got %03d for %s", code, filename_.c_str());
-				latestError_ = "Could not connect (invalid response)";
+				SetLatestError("Could not connect (invalid response)");
 				Disconnect();
 				return;
 			}
@@ -118,13 +136,13 @@ void HTTPFileLoader::Prepare() {
 int HTTPFileLoader::SendHEAD(const Url &url, std::vector<std::string> &responseHeaders) {
 	if (!url.Valid()) {
 		ERROR_LOG(Log::Loader, "HTTP request failed, invalid URL: '%s'", url.ToString().c_str());
-		latestError_ = "Invalid URL";
+		SetLatestError("Invalid URL");
 		return -400;
 	}
 
 	if (!client_.Resolve(url.Host().c_str(), url.Port())) {
 		ERROR_LOG(Log::Loader, "HTTP request failed, unable to resolve: |%s| port %d", url.Host().c_str(), url.Port());
-		latestError_ = "Could not connect (name not resolved)";
+		SetLatestError("Could not connect (name not resolved)");
 		return -400;
 	}
 
@@ -134,7 +152,7 @@ int HTTPFileLoader::SendHEAD(const Url &url, std::vector<std::string> &responseH
 	Connect(10.0);
 	if (!connected_) {
 		ERROR_LOG(Log::Loader, "HTTP request failed, failed to connect: %s port %d (resource: '%s')", url.Host().c_str(), url.Port(), url.Resource().c_str());
-		latestError_ = "Could not connect (refused to connect)";
+		SetLatestError("Could not connect (refused to connect)");
 		return -400;
 	}
 
@@ -142,7 +160,7 @@ int HTTPFileLoader::SendHEAD(const Url &url, std::vector<std::string> &responseH
 	int err = client_.SendRequest("HEAD", req, nullptr, &progress_);
 	if (err < 0) {
 		ERROR_LOG(Log::Loader, "HTTP request failed, failed to send request: %s port %d", url.Host().c_str(), url.Port());
-		latestError_ = "Could not connect (could not request data)";
+		SetLatestError("Could not connect (could not request data)");
 		Disconnect();
 		return -400;
 	}
@@ -152,6 +170,7 @@ int HTTPFileLoader::SendHEAD(const Url &url, std::vector<std::string> &responseH
 }
 
 HTTPFileLoader::~HTTPFileLoader() {
+	StopWorkers();
 	Disconnect();
 }
 
@@ -179,8 +198,9 @@ Path HTTPFileLoader::GetPath() const {
 }
 
 size_t HTTPFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flags flags) {
+	// A Cancel() only applies to the reads that were going on at the time.
+	cancel_ = false;
 	Prepare();
-	std::lock_guard<std::mutex> guard(readAtMutex_);
 
 	s64 absoluteEnd = std::min(absolutePos + (s64)bytes, filesize_);
 	if (absolutePos >= filesize_ || bytes == 0) {
@@ -188,32 +208,303 @@ size_t HTTPFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flags f
 		return 0;
 	}
 
-	Connect(10.0);
-	if (!connected_) {
-		return 0;
+	StartWorkers();
+
+	// Uncached reads are one-offs, don't bother reading ahead of them.
+	bool readAhead = (flags & Flags::HINT_UNCACHED) == 0;
+	u8 *dest = (u8 *)data;
+	size_t readBytes = 0;
+	s64 pos = absolutePos;
+	while (pos < absoluteEnd) {
+		// Cut at block boundaries so no single wait covers more than MAX_READ_BLOCKS.
+		s64 pieceEnd = std::min(((pos >> BLOCK_SHIFT) + MAX_READ_BLOCKS) << BLOCK_SHIFT, absoluteEnd);
+		size_t pieceBytes = (size_t)(pieceEnd - pos);
+		size_t got = ReadBlocks(pos, pieceBytes, dest + readBytes, readAhead);
+		readBytes += got;
+		pos += got;
+		if (got != pieceBytes) {
+			break;
+		}
+	}
+
+	filepos_ = absolutePos + readBytes;
+	return readBytes;
+}
+
+size_t HTTPFileLoader::ReadBlocks(s64 absolutePos, size_t bytes, u8 *data, bool readAhead) {
+	s64 firstBlock = absolutePos >> BLOCK_SHIFT;
+	s64 endBlock = ((absolutePos + (s64)bytes - 1) >> BLOCK_SHIFT) + 1;
+
+	std::unique_lock<std::mutex> guard(blocksLock_);
+	bool sequential = absolutePos == lastReadEnd_;
+	lastReadEnd_ = absolutePos + bytes;
+
+	// Queue whatever is missing (blocks may also get evicted by another reader while we wait.)
+	bool queuedAhead = false;
+	while (true) {
+		QueueBlocks(firstBlock, endBlock, true);
+		if (sequential && readAhead && !queuedAhead) {
+			s64 aheadStart = endBlock;
+			while (aheadStart < endBlock + READ_AHEAD_BLOCKS && blocks_.find(aheadStart) != blocks_.end()) {
+				aheadStart++;
+			}
+			// Top up in batches once half the window is used, so requests stay large.
+			// Queued behind the demand fetch, so that it's not delayed by read-ahead.
+			if (aheadStart - endBlock <= READ_AHEAD_BLOCKS / 2) {
+				QueueBlocks(aheadStart, endBlock + READ_AHEAD_BLOCKS, false);
+			}
+			queuedAhead = true;
+		}
+
+		bool waiting = false;
+		for (s64 b = firstBlock; b < endBlock; ++b) {
+			auto it = blocks_.find(b);
+			if (it == blocks_.end() || it->second.state == BlockState::PENDING) {
+				waiting = true;
+			} else if (it->second.state == BlockState::FAILED) {
+				// Return what we have, the failed blocks will be retried on the next read.
+				waiting = false;
+				break;
+			}
+		}
+		if (!waiting || cancel_) {
+			break;
+		}
+		blockCond_.wait_for(guard, std::chrono::milliseconds(100));
+	}
+
+	size_t readBytes = 0;
+	s64 pos = absolutePos;
+	for (s64 b = firstBlock; b < endBlock; ++b) {
+		auto it = blocks_.find(b);
+		if (it == blocks_.end() || it->second.state != BlockState::READY) {
+			break;
+		}
+
+		Block &block = it->second;
+		block.lastUse = ++useCounter_;
+		size_t offset = (size_t)(pos - (b << BLOCK_SHIFT));
+		size_t toCopy = std::min(bytes - readBytes, block.data.size() - offset);
+		memcpy(data + readBytes, &block.data[offset], toCopy);
+		readBytes += toCopy;
+		pos += toCopy;
+	}
+
+	if (readBytes != bytes) {
+		for (s64 b = firstBlock; b < endBlock; ++b) {
+			auto it = blocks_.find(b);
+			if (it != blocks_.end() && it->second.state == BlockState::FAILED) {
+				blocks_.erase(it);
+			}
+		}
+		// Don't count a failed read as a sequential position.
+		lastReadEnd_ = -1;
+	}
+
+	EvictBlocks();
+	return readBytes;
+}
+
+void HTTPFileLoader::QueueBlocks(s64 firstBlock, s64 endBlock, bool demand) {
+	endBlock = std::min(endBlock, ((filesize_ - 1) >> BLOCK_SHIFT) + 1);
+
+	std::vector<FetchJob> jobs;
+	for (s64 b = firstBlock; b < endBlock; ++b) {
+		if (blocks_.find(b) != blocks_.end()) {
+			continue;
+		}
+
+		Block &block = blocks_[b];
+		block.lastUse = ++useCounter_;
+		if (!jobs.empty() && jobs.back().block + jobs.back().count == b && jobs.back().count < REQUEST_BLOCKS) {
+			jobs.back().count++;
+		} else {
+			jobs.push_back(FetchJob{ b, 1 });
+		}
+	}
+
+	if (jobs.empty()) {
+		return;
+	}
+
+	if (demand) {
+		// Go ahead of any queued read-ahead, but keep our own jobs in order.
+		fetchQueue_.insert(fetchQueue_.begin(), jobs.begin(), jobs.end());
+	} else {
+		fetchQueue_.insert(fetchQueue_.end(), jobs.begin(), jobs.end());
+	}
+	workCond_.notify_all();
+}
+
+void HTTPFileLoader::EvictBlocks() {
+	if (blocks_.size() <= MAX_CACHED_BLOCKS) {
+		return;
+	}
+
+	// Pending blocks can't go, a worker will still fill them in.
+	std::vector<std::pair<u64, s64>> candidates;
+	for (const auto &it : blocks_) {
+		if (it.second.state != BlockState::PENDING) {
+			candidates.emplace_back(it.second.lastUse, it.first);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	for (const auto &candidate : candidates) {
+		if (blocks_.size() <= MAX_CACHED_BLOCKS) {
+			break;
+		}
+		blocks_.erase(candidate.second);
+	}
+}
+
+void HTTPFileLoader::StartWorkers() {
+	std::lock_guard<std::mutex> guard(blocksLock_);
+	if (workersStarted_) {
+		return;
+	}
+	workersStarted_ = true;
+
+	for (int i = 0; i < MAX_CONNECTIONS; ++i) {
+		Connection *conn = new Connection();
+		conn->client.SetUserAgent(StringFromFormat("PPSSPP/%s", PPSSPP_GIT_VERSION));
+		conn->client.SetDataTimeout(20.0);
+		conn->client.SetKeepAlive(true);
+		connections_.push_back(conn);
+		workers_.push_back(std::thread([this, conn] {
+			WorkerThread(conn);
+		}));
+	}
+}
+
+void HTTPFileLoader::StopWorkers() {
+	{
+		std::lock_guard<std::mutex> guard(blocksLock_);
+		stopWorkers_ = true;
+		// Abort any requests in flight.
+		for (Connection *conn : connections_) {
+			conn->abort = true;
+		}
+		workCond_.notify_all();
+	}
+
+	for (auto &worker : workers_) {
+		worker.join();
+	}
+	workers_.clear();
+
+	for (Connection *conn : connections_) {
+		if (conn->connected) {
+			conn->client.Disconnect();
+		}
+		delete conn;
 	}
+	connections_.clear();
+}
+
+void HTTPFileLoader::WorkerThread(Connection *conn) {
+	SetCurrentThreadName("HTTPFileLoader");
+
+	std::unique_lock<std::mutex> guard(blocksLock_);
+	while (true) {
+		workCond_.wait(guard, [this] {
+			return stopWorkers_ || !fetchQueue_.empty();
+		});
+		if (stopWorkers_) {
+			break;
+		}
+
+		FetchJob job = fetchQueue_.front();
+		fetchQueue_.pop_front();
+		// An earlier Cancel() was for the reads back then.
+		conn->abort = false;
+		guard.unlock();
+
+		s64 pos = job.block << BLOCK_SHIFT;
+		size_t bytes = (size_t)std::min((s64)job.count << BLOCK_SHIFT, filesize_ - pos);
+		std::vector<u8> output;
+		bool success = FetchRange(conn, pos, bytes, output);
+
+		guard.lock();
+		for (int i = 0; i < job.count; ++i) {
+			auto it = blocks_.find(job.block + i);
+			if (it == blocks_.end() || it->second.state != BlockState::PENDING) {
+				continue;
+			}
+
+			Block &block = it->second;
+			if (success) {
+				size_t offset = (size_t)i << BLOCK_SHIFT;
+				size_t blockBytes = std::min((size_t)BLOCK_SIZE, bytes - offset);
+				block.data.assign(output.begin() + offset, output.begin() + offset + blockBytes);
+				block.state = BlockState::READY;
+			} else {
+				block.state = BlockState::FAILED;
+			}
+		}
+		blockCond_.notify_all();
+	}
+}
+
+bool HTTPFileLoader::FetchRange(Connection *conn, s64 pos, size_t bytes, std::vector<u8> &output) {
+	// If the server dropped an idle keep-alive connection, reconnect once and retry.
+	for (int tries = 0; tries < 2 && !conn->abort; ++tries) {
+		bool reused = conn->connected;
+		if (!conn->connected) {
+			if (!conn->client.Resolve(url_.Host().c_str(), url_.Port())) {
+				SetLatestError("Could not connect (name not resolved)");
+				return false;
+			}
+			conn->connected = conn->client.Connect(3, 10.0, &conn->abort);
+			if (!conn->connected) {
+				SetLatestError("Could not connect (refused to connect)");
+				return false;
+			}
+		}
+
+		bool retry = false;
+		if (SendRangeRequest(conn, pos, bytes, output, &retry)) {
+			return true;
+		}
+
+		conn->client.Disconnect();
+		conn->connected = false;
+		if (!retry || !reused) {
+			break;
+		}
+	}
+	return false;
+}
+
+bool HTTPFileLoader::SendRangeRequest(Connection *conn, s64 pos, size_t bytes, std::vector<u8> &output, bool *retry) {
+	s64 end = pos + (s64)bytes;
 
 	char requestHeaders[4096];
 	// Note that the Range header is *inclusive*.
 	snprintf(requestHeaders, sizeof(requestHeaders),
-		"Range: bytes=%lld-%lld\r\n", absolutePos, absoluteEnd - 1);
+		"Range: bytes=%lld-%lld\r\n", pos, end - 1);
 
 	http::RequestParams req(url_.Resource(), "*/*");
-	int err = client_.SendRequest("GET", req, requestHeaders, &progress_);
+	int err = conn->client.SendRequest("GET", req, requestHeaders, &conn->progress);
 	if (err < 0) {
-		latestError_ = "Invalid response reading data";
-		Disconnect();
-		return 0;
+		SetLatestError("Invalid response reading data");
+		*retry = true;
+		return false;
 	}
 
 	net::Buffer readbuf;
 	std::vector<std::string> responseHeaders;
-	int code = client_.ReadResponseHeaders(&readbuf, responseHeaders, &progress_);
+	int code = conn->client.ReadResponseHeaders(&readbuf, responseHeaders, &conn->progress);
+	if (code < 0) {
+		// Most likely a connection the server already closed.
+		SetLatestError("Invalid response reading data");
+		*retry = true;
+		return false;
+	}
 	if (code != 206) {
 		ERROR_LOG(Log::Loader, "HTTP server did not respond with range, received code=%03d", code);
-		latestError_ = "Invalid response reading data";
-		Disconnect();
-		return 0;
+		SetLatestError("Invalid response reading data");
+		return false;
 	}
 
 	// TODO: Expire cache via ETag, etc.
@@ -226,10 +517,10 @@ size_t HTTPFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flags f
 			std::string lowerHeader = header;
 			std::transform(lowerHeader.begin(), lowerHeader.end(), lowerHeader.begin(), tolower);
 			if (sscanf(lowerHeader.c_str(), "content-range: bytes %lld-%lld/%lld", &first, &last, &total) >= 2) {
-				if (first == absolutePos && last == absoluteEnd - 1) {
+				if (first == pos && last == end - 1) {
 					supportedResponse = true;
 				} else {
-					ERROR_LOG(Log::Loader, "Unexpected HTTP range: got %lld-%lld, wanted %lld-%lld.", first, last, absolutePos, absoluteEnd - 1);
+					ERROR_LOG(Log::Loader, "Unexpected HTTP range: got %lld-%lld, wanted %lld-%lld.", first, last, pos, end - 1);
 				}
 			} else {
 				ERROR_LOG(Log::Loader, "Unexpected HTTP range response: %s", header.c_str());
@@ -238,31 +529,38 @@ size_t HTTPFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flags f
 	}
 
 	// TODO: Would be nice to read directly.
-	net::Buffer output;
-	int res = client_.ReadResponseEntity(&readbuf, responseHeaders, &output, &progress_);
+	net::Buffer entity;
+	int res = conn->client.ReadResponseEntity(&readbuf, responseHeaders, &entity, &conn->progress);
 	if (res != 0) {
 		ERROR_LOG(Log::Loader, "Unable to read HTTP response entity: %d", res);
-		// Let's take anything we got anyway.  Not worse than returning nothing?
+		SetLatestError("Invalid response reading data");
+		return false;
 	}
 
-	// TODO: Keepalive instead.
-	Disconnect();
-
 	if (!supportedResponse) {
 		ERROR_LOG(Log::Loader, "HTTP server did not respond with the range we wanted.");
-		latestError_ = "Invalid response reading data";
-		return 0;
+		SetLatestError("Invalid response reading data");
+		return false;
+	}
+	if (entity.size() != bytes) {
+		ERROR_LOG(Log::Loader, "HTTP response was short: got %d bytes, wanted %d", (int)entity.size(), (int)bytes);
+		SetLatestError("Invalid response reading data");
+		return false;
 	}
 
-	size_t readBytes = output.size();
-	output.Take(readBytes, (char *)data);
-	filepos_ = absolutePos + readBytes;
-	return readBytes;
+	if (!http::Client::ServerKeptAlive(responseHeaders)) {
+		conn->client.Disconnect();
+		conn->connected = false;
+	}
+
+	output.resize(bytes);
+	entity.Take(bytes, (char *)&output[0]);
+	return true;
 }
 
 void HTTPFileLoader::Connect(double timeout) {
 	if (!connected_) {
-		cancel_ = false;
-		connected_ = client_.Connect(3, timeout, &cancel_);
+		prepareCancel_ = false;
+		connected_ = client_.Connect(3, timeout, &prepareCancel_);
 	}
 }
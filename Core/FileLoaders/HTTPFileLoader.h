@@ -17,7 +17,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include "Common/File/Path.h"
@@ -27,6 +32,9 @@
 #include "Common/CommonTypes.h"
 #include "Core/Loaders.h"
 
+// Reads a file over HTTP using range requests.
+// Data is fetched in blocks by a few worker threads, each with its own keep-alive connection,
+// so several ranges can be in flight at once. Sequential reads also queue up read-ahead.
 class HTTPFileLoader : public FileLoader {
 public:
 	HTTPFileLoader(const ::Path &filename);
@@ -46,16 +54,60 @@ class HTTPFileLoader : public FileLoader {
 	}
 	size_t ReadAt(s64 absolutePos, size_t bytes, void *data, Flags flags = Flags::NONE) override;
 
-	void Cancel() override {
-		cancel_ = true;
-	}
+	// Cancels the reads in progress. Later reads work as usual.
+	void Cancel() override;
 
 	std::string LatestError() const override {
+		std::lock_guard<std::mutex> guard(errorLock_);
 		return latestError_;
 	}
 
 private:
+	enum {
+		BLOCK_SHIFT = 16,
+		BLOCK_SIZE = 1 << BLOCK_SHIFT,
+		// Blocks per range request. Larger reads are split so they spread over connections.
+		REQUEST_BLOCKS = 4,
+		// Blocks queued ahead of a sequential reader.
+		READ_AHEAD_BLOCKS = 32,
+		// Upper bound on blocks handled by one wait in ReadAt, so a read can't evict itself.
+		MAX_READ_BLOCKS = 32,
+		// 8 MB of cached data.
+		MAX_CACHED_BLOCKS = 128,
+		MAX_CONNECTIONS = 4,
+	};
+
+	enum class BlockState {
+		PENDING,
+		READY,
+		FAILED,
+	};
+
+	struct Block {
+		BlockState state = BlockState::PENDING;
+		u64 lastUse = 0;
+		std::vector<u8> data;
+	};
+
+	struct FetchJob {
+		s64 block;
+		int count;
+	};
+
+	// Each worker thread owns one of these, and reuses it between requests.
+	struct Connection {
+		Connection() : progress(&abort) {}
+
+		http::Client client;
+		net::RequestProgress progress;
+		bool connected = false;
+		// Aborts the request in flight. The HTTP client wants a plain bool, so it's only set
+		// under blocksLock_, and cleared when the worker takes its next job.
+		bool abort = false;
+	};
+
 	void Prepare();
+	void SetLatestError(const char *error);
 	int SendHEAD(const Url &url, std::vector<std::string> &responseHeaders);
 
 	void Connect(double timeout);
@@ -67,16 +119,43 @@ class HTTPFileLoader : public FileLoader {
 		connected_ = false;
 	}
 
+	void StartWorkers();
+	void StopWorkers();
+	void WorkerThread(Connection *conn);
+	bool FetchRange(Connection *conn, s64 pos, size_t bytes, std::vector<u8> &output);
+	bool SendRangeRequest(Connection *conn, s64 pos, size_t bytes, std::vector<u8> &output, bool *retry);
+
+	size_t ReadBlocks(s64 absolutePos, size_t bytes, u8 *data, bool readAhead);
+	// These require blocksLock_ to be held.
+	void QueueBlocks(s64 firstBlock, s64 endBlock, bool demand);
+	void EvictBlocks();
+
 	s64 filesize_ = 0;
-	s64 filepos_ = 0;
+	std::atomic<s64> filepos_{};
 	Url url_;
 	http::Client client_;
 	net::RequestProgress progress_;
 	::Path filename_;
 	bool connected_ = false;
-	bool cancel_ = false;
+	// For the HEAD request in Prepare, which uses client_.
+	bool prepareCancel_ = false;
+	// Makes the current ReadAt give up. Cleared at the start of each ReadAt.
+	std::atomic<bool> cancel_{};
+
+	mutable std::mutex errorLock_;
 	const char *latestError_ = "";
 
 	std::once_flag preparedFlag_;
-	std::mutex readAtMutex_;
+
+	std::mutex blocksLock_;
+	std::condition_variable blockCond_;
+	std::condition_variable workCond_;
+	std::map<s64, Block> blocks_;
+	std::deque<FetchJob> fetchQueue_;
+	u64 useCounter_ = 0;
+	s64 lastReadEnd_ = -1;
+	bool workersStarted_ = false;
+	bool stopWorkers_ = false;
+	std::vector<Connection *> connections_;
+	std::vector<std::thread> workers_;
 };
@@ -15,7 +15,9 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #include "ppsspp_config.h"
 
@@ -23,6 +25,7 @@
 #include "Common/Log.h"
 #include "Common/File/FileUtil.h"
 #include "Common/File/DirListing.h"
+#include "Core/Config.h"
 #include "Core/FileLoaders/LocalFileLoader.h"
 
 #if PPSSPP_PLATFORM(ANDROID)
@@ -42,6 +45,11 @@
 #include <streams/file_stream.h>
 #endif
 
+#ifdef LOCAL_FILE_LOADER_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if !defined(_WIN32) && !defined(HAVE_LIBRETRO_VFS)
 
 void LocalFileLoader::DetectSizeFd() {
@@ -57,6 +65,56 @@ void LocalFileLoader::DetectSizeFd() {
 }
 #endif
 
+#ifdef LOCAL_FILE_LOADER_MMAP
+
+void LocalFileLoader::MapFile() {
+	if (!g_Config.bMemoryMapDiscImages || filesize_ == 0)
+		return;
+	void *map = mmap(nullptr, (size_t)filesize_, PROT_READ, MAP_SHARED, fd_, 0);
+	if (map == MAP_FAILED) {
+		// Some content URIs and special files can't be mapped. pread works on those.
+		DEBUG_LOG(Log::FileSystem, "Couldn't map %s, reading it instead", filename_.c_str());
+		return;
+	}
+	map_ = (const u8 *)map;
+}
+
+void LocalFileLoader::AdviseReadAhead(s64 absolutePos, size_t size) {
+	// The kernel reads ahead for read(), but for faults in a mapping it only reads around the page.
+	// So when reads keep following each other (videos, streamed audio), ask for the next part early.
+	// MADV_SEQUENTIAL isn't used, it would also drop pages behind the reads from the cache.
+	static const s64 READ_AHEAD_SIZE = 4 * 1024 * 1024;
+	static const s64 pageMask = ~(s64)(sysconf(_SC_PAGESIZE) - 1);
+
+	std::lock_guard<std::mutex> guard(readLock_);
+	const bool sequential = absolutePos == nextPos_;
+	nextPos_ = absolutePos + (s64)size;
+	if (!sequential) {
+		sequentialReads_ = 0;
+		advisedEnd_ = 0;
+		return;
+	}
+	if (++sequentialReads_ < 3 || advisedEnd_ > nextPos_ + READ_AHEAD_SIZE / 2)
+		return;
+
+	const s64 from = std::max(nextPos_, advisedEnd_) & pageMask;
+	const s64 to = std::min(nextPos_ + READ_AHEAD_SIZE, (s64)filesize_);
+	if (to > from)
+		madvise((void *)(map_ + from), (size_t)(to - from), MADV_WILLNEED);
+	advisedEnd_ = to;
+}
+
+size_t LocalFileLoader::ReadMapped(s64 absolutePos, size_t bytes, size_t count, void *data) {
+	if (absolutePos < 0 || (u64)absolutePos >= filesize_)
+		return 0;
+	const size_t size = (size_t)std::min((u64)(bytes * count), filesize_ - (u64)absolutePos);
+	AdviseReadAhead(absolutePos, size);
+	memcpy(data, map_ + absolutePos, size);
+	return size / bytes;
+}
+
+#endif
+
 LocalFileLoader::LocalFileLoader(const Path &filename)
 	: filesize_(0), filename_(filename) {
 	if (filename.empty()) {
@@ -84,6 +142,9 @@ LocalFileLoader::LocalFileLoader(const Path &filename)
 		fd_ = fd;
 		isOpenedByFd_ = true;
 		DetectSizeFd();
+#ifdef LOCAL_FILE_LOADER_MMAP
+		MapFile();
+#endif
 		return;
 	}
 #endif
@@ -98,6 +159,9 @@ LocalFileLoader::LocalFileLoader(const Path &filename)
 	}
 
 	DetectSizeFd();
+#ifdef LOCAL_FILE_LOADER_MMAP
+	MapFile();
+#endif
 
 #else // _WIN32
 
@@ -127,6 +191,11 @@ LocalFileLoader::~LocalFileLoader() {
 #if defined(HAVE_LIBRETRO_VFS)
     filestream_close(handle_);
 #elif !defined(_WIN32)
+#ifdef LOCAL_FILE_LOADER_MMAP
+	if (map_) {
+		munmap((void *)map_, (size_t)filesize_);
+	}
+#endif
 	if (fd_ != -1) {
 		close(fd_);
 	}
@@ -179,6 +248,12 @@ size_t LocalFileLoader::ReadAt(s64 absolutePos, size_t bytes, size_t count, void
 		return 0;
 	}
 
+#ifdef LOCAL_FILE_LOADER_MMAP
+	if (map_) {
+		return ReadMapped(absolutePos, bytes, count, data);
+	}
+#endif
+
 #if defined(HAVE_LIBRETRO_VFS)
     std::lock_guard<std::mutex> guard(readLock_);
 	filestream_seek(handle_, absolutePos, RETRO_VFS_SEEK_POSITION_START);
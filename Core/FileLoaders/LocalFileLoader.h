@@ -32,6 +32,11 @@ typedef void *HANDLE;
 typedef RFILE* HANDLE;
 #endif
 
+// With a 64-bit address space, whole disc images can be mapped and read with a memcpy.
+#if PPSSPP_PLATFORM(LINUX) && PPSSPP_ARCH(64BIT) && !defined(HAVE_LIBRETRO_VFS)
+#define LOCAL_FILE_LOADER_MMAP 1
+#endif
+
 class LocalFileLoader : public FileLoader {
 public:
 	LocalFileLoader(const Path &filename);
@@ -51,6 +56,17 @@ class LocalFileLoader : public FileLoader {
 	int fd_ = -1;
 #else
 	HANDLE handle_ = 0;
+#endif
+#ifdef LOCAL_FILE_LOADER_MMAP
+	void MapFile();
+	size_t ReadMapped(s64 absolutePos, size_t bytes, size_t count, void *data);
+	void AdviseReadAhead(s64 absolutePos, size_t size);
+
+	const u8 *map_ = nullptr;
+	// Where the last read ended, how many reads in a row started there, and how far read-ahead was asked for.
+	s64 nextPos_ = -1;
+	int sequentialReads_ = 0;
+	s64 advisedEnd_ = 0;
 #endif
 	u64 filesize_ = 0;
 	Path filename_;
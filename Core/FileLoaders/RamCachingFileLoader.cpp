@@ -22,6 +22,7 @@
 
 #include "Common/Thread/ThreadUtil.h"
 #include "Common/TimeUtil.h"
+#include "Core/FileLoaders/AccessProfile.h"
 #include "Core/FileLoaders/RamCachingFileLoader.h"
 
 #include "Common/Log.h"
@@ -32,6 +33,7 @@ RamCachingFileLoader::RamCachingFileLoader(FileLoader *backend)
 	filesize_ = backend->FileSize();
 	if (filesize_ > 0) {
 		InitCache();
+		profile_ = AccessProfile::Get(backend->GetPath(), filesize_);
 	}
 }
 
@@ -68,6 +70,9 @@ s64 RamCachingFileLoader::FileSize() {
 
 size_t RamCachingFileLoader::ReadAt(s64 absolutePos, size_t bytes, void *data, Flags flags) {
 	size_t readSize = 0;
+	if (profile_ && (flags & Flags::HINT_PREFETCH) == 0) {
+		profile_->RecordRead(absolutePos, bytes);
+	}
 	if (cache_ == nullptr || (flags & Flags::HINT_UNCACHED) != 0) {
 		readSize = backend_->ReadAt(absolutePos, bytes, data, flags);
 	} else {
@@ -243,7 +248,7 @@ void RamCachingFileLoader::StartReadAhead(s64 pos) {
 
 			for (u32 i = cacheStartPos; i <= cacheEndPos; ++i) {
 				if (blocks_[i] == 0) {
-					SaveIntoCache((u64)i << BLOCK_SHIFT, BLOCK_SIZE * BLOCK_READAHEAD, Flags::NONE);
+					SaveIntoCache((u64)i << BLOCK_SHIFT, BLOCK_SIZE * BLOCK_READAHEAD, Flags::HINT_PREFETCH);
 					break;
 				}
 			}
@@ -254,8 +259,22 @@ void RamCachingFileLoader::StartReadAhead(s64 pos) {
 }
 
 u32 RamCachingFileLoader::NextAheadBlock() {
+	static_assert((int)AccessProfile::BLOCK_SIZE == (int)BLOCK_SIZE, "Profile blocks should match cache blocks");
 	std::lock_guard<std::mutex> guard(blocksMutex_);
 
+	// What the game read early on last time comes first, in the same order.
+	if (profile_) {
+		const std::vector<AccessProfile::Entry> &entries = profile_->Previous();
+		for (; profilePos_ < entries.size(); ++profilePos_) {
+			const AccessProfile::Entry &entry = entries[profilePos_];
+			for (u32 i = entry.block; i < entry.block + entry.count && i < blocks_.size(); ++i) {
+				if (blocks_[i] == 0) {
+					return i;
+				}
+			}
+		}
+	}
+
 	// If we had an aheadPos_ set, start reading from there and go forward.
 	u32 startFrom = (u32)(aheadPos_ >> BLOCK_SHIFT);
 	// But next time, start from the beginning again.
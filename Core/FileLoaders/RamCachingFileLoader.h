@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <thread>
@@ -24,6 +25,8 @@
 #include "Common/CommonTypes.h"
 #include "Core/Loaders.h"
 
+class AccessProfile;
+
 class RamCachingFileLoader : public ProxiedFileLoader {
 public:
 	RamCachingFileLoader(FileLoader *backend);
@@ -69,4 +72,8 @@ class RamCachingFileLoader : public ProxiedFileLoader {
 	std::thread aheadThread_;
 	bool aheadThreadRunning_ = false;
 	bool aheadCancel_ = false;
+
+	std::shared_ptr<AccessProfile> profile_;
+	// How far read-ahead has got in the profile's list.
+	size_t profilePos_ = 0;
 };
@@ -134,6 +134,9 @@ typedef struct ciso_header
 // TODO: Need much better error handling.
 
 static const u32 CSO_READ_BUFFER_SIZE = 256 * 1024;
+// Runs of uncompressed frames at least this big are read straight into place, rather than
+// through readBuffer.
+static const u32 CSO_DIRECT_READ_SIZE = 64 * 1024;
 
 CISOFileBlockDevice::CISOFileBlockDevice(FileLoader *fileLoader)
 	: BlockDevice(fileLoader)
@@ -249,6 +252,7 @@ bool CISOFileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached)
 	} else if (zlibBufferFrame == frameNumber) {
 		// We already have it.  Just apply the offset and copy.
 		memcpy(outPtr, zlibBuffer + compressedOffset, GetBlockSize());
+		bytesCopied_ += GetBlockSize();
 	} else {
 		const u32 readSize = (u32)fileLoader_->ReadAt(compressedReadPos, 1, compressedReadSize, readBuffer, flags);
 
@@ -285,6 +289,7 @@ bool CISOFileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached)
 		if (frameSize != (u32)GetBlockSize()) {
 			zlibBufferFrame = frameNumber;
 			memcpy(outPtr, zlibBuffer + compressedOffset, GetBlockSize());
+			bytesCopied_ += GetBlockSize();
 		}
 	}
 	return true;
@@ -331,6 +336,32 @@ bool CISOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 		const u32 frameBlockOffset = block & ((1 << blockShift) - 1);
 		const u32 frameBlocks = std::min(lastBlock - block + 1, blocksPerFrame - frameBlockOffset);
 
+		if ((idx & 0x80000000) != 0 && frameReadEnd > readBufferEnd) {
+			// Uncompressed frames that follow each other in the file can be read right into place.
+			u32 runFrames = 1;
+			u32 runBlocks = frameBlocks;
+			while (frame + runFrames <= lastFrameNumber) {
+				const u32 nextIdx = index[frame + runFrames];
+				const u64 nextReadPos = (u64)(nextIdx & 0x7FFFFFFF) << indexShift;
+				if ((nextIdx & 0x80000000) == 0 || nextReadPos != frameReadPos + (u64)runFrames * frameSize)
+					break;
+				runBlocks += std::min(lastBlock - (block + runBlocks) + 1, blocksPerFrame);
+				runFrames++;
+			}
+
+			const size_t runSize = (size_t)runBlocks * GetBlockSize();
+			if (runSize >= CSO_DIRECT_READ_SIZE) {
+				const size_t readSize = fileLoader_->ReadAt(frameReadPos + frameBlockOffset * GetBlockSize(), 1, runSize, outPtr);
+				if (readSize < runSize) {
+					memset(outPtr + readSize, 0, runSize - readSize);
+				}
+				frame += runFrames - 1;
+				block += runBlocks;
+				outPtr += runSize;
+				continue;
+			}
+		}
+
 		if (frameReadEnd > readBufferEnd) {
 			const s64 maxNeeded = totalReadEnd - frameReadPos;
 			const size_t chunkSize = (size_t)std::min(maxNeeded, (s64)std::max(frameReadSize, CSO_READ_BUFFER_SIZE));
@@ -348,6 +379,7 @@ bool CISOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 		const int plain = idx & 0x80000000;
 		if (plain) {
 			memcpy(outPtr, rawBuffer + frameBlockOffset * GetBlockSize(), frameBlocks * GetBlockSize());
+			bytesCopied_ += frameBlocks * GetBlockSize();
 		} else {
 			z.avail_in = frameReadSize;
 			z.next_out = frameBlocks == blocksPerFrame ? outPtr : zlibBuffer;
@@ -365,6 +397,7 @@ bool CISOFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 				memset(outPtr, 0, frameBlocks * GetBlockSize());
 			} else if (frameBlocks != blocksPerFrame) {
 				memcpy(outPtr, zlibBuffer + frameBlockOffset * GetBlockSize(), frameBlocks * GetBlockSize());
+				bytesCopied_ += frameBlocks * GetBlockSize();
 				// In case we end up reusing it in a single read later.
 				zlibBufferFrame = frame;
 			}
@@ -491,6 +524,7 @@ bool NPDRMDemoBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached)
 	int lba = blockNumber - currentBlock_;
 	if (lba >= 0 && lba < blockLBAs_){
 		memcpy(outPtr, blockBuf_ + lba*2048, 2048);
+		bytesCopied_ += 2048;
 		return true;
 	}
 
@@ -540,6 +574,7 @@ bool NPDRMDemoBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached)
 	}
 
 	memcpy(outPtr, blockBuf_+lba*2048, 2048);
+	bytesCopied_ += 2048;
 	return true;
 }
 
@@ -696,6 +731,7 @@ bool CHDFileBlockDevice::ReadBlock(int blockNumber, u8 *outPtr, bool uncached) {
 		currentHunk = hunk;
 	}
 	memcpy(outPtr, readBuffer + blockInHunk * impl_->header->unitbytes, GetBlockSize());
+	bytesCopied_ += GetBlockSize();
 	return true;
 }
 
@@ -705,10 +741,23 @@ bool CHDFileBlockDevice::ReadBlocks(u32 minBlock, int count, u8 *outPtr) {
 		return false;
 	}
 
-	for (int i = 0; i < count; i++) {
-		if (!ReadBlock(minBlock + i, outPtr + i * GetBlockSize())) {
+	// Hunks of plain 2048 byte sectors can be decompressed right into place.
+	const bool direct = impl_->chd && impl_->header->unitbytes == (u32)GetBlockSize() && impl_->header->hunkbytes == blocksPerHunk * GetBlockSize();
+	for (int i = 0; i < count; ) {
+		const u32 block = minBlock + i;
+		if (direct && (block % blocksPerHunk) == 0 && (u32)(count - i) >= blocksPerHunk && block + blocksPerHunk <= numBlocks) {
+			chd_error err = chd_read(impl_->chd, block / blocksPerHunk, outPtr + i * GetBlockSize());
+			if (err != CHDERR_NONE) {
+				ERROR_LOG(Log::Loader, "CHD read failed: %d %d %s", block, block / blocksPerHunk, chd_error_string(err));
+				NotifyReadError();
+			}
+			i += blocksPerHunk;
+			continue;
+		}
+		if (!ReadBlock(block, outPtr + i * GetBlockSize())) {
 			return false;
 		}
+		i++;
 	}
 	return true;
 }
@@ -53,9 +53,13 @@ class BlockDevice {
 
 	void NotifyReadError();
 
+	// Bytes that went through a buffer of the device's own on the way to outPtr.
+	u64 BytesCopied() const { return bytesCopied_; }
+
 protected:
 	FileLoader *fileLoader_;
 	bool reportedError_ = false;
+	u64 bytesCopied_ = 0;
 };
 
 class CISOFileBlockDevice : public BlockDevice {
@@ -38,6 +38,7 @@
 #include "Common/File/DiskFree.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/SysError.h"
+#include "Core/Config.h"
 #include "Core/FileSystems/DirectoryFileSystem.h"
 #include "Core/FileSystems/ISOFileSystem.h"
 #include "Core/HLE/sceKernel.h"
@@ -77,6 +78,9 @@ DirectoryFileSystem::DirectoryFileSystem(IHandleAllocator *_hAlloc, const Path &
 
 DirectoryFileSystem::~DirectoryFileSystem() {
 	CloseAll();
+	if (writeBackStats_.writes != 0) {
+		INFO_LOG(Log::FileSystem, "Write cache for %s: %llu writes (%llu bytes) took %llu host writes", basePath.c_str(), (unsigned long long)writeBackStats_.writes, (unsigned long long)writeBackStats_.bytes, (unsigned long long)writeBackStats_.flushes);
+	}
 }
 
 // TODO(scoped): Merge the two below functions somehow.
@@ -113,7 +117,15 @@ Path DirectoryFileSystem::GetLocalPath(std::string internalPath) const {
 	return basePath / internalPath;
 }
 
-bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, FileAccess access, u32 &error) {
+#if HOST_IS_CASE_SENSITIVE
+static bool FixFileNameCase(PathCaseCache *caseCache, const Path &basePath, std::string &fileName) {
+	if (caseCache)
+		return caseCache->FixPathCase(basePath, fileName, FPC_PATH_MUST_EXIST);
+	return FixPathCase(basePath, fileName, FPC_PATH_MUST_EXIST);
+}
+#endif
+
+bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, FileAccess access, u32 &error, PathCaseCache *caseCache) {
 	error = 0;
 
 	if (access == FILEACCESS_NONE) {
@@ -124,7 +136,7 @@ bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, File
 #if HOST_IS_CASE_SENSITIVE
 	if (access & (FILEACCESS_APPEND | FILEACCESS_CREATE | FILEACCESS_WRITE)) {
 		DEBUG_LOG(Log::FileSystem, "Checking case for path %s", fileName.c_str());
-		if (!FixPathCase(basePath, fileName, FPC_PATH_MUST_EXIST)) {
+		if (!FixFileNameCase(caseCache, basePath, fileName)) {
 			error = SCE_KERNEL_ERROR_ERRNO_FILE_NOT_FOUND;
 			return false;  // or go on and attempt (for a better error code than just 0?)
 		}
@@ -257,7 +269,7 @@ bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, File
 
 #if HOST_IS_CASE_SENSITIVE
 	if (!success && !(access & FILEACCESS_CREATE)) {
-		if (!FixPathCase(basePath, fileName, FPC_PATH_MUST_EXIST)) {
+		if (!FixFileNameCase(caseCache, basePath, fileName)) {
 			error = SCE_KERNEL_ERROR_ERRNO_FILE_NOT_FOUND;
 			return false;
 		}
@@ -308,6 +320,7 @@ bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, File
 
 size_t DirectoryFileHandle::Read(u8* pointer, s64 size)
 {
+	Flush();
 	size_t bytesRead = 0;
 	if (needsTrunc_ != -1) {
 		// If the file was marked to be truncated, pretend there's nothing.
@@ -330,23 +343,50 @@ size_t DirectoryFileHandle::Read(u8* pointer, s64 size)
 	return replay_ ? ReplayApplyDiskRead(pointer, (uint32_t)bytesRead, (uint32_t)size, inGameDir_, CoreTiming::GetGlobalTimeUs()) : bytesRead;
 }
 
-size_t DirectoryFileHandle::Write(const u8* pointer, s64 size)
+size_t DirectoryFileHandle::WriteToHost(const u8 *pointer, s64 size, bool *diskFull)
 {
 	size_t bytesWritten = 0;
-	bool diskFull = false;
 
 #ifdef _WIN32
 	BOOL success = ::WriteFile(hFile, (LPVOID)pointer, (DWORD)size, (LPDWORD)&bytesWritten, 0);
 	if (success == FALSE) {
 		DWORD err = GetLastError();
-		diskFull = err == ERROR_DISK_FULL || err == ERROR_NOT_ENOUGH_QUOTA;
+		*diskFull = err == ERROR_DISK_FULL || err == ERROR_NOT_ENOUGH_QUOTA;
 	}
 #else
 	bytesWritten = write(hFile, pointer, size);
 	if (bytesWritten == (size_t)-1) {
-		diskFull = errno == ENOSPC;
+		*diskFull = errno == ENOSPC;
 	}
 #endif
+	return bytesWritten;
+}
+
+void DirectoryFileHandle::ReportDiskFull()
+{
+	ERROR_LOG(Log::FileSystem, "Disk full");
+	auto err = GetI18NCategory(I18NCat::ERRORS);
+	g_OSD.Show(OSDType::MESSAGE_ERROR, err->T("Disk full while writing data"), 0.0f, "diskfull");
+}
+
+size_t DirectoryFileHandle::Write(const u8* pointer, s64 size)
+{
+	bool diskFull = false;
+
+	// Truncated files need the real position after each write, so they aren't cached.
+	if (writeBack_ && needsTrunc_ == -1 && size > 0) {
+		if (pendingWrite_.size() + size <= WRITE_BACK_SIZE) {
+			pendingWrite_.insert(pendingWrite_.end(), pointer, pointer + size);
+			writeBackStats_.writes++;
+			writeBackStats_.bytes += size;
+			MemoryStick_NotifyWrite();
+			return replay_ ? (size_t)ReplayApplyDiskWrite(pointer, (uint64_t)size, (uint64_t)size, &diskFull, inGameDir_, CoreTiming::GetGlobalTimeUs()) : (size_t)size;
+		}
+		// Doesn't fit, so write it out in order after what's already waiting.
+		Flush();
+	}
+
+	size_t bytesWritten = WriteToHost(pointer, size, &diskFull);
 	if (needsTrunc_ != -1) {
 		off_t off = (off_t)Seek(0, FILEMOVE_CURRENT);
 		if (needsTrunc_ < off) {
@@ -361,9 +401,7 @@ size_t DirectoryFileHandle::Write(const u8* pointer, s64 size)
 	MemoryStick_NotifyWrite();
 
 	if (diskFull) {
-		ERROR_LOG(Log::FileSystem, "Disk full");
-		auto err = GetI18NCategory(I18NCat::ERRORS);
-		g_OSD.Show(OSDType::MESSAGE_ERROR, err->T("Disk full while writing data"), 0.0f, "diskfull");
+		ReportDiskFull();
 		// We only return an error when the disk is actually full.
 		// When writing this would cause the disk to be full, so it wasn't written, we return 0.
 		Path saveFolder = GetSysDirectory(DIRECTORY_SAVEDATA);
@@ -378,8 +416,26 @@ size_t DirectoryFileHandle::Write(const u8* pointer, s64 size)
 	return bytesWritten;
 }
 
+void DirectoryFileHandle::Flush()
+{
+	if (pendingWrite_.empty())
+		return;
+
+	// The game was already told these were written, so all that's left is to complain.
+	bool diskFull = false;
+	size_t bytesWritten = WriteToHost(pendingWrite_.data(), (s64)pendingWrite_.size(), &diskFull);
+	if (bytesWritten != pendingWrite_.size()) {
+		ERROR_LOG(Log::FileSystem, "Failed to write %d cached bytes to the memory stick", (int)pendingWrite_.size());
+		if (diskFull)
+			ReportDiskFull();
+	}
+	writeBackStats_.flushes++;
+	pendingWrite_.clear();
+}
+
 size_t DirectoryFileHandle::Seek(s32 position, FileMove type)
 {
+	Flush();
 	if (needsTrunc_ != -1) {
 		// If the file is "currently truncated" move to the end based on that position.
 		// The actual, underlying file hasn't been truncated (yet.)
@@ -418,6 +474,7 @@ size_t DirectoryFileHandle::Seek(s32 position, FileMove type)
 
 void DirectoryFileHandle::Close()
 {
+	Flush();
 	if (needsTrunc_ != -1) {
 #ifdef _WIN32
 		Seek((s32)needsTrunc_, FILEMOVE_BEGIN);
@@ -443,11 +500,25 @@ void DirectoryFileHandle::Close()
 void DirectoryFileSystem::CloseAll() {
 	for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
 		INFO_LOG(Log::FileSystem, "DirectoryFileSystem::CloseAll(): Force closing %d (%s)", (int)iter->first, iter->second.guestFilename.c_str());
-		iter->second.hFile.Close();
+		CloseEntry(iter->second);
 	}
 	entries.clear();
 }
 
+void DirectoryFileSystem::CloseEntry(OpenFileEntry &entry) {
+	entry.hFile.Close();
+	const DirectoryWriteBackStats &stats = entry.hFile.writeBackStats_;
+	writeBackStats_.writes += stats.writes;
+	writeBackStats_.flushes += stats.flushes;
+	writeBackStats_.bytes += stats.bytes;
+}
+
+void DirectoryFileSystem::Flush() {
+	for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+		iter->second.hFile.Flush();
+	}
+}
+
 bool DirectoryFileSystem::MkDir(const std::string &dirname) {
 	bool result;
 #if HOST_IS_CASE_SENSITIVE
@@ -455,7 +526,7 @@ bool DirectoryFileSystem::MkDir(const std::string &dirname) {
 	// duplicate (different case) directories
 
 	std::string fixedCase = dirname;
-	if (!FixPathCase(basePath, fixedCase, FPC_PARTIAL_ALLOWED))
+	if (!caseCache.FixPathCase(basePath, fixedCase, FPC_PARTIAL_ALLOWED))
 		result = false;
 	else
 		result = File::CreateFullPath(GetLocalPath(fixedCase));
@@ -478,7 +549,7 @@ bool DirectoryFileSystem::RmDir(const std::string &dirname) {
 
 	// Nope, fix case and try again.  Should we try again?
 	std::string fullPath = dirname;
-	if (!FixPathCase(basePath, fullPath, FPC_FILE_MUST_EXIST))
+	if (!caseCache.FixPathCase(basePath, fullPath, FPC_FILE_MUST_EXIST))
 		return (bool)ReplayApplyDisk(ReplayAction::RMDIR, false, CoreTiming::GetGlobalTimeUs());
 
 	fullName = GetLocalPath(fullPath);
@@ -490,6 +561,7 @@ bool DirectoryFileSystem::RmDir(const std::string &dirname) {
 }
 
 int DirectoryFileSystem::RenameFile(const std::string &from, const std::string &to) {
+	Flush();
 	std::string fullTo = to;
 
 	// Rename ignores the path (even if specified) on to.
@@ -510,7 +582,7 @@ int DirectoryFileSystem::RenameFile(const std::string &from, const std::string &
 
 #if HOST_IS_CASE_SENSITIVE
 	// In case TO should overwrite a file with different case.  Check error code?
-	if (!FixPathCase(basePath, fullTo, FPC_PATH_MUST_EXIST))
+	if (!caseCache.FixPathCase(basePath, fullTo, FPC_PATH_MUST_EXIST))
 		return ReplayApplyDisk(ReplayAction::FILE_RENAME, -1, CoreTiming::GetGlobalTimeUs());
 #endif
 
@@ -523,7 +595,7 @@ int DirectoryFileSystem::RenameFile(const std::string &from, const std::string &
 	{
 		// May have failed due to case sensitivity on FROM, so try again.  Check error code?
 		std::string fullFromPath = from;
-		if (!FixPathCase(basePath, fullFromPath, FPC_FILE_MUST_EXIST))
+		if (!caseCache.FixPathCase(basePath, fullFromPath, FPC_FILE_MUST_EXIST))
 			return ReplayApplyDisk(ReplayAction::FILE_RENAME, -1, CoreTiming::GetGlobalTimeUs());
 		fullFrom = GetLocalPath(fullFromPath);
 
@@ -538,6 +610,7 @@ int DirectoryFileSystem::RenameFile(const std::string &from, const std::string &
 }
 
 bool DirectoryFileSystem::RemoveFile(const std::string &filename) {
+	Flush();
 	Path localPath = GetLocalPath(filename);
 
 	bool retValue = File::Delete(localPath);
@@ -547,7 +620,7 @@ bool DirectoryFileSystem::RemoveFile(const std::string &filename) {
 	{
 		// May have failed due to case sensitivity, so try again.  Try even if it fails?
 		std::string fullNamePath = filename;
-		if (!FixPathCase(basePath, fullNamePath, FPC_FILE_MUST_EXIST))
+		if (!caseCache.FixPathCase(basePath, fullNamePath, FPC_FILE_MUST_EXIST))
 			return (bool)ReplayApplyDisk(ReplayAction::FILE_REMOVE, false, CoreTiming::GetGlobalTimeUs());
 		localPath = GetLocalPath(fullNamePath);
 
@@ -560,10 +633,13 @@ bool DirectoryFileSystem::RemoveFile(const std::string &filename) {
 }
 
 int DirectoryFileSystem::OpenFile(std::string filename, FileAccess access, const char *devicename) {
+	// Another handle to the same file has to see what was written.
+	Flush();
 	OpenFileEntry entry;
 	entry.hFile.fileSystemFlags_ = flags;
+	entry.hFile.writeBack_ = g_Config.bMemStickWriteCache && (flags & FileSystemFlags::CARD);
 	u32 err = 0;
-	bool success = entry.hFile.Open(basePath, filename, (FileAccess)(access & FILEACCESS_PSP_FLAGS), err);
+	bool success = entry.hFile.Open(basePath, filename, (FileAccess)(access & FILEACCESS_PSP_FLAGS), err, CaseCache());
 	if (err == 0 && !success) {
 		err = SCE_KERNEL_ERROR_ERRNO_FILE_NOT_FOUND;
 	}
@@ -605,7 +681,7 @@ void DirectoryFileSystem::CloseFile(u32 handle) {
 	EntryMap::iterator iter = entries.find(handle);
 	if (iter != entries.end()) {
 		hAlloc->FreeHandle(handle);
-		iter->second.hFile.Close();
+		CloseEntry(iter->second);
 		entries.erase(iter);
 	} else {
 		//This shouldn't happen...
@@ -677,6 +753,7 @@ size_t DirectoryFileSystem::SeekFile(u32 handle, s32 position, FileMove type) {
 }
 
 PSPFileInfo DirectoryFileSystem::GetFileInfo(std::string filename) {
+	Flush();
 	PSPFileInfo x;
 	x.name = filename;
 
@@ -684,7 +761,7 @@ PSPFileInfo DirectoryFileSystem::GetFileInfo(std::string filename) {
 	Path fullName = GetLocalPath(filename);
 	if (!File::GetFileInfo(fullName, &info)) {
 #if HOST_IS_CASE_SENSITIVE
-		if (! FixPathCase(basePath, filename, FPC_FILE_MUST_EXIST))
+		if (!caseCache.FixPathCase(basePath, filename, FPC_FILE_MUST_EXIST))
 			return ReplayApplyDiskFileInfo(x, CoreTiming::GetGlobalTimeUs());
 		fullName = GetLocalPath(filename);
 
@@ -787,6 +864,7 @@ static std::string SimulateVFATBug(std::string filename) {
 }
 
 bool DirectoryFileSystem::ComputeRecursiveDirSizeIfFast(const std::string &path, int64_t *size) {
+	Flush();
 	Path localPath = GetLocalPath(path);
 
 	int64_t sizeTemp = File::ComputeRecursiveDirectorySize(localPath);
@@ -799,6 +877,7 @@ bool DirectoryFileSystem::ComputeRecursiveDirSizeIfFast(const std::string &path,
 }
 
 std::vector<PSPFileInfo> DirectoryFileSystem::GetDirListing(const std::string &path, bool *exists) {
+	Flush();
 	std::vector<PSPFileInfo> myVector;
 
 	std::vector<File::FileInfo> files;
@@ -809,7 +888,7 @@ std::vector<PSPFileInfo> DirectoryFileSystem::GetDirListing(const std::string &p
 	if (!success) {
 		// TODO: Case sensitivity should be checked on a file system basis, right?
 		std::string fixedPath = path;
-		if (FixPathCase(basePath, fixedPath, FPC_FILE_MUST_EXIST)) {
+		if (caseCache.FixPathCase(basePath, fixedPath, FPC_FILE_MUST_EXIST)) {
 			// May have failed due to case sensitivity, try again
 			localPath = GetLocalPath(fixedPath);
 			success = File::GetFilesInDir(localPath, &files, nullptr, flags);
@@ -882,7 +961,7 @@ u64 DirectoryFileSystem::FreeDiskSpace(const std::string &path) {
 
 #if HOST_IS_CASE_SENSITIVE
 	std::string fixedCase = path;
-	if (FixPathCase(basePath, fixedCase, FPC_FILE_MUST_EXIST)) {
+	if (caseCache.FixPathCase(basePath, fixedCase, FPC_FILE_MUST_EXIST)) {
 		// May have failed due to case sensitivity, try again.
 		if (free_disk_space(GetLocalPath(fixedCase), result)) {
 			return ReplayApplyDisk64(ReplayAction::FREESPACE, result, CoreTiming::GetGlobalTimeUs());
@@ -916,13 +995,14 @@ void DirectoryFileSystem::DoState(PointerWrap &p) {
 		u32 key;
 		OpenFileEntry entry;
 		entry.hFile.fileSystemFlags_ = flags;
+		entry.hFile.writeBack_ = g_Config.bMemStickWriteCache && (flags & FileSystemFlags::CARD);
 		for (u32 i = 0; i < num; i++) {
 			Do(p, key);
 			Do(p, entry.guestFilename);
 			Do(p, entry.access);
 			u32 err;
 			bool brokenFile = false;
-			if (!entry.hFile.Open(basePath,entry.guestFilename,entry.access, err)) {
+			if (!entry.hFile.Open(basePath, entry.guestFilename, entry.access, err, CaseCache())) {
 				ERROR_LOG(Log::FileSystem, "Failed to reopen file while loading state: %s", entry.guestFilename.c_str());
 				brokenFile = true;
 			}
@@ -942,6 +1022,8 @@ void DirectoryFileSystem::DoState(PointerWrap &p) {
 			}
 		}
 	} else {
+		// The state should match what's on the memory stick.
+		Flush();
 		for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
 			u32 key = iter->first;
 			Do(p, key);
@@ -20,6 +20,7 @@
 // TODO: Remove the Windows-specific code, FILE is fine there too.
 
 #include <map>
+#include <vector>
 
 #include "Common/File/Path.h"
 #include "Core/FileSystems/FileSystem.h"
@@ -28,6 +29,17 @@
 typedef void * HANDLE;
 #endif
 
+class PathCaseCache;
+
+// What the memory stick write cache got out of it.
+struct DirectoryWriteBackStats {
+	// Writes from the game that were held back.
+	u64 writes = 0;
+	// Host writes it took to get them out.
+	u64 flushes = 0;
+	u64 bytes = 0;
+};
+
 struct DirectoryFileHandle {
 	enum Flags {
 		NORMAL,
@@ -44,17 +56,32 @@ struct DirectoryFileHandle {
 	bool inGameDir_ = false;
 	FileSystemFlags fileSystemFlags_ = (FileSystemFlags)0;
 
+	// With the write cache on, small writes that follow each other are kept here and written in
+	// one go. The host file position stays at the start of them until then.
+	bool writeBack_ = false;
+	std::vector<u8> pendingWrite_;
+	DirectoryWriteBackStats writeBackStats_;
+
 	DirectoryFileHandle() {}
 
 	DirectoryFileHandle(Flags flags, FileSystemFlags fileSystemFlags)
 		: replay_(flags != SKIP_REPLAY), fileSystemFlags_(fileSystemFlags) {}
 
 	Path GetLocalPath(const Path &basePath, std::string localpath) const;
-	bool Open(const Path &basePath, std::string &fileName, FileAccess access, u32 &err);
+	bool Open(const Path &basePath, std::string &fileName, FileAccess access, u32 &err, PathCaseCache *caseCache = nullptr);
 	size_t Read(u8* pointer, s64 size);
 	size_t Write(const u8* pointer, s64 size);
 	size_t Seek(s32 position, FileMove type);
+	void Flush();
 	void Close();
+
+	enum {
+		WRITE_BACK_SIZE = 256 * 1024,
+	};
+
+private:
+	size_t WriteToHost(const u8 *pointer, s64 size, bool *diskFull);
+	void ReportDiskFull();
 };
 
 class DirectoryFileSystem : public IFileSystem {
@@ -87,6 +114,10 @@ class DirectoryFileSystem : public IFileSystem {
 
 	bool ComputeRecursiveDirSizeIfFast(const std::string &path, int64_t *size) override;
 	void Describe(char *buf, size_t size) const override { snprintf(buf, size, "Dir: %s", basePath.c_str()); }
+	void Flush() override;
+
+	// Of the files closed so far.
+	const DirectoryWriteBackStats &WriteBackStats() const { return writeBackStats_; }
 
 private:
 	struct OpenFileEntry {
@@ -100,8 +131,20 @@ class DirectoryFileSystem : public IFileSystem {
 	Path basePath;
 	IHandleAllocator *hAlloc;
 	FileSystemFlags flags;
+	DirectoryWriteBackStats writeBackStats_;
+#if HOST_IS_CASE_SENSITIVE
+	PathCaseCache caseCache;
+#endif
 
 	Path GetLocalPath(std::string internalPath) const;
+	void CloseEntry(OpenFileEntry &entry);
+	PathCaseCache *CaseCache() {
+#if HOST_IS_CASE_SENSITIVE
+		return &caseCache;
+#else
+		return nullptr;
+#endif
+	}
 };
 
 // VFSFileSystem: Ability to map in Android APK paths as well! Does not support all features, only meant for fonts.
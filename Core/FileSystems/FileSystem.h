@@ -148,6 +148,8 @@ class IFileSystem {
 	virtual u64      FreeDiskSpace(const std::string &path) = 0;
 	virtual bool     ComputeRecursiveDirSizeIfFast(const std::string &path, int64_t *size) = 0;
 	virtual void     Describe(char *buf, size_t size) const = 0;
+	// Writes out anything that's been held back, for sceIoSync and such.
+	virtual void     Flush() {}
 };
 
 
@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include "Common/CommonTypes.h"
+#include "Common/TimeUtil.h"
 #include "Common/Serialize/Serializer.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Core/FileSystems/ISOFileSystem.h"
@@ -29,6 +30,8 @@
 #include "Core/Reporting.h"
 
 const int sectorSize = 2048;
+// Directories with at least this many entries get a hash index of their children.
+const size_t childIndexThreshold = 32;
 
 bool parseLBN(const std::string &filename, u32 *sectorStart, u32 *readSize) {
 	// The format of this is: "/sce_lbn" "0x"? HEX* ANY* "_size" "0x"? HEX* ANY*
@@ -143,6 +146,7 @@ struct VolDescriptor {
 ISOFileSystem::ISOFileSystem(IHandleAllocator *_hAlloc, BlockDevice *_blockDevice) {
 	blockDevice = _blockDevice;
 	hAlloc = _hAlloc;
+	double start = time_now_d();
 
 	VolDescriptor desc;
 	if (!blockDevice->ReadBlock(16, (u8*)&desc))
@@ -170,9 +174,16 @@ ISOFileSystem::ISOFileSystem(IHandleAllocator *_hAlloc, BlockDevice *_blockDevic
 
 	treeroot->startsector = desc.root.firstDataSector;
 	treeroot->dirsize = desc.root.dataLength;
+	// Directories are read when first looked in, so this is just the volume descriptor.
+	INFO_LOG(Log::FileSystem, "Mounted ISO in %0.2f ms", (time_now_d() - start) * 1000.0);
 }
 
 ISOFileSystem::~ISOFileSystem() {
+	INFO_LOG(Log::FileSystem, "ISO: read %d directories (%d entries) in %0.2f ms, %d lookups of %d path components, %d of them indexed",
+		stats_.directoriesRead, stats_.entriesRead, stats_.readSeconds * 1000.0, stats_.lookups, stats_.components, stats_.indexedComponents);
+	if (stats_.bytesRead != 0) {
+		INFO_LOG(Log::FileSystem, "ISO: read %lld bytes from files, %0.3f bytes copied per byte read", (long long)stats_.bytesRead, (double)stats_.bytesCopied / (double)stats_.bytesRead);
+	}
 	delete blockDevice;
 	delete treeroot;
 }
@@ -185,7 +196,21 @@ std::string ISOFileSystem::TreeEntry::BuildPath() {
 	}
 }
 
+ISOFileSystem::TreeEntry *ISOFileSystem::TreeEntry::FindChild(const std::string &childName) const {
+	if (!childIndex.empty()) {
+		auto it = childIndex.find(childName);
+		return it != childIndex.end() ? it->second : nullptr;
+	}
+	for (TreeEntry *child : children) {
+		if (child->name == childName)
+			return child;
+	}
+	return nullptr;
+}
+
 void ISOFileSystem::ReadDirectory(TreeEntry *root) {
+	double start = time_now_d();
+	stats_.directoriesRead++;
 	for (u32 secnum = root->startsector, endsector = root->startsector + (root->dirsize + 2047) / 2048; secnum < endsector; ++secnum) {
 		u8 theSector[2048];
 		if (!blockDevice->ReadBlock(secnum, theSector)) {
@@ -254,6 +279,15 @@ void ISOFileSystem::ReadDirectory(TreeEntry *root) {
 		}
 	}
 	root->valid = true;
+	stats_.entriesRead += (int)root->children.size();
+
+	if (root->children.size() >= childIndexThreshold) {
+		root->childIndex.reserve(root->children.size());
+		// Like a scan, the first entry with a name wins.
+		for (TreeEntry *child : root->children)
+			root->childIndex.emplace(child->name, child);
+	}
+	stats_.readSeconds += time_now_d() - start;
 }
 
 ISOFileSystem::TreeEntry *ISOFileSystem::GetFromPath(const std::string &path, bool catchError) {
@@ -277,35 +311,29 @@ ISOFileSystem::TreeEntry *ISOFileSystem::GetFromPath(const std::string &path, bo
 	if (pathLength <= pathIndex)
 		return treeroot;
 
+	stats_.lookups++;
 	TreeEntry *entry = treeroot;
 	while (true) {
+		// Only the directories on the way are read, the one found is read when listed.
 		if (!entry->valid) {
 			ReadDirectory(entry);
 		}
 		TreeEntry *nextEntry = nullptr;
-		std::string name = "";
 		if (pathLength > pathIndex) {
 			size_t nextSlashIndex = path.find_first_of('/', pathIndex);
 			if (nextSlashIndex == std::string::npos)
 				nextSlashIndex = pathLength;
 
 			const std::string firstPathComponent = path.substr(pathIndex, nextSlashIndex - pathIndex);
-			for (size_t i = 0; i < entry->children.size(); i++) {
-				const std::string &n = entry->children[i]->name;
-				if (firstPathComponent == n) {
-					//yay we got it
-					nextEntry = entry->children[i];
-					name = n;
-					break;
-				}
-			}
+			stats_.components++;
+			if (!entry->childIndex.empty())
+				stats_.indexedComponents++;
+			nextEntry = entry->FindChild(firstPathComponent);
 		}
-		
+
 		if (nextEntry) {
 			entry = nextEntry;
-			if (!entry->valid)
-				ReadDirectory(entry);
-			pathIndex += name.length();
+			pathIndex += entry->name.length();
 			if (pathIndex < pathLength && path[pathIndex] == '/')
 				++pathIndex;
 
@@ -483,9 +511,12 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 			return 0;
 		}
 		
+		const u64 copiedBefore = blockDevice->BytesCopied();
 		if (e.isBlockSectorMode) {
 			// Whole sectors! Shortcut to this simple code.
 			blockDevice->ReadBlocks(e.seekPos, (int)size, pointer);
+			stats_.bytesRead += size * blockDevice->GetBlockSize();
+			stats_.bytesCopied += blockDevice->BytesCopied() - copiedBefore;
 			if (abs((int)lastReadBlock_ - (int)e.seekPos) > 100) {
 				// This is an estimate, sometimes it takes 1+ seconds, but it definitely takes time.
 				usec = 100000;
@@ -544,6 +575,7 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 			pointer += firstBlockSize;
 		}
 		if (middleSize > 0) {
+			// Straight into the destination, the device only copies if it has to.
 			const u32 sectors = (u32)(middleSize / 2048);
 			blockDevice->ReadBlocks(secNum, sectors, pointer);
 			secNum += sectors;
@@ -556,6 +588,8 @@ size_t ISOFileSystem::ReadFile(u32 handle, u8 *pointer, s64 size, int &usec) {
 		}
 
 		size_t totalBytes = pointer - start;
+		stats_.bytesRead += totalBytes;
+		stats_.bytesCopied += blockDevice->BytesCopied() - copiedBefore + firstBlockSize + lastBlockSize;
 		if (abs((int)lastReadBlock_ - (int)secNum) > 100) {
 			// This is an estimate, sometimes it takes 1+ seconds, but it definitely takes time.
 			usec = 100000;
@@ -650,6 +684,9 @@ std::vector<PSPFileInfo> ISOFileSystem::GetDirListing(const std::string &path, b
 	if (entry == &entireISO) {
 		entry = GetFromPath("/");
 	}
+	if (!entry->valid) {
+		ReadDirectory(entry);
+	}
 
 	const std::string dot(".");
 	const std::string dotdot("..");
@@ -20,6 +20,7 @@
 #include <map>
 #include <list>
 #include <memory>
+#include <unordered_map>
 
 #include "FileSystem.h"
 
@@ -63,6 +64,7 @@ class ISOFileSystem : public IFileSystem {
 
 		// Recursive function that reconstructs the path by looking at the parent pointers.
 		std::string BuildPath();
+		TreeEntry *FindChild(const std::string &childName) const;
 
 		std::string name;
 		u32 flags = 0;
@@ -77,6 +79,21 @@ class ISOFileSystem : public IFileSystem {
 
 		bool valid = false;
 		std::vector<TreeEntry *> children;
+		// Only built for large directories, small ones are faster to scan.
+		std::unordered_map<std::string, TreeEntry *> childIndex;
+	};
+
+	// Logged on unmount, to see what lazy loading saved.
+	struct LookupStats {
+		int directoriesRead = 0;
+		int entriesRead = 0;
+		double readSeconds = 0.0;
+		int lookups = 0;
+		int components = 0;
+		int indexedComponents = 0;
+		// What ReadFile handed out, and how much of it was copied on the way there.
+		u64 bytesRead = 0;
+		u64 bytesCopied = 0;
 	};
 
 	struct OpenFileEntry {
@@ -96,6 +113,7 @@ class ISOFileSystem : public IFileSystem {
 	u32 lastReadBlock_;
 
 	TreeEntry entireISO;
+	LookupStats stats_;
 
 	void ReadDirectory(TreeEntry *root);
 	TreeEntry *GetFromPath(const std::string &path, bool catchError = true);
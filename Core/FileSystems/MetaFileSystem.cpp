@@ -617,6 +617,13 @@ u64 MetaFileSystem::FreeDiskSpace(const std::string &path) {
 		return 0;
 }
 
+void MetaFileSystem::Flush() {
+	std::lock_guard<std::recursive_mutex> guard(lock);
+	for (auto &mount : fileSystems) {
+		mount.system->Flush();
+	}
+}
+
 void MetaFileSystem::DoState(PointerWrap &p) {
 	std::lock_guard<std::recursive_mutex> guard(lock);
 
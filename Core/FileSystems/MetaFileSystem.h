@@ -93,6 +93,7 @@ class MetaFileSystem : public IHandleAllocator, public IFileSystem {
 	void FreeHandle(u32 handle) override {}
 
 	void DoState(PointerWrap &p) override;
+	void Flush() override;
 
 	int MapFilePath(const std::string &inpath, std::string &outpath, MountPoint **system);
 
@@ -27,6 +27,7 @@
 #include "Core/HLE/AtracCtx.h"
 #include "Core/HW/Atrac3Standalone.h"
 #include "Core/HLE/sceKernelMemory.h"
+#include "ext/xxhash.h"
 
 const size_t overAllocBytes = 16384;
 
@@ -144,6 +145,9 @@ void Atrac::DoState(PointerWrap &p) {
 	if (p.mode == p.MODE_READ && bufferState_ != ATRAC_STATUS_NO_DATA) {
 		CreateDecoder();
 	}
+	if (p.mode == p.MODE_READ) {
+		loopCache_.Abort();
+	}
 
 	if (s >= 2 && s < 9) {
 		bool oldResetBuffer = false;
@@ -154,6 +158,7 @@ void Atrac::DoState(PointerWrap &p) {
 void Atrac::ResetData() {
 	delete decoder_;
 	decoder_ = nullptr;
+	loopCache_.Abort();
 
 	if (dataBuf_)
 		delete[] dataBuf_;
@@ -833,36 +838,72 @@ void Atrac::ForceSeekToSample(int sample) {
 	if (decoder_) {
 		decoder_->FlushBuffers();
 	}
+	loopCache_.Abort();
 	currentSample_ = sample;
 }
 
-void Atrac::SeekToSample(int sample) {
-	// It seems like the PSP aligns the sample position to 0x800...?
-	const u32 offsetSamples = track_.FirstSampleOffsetFull();
-	const u32 unalignedSamples = (offsetSamples + sample) % track_.SamplesPerFrame();
-	int seekFrame = sample + offsetSamples - unalignedSamples;
+void Atrac::PrimeDecoder(int sample) {
+	// Prefill the decode buffer with packets before the first sample offset.
+	decoder_->FlushBuffers();
 
-	if ((sample != currentSample_ || sample == 0) && decoder_ != nullptr) {
-		// Prefill the decode buffer with packets before the first sample offset.
-		decoder_->FlushBuffers();
+	int adjust = 0;
+	if (sample == 0) {
+		int offsetSamples = track_.FirstSampleOffsetFull();
+		adjust = -(int)(offsetSamples % track_.SamplesPerFrame());
+	}
+	const u32 off = track_.FileOffsetBySample(sample + adjust);
+	const u32 backfill = track_.bytesPerFrame * 2;
+	const u32 start = off - track_.dataByteOffset < backfill ? track_.dataByteOffset : off - backfill;
 
-		int adjust = 0;
-		if (sample == 0) {
-			int offsetSamples = track_.FirstSampleOffsetFull();
-			adjust = -(int)(offsetSamples % track_.SamplesPerFrame());
-		}
-		const u32 off = track_.FileOffsetBySample(sample + adjust);
-		const u32 backfill = track_.bytesPerFrame * 2;
-		const u32 start = off - track_.dataByteOffset < backfill ? track_.dataByteOffset : off - backfill;
+	for (u32 pos = start; pos < off; ) {
+		int frames = (off - pos + track_.bytesPerFrame - 1) / track_.bytesPerFrame;
+		int decoded = decoder_->DecodeFrames(BufferStart() + pos, track_.bytesPerFrame, frames, 2, nullptr, nullptr);
+		// A bad frame ends the batch, just step over it and keep priming.
+		pos += (decoded + 1) * track_.bytesPerFrame;
+	}
+}
 
-		for (u32 pos = start; pos < off; pos += track_.bytesPerFrame) {
-			decoder_->Decode(BufferStart() + pos, track_.bytesPerFrame, nullptr, 2, nullptr, nullptr);
-		}
+void Atrac::SeekToSample(int sample) {
+	if ((sample != currentSample_ || sample == 0) && decoder_ != nullptr) {
+		// Sample 0 primes again every time, that doesn't move us out of a loop pass.
+		if (sample != currentSample_)
+			loopCache_.Abort();
+		if (!loopCache_.Playing())
+			PrimeDecoder(sample);
 	}
 
 	currentSample_ = sample;
 }
 
+bool Atrac::StartLoopCachePass(int loopStart) {
+	// Only when the whole file is in memory, streamed data keeps changing under us.
+	if (!DecodedAudioCacheEnabled() || bufferState_ != ATRAC_STATUS_ALL_DATA_LOADED || decoder_ == nullptr) {
+		loopCache_.Abort();
+		return false;
+	}
+
+	// Everything the pass decodes, from the frames that prime the decoder to the end of the loop.
+	const int loopEnd = track_.loopEndSample - track_.FirstSampleOffsetFull();
+	const u32 off = track_.FileOffsetBySample(loopStart);
+	const u32 backfill = track_.bytesPerFrame * 2;
+	const u32 start = off - track_.dataByteOffset < backfill ? track_.dataByteOffset : off - backfill;
+	const u32 end = std::min(track_.FileOffsetBySample(loopEnd) + track_.bytesPerFrame, first_.size);
+	if (start >= end) {
+		loopCache_.Abort();
+		return false;
+	}
+
+	DecodedAudioKey key{};
+	key.hash = XXH3_64bits(BufferStart() + start, end - start);
+	key.codec = track_.codecType;
+	key.loopStart = loopStart;
+	key.loopEnd = loopEnd;
+	key.channels = outputChannels_;
+	// The first frame of the pass is taken wherever DecodeData says it is.
+	loopCacheNextOffset_ = 0;
+	return loopCache_.StartPass(key);
+}
+
 int Atrac::RemainingFrames() const {
 	if (bufferState_ == ATRAC_STATUS_ALL_DATA_LOADED) {
 		// Meaning, infinite I guess?  We've got it all.
@@ -973,11 +1014,40 @@ u32 Atrac::DecodeData(u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u32 *finish, i
 		numSamples = std::min(maxSamples, numSamples);
 
 		outSamples = numSamples;
-		if (!decoder_->Decode(indata, track_.bytesPerFrame, &bytesConsumed, outputChannels_, (int16_t *)outbuf, &outSamples)) {
-			// Decode failed.
-			*SamplesNum = 0;
-			*finish = 1;
-			return ATRAC_ERROR_ALL_DATA_DECODED;
+		const bool inLoopPass = loopCacheNextOffset_ == 0 || loopCacheNextOffset_ == off;
+		loopCacheNextOffset_ = off + track_.bytesPerFrame;
+
+		const s16 *cachedPcm = nullptr;
+		const DecodedAudioFrame *cachedFrame = inLoopPass ? loopCache_.PeekFrame(&cachedPcm) : nullptr;
+		if (cachedFrame) {
+			// Same as decoding, which also caps the output to the samples we want.
+			if (outbuf)
+				memcpy(outbuf, cachedPcm, std::min(outSamples, cachedFrame->samples) * outputChannels_ * sizeof(s16));
+			loopCache_.NextFrame();
+		} else if (loopCache_.Recording() && inLoopPass) {
+			// Decode the whole frame for the cache, and hand out what was asked for.
+			loopCacheFrame_.resize(track_.SamplesPerFrame() * outputChannels_);
+			int frameSamples = 0;
+			if (!decoder_->Decode(indata, track_.bytesPerFrame, &bytesConsumed, outputChannels_, &loopCacheFrame_[0], &frameSamples)) {
+				loopCache_.Abort();
+				*SamplesNum = 0;
+				*finish = 1;
+				return ATRAC_ERROR_ALL_DATA_DECODED;
+			}
+			loopCache_.RecordFrame(&loopCacheFrame_[0], frameSamples, outputChannels_, bytesConsumed, 0);
+			if (outbuf)
+				memcpy(outbuf, &loopCacheFrame_[0], std::min(outSamples, frameSamples) * outputChannels_ * sizeof(s16));
+		} else {
+			if (loopCache_.Abort()) {
+				// The decoder sat out the cached frames, catch it up.
+				PrimeDecoder(currentSample_);
+			}
+			if (!decoder_->Decode(indata, track_.bytesPerFrame, &bytesConsumed, outputChannels_, (int16_t *)outbuf, &outSamples)) {
+				// Decode failed.
+				*SamplesNum = 0;
+				*finish = 1;
+				return ATRAC_ERROR_ALL_DATA_DECODED;
+			}
 		}
 
 		if (packetAddr != 0 && MemBlockInfoDetailed()) {
@@ -1016,7 +1086,12 @@ u32 Atrac::DecodeData(u8 *outbuf, u32 outbufPtr, u32 *SamplesNum, u32 *finish, i
 	bool hitEnd = currentSample_ >= track_.endSample || (numSamples == 0 && first_.size >= track_.fileSize);
 	int loopEndAdjusted = track_.loopEndSample - track_.FirstSampleOffsetFull();
 	if ((hitEnd || currentSample_ > loopEndAdjusted) && loopNum != 0) {
-		SeekToSample(track_.loopStartSample - track_.FirstSampleOffsetFull());
+		// Like SeekToSample(), but a pass served from the cache doesn't need the decoder primed.
+		const int loopStart = track_.loopStartSample - track_.FirstSampleOffsetFull();
+		if (!StartLoopCachePass(loopStart) && decoder_ != nullptr) {
+			PrimeDecoder(loopStart);
+		}
+		currentSample_ = loopStart;
 		if (bufferState_ != ATRAC_STATUS_FOR_SCESAS) {
 			if (loopNum_ > 0)
 				loopNum_--;
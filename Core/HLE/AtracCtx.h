@@ -24,6 +24,7 @@
 
 #include "Core/MemMap.h"
 #include "Core/HLE/sceAtrac.h"
+#include "Core/HW/DecodedAudioCache.h"
 
 struct AtracSingleResetBufferInfo {
 	u32_le writePosPtr;
@@ -325,6 +326,10 @@ class Atrac : public AtracBase {
 	void ResetData();
 	void SeekToSample(int sample);
 	void ForceSeekToSample(int sample);
+	// Flushes the decoder and runs the frames before the one with sample through it.
+	void PrimeDecoder(int sample);
+	// At the loop point, returns true if the pass starting at loopStart is served from loopCache_.
+	bool StartLoopCachePass(int loopStart);
 	u32 StreamBufferEnd() const {
 		// The buffer is always aligned to a frame in size, not counting an optional header.
 		// The header will only initially exist after the data is first set.
@@ -349,4 +354,9 @@ class Atrac : public AtracBase {
 	u32 bufferPos_ = 0;
 	u32 bufferValidBytes_ = 0;
 	u32 bufferHeaderSize_ = 0;
+
+	// Not saved, see DecodedAudioCache.h.
+	DecodedLoopCache loopCache_;
+	u32 loopCacheNextOffset_ = 0;
+	std::vector<s16> loopCacheFrame_;
 };
@@ -17,6 +17,7 @@
 
 #include <cstdarg>
 #include <map>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -74,6 +75,14 @@ static const HLEFunction *latestSyscall = nullptr;
 static uint32_t latestSyscallPC = 0;
 static int idleOp;
 
+struct SyscallTotals {
+	u64 calls = 0;
+	double seconds = 0.0;
+};
+// Cumulative, unlike kernelStats which is per frame.  Read from the debugger thread.
+static std::mutex syscallTotalsLock;
+static std::map<KernelStatsSyscall, SyscallTotals> syscallTotals;
+
 // Split syscall support. NOTE: This needs to be saved in DoState somehow!
 static int splitSyscallEatCycles = 0;
 
@@ -169,6 +178,7 @@ void HLEShutdown() {
 		delete p;
 	}
 	mipsCallActions.clear();
+	hleResetSyscallStats();
 }
 
 int GetNumRegisteredModules() {
@@ -654,6 +664,13 @@ static void updateSyscallStats(int modulenum, int funcnum, double total)
 	kernelStats.msInSyscalls += total;
 
 	KernelStatsSyscall statCall(modulenum, funcnum);
+	{
+		std::lock_guard<std::mutex> guard(syscallTotalsLock);
+		SyscallTotals &totals = syscallTotals[statCall];
+		totals.calls++;
+		totals.seconds += total;
+	}
+
 	auto summedStat = kernelStats.summedMsInSyscalls.find(statCall);
 	if (summedStat == kernelStats.summedMsInSyscalls.end())
 	{
@@ -675,6 +692,28 @@ static void updateSyscallStats(int modulenum, int funcnum, double total)
 	}
 }
 
+std::vector<HLESyscallStat> hleGetSyscallStats() {
+	std::vector<HLESyscallStat> stats;
+	std::lock_guard<std::mutex> guard(syscallTotalsLock);
+	stats.reserve(syscallTotals.size());
+	for (const auto &it : syscallTotals) {
+		int modulenum = it.first.first;
+		int funcnum = it.first.second;
+		if (modulenum >= (int)moduleDB.size() || funcnum >= moduleDB[modulenum].numFunctions)
+			continue;
+		stats.push_back({ moduleDB[modulenum].name, moduleDB[modulenum].funcTable[funcnum].name, it.second.calls, it.second.seconds });
+	}
+	return stats;
+}
+
+void hleResetSyscallStats() {
+	std::lock_guard<std::mutex> guard(syscallTotalsLock);
+	syscallTotals.clear();
+}
+
+// These flags need checks before the call, the rest are informational.
+static const u32 HLE_CHECKED_FLAGS = HLE_NOT_IN_INTERRUPT | HLE_NOT_DISPATCH_SUSPENDED | HLE_CLEAR_STACK_BYTES;
+
 inline void CallSyscallWithFlags(const HLEFunction *info)
 {
 	latestSyscall = info;
@@ -714,6 +753,22 @@ inline void CallSyscallWithoutFlags(const HLEFunction *info)
 		SetDeadbeefRegs();
 }
 
+// The jit keeps running the same block after these, so nothing may change PC or the thread.
+// A pending debug break is still fine, it only changes coreState, which the jit checks.
+static void CallSyscallPure(const HLEFunction *info)
+{
+	latestSyscall = info;
+	latestSyscallPC = currentMIPS->pc;
+	info->func();
+
+	if (hleAfterSyscall != HLE_AFTER_NOTHING) {
+		_dbg_assert_msg_((hleAfterSyscall & ~(HLE_AFTER_DEBUG_BREAK | HLE_AFTER_SKIP_DEADBEEF | HLE_AFTER_CORETIMING_FORCE_CHECK)) == 0, "%s is marked HLE_PURE but rescheduled (%03x)", info->name, hleAfterSyscall);
+		hleFinishSyscall(info);
+	} else {
+		SetDeadbeefRegs();
+	}
+}
+
 const HLEFunction *GetSyscallFuncPointer(MIPSOpcode op)
 {
 	u32 callno = (op >> 6) & 0xFFFFF; //20 bits
@@ -747,11 +802,20 @@ void *GetQuickSyscallFunc(MIPSOpcode op) {
 	// TODO: Do this with a flag?
 	if (op == idleOp)
 		return (void *)info->func;
-	if (info->flags != 0)
+	if (info->flags & HLE_CHECKED_FLAGS)
 		return (void *)&CallSyscallWithFlags;
+	if (info->flags & HLE_PURE)
+		return (void *)&CallSyscallPure;
 	return (void *)&CallSyscallWithoutFlags;
 }
 
+bool IsPureSyscall(MIPSOpcode op) {
+	if (op == idleOp)
+		return false;
+	const HLEFunction *info = GetSyscallFuncPointer(op);
+	return info && info->func && (info->flags & HLE_PURE) != 0 && (info->flags & HLE_CHECKED_FLAGS) == 0;
+}
+
 static double hleSteppingTime = 0.0;
 void hleSetSteppingTime(double t) {
 	hleSteppingTime += t;
@@ -779,7 +843,7 @@ void CallSyscall(MIPSOpcode op)
 	if (info->func) {
 		if (op == idleOp)
 			info->func();
-		else if (info->flags != 0)
+		else if (info->flags & HLE_CHECKED_FLAGS)
 			CallSyscallWithFlags(info);
 		else
 			CallSyscallWithoutFlags(info);
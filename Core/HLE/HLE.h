@@ -20,6 +20,7 @@
 #include <cstdio>
 #include <cstdarg>
 #include <type_traits>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Log.h"
@@ -42,6 +43,9 @@ enum {
 	HLE_CLEAR_STACK_BYTES = 1 << 10,
 	// Indicates that this call operates in kernel mode.
 	HLE_KERNEL_SYSCALL = 1 << 11,
+	// The call never reschedules, delays, runs callbacks/interrupts or enqueues mips calls.
+	// PC and the current thread are unchanged afterward, so the jit can keep going in the same block.
+	HLE_PURE = 1 << 12,
 };
 
 struct HLEFunction {
@@ -162,6 +166,20 @@ void HLEReturnFromMipsCall();
 const HLEFunction *GetSyscallFuncPointer(MIPSOpcode op);
 // For jit, takes arg: const HLEFunction *
 void *GetQuickSyscallFunc(MIPSOpcode op);
+// For jit, true if the block can continue after this syscall (see HLE_PURE.)
+bool IsPureSyscall(MIPSOpcode op);
+
+struct HLESyscallStat {
+	const char *module;
+	const char *name;
+	u64 calls;
+	// Seconds spent in the call, excluding stepping and flip time.
+	double seconds;
+};
+
+// Totals per syscall since the last reset.  Only counted while coreCollectDebugStats is on.
+std::vector<HLESyscallStat> hleGetSyscallStats();
+void hleResetSyscallStats();
 
 void hleDoLogInternal(Log t, LogLevel level, u64 res, const char *file, int line, const char *reportTag, char retmask, const char *reason, const char *formatted_reason);
 
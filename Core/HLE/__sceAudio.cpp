@@ -29,6 +29,7 @@
 #include <emmintrin.h>
 #endif
 
+#include "Core/AVIDump.h"
 #include "Core/Config.h"
 #include "Core/CoreTiming.h"
 #include "Core/MemMapHelpers.h"
@@ -44,6 +45,7 @@
 #include "Core/HLE/sceAudio.h"
 #include "Core/HLE/sceKernel.h"
 #include "Core/HLE/sceKernelThread.h"
+#include "Core/HW/DecodedAudioCache.h"
 #include "Core/Util/AudioFormat.h"
 
 // Should be used to lock anything related to the outAudioQueue.
@@ -184,6 +186,8 @@ void __AudioShutdown() {
 		chans[i].index = i;
 		chans[i].clear();
 	}
+	// The contexts using it are gone by now.
+	DecodedAudioCacheClear();
 
 #ifndef MOBILE_DEVICE
 	if (g_Config.bDumpAudio) {
@@ -392,23 +396,16 @@ void __AudioUpdate(bool resetRecording) {
 			sz2 = 0;
 		}
 
+		// Straight out of the queue's storage, no copy.
 		if (firstChannel) {
-			for (size_t s = 0; s < sz1; s++)
-				mixBuffer[s] = buf1[s];
-			if (buf2) {
-				for (size_t s = 0; s < sz2; s++)
-					mixBuffer[s + sz1] = buf2[s];
-			}
+			ConvertS16ToS32(mixBuffer, buf1, sz1);
+			if (buf2)
+				ConvertS16ToS32(mixBuffer + sz1, buf2, sz2);
 			firstChannel = false;
 		} else {
-			// Surprisingly hard to SIMD efficiently on SSE2 due to lack of 16-to-32-bit sign extension. NEON should be straight-forward though, and SSE4.1 can do it nicely.
-			// Actually, the cmple/pack trick should work fine...
-			for (size_t s = 0; s < sz1; s++)
-				mixBuffer[s] += buf1[s];
-			if (buf2) {
-				for (size_t s = 0; s < sz2; s++)
-					mixBuffer[s + sz1] += buf2[s];
-			}
+			AddS16ToS32(mixBuffer, buf1, sz1);
+			if (buf2)
+				AddS16ToS32(mixBuffer + sz1, buf2, sz2);
 		}
 	}
 
@@ -444,14 +441,16 @@ void __AudioUpdate(bool resetRecording) {
 			}
 		} else {
 			if (g_Config.bDumpAudio) {
-				for (int i = 0; i < hwBlockSize * 2; i++) {
-					clampedMixBuffer[i] = clamp_s16(mixBuffer[i]);
-				}
+				ClampS32ToS16(clampedMixBuffer, mixBuffer, hwBlockSize * 2);
 				g_wave_writer.AddStereoSamples(clampedMixBuffer, hwBlockSize);
 			} else {
 				__StopLogAudio();
 			}
 		}
+		if (AVIDump::IsRecording()) {
+			ClampS32ToS16(clampedMixBuffer, mixBuffer, hwBlockSize * 2);
+			AVIDump::AddAudio(clampedMixBuffer, hwBlockSize);
+		}
 #endif
 	}
 }
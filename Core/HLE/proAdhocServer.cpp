@@ -27,6 +27,9 @@
 #include <cstdio>
 #include <cstring>
 #include <signal.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #if defined(HAVE_LIBNX) || PPSSPP_PLATFORM(SWITCH)
 #include <netdb.h>
@@ -46,6 +49,20 @@ extern "C" struct hostent *gethostbyname(const char *name);
 #include <netinet/tcp.h>
 #endif
 
+#if PPSSPP_PLATFORM(LINUX) || PPSSPP_PLATFORM(ANDROID)
+#include <sys/epoll.h>
+#include <unistd.h>
+#define ADHOC_SERVER_USE_EPOLL
+#endif
+
+// Not select: FD_SETSIZE is only 64 on Windows, and sockets past it would have to be polled blindly.
+#if defined(_WIN32)
+#define adhoc_poll WSAPoll
+#else
+#include <poll.h>
+#define adhoc_poll poll
+#endif
+
 #include <fcntl.h>
 #include <errno.h>
 //#include <sqlite3.h>
@@ -75,9 +92,27 @@ SceNetAdhocctlUserNode * _db_user = NULL;
 // Game Database
 SceNetAdhocctlGameNode * _db_game = NULL;
 
+// Hashed indices into the Database above. The linked lists stay authoritative for iteration,
+// these only replace the linear searches by Socket, IP, MAC, Product Code and Group Name.
+static std::unordered_map<int, SceNetAdhocctlUserNode *> _db_user_by_stream;
+static std::unordered_map<uint32_t, SceNetAdhocctlUserNode *> _db_user_by_ip;
+static std::unordered_multimap<uint64_t, SceNetAdhocctlUserNode *> _db_user_by_mac;
+static std::unordered_map<std::string, SceNetAdhocctlGameNode *> _db_game_by_product;
+static std::unordered_map<std::string, SceNetAdhocctlGroupNode *> _db_group_by_name;
+
+// Status Logfile needs rewriting (written at most once per SERVER_STATUS_INTERVAL)
+static bool _status_dirty = false;
+static double _status_last_write = 0.0;
+
+#ifdef ADHOC_SERVER_USE_EPOLL
+// Event Queue for the Listening Socket and all User Streams
+static int _event_fd = -1;
+#endif
+
 // Server Status
 std::atomic<bool> adhocServerRunning(false);
 std::thread adhocServerThread;
+bool adhocServerWriteStatus = true;
 
 // Crosslink database for cross region Adhoc play
 std::vector<db_crosslink> crosslinks;
@@ -496,6 +531,104 @@ void change_blocking_mode(int fd, int nonblocking);
 int create_listen_socket(uint16_t port);
 int server_loop(int server);
 
+static uint64_t mac_key(const SceNetEtherAddr & mac)
+{
+	uint64_t key = 0;
+	memcpy(&key, mac.data, ETHER_ADDR_LEN);
+	return key;
+}
+
+static std::string product_key(const SceNetAdhocctlProductCode & product)
+{
+	// Matches the strncmp semantics of the original linear search
+	return std::string(product.data, strnlen(product.data, PRODUCT_CODE_LENGTH));
+}
+
+static std::string group_key(const SceNetAdhocctlGameNode * game, const SceNetAdhocctlGroupName & group)
+{
+	// Group Names are only unique per Game
+	const char * name = (const char *)group.data;
+	return product_key(game->game) + '/' + std::string(name, strnlen(name, ADHOCCTL_GROUPNAME_LEN));
+}
+
+/**
+ * Register Socket for Read Events
+ * @param fd Socket
+ */
+static void watch_socket(int fd)
+{
+#ifdef ADHOC_SERVER_USE_EPOLL
+	if(_event_fd != -1)
+	{
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN | EPOLLRDHUP;
+		ev.data.fd = fd;
+		if(epoll_ctl(_event_fd, EPOLL_CTL_ADD, fd, &ev) != 0) ERROR_LOG(Log::sceNet, "AdhocServer: epoll_ctl add failed (Socket error %d)", errno);
+	}
+#endif
+}
+
+/**
+ * Unregister Socket from Read Events (before it gets closed)
+ * @param fd Socket
+ */
+static void unwatch_socket(int fd)
+{
+#ifdef ADHOC_SERVER_USE_EPOLL
+	if(_event_fd != -1)
+	{
+		struct epoll_event ev;
+		memset(&ev, 0, sizeof(ev));
+		epoll_ctl(_event_fd, EPOLL_CTL_DEL, fd, &ev);
+	}
+#endif
+}
+
+/**
+ * Wait for Socket Events
+ * @param server Server Listening Socket
+ * @param timeout Timeout in Milliseconds
+ * @param ready OUT: Sockets with pending Data (or Errors)
+ */
+static void wait_for_events(int server, int timeout, std::vector<int> & ready)
+{
+	ready.clear();
+
+#ifdef ADHOC_SERVER_USE_EPOLL
+	if(_event_fd != -1)
+	{
+		struct epoll_event events[256];
+		int count = epoll_wait(_event_fd, events, ARRAY_SIZE(events), timeout);
+		for(int i = 0; i < count; i++) ready.push_back(events[i].data.fd);
+		return;
+	}
+#endif
+
+	// Portable Fallback (kept around so it doesn't get reallocated on every Wakeup)
+	static std::vector<pollfd> fds;
+	fds.clear();
+	pollfd pfd;
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.events = POLLIN;
+	pfd.fd = server;
+	fds.push_back(pfd);
+	for(SceNetAdhocctlUserNode * user = _db_user; user != NULL; user = user->next)
+	{
+		pfd.fd = user->stream;
+		fds.push_back(pfd);
+	}
+
+	int count = adhoc_poll(fds.data(), (unsigned long)fds.size(), timeout);
+	if(count <= 0) return;
+
+	// Errors and Hangups are reported too, recv will find out what happened
+	for(const pollfd & entry : fds)
+	{
+		if(entry.revents != 0) ready.push_back((int)entry.fd);
+	}
+}
+
 void __AdhocServerInit() {
 	// Database Product name will update if new game region played on my server to list possible crosslinks
 	productids = std::vector<db_productid>(default_productids, default_productids + ARRAY_SIZE(default_productids));
@@ -513,11 +646,10 @@ void login_user_stream(int fd, uint32_t ip)
 	if(_db_user_count < SERVER_USER_MAXIMUM)
 	{
 		// Check IP Duplication
-		SceNetAdhocctlUserNode * u = _db_user;
-		while(u != NULL && u->resolver.ip != ip) u = u->next;
+		auto existing = _db_user_by_ip.find(ip);
 
-		if (u != NULL) { // IP Already existed
-			WARN_LOG(Log::sceNet, "AdhocServer: Already Existing IP: %s\n", ip2str(*(in_addr*)&u->resolver.ip).c_str());
+		if (existing != _db_user_by_ip.end()) { // IP Already existed
+			WARN_LOG(Log::sceNet, "AdhocServer: Already Existing IP: %s\n", ip2str(*(in_addr*)&existing->second->resolver.ip).c_str());
 		}
 
 		// Unique IP Address
@@ -543,6 +675,13 @@ void login_user_stream(int fd, uint32_t ip)
 				if(_db_user != NULL) _db_user->prev = user;
 				_db_user = user;
 
+				// Index User
+				_db_user_by_stream[fd] = user;
+				_db_user_by_ip[ip] = user;
+
+				// Wait for Data from User
+				watch_socket(fd);
+
 				// Initialize Death Clock
 				user->last_recv = time(NULL);
 
@@ -586,19 +725,19 @@ void login_user_data(SceNetAdhocctlUserNode * user, SceNetAdhocctlLoginPacketC2S
 	if(valid_product_code == 1 && memcmp(&data->mac, "\xFF\xFF\xFF\xFF\xFF\xFF", sizeof(data->mac)) != 0 && memcmp(&data->mac, "\x00\x00\x00\x00\x00\x00", sizeof(data->mac)) != 0 && data->name.data[0] != 0)
 	{
 		// Check for duplicated MAC as most games identify Players by MAC
-		SceNetAdhocctlUserNode* u = _db_user;
-		while (u != NULL && !IsMatch(u->resolver.mac, data->mac)) u = u->next;
+		auto existing = _db_user_by_mac.find(mac_key(data->mac));
 
-		if (u != NULL) { // MAC Already existed
-			WARN_LOG(Log::sceNet, "AdhocServer: Already Existing MAC: %s [%s]\n", mac2str(&data->mac).c_str(), ip2str(*(in_addr*)&u->resolver.ip).c_str());
+		if (existing != _db_user_by_mac.end()) { // MAC Already existed
+			WARN_LOG(Log::sceNet, "AdhocServer: Already Existing MAC: %s [%s]\n", mac2str(&data->mac).c_str(), ip2str(*(in_addr*)&existing->second->resolver.ip).c_str());
 		}
 
 		// Game Product Override
 		game_product_override(&data->game);
 
 		// Find existing Game
-		SceNetAdhocctlGameNode * game = _db_game;
-		while(game != NULL && strncmp(game->game.data, data->game.data, PRODUCT_CODE_LENGTH) != 0) game = game->next;
+		std::string productKey = product_key(data->game);
+		auto foundGame = _db_game_by_product.find(productKey);
+		SceNetAdhocctlGameNode * game = foundGame != _db_game_by_product.end() ? foundGame->second : NULL;
 
 		// Game not found
 		if(game == NULL)
@@ -619,6 +758,9 @@ void login_user_data(SceNetAdhocctlUserNode * user, SceNetAdhocctlLoginPacketC2S
 				game->next = _db_game;
 				if(_db_game != NULL) _db_game->prev = game;
 				_db_game = game;
+
+				// Index Game
+				_db_game_by_product[productKey] = game;
 			}
 		}
 
@@ -627,6 +769,7 @@ void login_user_data(SceNetAdhocctlUserNode * user, SceNetAdhocctlLoginPacketC2S
 		{
 			// Save MAC
 			user->resolver.mac = data->mac;
+			_db_user_by_mac.emplace(mac_key(user->resolver.mac), user);
 
 			// Save Nickname
 			user->resolver.name = data->name;
@@ -680,7 +823,13 @@ void logout_user(SceNetAdhocctlUserNode * user)
 	// Unlink Rightside
 	if(user->next != NULL) user->next->prev = user->prev;
 
+	// Remove from Indices
+	_db_user_by_stream.erase(user->stream);
+	auto byIP = _db_user_by_ip.find(user->resolver.ip);
+	if(byIP != _db_user_by_ip.end() && byIP->second == user) _db_user_by_ip.erase(byIP);
+
 	// Close Stream
+	unwatch_socket(user->stream);
 	closesocket(user->stream);
 
 	// Playing User
@@ -692,6 +841,17 @@ void logout_user(SceNetAdhocctlUserNode * user)
 		strncpy(safegamestr, user->game->game.data, PRODUCT_CODE_LENGTH);
 		INFO_LOG(Log::sceNet, "AdhocServer: %s (MAC: %s - IP: %s) stopped playing %s", (char *)user->resolver.name.data, mac2str(&user->resolver.mac).c_str(), ip2str(*(in_addr*)&user->resolver.ip).c_str(), safegamestr);
 
+		// Remove MAC from Index (only known after Login)
+		auto range = _db_user_by_mac.equal_range(mac_key(user->resolver.mac));
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			if(it->second == user)
+			{
+				_db_user_by_mac.erase(it);
+				break;
+			}
+		}
+
 		// Fix Game Player Count
 		user->game->playercount--;
 
@@ -707,6 +867,9 @@ void logout_user(SceNetAdhocctlUserNode * user)
 			// Unlink Rightside
 			if(user->game->next != NULL) user->game->next->prev = user->game->prev;
 
+			// Remove from Index
+			_db_game_by_product.erase(product_key(user->game->game));
+
 			// Free Game Node Memory
 			free(user->game);
 		}
@@ -754,6 +917,13 @@ void free_database()
 		// Move Pointer
 		user = next;
 	}
+
+	// Drop Index Leftovers
+	_db_user_by_stream.clear();
+	_db_user_by_ip.clear();
+	_db_user_by_mac.clear();
+	_db_game_by_product.clear();
+	_db_group_by_name.clear();
 }
 
 /**
@@ -793,8 +963,9 @@ void connect_user(SceNetAdhocctlUserNode * user, SceNetAdhocctlGroupName * group
 		if(user->group == NULL)
 		{
 			// Find Group in Game Node
-			SceNetAdhocctlGroupNode * g = user->game->group;
-			while(g != NULL && strncmp((char *)g->group.data, (char *)group->data, ADHOCCTL_GROUPNAME_LEN) != 0) g = g->next;
+			std::string groupKey = group_key(user->game, *group);
+			auto foundGroup = _db_group_by_name.find(groupKey);
+			SceNetAdhocctlGroupNode * g = foundGroup != _db_group_by_name.end() ? foundGroup->second : NULL;
 
 			// BSSID Packet
 			SceNetAdhocctlConnectBSSIDPacketS2C bssid;
@@ -830,6 +1001,9 @@ void connect_user(SceNetAdhocctlUserNode * user, SceNetAdhocctlGroupName * group
 
 					// Increase Group Counter for Game
 					g->game->groupcount++;
+
+					// Index Group
+					_db_group_by_name[groupKey] = g;
 				}
 			}
 
@@ -1014,6 +1188,9 @@ void disconnect_user(SceNetAdhocctlUserNode * user)
 			// Unlink Rightside
 			if(user->group->next != NULL) user->group->next->prev = user->group->prev;
 
+			// Remove from Index
+			_db_group_by_name.erase(group_key(user->game, user->group->group));
+
 			// Free Group Memory
 			free(user->group);
 
@@ -1420,9 +1597,25 @@ void game_product_override(SceNetAdhocctlProductCode * product)
 
 /**
  * Update Status Logfile
+ * The Logfile holds the whole Database, so it only gets marked dirty here and is rewritten by flush_status.
  */
 void update_status()
 {
+	_status_dirty = true;
+}
+
+/**
+ * Write Status Logfile
+ */
+static void write_status()
+{
+	// Remember Write
+	_status_dirty = false;
+	_status_last_write = time_now_d();
+
+	// Logfile disabled
+	if(!adhocServerWriteStatus) return;
+
 	// Open Logfile
 	FILE * log = File::OpenCFile(Path(SERVER_STATUS_XMLOUT), "w");
 
@@ -1873,216 +2066,309 @@ int create_listen_socket(uint16_t port)
 }
 
 /**
- * Server Main Loop
- * @param server Server Listening Socket
- * @return OS Error Code
+ * Rewrite Status Logfile if it changed and the Write Interval passed
+ * @param force Ignore the Write Interval
  */
-int server_loop(int server)
+static void flush_status(bool force)
 {
-	// Set Running Status
-	//_status = 1;
-	adhocServerRunning = true;
+	if(_status_dirty && (force || time_now_d() - _status_last_write >= SERVER_STATUS_INTERVAL)) write_status();
+}
 
-	// Create Empty Status Logfile
-	update_status();
+/**
+ * Accept pending Login Requests
+ * @param server Server Listening Socket
+ */
+static void accept_logins(int server)
+{
+	// Login Result
+	int loginresult = 0;
 
-	// Handling Loop
-	while (adhocServerRunning) //(_status == 1)
+	// Login Processing Loop
+	do
 	{
-		// Login Block
+		// Prepare Address Structure
+		struct sockaddr_in addr;
+		socklen_t addrlen = sizeof(addr);
+		memset(&addr, 0, sizeof(addr));
+
+		// Accept Login Requests
+		// loginresult = accept4(server, (struct sockaddr *)&addr, &addrlen, SOCK_NONBLOCK);
+
+		// Alternative Accept Approach (some Linux Kernel don't support the accept4 Syscall... wtf?)
+		loginresult = accept(server, (struct sockaddr *)&addr, &addrlen);
+		if(loginresult != -1)
 		{
-			// Login Result
-			int loginresult = 0;
+			// Switch Socket into Non-Blocking Mode
+			change_blocking_mode(loginresult, 1);
+		}
 
-			// Login Processing Loop
-			do
-			{
-				// Prepare Address Structure
-				struct sockaddr_in addr;
-				socklen_t addrlen = sizeof(addr);
-				memset(&addr, 0, sizeof(addr));
+		// Login User (Stream)
+		if (loginresult != -1) {
+			u32_le sip = addr.sin_addr.s_addr;
+			/* // Replacing 127.0.0.x with Ethernet IP will cause issue with multiple-instance of localhost (127.0.0.x)
+			if (sip == 0x0100007f) { //127.0.0.1 should be replaced with LAN/WAN IP whenever available
+				char str[100];
+				gethostname(str, 100);
+				u8 *pip = (u8*)&sip;
+				if (gethostbyname(str)->h_addrtype == AF_INET && gethostbyname(str)->h_addr_list[0] != NULL) pip = (u8*)gethostbyname(str)->h_addr_list[0];
+				sip = *(u32_le*)pip;
+				WARN_LOG(Log::sceNet, "AdhocServer: Replacing IP %s with %s", inet_ntoa(addr.sin_addr), inet_ntoa(*(in_addr*)&pip));
+			}
+			*/
+			login_user_stream(loginresult, sip);
+		}
+	} while(loginresult != -1);
+}
 
-				// Accept Login Requests
-				// loginresult = accept4(server, (struct sockaddr *)&addr, &addrlen, SOCK_NONBLOCK);
+/**
+ * Process one Packet from the User RX Buffer
+ * @param user User Node (may be logged out and freed by this call)
+ * @return true if a Packet was consumed
+ */
+static bool process_user_packet(SceNetAdhocctlUserNode * user)
+{
+	// Waiting for Login Packet
+	if(get_user_state(user) == USER_STATE_WAITING)
+	{
+		// Valid Opcode
+		if(user->rx[0] == OPCODE_LOGIN)
+		{
+			// Enough Data available
+			if(user->rxpos >= sizeof(SceNetAdhocctlLoginPacketC2S))
+			{
+				// Clone Packet
+				SceNetAdhocctlLoginPacketC2S packet = *(SceNetAdhocctlLoginPacketC2S *)user->rx;
 
-				// Alternative Accept Approach (some Linux Kernel don't support the accept4 Syscall... wtf?)
-				loginresult = accept(server, (struct sockaddr *)&addr, &addrlen);
-				if(loginresult != -1)
-				{
-					// Switch Socket into Non-Blocking Mode
-					change_blocking_mode(loginresult, 1);
-				}
+				// Remove Packet from RX Buffer
+				clear_user_rxbuf(user, sizeof(SceNetAdhocctlLoginPacketC2S));
 
-				// Login User (Stream)
-				if (loginresult != -1) {
-					u32_le sip = addr.sin_addr.s_addr;
-					/* // Replacing 127.0.0.x with Ethernet IP will cause issue with multiple-instance of localhost (127.0.0.x)
-					if (sip == 0x0100007f) { //127.0.0.1 should be replaced with LAN/WAN IP whenever available
-						char str[100];
-						gethostname(str, 100);
-						u8 *pip = (u8*)&sip;
-						if (gethostbyname(str)->h_addrtype == AF_INET && gethostbyname(str)->h_addr_list[0] != NULL) pip = (u8*)gethostbyname(str)->h_addr_list[0];
-						sip = *(u32_le*)pip;
-						WARN_LOG(Log::sceNet, "AdhocServer: Replacing IP %s with %s", inet_ntoa(addr.sin_addr), inet_ntoa(*(in_addr*)&pip));
-					}
-					*/
-					login_user_stream(loginresult, sip);
-				}
-			} while(loginresult != -1);
+				// Login User (Data)
+				login_user_data(user, &packet);
+				return true;
+			}
 		}
 
-		// Receive Data from Users
-		SceNetAdhocctlUserNode * user = _db_user;
-		while(user != NULL)
+		// Invalid Opcode
+		else
 		{
-			// Next User (for safe delete)
-			SceNetAdhocctlUserNode * next = user->next;
+			// Notify User
+			WARN_LOG(Log::sceNet, "AdhocServer: Invalid Opcode 0x%02X in Waiting State from %s", user->rx[0], ip2str(*(in_addr*)&user->resolver.ip).c_str());
+
+			// Logout User
+			logout_user(user);
+			return true;
+		}
+	}
 
-			// Receive Data from User
-			int recvresult = (int)recv(user->stream, (char*)user->rx + user->rxpos, sizeof(user->rx) - user->rxpos, MSG_NOSIGNAL);
+	// Logged-In User
+	else if(get_user_state(user) == USER_STATE_LOGGED_IN)
+	{
+		// Ping Packet
+		if(user->rx[0] == OPCODE_PING)
+		{
+			// Delete Packet from RX Buffer
+			clear_user_rxbuf(user, 1);
+			return true;
+		}
 
-			// Connection Closed or Timed Out
-			if(recvresult == 0 || (recvresult == -1 && errno != EAGAIN && errno != EWOULDBLOCK) || get_user_state(user) == USER_STATE_TIMED_OUT)
+		// Group Connect Packet
+		else if(user->rx[0] == OPCODE_CONNECT)
+		{
+			// Enough Data available
+			if(user->rxpos >= sizeof(SceNetAdhocctlConnectPacketC2S))
 			{
-				// Logout User
-				logout_user(user);
+				// Cast Packet
+				SceNetAdhocctlConnectPacketC2S * packet = (SceNetAdhocctlConnectPacketC2S *)user->rx;
+
+				// Clone Group Name
+				SceNetAdhocctlGroupName group = packet->group;
+
+				// Remove Packet from RX Buffer
+				clear_user_rxbuf(user, sizeof(SceNetAdhocctlConnectPacketC2S));
+
+				// Change Game Group
+				connect_user(user, &group);
+				return true;
 			}
+		}
+
+		// Group Disconnect Packet
+		else if(user->rx[0] == OPCODE_DISCONNECT)
+		{
+			// Remove Packet from RX Buffer
+			clear_user_rxbuf(user, 1);
 
-			// Received Data (or leftovers in RX-Buffer)
-			else if(recvresult > 0 || user->rxpos > 0)
+			// Leave Game Group
+			disconnect_user(user);
+			return true;
+		}
+
+		// Network Scan Packet
+		else if(user->rx[0] == OPCODE_SCAN)
+		{
+			// Remove Packet from RX Buffer
+			clear_user_rxbuf(user, 1);
+
+			// Send Network List
+			send_scan_results(user);
+			return true;
+		}
+
+		// Chat Text Packet
+		else if(user->rx[0] == OPCODE_CHAT)
+		{
+			// Enough Data available
+			if(user->rxpos >= sizeof(SceNetAdhocctlChatPacketC2S))
 			{
-				// New Incoming Data
-				if(recvresult > 0)
-				{
-					// Move RX Pointer
-					user->rxpos += recvresult;
+				// Cast Packet
+				SceNetAdhocctlChatPacketC2S * packet = (SceNetAdhocctlChatPacketC2S *)user->rx;
 
-					// Update Death Clock
-					user->last_recv = time(NULL);
-				}
+				// Clone Buffer for Message
+				char message[64];
+				memset(message, 0, sizeof(message));
+				strncpy(message, packet->message, sizeof(message) - 1);
 
-				// Waiting for Login Packet
-				if(get_user_state(user) == USER_STATE_WAITING)
-				{
-					// Valid Opcode
-					if(user->rx[0] == OPCODE_LOGIN)
-					{
-						// Enough Data available
-						if(user->rxpos >= sizeof(SceNetAdhocctlLoginPacketC2S))
-						{
-							// Clone Packet
-							SceNetAdhocctlLoginPacketC2S packet = *(SceNetAdhocctlLoginPacketC2S *)user->rx;
+				// Remove Packet from RX Buffer
+				clear_user_rxbuf(user, sizeof(SceNetAdhocctlChatPacketC2S));
 
-							// Remove Packet from RX Buffer
-							clear_user_rxbuf(user, sizeof(SceNetAdhocctlLoginPacketC2S));
+				// Spread Chat Message
+				spread_message(user, message);
+				return true;
+			}
+		}
 
-							// Login User (Data)
-							login_user_data(user, &packet);
-						}
-					}
+		// Invalid Opcode
+		else
+		{
+			// Notify User
+			WARN_LOG(Log::sceNet, "AdhocServer: Invalid Opcode 0x%02X in Logged-In State from %s (MAC: %s - IP: %s)", user->rx[0], (char *)user->resolver.name.data, mac2str(&user->resolver.mac).c_str(), ip2str(*(in_addr*)&user->resolver.ip).c_str());
 
-					// Invalid Opcode
-					else
-					{
-						// Notify User
-						WARN_LOG(Log::sceNet, "AdhocServer: Invalid Opcode 0x%02X in Waiting State from %s", user->rx[0], ip2str(*(in_addr*)&user->resolver.ip).c_str());
+			// Logout User
+			logout_user(user);
+			return true;
+		}
+	}
 
-						// Logout User
-						logout_user(user);
-					}
-				}
+	// Incomplete Packet
+	return false;
+}
 
-				// Logged-In User
-				else if(get_user_state(user) == USER_STATE_LOGGED_IN)
-				{
-					// Ping Packet
-					if(user->rx[0] == OPCODE_PING)
-					{
-						// Delete Packet from RX Buffer
-						clear_user_rxbuf(user, 1);
-					}
+/**
+ * Receive Data from User and process every complete Packet
+ * @param user User Node (may be logged out and freed by this call)
+ */
+static void receive_user_data(SceNetAdhocctlUserNode * user)
+{
+	// Remember Socket to detect Logouts during Packet Processing
+	int fd = user->stream;
 
-					// Group Connect Packet
-					else if(user->rx[0] == OPCODE_CONNECT)
-					{
-						// Enough Data available
-						if(user->rxpos >= sizeof(SceNetAdhocctlConnectPacketC2S))
-						{
-							// Cast Packet
-							SceNetAdhocctlConnectPacketC2S * packet = (SceNetAdhocctlConnectPacketC2S *)user->rx;
+	// Receive Data from User
+	int recvresult = (int)recv(user->stream, (char*)user->rx + user->rxpos, sizeof(user->rx) - user->rxpos, MSG_NOSIGNAL);
 
-							// Clone Group Name
-							SceNetAdhocctlGroupName group = packet->group;
+	// Connection Closed
+	if(recvresult == 0 || (recvresult == -1 && errno != EAGAIN && errno != EWOULDBLOCK))
+	{
+		// Logout User
+		logout_user(user);
+		return;
+	}
 
-							// Remove Packet from RX Buffer
-							clear_user_rxbuf(user, sizeof(SceNetAdhocctlConnectPacketC2S));
+	// Nothing new
+	if(recvresult <= 0) return;
 
-							// Change Game Group
-							connect_user(user, &group);
-						}
-					}
+	// Move RX Pointer
+	user->rxpos += recvresult;
 
-					// Group Disconnect Packet
-					else if(user->rx[0] == OPCODE_DISCONNECT)
-					{
-						// Remove Packet from RX Buffer
-						clear_user_rxbuf(user, 1);
+	// Update Death Clock
+	user->last_recv = time(NULL);
 
-						// Leave Game Group
-						disconnect_user(user);
-					}
+	// Drain every complete Packet, the old Polling Loop only handled one per 10ms Tick
+	while(user->rxpos > 0 && process_user_packet(user))
+	{
+		// User got logged out by the Packet Handler
+		auto it = _db_user_by_stream.find(fd);
+		if(it == _db_user_by_stream.end() || it->second != user) return;
+	}
+}
 
-					// Network Scan Packet
-					else if(user->rx[0] == OPCODE_SCAN)
-					{
-						// Remove Packet from RX Buffer
-						clear_user_rxbuf(user, 1);
+/**
+ * Logout Users that stopped talking to us
+ */
+static void logout_timed_out_users()
+{
+	SceNetAdhocctlUserNode * user = _db_user;
+	while(user != NULL)
+	{
+		// Next User (for safe delete)
+		SceNetAdhocctlUserNode * next = user->next;
 
-						// Send Network List
-						send_scan_results(user);
-					}
+		// Timed Out
+		if(get_user_state(user) == USER_STATE_TIMED_OUT) logout_user(user);
 
-					// Chat Text Packet
-					else if(user->rx[0] == OPCODE_CHAT)
-					{
-						// Enough Data available
-						if(user->rxpos >= sizeof(SceNetAdhocctlChatPacketC2S))
-						{
-							// Cast Packet
-							SceNetAdhocctlChatPacketC2S * packet = (SceNetAdhocctlChatPacketC2S *)user->rx;
+		// Move Pointer
+		user = next;
+	}
+}
+
+/**
+ * Server Main Loop
+ * @param server Server Listening Socket
+ * @return OS Error Code
+ */
+int server_loop(int server)
+{
+	// Set Running Status
+	//_status = 1;
+	adhocServerRunning = true;
+
+	// Create Empty Status Logfile
+	write_status();
 
-							// Clone Buffer for Message
-							char message[64];
-							memset(message, 0, sizeof(message));
-							strncpy(message, packet->message, sizeof(message) - 1);
+#ifdef ADHOC_SERVER_USE_EPOLL
+	// Create Event Queue (falls back to poll on failure)
+	_event_fd = epoll_create1(EPOLL_CLOEXEC);
+	if(_event_fd == -1) WARN_LOG(Log::sceNet, "AdhocServer: epoll_create1 failed (Socket error %d), falling back to poll", errno);
+#endif
 
-							// Remove Packet from RX Buffer
-							clear_user_rxbuf(user, sizeof(SceNetAdhocctlChatPacketC2S));
+	// Wait for Login Requests
+	watch_socket(server);
 
-							// Spread Chat Message
-							spread_message(user, message);
-						}
-					}
+	// Ready Sockets
+	std::vector<int> ready;
 
-					// Invalid Opcode
-					else
-					{
-						// Notify User
-						WARN_LOG(Log::sceNet, "AdhocServer: Invalid Opcode 0x%02X in Logged-In State from %s (MAC: %s - IP: %s)", user->rx[0], (char *)user->resolver.name.data, mac2str(&user->resolver.mac).c_str(), ip2str(*(in_addr*)&user->resolver.ip).c_str());
+	// Next Timeout Check
+	time_t next_sweep = time(NULL) + 1;
 
-						// Logout User
-						logout_user(user);
-					}
-				}
+	// Handling Loop
+	while (adhocServerRunning) //(_status == 1)
+	{
+		// Sleep until a Socket has Data or the Timeout passed
+		wait_for_events(server, SERVER_POLL_TIMEOUT, ready);
+
+		for(int fd : ready)
+		{
+			// Login Requests
+			if(fd == server)
+			{
+				accept_logins(server);
+				continue;
 			}
 
-			// Move Pointer
-			user = next;
+			// Receive Data from User (Socket might be gone if the User got dropped earlier in this Batch)
+			auto it = _db_user_by_stream.find(fd);
+			if(it != _db_user_by_stream.end()) receive_user_data(it->second);
 		}
 
-		// Prevent needless CPU Overload (1ms Sleep)
-		// !!!! COMMENT NOT REFLECTING REALITY
-		sleep_ms(10, "pro-adhoc-poll");
+		// Timeout resolution is one second anyway
+		time_t now = time(NULL);
+		if(now >= next_sweep)
+		{
+			logout_timed_out_users();
+			next_sweep = now + 1;
+		}
+
+		// Write Status Logfile at most once per Interval
+		flush_status(false);
 
 		// Don't do anything if it's paused, otherwise the log will be flooded
 		while (adhocServerRunning && Core_IsStepping() && coreState != CORE_POWERDOWN)
@@ -2092,9 +2378,19 @@ int server_loop(int server)
 	// Free User Database Memory
 	free_database();
 
+	// Write final Status
+	flush_status(true);
+
 	// Close Server Socket
+	unwatch_socket(server);
 	closesocket(server);
 
+#ifdef ADHOC_SERVER_USE_EPOLL
+	// Close Event Queue
+	if(_event_fd != -1) close(_event_fd);
+	_event_fd = -1;
+#endif
+
 	// Return Success
 	return 0;
 }
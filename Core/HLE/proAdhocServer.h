@@ -39,6 +39,12 @@
 // Server User Timeout (in seconds)
 #define SERVER_USER_TIMEOUT 15
 
+// Server Event Wait Timeout (in milliseconds, only bounds Shutdown / Timeout Sweep latency)
+#define SERVER_POLL_TIMEOUT 100
+
+// Minimum Interval between Status Logfile Rewrites (in seconds)
+#define SERVER_STATUS_INTERVAL 1.0
+
 // Server SQLite3 Database
 #define SERVER_DATABASE "database.db"
 
@@ -371,3 +377,5 @@ int proAdhocServerThread(int port); // (int argc, char * argv[])
 //extern int _status;
 extern std::atomic<bool> adhocServerRunning;
 extern std::thread adhocServerThread;
+// Whether the server keeps SERVER_STATUS_XMLOUT up to date, set before starting it.
+extern bool adhocServerWriteStatus;
@@ -1653,7 +1653,9 @@ static u32 sceIoRmdir(const char *dirname) {
 }
 
 static u32 sceIoSync(const char *devicename, int flag) {
-	DEBUG_LOG(Log::sceIo, "UNIMPL sceIoSync(%s, %i)", devicename, flag);
+	DEBUG_LOG(Log::sceIo, "sceIoSync(%s, %i)", devicename, flag);
+	// Only the memory stick holds anything back, so no need to pick out the device.
+	pspFileSystem.Flush();
 	return 0;
 }
 
@@ -836,10 +836,13 @@ static bool InitPmp(MpegContext * ctx){
 		return false;
 	}
 
-	// initialize ctx->mediaengine->m_pFrame and ctx->mediaengine->m_pFrameRGB
+	// initialize ctx->mediaengine->m_pFrame, m_pPendingFrame and m_pFrameRGB
 	if (!mediaengine->m_pFrame){
 		mediaengine->m_pFrame = av_frame_alloc();
 	}
+	if (!mediaengine->m_pPendingFrame){
+		mediaengine->m_pPendingFrame = av_frame_alloc();
+	}
 	if (!mediaengine->m_pFrameRGB){
 		mediaengine->m_pFrameRGB = av_frame_alloc();
 	}
@@ -27,6 +27,7 @@
 // https://github.com/hrydgard/ppsspp/issues/1078
 
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <thread>
 #include <mutex>
@@ -34,10 +35,12 @@
 
 #include "Common/Profiler/Profiler.h"
 #include "Common/Thread/ThreadUtil.h"
+#include "Common/TimeUtil.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Common/Log.h"
 #include "Core/Config.h"
 #include "Core/CoreTiming.h"
+#include "Core/Debugger/MemBlockInfo.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HLE/FunctionWrappers.h"
 #include "Core/MIPS/MIPS.h"
@@ -86,9 +89,13 @@ enum SasThreadState {
 };
 struct SasThreadParams {
 	u32 outAddr;
-	u32 inAddr;
+	u32 outSize;
+	bool hasInput;
 	int leftVol;
 	int rightVol;
+	// Set while there's a mix whose output hasn't been copied to outAddr yet.
+	bool outPending;
+	double mixSeconds;
 };
 
 static std::thread *sasThread;
@@ -100,6 +107,12 @@ static volatile int sasThreadState = SasThreadState::DISABLED;
 static SasThreadParams sasThreadParams;
 static int sasMixEvent = -1;
 
+// The SAS thread never touches the input or output in PSP memory.  The input is copied in when the
+// mix is queued, and the output is copied out by the emu thread in __SasDrain().  That way PSP memory
+// changes at the same emulated time no matter how long the mix actually takes.
+static s16 sasThreadIn[PSP_SAS_MAX_GRAIN * 2];
+static s16 sasThreadOut[PSP_SAS_MAX_GRAIN * 4];
+
 int __SasThread() {
 	SetCurrentThreadName("SAS");
 
@@ -107,7 +120,9 @@ int __SasThread() {
 	while (sasThreadState != SasThreadState::DISABLED) {
 		sasWake.wait(guard);
 		if (sasThreadState == SasThreadState::QUEUED) {
-			sas->Mix(sasThreadParams.outAddr, sasThreadParams.inAddr, sasThreadParams.leftVol, sasThreadParams.rightVol);
+			double start = time_now_d();
+			sas->MixTo(sasThreadOut, sasThreadParams.hasInput ? sasThreadIn : nullptr, sasThreadParams.leftVol, sasThreadParams.rightVol);
+			sasThreadParams.mixSeconds = time_now_d() - start;
 
 			std::lock_guard<std::mutex> doneGuard(sasDoneMutex);
 			sasThreadState = SasThreadState::READY;
@@ -117,30 +132,66 @@ int __SasThread() {
 	return 0;
 }
 
+static void __SasCommitMix() {
+	sasThreadParams.outPending = false;
+	sas->mixStats.mixes++;
+	sas->mixStats.mixSeconds += sasThreadParams.mixSeconds;
+
+	u8 *outp = Memory::GetPointerWriteRange(sasThreadParams.outAddr, sasThreadParams.outSize);
+	if (outp) {
+		memcpy(outp, sasThreadOut, sasThreadParams.outSize);
+		NotifyMemInfo(MemBlockFlags::WRITE, sasThreadParams.outAddr, sasThreadParams.outSize, "SasMix");
+	}
+}
+
+// Waits for the SAS thread and hands off its output.  Must be called before anything reads or changes
+// SAS state, and is the only place the emu thread blocks on a mix.
 static void __SasDrain() {
-	std::unique_lock<std::mutex> guard(sasDoneMutex);
-	while (sasThreadState == SasThreadState::QUEUED)
-		sasDone.wait(guard);
+	if (sasThreadState == SasThreadState::QUEUED) {
+		double start = time_now_d();
+		std::unique_lock<std::mutex> guard(sasDoneMutex);
+		while (sasThreadState == SasThreadState::QUEUED)
+			sasDone.wait(guard);
+		sas->mixStats.stallSeconds += time_now_d() - start;
+	}
+	if (sasThreadParams.outPending)
+		__SasCommitMix();
 }
 
 static void __SasEnqueueMix(u32 outAddr, u32 inAddr = 0, int leftVol = 0, int rightVol = 0) {
 	if (sasThreadState == SasThreadState::DISABLED) {
 		// No thread, call it immediately.
+		double start = time_now_d();
 		sas->Mix(outAddr, inAddr, leftVol, rightVol);
+		double elapsed = time_now_d() - start;
+		sas->mixStats.mixes++;
+		sas->mixStats.mixSeconds += elapsed;
+		sas->mixStats.stallSeconds += elapsed;
 		return;
 	}
 
-	if (sasThreadState == SasThreadState::QUEUED) {
-		// Wait for the queue to drain.
-		__SasDrain();
-	}
+	// Wait for the previous mix, and write out its output.
+	__SasDrain();
 
 	// We're safe to write, since it can't be processing now anymore.
 	// No other thread enqueues.
+	const u32 grainSize = sas->GetGrainSize();
 	sasThreadParams.outAddr = outAddr;
-	sasThreadParams.inAddr = inAddr;
+	sasThreadParams.outSize = sas->GetOutputSize();
 	sasThreadParams.leftVol = leftVol;
 	sasThreadParams.rightVol = rightVol;
+	sasThreadParams.outPending = Memory::IsValidRange(outAddr, sasThreadParams.outSize);
+	if (!sasThreadParams.outPending) {
+		WARN_LOG_REPORT(Log::sceSas, "Bad SAS Mix output address: %08x, grain=%d", outAddr, grainSize);
+	}
+
+	const s16 *inp = inAddr ? (const s16 *)Memory::GetPointerRange(inAddr, 4 * grainSize) : nullptr;
+	sasThreadParams.hasInput = inp != nullptr;
+	if (inp) {
+		memcpy(sasThreadIn, inp, 4 * grainSize);
+		if (MemBlockInfoDetailed())
+			NotifyMemInfo(MemBlockFlags::READ, inAddr, grainSize * sizeof(u16) * 2, "SasMix");
+	}
 
 	// And now, notify.
 	sasWakeMutex.lock();
@@ -158,6 +209,7 @@ static void __SasDisableThread() {
 		sasThread->join();
 		delete sasThread;
 		sasThread = nullptr;
+		sasThreadParams.outPending = false;
 	}
 }
 
@@ -185,6 +237,8 @@ void __SasInit() {
 
 	sasMixEvent = CoreTiming::RegisterEvent("SasMix", sasMixFinish);
 
+	sasThreadParams.outPending = false;
+	sas->mixStats.threaded = g_Config.bSeparateSASThread;
 	if (g_Config.bSeparateSASThread) {
 		sasThreadState = SasThreadState::READY;
 		sasThread = new std::thread(__SasThread);
@@ -198,10 +252,8 @@ void __SasDoState(PointerWrap &p) {
 	if (!s)
 		return;
 
-	if (sasThreadState == SasThreadState::QUEUED) {
-		// Wait for the queue to drain.  Don't want to save the wrong stuff.
-		__SasDrain();
-	}
+	// Wait for the queue to drain, and the output to land in memory.  Don't want to save the wrong stuff.
+	__SasDrain();
 
 	DoClass(p, sas);
 
@@ -210,6 +262,7 @@ void __SasDoState(PointerWrap &p) {
 	} else {
 		sasMixEvent = -1;
 		__SasDisableThread();
+		sas->mixStats.threaded = false;
 	}
 
 	CoreTiming::RestoreRegisterEvent(sasMixEvent, "SasMix", sasMixFinish);
@@ -246,6 +299,7 @@ static u32 sceSasInit(u32 core, u32 grainSize, u32 maxVoices, u32 outputMode, u3
 	}
 	INFO_LOG(Log::sceSas, "sceSasInit(%08x, %i, %i, %i, %i)", core, grainSize, maxVoices, outputMode, sampleRate);
 
+	__SasDrain();
 	sas->SetGrainSize(grainSize);
 	// Seems like maxVoices is actually ignored for all intents and purposes.
 	sas->maxVoices = PSP_SAS_VOICES_MAX;
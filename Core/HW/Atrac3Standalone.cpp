@@ -1,5 +1,6 @@
 #include "SimpleAudioDec.h"
 #include "Common/LogReporting.h"
+#include "Common/Math/CrossSIMD.h"
 #include "ext/at3_standalone/at3_decoders.h"
 
 inline int16_t clamp16(float f) {
@@ -11,6 +12,58 @@ inline int16_t clamp16(float f) {
 		return (int)(f * 32767);
 }
 
+// Same as clamp16() on each sample, interleaving two channels if right is not null.
+static void ConvertFloatToS16(int16_t *out, const float *left, const float *right, int count) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(32767.0f);
+	auto convert8 = [&](const float *in) {
+		__m128 lo = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in), minusOne), one), scale);
+		__m128 hi = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4), minusOne), one), scale);
+		return _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+	};
+	if (right) {
+		for (; i + 8 <= count; i += 8) {
+			__m128i l = convert8(left + i);
+			__m128i r = convert8(right + i);
+			_mm_storeu_si128((__m128i *)(out + i * 2), _mm_unpacklo_epi16(l, r));
+			_mm_storeu_si128((__m128i *)(out + i * 2 + 8), _mm_unpackhi_epi16(l, r));
+		}
+	} else {
+		for (; i + 8 <= count; i += 8)
+			_mm_storeu_si128((__m128i *)(out + i), convert8(left + i));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	auto convert8 = [](const float *in) {
+		float32x4_t lo = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(in), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), 32767.0f);
+		float32x4_t hi = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + 4), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f)), 32767.0f);
+		return vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi)));
+	};
+	if (right) {
+		for (; i + 8 <= count; i += 8) {
+			int16x8x2_t lr;
+			lr.val[0] = convert8(left + i);
+			lr.val[1] = convert8(right + i);
+			vst2q_s16(out + i * 2, lr);
+		}
+	} else {
+		for (; i + 8 <= count; i += 8)
+			vst1q_s16(out + i, convert8(left + i));
+	}
+#endif
+	if (right) {
+		for (; i < count; i++) {
+			out[i * 2] = clamp16(left[i]);
+			out[i * 2 + 1] = clamp16(right[i]);
+		}
+	} else {
+		for (; i < count; i++)
+			out[i] = clamp16(left[i]);
+	}
+}
+
 // Uses our standalone AT3/AT3+ decoder derived from FFMPEG
 // Test case for ATRAC3: Mega Man Maverick Hunter X, PSP menu sound
 class Atrac3Audio : public AudioDecoder {
@@ -34,7 +87,7 @@ class Atrac3Audio : public AudioDecoder {
 			}
 		}
 		for (int i = 0; i < 2; i++) {
-			buffers_[i] = new float[4096];
+			buffers_[i] = new float[MAX_BATCH_FRAMES * 2048];
 		}
 	}
 	~Atrac3Audio() {
@@ -104,26 +157,45 @@ class Atrac3Audio : public AudioDecoder {
 				*outSamples = nb_samples;
 			}
 			if (outbuf) {
-				_dbg_assert_(outputChannels == 1 || outputChannels == 2);
-				const float *left = buffers_[0];
-				if (outputChannels == 2) {
-					// Stereo output, standard.
-					const float *right = channels_ == 2 ? buffers_[1] : buffers_[0];
-					for (int i = 0; i < nb_samples; i++) {
-						outbuf[i * 2] = clamp16(left[i]);
-						outbuf[i * 2 + 1] = clamp16(right[i]);
-					}
-				} else {
-					// Mono output, just take the left channel.
-					for (int i = 0; i < nb_samples; i++) {
-						outbuf[i] = clamp16(left[i]);
-					}
-				}
+				WriteOutput(outbuf, outputChannels, nb_samples);
 			}
 		}
 		return true;
 	}
 
+	int DecodeFrames(const uint8_t *inbuf, int inbytes, int frameCount, int outputChannels, int16_t *outbuf, int *outSamples) override {
+		if (!codecOpen_) {
+			return AudioDecoder::DecodeFrames(inbuf, inbytes, frameCount, outputChannels, outbuf, outSamples);
+		}
+		blockAlign_ = inbytes;
+
+		int frames = 0;
+		int totalSamples = 0;
+		while (frames < frameCount) {
+			int batch = std::min(frameCount - frames, (int)MAX_BATCH_FRAMES);
+			int nb_samples = 0;
+			const uint8_t *in = inbuf + frames * inbytes;
+			int result;
+			if (audioType_ == PSP_CODEC_AT3PLUS) {
+				result = atrac3p_decode_frames(at3pCtx_, buffers_, &nb_samples, in, inbytes, batch);
+			} else {
+				result = atrac3_decode_frames(at3Ctx_, buffers_, &nb_samples, in, inbytes, batch);
+			}
+			if (result <= 0)
+				break;
+			if (outbuf && nb_samples > 0) {
+				WriteOutput(outbuf + totalSamples * outputChannels, outputChannels, nb_samples);
+			}
+			frames += result / inbytes;
+			totalSamples += nb_samples;
+			if (result / inbytes < batch)
+				break;
+		}
+		if (outSamples)
+			*outSamples = totalSamples;
+		return frames;
+	}
+
 	void SetChannels(int channels) override {
 		// Hmm. ignore for now.
 	}
@@ -131,6 +203,20 @@ class Atrac3Audio : public AudioDecoder {
 	PSPAudioType GetAudioType() const override { return audioType_; }
 
 private:
+	// Frames decoded at once by DecodeFrames(), the buffers are sized for this many.
+	enum { MAX_BATCH_FRAMES = 8 };
+
+	void WriteOutput(int16_t *outbuf, int outputChannels, int nb_samples) {
+		_dbg_assert_(outputChannels == 1 || outputChannels == 2);
+		if (outputChannels == 2) {
+			// Stereo output, standard.
+			ConvertFloatToS16(outbuf, buffers_[0], channels_ == 2 ? buffers_[1] : buffers_[0], nb_samples);
+		} else {
+			// Mono output, just take the left channel.
+			ConvertFloatToS16(outbuf, buffers_[0], nullptr, nb_samples);
+		}
+	}
+
 	ATRAC3PContext *at3pCtx_ = nullptr;
 	ATRAC3Context *at3Ctx_ = nullptr;
 
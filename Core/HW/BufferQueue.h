@@ -125,6 +125,14 @@ struct BufferQueue {
 		return bytesgot;
 	}
 
+	// The first wantedsize bytes in place, or nullptr if there aren't that many or they wrap around.
+	// Only valid until the next push.
+	const unsigned char *peek_front(int wantedsize) const {
+		if (wantedsize > filled || start + wantedsize > bufQueueSize)
+			return nullptr;
+		return bufQueue + start;
+	}
+
 	void DoState(PointerWrap &p);
 
 private:
@@ -0,0 +1,140 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "Common/Log.h"
+#include "Core/Config.h"
+#include "Core/HW/DecodedAudioCache.h"
+
+struct DecodedAudioCacheEntry {
+	std::shared_ptr<const DecodedAudio> audio;
+	uint64_t lastUse;
+};
+
+static std::mutex g_cacheLock;
+static std::map<DecodedAudioKey, DecodedAudioCacheEntry> g_cache;
+static size_t g_cacheUsage = 0;
+static uint64_t g_cacheUseCounter = 0;
+
+bool DecodedAudioKey::operator <(const DecodedAudioKey &other) const {
+	return std::tie(hash, codec, loopStart, loopEnd, channels) < std::tie(other.hash, other.codec, other.loopStart, other.loopEnd, other.channels);
+}
+
+bool DecodedAudioKey::operator ==(const DecodedAudioKey &other) const {
+	return std::tie(hash, codec, loopStart, loopEnd, channels) == std::tie(other.hash, other.codec, other.loopStart, other.loopEnd, other.channels);
+}
+
+static size_t CacheBudget() {
+	return (size_t)std::max(g_Config.iDecodedAudioCacheMB, 0) * 1024 * 1024;
+}
+
+bool DecodedAudioCacheEnabled() {
+	return g_Config.iDecodedAudioCacheMB > 0;
+}
+
+void DecodedAudioCacheClear() {
+	std::lock_guard<std::mutex> guard(g_cacheLock);
+	g_cache.clear();
+	g_cacheUsage = 0;
+}
+
+static std::shared_ptr<const DecodedAudio> CacheFind(const DecodedAudioKey &key) {
+	std::lock_guard<std::mutex> guard(g_cacheLock);
+	auto it = g_cache.find(key);
+	if (it == g_cache.end())
+		return nullptr;
+	it->second.lastUse = ++g_cacheUseCounter;
+	return it->second.audio;
+}
+
+static void CacheInsert(const DecodedAudioKey &key, std::shared_ptr<const DecodedAudio> audio) {
+	const size_t budget = CacheBudget();
+	const size_t size = audio->MemoryUsage();
+	if (size > budget)
+		return;
+
+	std::lock_guard<std::mutex> guard(g_cacheLock);
+	auto existing = g_cache.find(key);
+	if (existing != g_cache.end()) {
+		g_cacheUsage -= existing->second.audio->MemoryUsage();
+		g_cache.erase(existing);
+	}
+	// Few enough tracks that a scan for the least recently used one is fine.
+	while (g_cacheUsage + size > budget && !g_cache.empty()) {
+		auto oldest = g_cache.begin();
+		for (auto it = g_cache.begin(); it != g_cache.end(); ++it) {
+			if (it->second.lastUse < oldest->second.lastUse)
+				oldest = it;
+		}
+		g_cacheUsage -= oldest->second.audio->MemoryUsage();
+		g_cache.erase(oldest);
+	}
+	g_cache[key] = DecodedAudioCacheEntry{ audio, ++g_cacheUseCounter };
+	g_cacheUsage += size;
+	DEBUG_LOG(Log::ME, "Cached %d decoded frames (%d KB, %d KB in use)", (int)audio->frames.size(), (int)(size / 1024), (int)(g_cacheUsage / 1024));
+}
+
+bool DecodedLoopCache::StartPass(const DecodedAudioKey &key) {
+	if (recording_ && !recording_->frames.empty() && key == key_) {
+		CacheInsert(key_, std::shared_ptr<const DecodedAudio>(recording_.release()));
+	}
+	Abort();
+	if (!DecodedAudioCacheEnabled()) {
+		return false;
+	}
+
+	key_ = key;
+	playing_ = CacheFind(key);
+	if (!playing_) {
+		recording_.reset(new DecodedAudio());
+	}
+	return playing_ != nullptr;
+}
+
+bool DecodedLoopCache::Abort() {
+	bool served = playing_ && nextFrame_ > 0;
+	playing_.reset();
+	recording_.reset();
+	nextFrame_ = 0;
+	return served;
+}
+
+const DecodedAudioFrame *DecodedLoopCache::PeekFrame(const int16_t **pcm) const {
+	if (!playing_ || nextFrame_ >= playing_->frames.size())
+		return nullptr;
+	const DecodedAudioFrame &frame = playing_->frames[nextFrame_];
+	*pcm = playing_->pcm.data() + frame.pcmOffset;
+	return &frame;
+}
+
+void DecodedLoopCache::RecordFrame(const int16_t *pcm, int samples, int channels, int inputBytes, uint64_t inputHash) {
+	DecodedAudio *audio = recording_.get();
+	if (!audio)
+		return;
+	size_t count = (size_t)samples * channels;
+	if (audio->MemoryUsage() + count * sizeof(int16_t) + sizeof(DecodedAudioFrame) > CacheBudget()) {
+		// Wouldn't fit anyway.
+		recording_.reset();
+		return;
+	}
+	audio->frames.push_back(DecodedAudioFrame{ audio->pcm.size(), samples, inputBytes, inputHash });
+	audio->pcm.insert(audio->pcm.end(), pcm, pcm + count);
+}
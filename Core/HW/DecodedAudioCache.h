@@ -0,0 +1,92 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Opt-in cache of decoded PCM for looping music (g_Config.iDecodedAudioCacheMB, 0 is off).
+// Games often loop the same ATRAC or MP3 track for hours. Once a whole pass over the loop has been
+// decoded, the passes after it are copied from here instead of running the decoder again.
+//
+// None of this is part of save states. The output is the same as decoding, and a context that stops
+// playing from the cache re-primes its decoder like after a seek.
+
+struct DecodedAudioKey {
+	// Of the source data the pass decodes. Streamed sources can't know it up front and use 0, their
+	// frames carry a hash of their own input instead.
+	uint64_t hash;
+	uint32_t codec;
+	int64_t loopStart;
+	int64_t loopEnd;
+	int channels;
+
+	bool operator <(const DecodedAudioKey &other) const;
+	bool operator ==(const DecodedAudioKey &other) const;
+};
+
+struct DecodedAudioFrame {
+	// Into DecodedAudio::pcm, in int16_t units.
+	size_t pcmOffset;
+	// Per channel.
+	int samples;
+	int inputBytes;
+	uint64_t inputHash;
+};
+
+struct DecodedAudio {
+	std::vector<int16_t> pcm;
+	std::vector<DecodedAudioFrame> frames;
+
+	size_t MemoryUsage() const {
+		return pcm.size() * sizeof(int16_t) + frames.size() * sizeof(DecodedAudioFrame);
+	}
+};
+
+bool DecodedAudioCacheEnabled();
+void DecodedAudioCacheClear();
+
+// A context's passes over its loop. Each pass either records the frames it decodes, or plays back a
+// previous recording of the same pass.
+class DecodedLoopCache {
+public:
+	// Call at the loop point, before the first frame of the pass. Commits the pass that just ended if
+	// it was recorded in full and with the same key. Returns true if this pass plays from the cache.
+	bool StartPass(const DecodedAudioKey &key);
+	// Ends the pass without committing anything, for seeks and anything else unexpected.
+	// Returns true if frames were served from the cache, so the decoder fell behind.
+	bool Abort();
+
+	bool Playing() const { return playing_ != nullptr; }
+	bool Recording() const { return recording_ != nullptr; }
+
+	// While playing. Returns nullptr when the recording has run out.
+	const DecodedAudioFrame *PeekFrame(const int16_t **pcm) const;
+	void NextFrame() { nextFrame_++; }
+
+	// While recording. Gives up on the pass if it gets too large for the cache.
+	void RecordFrame(const int16_t *pcm, int samples, int channels, int inputBytes, uint64_t inputHash);
+
+private:
+	DecodedAudioKey key_{};
+	std::shared_ptr<const DecodedAudio> playing_;
+	std::unique_ptr<DecodedAudio> recording_;
+	size_t nextFrame_ = 0;
+};
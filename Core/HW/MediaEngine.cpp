@@ -30,6 +30,7 @@
 #include "Core/HW/SimpleAudioDec.h"
 
 #include <algorithm>
+#include <cstring>
 
 #ifdef _M_SSE
 #include <emmintrin.h>
@@ -361,6 +362,8 @@ void MediaEngine::closeContext()
 		av_frame_free(&m_pFrameRGB);
 	if (m_pFrame)
 		av_frame_free(&m_pFrame);
+	if (m_pPendingFrame)
+		av_frame_free(&m_pPendingFrame);
 	if (m_pIOContext && m_pIOContext->buffer)
 		av_free(m_pIOContext->buffer);
 	if (m_pIOContext)
@@ -385,6 +388,7 @@ void MediaEngine::closeContext()
 	m_pIOContext = nullptr;
 #endif
 	m_buffer = nullptr;
+	m_framePending = false;
 }
 
 bool MediaEngine::loadStream(const u8 *buffer, int readSize, int RingbufferSize)
@@ -551,7 +555,10 @@ bool MediaEngine::setVideoStream(int streamNum, bool force) {
 
 		AVDictionary *opt = nullptr;
 		// Allow ffmpeg to use any number of threads it wants.  Without this, it doesn't use threads.
+		// Only slice threading actually happens: frame threading keeps frames in flight, which LOW_DELAY
+		// rules out, and each sceMpegAvcDecode needs to consume just its own frame's data from the ringbuffer.
 		av_dict_set(&opt, "threads", "0", 0);
+		av_dict_set(&opt, "thread_type", "slice", 0);
 		int openResult = avcodec_open2(m_pCodecCtx, pCodec, &opt);
 		av_dict_free(&opt);
 		if (openResult < 0) {
@@ -590,6 +597,9 @@ bool MediaEngine::setVideoDim(int width, int height)
 	if (!m_pFrame) {
 		m_pFrame = av_frame_alloc();
 	}
+	if (!m_pPendingFrame) {
+		m_pPendingFrame = av_frame_alloc();
+	}
 
 	sws_freeContext(m_sws_ctx);
 	m_sws_ctx = nullptr;
@@ -658,6 +668,31 @@ void MediaEngine::updateSwsFormat(int videoPixelMode) {
 #endif
 }
 
+#ifdef USE_FFMPEG
+bool MediaEngine::canConvertDirectly(const AVCodecContext *codecCtx) const {
+	// Only the PSP's own format, swscale handles anything else (and any scaling.)
+	if (m_pFrame->format != AV_PIX_FMT_YUV420P && m_pFrame->format != AV_PIX_FMT_YUVJ420P)
+		return false;
+	if (m_pFrame->width != m_desWidth || m_pFrame->height != m_desHeight)
+		return false;
+	return codecCtx->width == m_desWidth && codecCtx->height == m_desHeight;
+}
+#endif
+
+void MediaEngine::convertPendingFrame() {
+#ifdef USE_FFMPEG
+	if (!m_framePending)
+		return;
+	m_framePending = false;
+	if (!m_pPendingFrame || !m_pFrameRGB)
+		return;
+
+	m_pFrameRGB->linesize[0] = getPixelFormatBytes(m_framePendingMode) * m_desWidth;
+	ConvertYUV420ToPSPFormat(m_pFrameRGB->data[0], m_pFrameRGB->linesize[0], m_pPendingFrame->data[0], m_pPendingFrame->linesize[0],
+		m_pPendingFrame->data[1], m_pPendingFrame->data[2], m_pPendingFrame->linesize[1], m_desWidth, m_desHeight, m_framePendingMode);
+#endif
+}
+
 bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 #ifdef USE_FFMPEG
 	auto codecIter = m_pCodecCtxs.find(m_videoStream);
@@ -709,13 +744,25 @@ bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 					setVideoDim();
 				}
 				if (m_pFrameRGB && !skipFrame) {
-					updateSwsFormat(videoPixelMode);
-					// TODO: Technically we could set this to frameWidth instead of m_desWidth for better perf.
-					// Update the linesize for the new format too.  We started with the largest size, so it should fit.
-					m_pFrameRGB->linesize[0] = getPixelFormatBytes(videoPixelMode) * m_desWidth;
+					// The previous frame is replaced either way, so it never needs converting now.
+					// Only setVideoDim() and the PMP setup allocate the pending frame, so it may be missing.
+					if (m_pPendingFrame)
+						av_frame_unref(m_pPendingFrame);
+					m_framePending = false;
+					if (m_pPendingFrame && canConvertDirectly(m_pCodecCtx) && av_frame_ref(m_pPendingFrame, m_pFrame) >= 0) {
+						// Converted when the game asks for the image, straight into its buffer if possible.
+						// Holding a reference keeps it valid while skipped frames are decoded into m_pFrame.
+						m_framePending = true;
+						m_framePendingMode = videoPixelMode;
+					} else {
+						updateSwsFormat(videoPixelMode);
+						// TODO: Technically we could set this to frameWidth instead of m_desWidth for better perf.
+						// Update the linesize for the new format too.  We started with the largest size, so it should fit.
+						m_pFrameRGB->linesize[0] = getPixelFormatBytes(videoPixelMode) * m_desWidth;
 
-					sws_scale(m_sws_ctx, m_pFrame->data, m_pFrame->linesize, 0,
-						m_pCodecCtx->height, m_pFrameRGB->data, m_pFrameRGB->linesize);
+						sws_scale(m_sws_ctx, m_pFrame->data, m_pFrame->linesize, 0,
+							m_pCodecCtx->height, m_pFrameRGB->data, m_pFrameRGB->linesize);
+					}
 				}
 
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(55, 58, 100)
@@ -765,6 +812,187 @@ bool MediaEngine::stepVideo(int videoPixelMode, bool skipFrame) {
 #endif // USE_FFMPEG
 }
 
+// BT.601 limited range to RGB in 13-bit fixed point, matching what swscale does with the ranges
+// forced to 0 in updateSwsFormat().  Chroma is nearest, like the unscaled swscale paths.
+enum {
+	YUV_Y = 9539,    // 1.164
+	YUV_VR = 13074,  // 1.596
+	YUV_UG = -3209,  // -0.392
+	YUV_VG = -6660,  // -0.813
+	YUV_UB = 16525,  // 2.017
+	YUV_ROUND = 1 << 12,
+};
+
+static inline u8 ClampYUVComponent(int v) {
+	return v < 0 ? 0 : (v > 255 ? 255 : (u8)v);
+}
+
+static inline u32 YUVToPSPPixel(int y, int u, int v, int videoPixelMode) {
+	int yterm = YUV_Y * (y - 16) + YUV_ROUND;
+	u32 r = ClampYUVComponent((yterm + YUV_VR * (v - 128)) >> 13);
+	u32 g = ClampYUVComponent((yterm + YUV_UG * (u - 128) + YUV_VG * (v - 128)) >> 13);
+	u32 b = ClampYUVComponent((yterm + YUV_UB * (u - 128)) >> 13);
+	// Alpha is left at 0, like writeVideoImage() does.
+	switch (videoPixelMode) {
+	case GE_CMODE_16BIT_BGR5650:
+		return (r >> 3) | ((g >> 2) << 5) | ((b >> 3) << 11);
+	case GE_CMODE_16BIT_ABGR5551:
+		return (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10);
+	case GE_CMODE_16BIT_ABGR4444:
+		return (r >> 4) | ((g >> 4) << 4) | ((b >> 4) << 8);
+	default:
+		return r | (g << 8) | (b << 16);
+	}
+}
+
+#if PPSSPP_ARCH(SSE2)
+// Returns 8 clamped values of (yterm + a * c0 + b * c1) >> 13 as 16-bit lanes.
+static inline __m128i YUVMaddComponent(__m128i ytermLo, __m128i ytermHi, __m128i uvLo, __m128i uvHi, __m128i coefs) {
+	__m128i lo = _mm_srai_epi32(_mm_add_epi32(ytermLo, _mm_madd_epi16(uvLo, coefs)), 13);
+	__m128i hi = _mm_srai_epi32(_mm_add_epi32(ytermHi, _mm_madd_epi16(uvHi, coefs)), 13);
+	// Saturate to 0-255, then back to 16 bits for the packing below.
+	__m128i packed = _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+	return _mm_unpacklo_epi8(packed, _mm_setzero_si128());
+}
+#endif
+
+void ConvertYUV420ToPSPFormat(u8 *dst, int dstStride, const u8 *srcY, int yStride, const u8 *srcU, const u8 *srcV, int uvStride, int width, int height, int videoPixelMode) {
+	const int bpp = videoPixelMode == GE_CMODE_32BIT_ABGR8888 ? 4 : 2;
+	for (int row = 0; row < height; ++row) {
+		const u8 *ys = srcY + row * yStride;
+		const u8 *us = srcU + (row >> 1) * uvStride;
+		const u8 *vs = srcV + (row >> 1) * uvStride;
+		u8 *d = dst + row * dstStride;
+		int x = 0;
+
+#if PPSSPP_ARCH(SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i yCoefs = _mm_set1_epi32((YUV_ROUND << 16) | YUV_Y);
+		const __m128i yBias = _mm_set1_epi32(0x00010000 | (u16)-16);
+		const __m128i uvBias = _mm_set1_epi16(-128);
+		const __m128i rCoefs = _mm_set1_epi32((u32)YUV_VR << 16);
+		const __m128i gCoefs = _mm_set1_epi32(((u32)(u16)YUV_VG << 16) | (u16)YUV_UG);
+		const __m128i bCoefs = _mm_set1_epi32((u16)YUV_UB);
+		for (; x + 8 <= width; x += 8) {
+			__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ys + x)), zero);
+			u32 u4, v4;
+			memcpy(&u4, us + (x >> 1), 4);
+			memcpy(&v4, vs + (x >> 1), 4);
+			__m128i u = _mm_add_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero), uvBias);
+			__m128i v = _mm_add_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero), uvBias);
+			// Each chroma sample covers two pixels.
+			u = _mm_unpacklo_epi16(u, u);
+			v = _mm_unpacklo_epi16(v, v);
+
+			// Pairs of (y - 16, 1) so one madd gives the luma term plus rounding.
+			__m128i ytermLo = _mm_madd_epi16(_mm_add_epi16(_mm_unpacklo_epi16(y, zero), yBias), yCoefs);
+			__m128i ytermHi = _mm_madd_epi16(_mm_add_epi16(_mm_unpackhi_epi16(y, zero), yBias), yCoefs);
+			__m128i uvLo = _mm_unpacklo_epi16(u, v);
+			__m128i uvHi = _mm_unpackhi_epi16(u, v);
+
+			__m128i r = YUVMaddComponent(ytermLo, ytermHi, uvLo, uvHi, rCoefs);
+			__m128i g = YUVMaddComponent(ytermLo, ytermHi, uvLo, uvHi, gCoefs);
+			__m128i b = YUVMaddComponent(ytermLo, ytermHi, uvLo, uvHi, bCoefs);
+
+			switch (videoPixelMode) {
+			case GE_CMODE_32BIT_ABGR8888:
+			{
+				__m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+				_mm_storeu_si128((__m128i *)(d + x * 4), _mm_unpacklo_epi16(rg, b));
+				_mm_storeu_si128((__m128i *)(d + x * 4 + 16), _mm_unpackhi_epi16(rg, b));
+				break;
+			}
+			case GE_CMODE_16BIT_BGR5650:
+			{
+				__m128i pix = _mm_or_si128(_mm_srli_epi16(r, 3), _mm_slli_epi16(_mm_srli_epi16(g, 2), 5));
+				pix = _mm_or_si128(pix, _mm_slli_epi16(_mm_srli_epi16(b, 3), 11));
+				_mm_storeu_si128((__m128i *)(d + x * 2), pix);
+				break;
+			}
+			case GE_CMODE_16BIT_ABGR5551:
+			{
+				__m128i pix = _mm_or_si128(_mm_srli_epi16(r, 3), _mm_slli_epi16(_mm_srli_epi16(g, 3), 5));
+				pix = _mm_or_si128(pix, _mm_slli_epi16(_mm_srli_epi16(b, 3), 10));
+				_mm_storeu_si128((__m128i *)(d + x * 2), pix);
+				break;
+			}
+			case GE_CMODE_16BIT_ABGR4444:
+			{
+				__m128i pix = _mm_or_si128(_mm_srli_epi16(r, 4), _mm_slli_epi16(_mm_srli_epi16(g, 4), 4));
+				pix = _mm_or_si128(pix, _mm_slli_epi16(_mm_srli_epi16(b, 4), 8));
+				_mm_storeu_si128((__m128i *)(d + x * 2), pix);
+				break;
+			}
+			}
+		}
+#elif PPSSPP_ARCH(ARM_NEON)
+		for (; x + 8 <= width; x += 8) {
+			int16x8_t y = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ys + x))), vdupq_n_s16(16));
+			u32 u4, v4;
+			memcpy(&u4, us + (x >> 1), 4);
+			memcpy(&v4, vs + (x >> 1), 4);
+			// Each chroma sample covers two pixels.
+			uint8x8x2_t uz = vzip_u8(vreinterpret_u8_u32(vdup_n_u32(u4)), vreinterpret_u8_u32(vdup_n_u32(u4)));
+			uint8x8x2_t vz = vzip_u8(vreinterpret_u8_u32(vdup_n_u32(v4)), vreinterpret_u8_u32(vdup_n_u32(v4)));
+			int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(uz.val[0])), vdupq_n_s16(128));
+			int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vz.val[0])), vdupq_n_s16(128));
+
+			int32x4_t ytermLo = vmlal_n_s16(vdupq_n_s32(YUV_ROUND), vget_low_s16(y), YUV_Y);
+			int32x4_t ytermHi = vmlal_n_s16(vdupq_n_s32(YUV_ROUND), vget_high_s16(y), YUV_Y);
+
+			int32x4_t rLo = vmlal_n_s16(ytermLo, vget_low_s16(v), YUV_VR);
+			int32x4_t rHi = vmlal_n_s16(ytermHi, vget_high_s16(v), YUV_VR);
+			int32x4_t gLo = vmlal_n_s16(vmlal_n_s16(ytermLo, vget_low_s16(u), YUV_UG), vget_low_s16(v), YUV_VG);
+			int32x4_t gHi = vmlal_n_s16(vmlal_n_s16(ytermHi, vget_high_s16(u), YUV_UG), vget_high_s16(v), YUV_VG);
+			int32x4_t bLo = vmlal_n_s16(ytermLo, vget_low_s16(u), YUV_UB);
+			int32x4_t bHi = vmlal_n_s16(ytermHi, vget_high_s16(u), YUV_UB);
+
+			uint8x8_t r = vqmovun_s16(vcombine_s16(vqshrn_n_s32(rLo, 13), vqshrn_n_s32(rHi, 13)));
+			uint8x8_t g = vqmovun_s16(vcombine_s16(vqshrn_n_s32(gLo, 13), vqshrn_n_s32(gHi, 13)));
+			uint8x8_t b = vqmovun_s16(vcombine_s16(vqshrn_n_s32(bLo, 13), vqshrn_n_s32(bHi, 13)));
+
+			switch (videoPixelMode) {
+			case GE_CMODE_32BIT_ABGR8888:
+			{
+				uint8x8x4_t pix = { { r, g, b, vdup_n_u8(0) } };
+				vst4_u8(d + x * 4, pix);
+				break;
+			}
+			case GE_CMODE_16BIT_BGR5650:
+			{
+				uint16x8_t pix = vorrq_u16(vshrq_n_u16(vmovl_u8(r), 3), vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 2)), 5));
+				pix = vorrq_u16(pix, vshlq_n_u16(vmovl_u8(vshr_n_u8(b, 3)), 11));
+				vst1q_u16((u16 *)(d + x * 2), pix);
+				break;
+			}
+			case GE_CMODE_16BIT_ABGR5551:
+			{
+				uint16x8_t pix = vorrq_u16(vshrq_n_u16(vmovl_u8(r), 3), vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 3)), 5));
+				pix = vorrq_u16(pix, vshlq_n_u16(vmovl_u8(vshr_n_u8(b, 3)), 10));
+				vst1q_u16((u16 *)(d + x * 2), pix);
+				break;
+			}
+			case GE_CMODE_16BIT_ABGR4444:
+			{
+				uint16x8_t pix = vorrq_u16(vshrq_n_u16(vmovl_u8(r), 4), vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 4)), 4));
+				pix = vorrq_u16(pix, vshlq_n_u16(vmovl_u8(vshr_n_u8(b, 4)), 8));
+				vst1q_u16((u16 *)(d + x * 2), pix);
+				break;
+			}
+			}
+		}
+#endif
+
+		for (; x < width; ++x) {
+			u32 pixel = YUVToPSPPixel(ys[x], us[x >> 1], vs[x >> 1], videoPixelMode);
+			if (bpp == 4)
+				memcpy(d + x * 4, &pixel, 4);
+			else
+				memcpy(d + x * 2, &pixel, 2);
+		}
+	}
+}
+
 // Helpers that null out alpha (which seems to be the case on the PSP.)
 // Some games depend on this, for example Sword Art Online (doesn't clear A's from buffer.)
 inline void writeVideoLineRGBA(void *destp, const void *srcp, int width) {
@@ -868,38 +1096,44 @@ int MediaEngine::writeVideoImage(u32 bufferPtr, int frameWidth, int videoPixelMo
 		imgbuf = new u8[videoImageSize];
 	}
 
-	switch (videoPixelMode) {
-	case GE_CMODE_32BIT_ABGR8888:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineRGBA(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u32);
-		}
-		break;
+	if (m_framePending && videoLineSize != 0) {
+		// Convert straight into the game's buffer, alpha is already zero.
+		ConvertYUV420ToPSPFormat(imgbuf, videoLineSize, m_pPendingFrame->data[0], m_pPendingFrame->linesize[0],
+			m_pPendingFrame->data[1], m_pPendingFrame->data[2], m_pPendingFrame->linesize[1], width, height, videoPixelMode);
+	} else {
+		switch (videoPixelMode) {
+		case GE_CMODE_32BIT_ABGR8888:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineRGBA(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u32);
+			}
+			break;
 
-	case GE_CMODE_16BIT_BGR5650:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5650(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
-		}
-		break;
+		case GE_CMODE_16BIT_BGR5650:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5650(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
 
-	case GE_CMODE_16BIT_ABGR5551:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5551(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
-		}
-		break;
+		case GE_CMODE_16BIT_ABGR5551:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5551(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
 
-	case GE_CMODE_16BIT_ABGR4444:
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR4444(imgbuf + videoLineSize * y, data, width);
-			data += width * sizeof(u16);
-		}
-		break;
+		case GE_CMODE_16BIT_ABGR4444:
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR4444(imgbuf + videoLineSize * y, data, width);
+				data += width * sizeof(u16);
+			}
+			break;
 
-	default:
-		ERROR_LOG_REPORT(Log::ME, "Unsupported video pixel format %d", videoPixelMode);
-		break;
+		default:
+			ERROR_LOG_REPORT(Log::ME, "Unsupported video pixel format %d", videoPixelMode);
+			break;
+		}
 	}
 
 	if (swizzle) {
@@ -960,46 +1194,55 @@ int MediaEngine::writeVideoImageWithRange(u32 bufferPtr, int frameWidth, int vid
 	if (height > m_desHeight - ypos)
 		height = m_desHeight - ypos;
 
-	switch (videoPixelMode) {
-	case GE_CMODE_32BIT_ABGR8888:
-		data += (ypos * m_desWidth + xpos) * sizeof(u32);
-		for (int y = 0; y < height; y++) {
-			writeVideoLineRGBA(imgbuf, data, width);
-			data += m_desWidth * sizeof(u32);
-			imgbuf += videoLineSize;
-		}
-		break;
-
-	case GE_CMODE_16BIT_BGR5650:
-		data += (ypos * m_desWidth + xpos) * sizeof(u16);
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5650(imgbuf, data, width);
-			data += m_desWidth * sizeof(u16);
-			imgbuf += videoLineSize;
-		}
-		break;
-
-	case GE_CMODE_16BIT_ABGR5551:
-		data += (ypos * m_desWidth + xpos) * sizeof(u16);
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR5551(imgbuf, data, width);
-			data += m_desWidth * sizeof(u16);
-			imgbuf += videoLineSize;
-		}
-		break;
+	if (m_framePending && videoLineSize != 0 && (xpos & 1) == 0 && (ypos & 1) == 0 && width > 0 && height > 0) {
+		// Convert straight from the decoded frame, alpha is already zero.
+		const AVFrame *frame = m_pPendingFrame;
+		const int uvOffset = (ypos / 2) * frame->linesize[1] + xpos / 2;
+		ConvertYUV420ToPSPFormat(imgbuf, videoLineSize, frame->data[0] + ypos * frame->linesize[0] + xpos, frame->linesize[0],
+			frame->data[1] + uvOffset, frame->data[2] + uvOffset, frame->linesize[1], width, height, videoPixelMode);
+	} else {
+		convertPendingFrame();
+		switch (videoPixelMode) {
+		case GE_CMODE_32BIT_ABGR8888:
+			data += (ypos * m_desWidth + xpos) * sizeof(u32);
+			for (int y = 0; y < height; y++) {
+				writeVideoLineRGBA(imgbuf, data, width);
+				data += m_desWidth * sizeof(u32);
+				imgbuf += videoLineSize;
+			}
+			break;
+
+		case GE_CMODE_16BIT_BGR5650:
+			data += (ypos * m_desWidth + xpos) * sizeof(u16);
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5650(imgbuf, data, width);
+				data += m_desWidth * sizeof(u16);
+				imgbuf += videoLineSize;
+			}
+			break;
+
+		case GE_CMODE_16BIT_ABGR5551:
+			data += (ypos * m_desWidth + xpos) * sizeof(u16);
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR5551(imgbuf, data, width);
+				data += m_desWidth * sizeof(u16);
+				imgbuf += videoLineSize;
+			}
+			break;
+
+		case GE_CMODE_16BIT_ABGR4444:
+			data += (ypos * m_desWidth + xpos) * sizeof(u16);
+			for (int y = 0; y < height; y++) {
+				writeVideoLineABGR4444(imgbuf, data, width);
+				data += m_desWidth * sizeof(u16);
+				imgbuf += videoLineSize;
+			}
+			break;
 
-	case GE_CMODE_16BIT_ABGR4444:
-		data += (ypos * m_desWidth + xpos) * sizeof(u16);
-		for (int y = 0; y < height; y++) {
-			writeVideoLineABGR4444(imgbuf, data, width);
-			data += m_desWidth * sizeof(u16);
-			imgbuf += videoLineSize;
+		default:
+			ERROR_LOG_REPORT(Log::ME, "Unsupported video pixel format %d", videoPixelMode);
+			break;
 		}
-		break;
-
-	default:
-		ERROR_LOG_REPORT(Log::ME, "Unsupported video pixel format %d", videoPixelMode);
-		break;
 	}
 
 	if (swizzle) {
@@ -1022,6 +1265,7 @@ int MediaEngine::writeVideoImageWithRange(u32 bufferPtr, int frameWidth, int vid
 
 u8 *MediaEngine::getFrameImage() {
 #ifdef USE_FFMPEG
+	convertPendingFrame();
 	return m_pFrameRGB->data[0];
 #else
 	return nullptr;
@@ -1043,7 +1287,7 @@ int MediaEngine::getAudioRemainSize() {
 	return m_demux->getRemainSize();
 }
 
-int MediaEngine::getNextAudioFrame(u8 **buf, int *headerCode1, int *headerCode2) {
+int MediaEngine::getNextAudioFrame(const u8 **buf, int *headerCode1, int *headerCode2) {
 	// When getting a frame, increment pts
 	m_audiopts += 4180;
 
@@ -1068,7 +1312,7 @@ int MediaEngine::getAudioSamples(u32 bufferPtr) {
 		return 0;
 	}
 
-	u8 *audioFrame = nullptr;
+	const u8 *audioFrame = nullptr;
 	int headerCode1, headerCode2;
 	int frameSize = getNextAudioFrame(&audioFrame, &headerCode1, &headerCode2);
 	if (frameSize == 0) {
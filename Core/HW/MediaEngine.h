@@ -50,6 +50,9 @@ inline s64 getMpegTimeStamp(const u8 *buf) {
 bool InitFFmpeg();
 #endif
 
+// Converts a YUV 4:2:0 picture to one of the PSP's video pixel formats (GE_CMODE_*), with zero alpha.
+void ConvertYUV420ToPSPFormat(u8 *dst, int dstStride, const u8 *srcY, int yStride, const u8 *srcU, const u8 *srcV, int uvStride, int width, int height, int videoPixelMode);
+
 class MediaEngine {
 public:
 	MediaEngine();
@@ -97,7 +100,11 @@ class MediaEngine {
 	bool SetupStreams();
 	bool setVideoDim(int width = 0, int height = 0);
 	void updateSwsFormat(int videoPixelMode);
-	int getNextAudioFrame(u8 **buf, int *headerCode1, int *headerCode2);
+#ifdef USE_FFMPEG
+	bool canConvertDirectly(const AVCodecContext *codecCtx) const;
+#endif
+	void convertPendingFrame();
+	int getNextAudioFrame(const u8 **buf, int *headerCode1, int *headerCode2);
 
 	static int MpegReadbuffer(void *opaque, uint8_t *buf, int buf_size);
 
@@ -107,6 +114,8 @@ class MediaEngine {
 	std::map<int, AVCodecContext *> m_pCodecCtxs;
 	AVFrame *m_pFrame = nullptr;
 	AVFrame *m_pFrameRGB = nullptr;
+	// A reference to the last frame shown, while it's only converted on demand.
+	AVFrame *m_pPendingFrame = nullptr;
 #endif
 
 	u8 *m_buffer = nullptr;
@@ -131,6 +140,9 @@ class MediaEngine {
 #endif
 
 	int m_sws_fmt = 0;
+	// The last frame shown is still only in m_pPendingFrame, not yet in m_pFrameRGB.
+	bool m_framePending = false;
+	int m_framePendingMode = 0;
 	int m_videoStream = -1;
 	int m_expectedVideoStreams = 0;
 
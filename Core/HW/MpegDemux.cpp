@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "Common/Serialize/SerializeFuncs.h"
+#include "Common/Math/CrossSIMD.h"
 #include "Core/HW/MpegDemux.h"
 #include "Core/Reporting.h"
 
@@ -187,6 +190,47 @@ bool MpegDemux::skipPackHeader() {
 	return true;
 }
 
+// Position of the first 00 00 01 xx start code at or after pos, with all four bytes before size.
+// Returns -1 if there is none.
+static int FindStartCode(const u8 *buf, int pos, int size) {
+	int i = pos;
+#if PPSSPP_ARCH(SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi8(1);
+	while (i + 19 <= size) {
+		__m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + i)), zero);
+		__m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + i + 1)), zero);
+		__m128i b2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(buf + i + 2)), one);
+		int mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2));
+		if (mask != 0) {
+			int bit = 0;
+			while ((mask & (1 << bit)) == 0)
+				bit++;
+			return i + bit;
+		}
+		i += 16;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t one = vdupq_n_u8(1);
+	while (i + 19 <= size) {
+		uint8x16_t b0 = vceqq_u8(vld1q_u8(buf + i), zero);
+		uint8x16_t b1 = vceqq_u8(vld1q_u8(buf + i + 1), zero);
+		uint8x16_t b2 = vceqq_u8(vld1q_u8(buf + i + 2), one);
+		uint8x16_t match = vandq_u8(vandq_u8(b0, b1), b2);
+		uint8x8_t any = vorr_u8(vget_low_u8(match), vget_high_u8(match));
+		if (vget_lane_u64(vreinterpret_u64_u8(any), 0) != 0)
+			break;
+		i += 16;
+	}
+#endif
+	for (; i + 4 <= size; i++) {
+		if (buf[i] == 0 && buf[i + 1] == 0 && buf[i + 2] == 1)
+			return i;
+	}
+	return -1;
+}
+
 bool MpegDemux::demux(int audioChannel)
 {
 	if (audioChannel >= 0)
@@ -198,8 +242,12 @@ bool MpegDemux::demux(int audioChannel)
 	{
 		// Search for start code
 		u32 startCode = 0xFF;
-		while ((startCode & PACKET_START_CODE_MASK) != PACKET_START_CODE_PREFIX && !isEOF()) {
-			startCode = (startCode << 8) | read8();
+		int codePos = FindStartCode(m_buf, m_index, m_readSize);
+		if (codePos >= 0) {
+			startCode = PACKET_START_CODE_PREFIX | m_buf[codePos + 3];
+			m_index = codePos + 4;
+		} else {
+			m_index = m_readSize;
 		}
 		// Not enough data available yet.
 		if (m_readSize - m_index < 16) {
@@ -295,7 +343,7 @@ static bool isHeader(const u8 *audioStream, int offset)
 	return (audioStream[offset] == header1) && (audioStream[offset+1] == header2);
 }
 
-static int getNextHeaderPosition(u8* audioStream, int curpos, int limit, int frameSize)
+static int getNextHeaderPosition(const u8 *audioStream, int curpos, int limit, int frameSize)
 {
 	int endScan = limit - 1;
 
@@ -311,34 +359,43 @@ static int getNextHeaderPosition(u8* audioStream, int curpos, int limit, int fra
 	return -1;
 }
 
-int MpegDemux::getNextAudioFrame(u8 **buf, int *headerCode1, int *headerCode2, s64 *pts)
+int MpegDemux::getNextAudioFrame(const u8 **buf, int *headerCode1, int *headerCode2, s64 *pts)
 {
 	int gotsize;
 	int frameSize;
 	if (!hasNextAudioFrame(&gotsize, &frameSize, headerCode1, headerCode2))
 		return 0;
-	int audioPos = 8;
-	int nextHeader = getNextHeaderPosition(m_audioFrame, audioPos, gotsize, frameSize);
-	if (nextHeader >= 0) {
-		audioPos = nextHeader;
+
+	// Usually the next header follows right after the frame, and then the frame can be used in place.
+	// Popping doesn't overwrite anything, so it stays valid until the next demux().
+	int audioPos;
+	const u8 *frame = m_audioStream.peek_front(std::min(frameSize + 2, gotsize));
+	if (frame && frameSize + 2 <= gotsize && isHeader(frame, frameSize)) {
+		audioPos = frameSize;
 	} else {
-		audioPos = gotsize;
+		m_audioStream.get_front(m_audioFrame, gotsize);
+		frame = m_audioFrame;
+		audioPos = getNextHeaderPosition(m_audioFrame, 8, gotsize, frameSize);
+		if (audioPos < 0)
+			audioPos = gotsize;
 	}
 	m_audioStream.pop_front(0, audioPos, pts);
 	if (buf) {
-		*buf = m_audioFrame + 8;
+		*buf = frame + 8;
 	}
 	return frameSize - 8;
 }
 
 bool MpegDemux::hasNextAudioFrame(int *gotsizeOut, int *frameSizeOut, int *headerCode1, int *headerCode2)
 {
-	int gotsize = m_audioStream.get_front(m_audioFrame, 0x2000);
-	if (gotsize < 4 || !isHeader(m_audioFrame, 0))
+	// Only the header is needed to know if the whole frame is there.
+	u8 header[4];
+	if (m_audioStream.get_front(header, 4) < 4 || !isHeader(header, 0))
 		return false;
-	u8 code1 = m_audioFrame[2];
-	u8 code2 = m_audioFrame[3];
+	u8 code1 = header[2];
+	u8 code2 = header[3];
 	int frameSize = (((code1 & 0x03) << 8) | (code2 * 8)) + 0x10;
+	int gotsize = std::min(m_audioStream.getQueueSize(), (int)sizeof(m_audioFrame));
 	if (frameSize > gotsize)
 		return false;
 
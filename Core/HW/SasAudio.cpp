@@ -17,6 +17,7 @@
 
 #include <algorithm>
 
+#include "Common/Math/CrossSIMD.h"
 #include "Common/Profiler/Profiler.h"
 
 #include "Common/Serialize/SerializeFuncs.h"
@@ -63,7 +64,43 @@ void VagDecoder::Start(u32 data, u32 vagSize, bool loopEnabled) {
 	s_2 = 0;
 }
 
-void VagDecoder::DecodeBlock(const u8 *&read_pointer) {
+// Expands the 28 4-bit samples after the block header to 16 bits and applies the shift. Writes 32.
+static inline void UnpackVagBlock(const u8 *block, int shift_factor, s16 *out) {
+#if PPSSPP_ARCH(SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i data = _mm_srli_si128(_mm_loadu_si128((const __m128i *)block), 2);
+	// Both nibbles to the top of their byte, low nibble (the earlier sample) first.
+	__m128i lo = _mm_slli_epi16(_mm_and_si128(data, _mm_set1_epi8(0x0F)), 4);
+	__m128i hi = _mm_and_si128(data, _mm_set1_epi8((char)0xF0));
+	__m128i first = _mm_unpacklo_epi8(lo, hi);
+	__m128i second = _mm_unpackhi_epi8(lo, hi);
+	__m128i shift = _mm_cvtsi32_si128(shift_factor);
+	_mm_storeu_si128((__m128i *)(out + 0), _mm_sra_epi16(_mm_unpacklo_epi8(zero, first), shift));
+	_mm_storeu_si128((__m128i *)(out + 8), _mm_sra_epi16(_mm_unpackhi_epi8(zero, first), shift));
+	_mm_storeu_si128((__m128i *)(out + 16), _mm_sra_epi16(_mm_unpacklo_epi8(zero, second), shift));
+	_mm_storeu_si128((__m128i *)(out + 24), _mm_sra_epi16(_mm_unpackhi_epi8(zero, second), shift));
+#elif PPSSPP_ARCH(ARM_NEON)
+	uint8x16_t data = vextq_u8(vld1q_u8(block), vdupq_n_u8(0), 2);
+	uint8x16_t lo = vshlq_n_u8(vandq_u8(data, vdupq_n_u8(0x0F)), 4);
+	uint8x16_t hi = vandq_u8(data, vdupq_n_u8(0xF0));
+	uint8x16x2_t samples = vzipq_u8(lo, hi);
+	int16x8_t shift = vdupq_n_s16(-shift_factor);
+	vst1q_s16(out + 0, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(samples.val[0]), 8)), shift));
+	vst1q_s16(out + 8, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(samples.val[0]), 8)), shift));
+	vst1q_s16(out + 16, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(samples.val[1]), 8)), shift));
+	vst1q_s16(out + 24, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(samples.val[1]), 8)), shift));
+#else
+	const u8 *data = block + 2;
+	for (int i = 0; i < 28; i += 2) {
+		u8 d = *data++;
+		out[i] = (short)((d & 0xf) << 12) >> shift_factor;
+		out[i + 1] = (short)((d & 0xf0) << 8) >> shift_factor;
+	}
+	out[28] = out[29] = out[30] = out[31] = 0;
+#endif
+}
+
+void VagDecoder::DecodeBlock(const u8 *&read_pointer, s16 *out) {
 	if (curBlock_ == numBlocks_ - 1) {
 		end_ = true;
 		return;
@@ -72,10 +109,10 @@ void VagDecoder::DecodeBlock(const u8 *&read_pointer) {
 	_dbg_assert_(curBlock_ < numBlocks_);
 
 	const u8 *readp = read_pointer;
-	int predict_nr = *readp++;
+	int predict_nr = readp[0];
 	int shift_factor = predict_nr & 0xf;
 	predict_nr >>= 4;
-	int flags = *readp++;
+	int flags = readp[1];
 	if (flags == 7) {
 		VERBOSE_LOG(Log::SasMix, "VAG ending block at %d", curBlock_);
 		end_ = true;
@@ -90,30 +127,34 @@ void VagDecoder::DecodeBlock(const u8 *&read_pointer) {
 		}
 	}
 
-	// Keep state in locals to avoid bouncing to memory.
-	int s1 = s_1;
-	int s2 = s_2;
+	alignas(16) s16 unpacked[32];
+	UnpackVagBlock(readp, shift_factor, unpacked);
 
 	int coef1 = f[predict_nr][0];
 	int coef2 = -f[predict_nr][1];
 
-	// TODO: Unroll once more and interleave the unpacking with the decoding more?
-	for (int i = 0; i < 28; i += 2) {
-		u8 d = *readp++;
-		int sample1 = (short)((d & 0xf) << 12) >> shift_factor;
-		int sample2 = (short)((d & 0xf0) << 8) >> shift_factor;
-		s2 = clamp_s16(sample1 + ((s1 * coef1 + s2 * coef2) >> 6));
-		s1 = clamp_s16(sample2 + ((s2 * coef1 + s1 * coef2) >> 6));
-		samples[i] = s2;
-		samples[i + 1] = s1;
-	}
-
-	s_1 = s1;
-	s_2 = s2;
-	curSample = 0;
-	curBlock_++;
+	if (coef1 == 0 && coef2 == 0) {
+		// No prediction, the samples are already final. Common for silence and noise.
+		memcpy(out, unpacked, 28 * sizeof(s16));
+		s_1 = unpacked[27];
+		s_2 = unpacked[26];
+	} else {
+		// Each sample depends on the two before it, so this part stays serial.
+		// Keep state in locals to avoid bouncing to memory.
+		int s1 = s_1;
+		int s2 = s_2;
+		for (int i = 0; i < 28; i += 2) {
+			s2 = clamp_s16(unpacked[i] + ((s1 * coef1 + s2 * coef2) >> 6));
+			s1 = clamp_s16(unpacked[i + 1] + ((s2 * coef1 + s1 * coef2) >> 6));
+			out[i] = s2;
+			out[i + 1] = s1;
+		}
+		s_1 = s1;
+		s_2 = s2;
+	}
 
-	read_pointer = readp;
+	curBlock_++;
+	read_pointer = readp + 16;
 }
 
 void VagDecoder::GetSamples(s16 *outSamples, int numSamples) {
@@ -129,7 +170,8 @@ void VagDecoder::GetSamples(s16 *outSamples, int numSamples) {
 	const u8 *readp = Memory::GetPointerUnchecked(read_);
 	const u8 *origp = readp;
 
-	for (int i = 0; i < numSamples; i++) {
+	int i = 0;
+	while (i < numSamples) {
 		if (curSample == 28) {
 			if (loopAtNextBlock_) {
 				VERBOSE_LOG(Log::SasMix, "Looping VAG from block %d/%d to %d", curBlock_, numBlocks_, loopStartBlock_);
@@ -140,15 +182,26 @@ void VagDecoder::GetSamples(s16 *outSamples, int numSamples) {
 				curBlock_ = loopStartBlock_;
 				loopAtNextBlock_ = false;
 			}
-			DecodeBlock(readp);
+			// Whole blocks are decoded straight into the output, only partial ones go through samples.
+			bool direct = numSamples - i >= 28;
+			DecodeBlock(readp, direct ? &outSamples[i] : samples);
 			if (end_) {
 				// Clear the rest of the buffer and return.
 				memset(&outSamples[i], 0, (numSamples - i) * sizeof(s16));
 				return;
 			}
+			if (direct) {
+				i += 28;
+				continue;
+			}
+			curSample = 0;
 		}
 		_dbg_assert_(curSample < 28);
-		outSamples[i] = samples[curSample++];
+		// Copy out as much of the decoded block as we can at once.
+		int count = std::min(numSamples - i, 28 - curSample);
+		memcpy(&outSamples[i], &samples[curSample], count * sizeof(s16));
+		curSample += count;
+		i += count;
 	}
 
 	if (readp > origp) {
@@ -406,11 +459,17 @@ void SasInstance::GetDebugText(char *text, size_t bufsize) {
 		}
 	}
 
+	// On the SAS thread, whatever part of the mix the emu thread didn't wait for ran in parallel.
+	const int mixes = std::max(mixStats.mixes, 1);
+	const double overlapSeconds = std::max(mixStats.mixSeconds - mixStats.stallSeconds, 0.0);
 	snprintf(text, bufsize,
 		"SR: %d Mode: %s Grain: %d\n"
+		"Mix: %s, %d grains, avg %0.1f us, stall avg %0.1f us, overlap %d%%\n"
 		"Effect: Type: %d Dry: %d Wet: %d L: %d R: %d Delay: %d Feedback: %d\n"
 		"\n%s\n",
 		sampleRate, outputMode == PSP_SAS_OUTPUTMODE_RAW ? "Raw" : "Mixed", grainSize,
+		mixStats.threaded ? "threaded" : "inline", mixStats.mixes, mixStats.mixSeconds * 1000000.0 / mixes, mixStats.stallSeconds * 1000000.0 / mixes,
+		mixStats.mixSeconds > 0.0 ? (int)(overlapSeconds * 100.0 / mixStats.mixSeconds) : 0,
 		waveformEffect.type, waveformEffect.isDryOn, waveformEffect.isWetOn, waveformEffect.leftVol, waveformEffect.rightVol, waveformEffect.delay, waveformEffect.feedback,
 		voiceBuf);
 
@@ -520,6 +579,155 @@ bool SasVoice::HaveSamplesEnded() const {
 	}
 }
 
+static inline bool VolumeFitsS16(int vol) {
+	return vol >= -0x8000 && vol <= 0x7FFF;
+}
+
+// Resamples src at the given pitch with linear interpolation, and scales by the envelope.
+// Expects envelope values in 0 - 0x8000, so that the results fit in 16 bits.
+// Returns the new sampleFrac.
+static u32 ResampleVoice(s16 *out, const s16 *src, u32 sampleFrac, int pitch, bool needsInterp, const int *envelope, int count) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	const __m128i round = _mm_set1_epi32(1 << 14);
+	if (!needsInterp) {
+		// Pitch is exactly 1:1 and we're on a whole sample, so it's a straight copy.
+		const s16 *s = src + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		for (; i + 4 <= count; i += 4) {
+			__m128i samples = _mm_loadl_epi64((const __m128i *)(s + i));
+			__m128i env = _mm_loadu_si128((const __m128i *)(envelope + i));
+			// Split the envelope into two halves that fit in 16 bits, so madd gives sample * env exactly.
+			__m128i envHalf = _mm_srli_epi32(env, 1);
+			__m128i envPairs = _mm_or_si128(envHalf, _mm_slli_epi32(_mm_sub_epi32(env, envHalf), 16));
+			__m128i scaled = _mm_madd_epi16(_mm_unpacklo_epi16(samples, samples), envPairs);
+			scaled = _mm_srai_epi32(_mm_add_epi32(scaled, round), 15);
+			_mm_storel_epi64((__m128i *)(out + i), _mm_packs_epi32(scaled, scaled));
+		}
+		sampleFrac += i * PSP_SAS_PITCH_BASE;
+	} else {
+		const __m128i mask = _mm_set1_epi32(PSP_SAS_PITCH_MASK);
+		const __m128i lowWord = _mm_set1_epi32(0xFFFF);
+		__m128i fracs = _mm_add_epi32(_mm_set1_epi32(sampleFrac), _mm_set_epi32(pitch * 3, pitch * 2, pitch, 0));
+		const __m128i step = _mm_set1_epi32(pitch * 4);
+		for (; i + 4 <= count; i += 4) {
+			// Each pair of neighbouring samples is a single 32-bit load.
+			u32 p0, p1, p2, p3;
+			memcpy(&p0, src + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+			memcpy(&p1, src + ((sampleFrac + pitch) >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+			memcpy(&p2, src + ((sampleFrac + pitch * 2) >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+			memcpy(&p3, src + ((sampleFrac + pitch * 3) >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+			sampleFrac += pitch * 4;
+			__m128i pairs = _mm_set_epi32(p3, p2, p1, p0);
+
+			__m128i f = _mm_and_si128(fracs, mask);
+			__m128i weights = _mm_or_si128(_mm_sub_epi32(mask, f), _mm_slli_epi32(f, 16));
+			fracs = _mm_add_epi32(fracs, step);
+			__m128i sample = _mm_srai_epi32(_mm_madd_epi16(pairs, weights), PSP_SAS_PITCH_BASE_SHIFT);
+
+			__m128i env = _mm_loadu_si128((const __m128i *)(envelope + i));
+			__m128i envHalf = _mm_srli_epi32(env, 1);
+			__m128i envPairs = _mm_or_si128(envHalf, _mm_slli_epi32(_mm_sub_epi32(env, envHalf), 16));
+			__m128i sampleDup = _mm_or_si128(_mm_and_si128(sample, lowWord), _mm_slli_epi32(sample, 16));
+			__m128i scaled = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(sampleDup, envPairs), round), 15);
+			_mm_storel_epi64((__m128i *)(out + i), _mm_packs_epi32(scaled, scaled));
+		}
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int32x4_t round = vdupq_n_s32(1 << 14);
+	if (!needsInterp) {
+		const s16 *s = src + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		for (; i + 4 <= count; i += 4) {
+			int32x4_t sample = vmovl_s16(vld1_s16(s + i));
+			int32x4_t scaled = vshrq_n_s32(vaddq_s32(vmulq_s32(sample, vld1q_s32(envelope + i)), round), 15);
+			vst1_s16(out + i, vmovn_s32(scaled));
+		}
+		sampleFrac += i * PSP_SAS_PITCH_BASE;
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			alignas(16) s16 s0[4], s1[4], w0[4], w1[4];
+			for (int j = 0; j < 4; j++) {
+				const s16 *s = src + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+				int f = sampleFrac & PSP_SAS_PITCH_MASK;
+				s0[j] = s[0];
+				s1[j] = s[1];
+				w0[j] = PSP_SAS_PITCH_MASK - f;
+				w1[j] = f;
+				sampleFrac += pitch;
+			}
+			int32x4_t sample = vmlal_s16(vmull_s16(vld1_s16(s0), vld1_s16(w0)), vld1_s16(s1), vld1_s16(w1));
+			sample = vshrq_n_s32(sample, PSP_SAS_PITCH_BASE_SHIFT);
+			int32x4_t scaled = vshrq_n_s32(vaddq_s32(vmulq_s32(sample, vld1q_s32(envelope + i)), round), 15);
+			vst1_s16(out + i, vmovn_s32(scaled));
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		const s16 *s = src + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		int sample = s[0];
+		if (needsInterp) {
+			int f = sampleFrac & PSP_SAS_PITCH_MASK;
+			sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
+		}
+		sampleFrac += pitch;
+		out[i] = (s16)(((sample * envelope[i]) + (1 << 14)) >> 15);
+	}
+	return sampleFrac;
+}
+
+// Scales mono voice samples by the dry and send volumes, accumulating into the interleaved stereo buffers.
+// Volumes must fit in 16 bits.
+static void MixVoiceSamples(int *mix, int *send, const s16 *samples, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	const __m128i volume = _mm_set_epi16(volumeRight, volumeLeft, volumeRight, volumeLeft, volumeRight, volumeLeft, volumeRight, volumeLeft);
+	const __m128i effect = _mm_set_epi16(effectRight, effectLeft, effectRight, effectLeft, effectRight, effectLeft, effectRight, effectLeft);
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadl_epi64((const __m128i *)(samples + i));
+		// Each sample twice, for left and right.
+		__m128i dup = _mm_unpacklo_epi16(s, s);
+
+		__m128i lo = _mm_mullo_epi16(dup, volume);
+		__m128i hi = _mm_mulhi_epi16(dup, volume);
+		__m128i *m = (__m128i *)(mix + i * 2);
+		_mm_storeu_si128(m, _mm_add_epi32(_mm_loadu_si128(m), _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12)));
+		_mm_storeu_si128(m + 1, _mm_add_epi32(_mm_loadu_si128(m + 1), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12)));
+
+		lo = _mm_mullo_epi16(dup, effect);
+		hi = _mm_mulhi_epi16(dup, effect);
+		__m128i *e = (__m128i *)(send + i * 2);
+		_mm_storeu_si128(e, _mm_add_epi32(_mm_loadu_si128(e), _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12)));
+		_mm_storeu_si128(e + 1, _mm_add_epi32(_mm_loadu_si128(e + 1), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12)));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	alignas(16) const s16 volumes[4] = { (s16)volumeLeft, (s16)volumeRight, (s16)volumeLeft, (s16)volumeRight };
+	alignas(16) const s16 effects[4] = { (s16)effectLeft, (s16)effectRight, (s16)effectLeft, (s16)effectRight };
+	const int16x4_t volume = vld1_s16(volumes);
+	const int16x4_t effect = vld1_s16(effects);
+	for (; i + 4 <= count; i += 4) {
+		int16x4_t s = vld1_s16(samples + i);
+		// Each sample twice, for left and right.
+		int16x4x2_t dup = vzip_s16(s, s);
+
+		int *m = mix + i * 2;
+		vst1q_s32(m, vaddq_s32(vld1q_s32(m), vshrq_n_s32(vmull_s16(dup.val[0], volume), 12)));
+		vst1q_s32(m + 4, vaddq_s32(vld1q_s32(m + 4), vshrq_n_s32(vmull_s16(dup.val[1], volume), 12)));
+
+		int *e = send + i * 2;
+		vst1q_s32(e, vaddq_s32(vld1q_s32(e), vshrq_n_s32(vmull_s16(dup.val[0], effect), 12)));
+		vst1q_s32(e + 4, vaddq_s32(vld1q_s32(e + 4), vshrq_n_s32(vmull_s16(dup.val[1], effect), 12)));
+	}
+#endif
+
+	for (; i < count; i++) {
+		int sample = samples[i];
+		mix[i * 2] += (sample * volumeLeft) >> 12;
+		mix[i * 2 + 1] += (sample * volumeRight) >> 12;
+		send[i * 2] += sample * effectLeft >> 12;
+		send[i * 2 + 1] += sample * effectRight >> 12;
+	}
+}
+
 void SasInstance::MixVoice(SasVoice &voice) {
 	switch (voice.type) {
 	case VOICETYPE_VAG:
@@ -571,34 +779,41 @@ void SasInstance::MixVoice(SasVoice &voice) {
 		}
 
 		const bool needsInterp = voicePitch != PSP_SAS_PITCH_BASE || (sampleFrac & PSP_SAS_PITCH_MASK) != 0;
-		for (int i = delay; i < grainSize; i++) {
-			const int16_t *s = mixTemp_ + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		const int count = grainSize - delay;
 
-			// Linear interpolation. Good enough. Need to make resampleHist bigger if we want more.
-			int sample = s[0];
-			if (needsInterp) {
-				int f = sampleFrac & PSP_SAS_PITCH_MASK;
-				sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
-			}
-			sampleFrac += voicePitch;
+		// The envelope is a per-sample state machine, so step it ahead of the mixing.
+		const bool envelopeInRange = voice.envelope.StepBlock(envelopeTemp_, count);
 
-			// The maximum envelope height (PSP_SAS_ENVELOPE_HEIGHT_MAX) is (1 << 30) - 1.
-			// Reduce it to 14 bits, by shifting off 15.  Round up by adding (1 << 14) first.
-			int envelopeValue = voice.envelope.GetHeight();
-			voice.envelope.Step();
-			envelopeValue = (envelopeValue + (1 << 14)) >> 15;
-
-			// We just scale by the envelope before we scale by volumes.
-			// Again, we round up by adding (1 << 14) first (*after* multiplying.)
-			sample = ((sample * envelopeValue) + (1 << 14)) >> 15;
-
-			// We mix into this 32-bit temp buffer and clip in a second loop
-			// Ideally, the shift right should be there too but for now I'm concerned about
-			// not overflowing.
-			mixBuffer[i * 2] += (sample * voice.volumeLeft) >> 12;
-			mixBuffer[i * 2 + 1] += (sample * voice.volumeRight) >> 12;
-			sendBuffer[i * 2] += sample * voice.effectLeft >> 12;
-			sendBuffer[i * 2 + 1] += sample * voice.effectRight >> 12;
+		// With the envelope at most 0x8000 the enveloped samples fit in 16 bits, which lets the
+		// kernels use 16-bit multiplies.  Volumes are range checked by sceSas already.
+		if (envelopeInRange && VolumeFitsS16(voice.volumeLeft) && VolumeFitsS16(voice.volumeRight) && VolumeFitsS16(voice.effectLeft) && VolumeFitsS16(voice.effectRight)) {
+			sampleFrac = ResampleVoice(voiceTemp_, mixTemp_, sampleFrac, voicePitch, needsInterp, envelopeTemp_, count);
+			MixVoiceSamples(mixBuffer + delay * 2, sendBuffer + delay * 2, voiceTemp_, count, voice.volumeLeft, voice.volumeRight, voice.effectLeft, voice.effectRight);
+		} else {
+			for (int i = 0; i < count; i++) {
+				const int16_t *s = mixTemp_ + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+
+				// Linear interpolation. Good enough. Need to make resampleHist bigger if we want more.
+				int sample = s[0];
+				if (needsInterp) {
+					int f = sampleFrac & PSP_SAS_PITCH_MASK;
+					sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
+				}
+				sampleFrac += voicePitch;
+
+				// We just scale by the envelope before we scale by volumes.
+				// Again, we round up by adding (1 << 14) first (*after* multiplying.)
+				sample = ((sample * envelopeTemp_[i]) + (1 << 14)) >> 15;
+
+				// We mix into this 32-bit temp buffer and clip in a second loop
+				// Ideally, the shift right should be there too but for now I'm concerned about
+				// not overflowing.
+				const int o = (delay + i) * 2;
+				mixBuffer[o] += (sample * voice.volumeLeft) >> 12;
+				mixBuffer[o + 1] += (sample * voice.volumeRight) >> 12;
+				sendBuffer[o] += sample * voice.effectLeft >> 12;
+				sendBuffer[o + 1] += sample * voice.effectRight >> 12;
+			}
 		}
 
 		voice.resampleHist[0] = mixTemp_[tempPos - 2];
@@ -617,6 +832,28 @@ void SasInstance::MixVoice(SasVoice &voice) {
 }
 
 void SasInstance::Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol) {
+	s16 *outp = (s16 *)Memory::GetPointerWriteRange(outAddr, GetOutputSize());
+	const s16 *inp = inAddr ? (const s16 *)Memory::GetPointerRange(inAddr, 4 * grainSize) : 0;
+	if (!outp) {
+		WARN_LOG_REPORT(Log::sceSas, "Bad SAS Mix output address: %08x, grain=%d", outAddr, grainSize);
+	}
+
+	MixTo(outp, inp, leftVol, rightVol);
+
+	if (!outp) {
+		// Nothing written.
+	} else if (outputMode == PSP_SAS_OUTPUTMODE_MIXED) {
+		if (MemBlockInfoDetailed()) {
+			if (inp)
+				NotifyMemInfo(MemBlockFlags::READ, inAddr, grainSize * sizeof(u16) * 2, "SasMix");
+			NotifyMemInfo(MemBlockFlags::WRITE, outAddr, grainSize * sizeof(u16) * 2, "SasMix");
+		}
+	} else {
+		NotifyMemInfo(MemBlockFlags::WRITE, outAddr, grainSize * sizeof(u16) * 4, "SasMix");
+	}
+}
+
+void SasInstance::MixTo(s16 *outp, const s16 *inp, int leftVol, int rightVol) {
 	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
 		SasVoice &voice = voices[v];
 		if (!voice.playing || voice.paused)
@@ -627,18 +864,11 @@ void SasInstance::Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol) {
 	// Then mix the send buffer in with the rest.
 
 	// Alright, all voices mixed. Let's convert and clip, and at the same time, wipe mixBuffer for next time. Could also dither.
-	s16 *outp = (s16 *)Memory::GetPointerWriteRange(outAddr, 4 * grainSize);
-	const s16 *inp = inAddr ? (const s16 *)Memory::GetPointerRange(inAddr, 4 * grainSize) : 0;
 	if (!outp) {
-		WARN_LOG_REPORT(Log::sceSas, "Bad SAS Mix output address: %08x, grain=%d", outAddr, grainSize);
+		// Voices still advance, but there's nowhere to write.
 	} else if (outputMode == PSP_SAS_OUTPUTMODE_MIXED) {
 		// Okay, apply effects processing to the Send buffer.
 		WriteMixedOutput(outp, inp, leftVol, rightVol);
-		if (MemBlockInfoDetailed()) {
-			if (inp)
-				NotifyMemInfo(MemBlockFlags::READ, inAddr, grainSize * sizeof(u16) * 2, "SasMix");
-			NotifyMemInfo(MemBlockFlags::WRITE, outAddr, grainSize * sizeof(u16) * 2, "SasMix");
-		}
 	} else {
 		s16 *outpL = outp + grainSize * 0;
 		s16 *outpR = outp + grainSize * 1;
@@ -651,7 +881,6 @@ void SasInstance::Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol) {
 			*outpSendL++ = clamp_s16(sendBuffer[i + 0]);
 			*outpSendR++ = clamp_s16(sendBuffer[i + 1]);
 		}
-		NotifyMemInfo(MemBlockFlags::WRITE, outAddr, grainSize * sizeof(u16) * 4, "SasMix");
 	}
 	memset(mixBuffer, 0, grainSize * sizeof(int) * 2);
 	memset(sendBuffer, 0, grainSize * sizeof(int) * 2);
@@ -723,7 +952,24 @@ void SasInstance::SetWaveformEffectType(int type) {
 // which is which.
 void SasInstance::ApplyWaveformEffect() {
 	// First, downsample the send buffer to 22khz. We do this naively for now.
-	for (int i = 0; i < grainSize / 2; i++) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	for (; i + 4 <= grainSize / 2; i += 4) {
+		// Keep the first stereo frame of each pair, packing with saturation clamps.
+		const __m128i *src = (const __m128i *)(sendBuffer + i * 4);
+		__m128i frames01 = _mm_unpacklo_epi64(_mm_loadu_si128(src + 0), _mm_loadu_si128(src + 1));
+		__m128i frames23 = _mm_unpacklo_epi64(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+		_mm_storeu_si128((__m128i *)(sendBufferDownsampled + i * 2), _mm_packs_epi32(frames01, frames23));
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	for (; i + 4 <= grainSize / 2; i += 4) {
+		const int *src = sendBuffer + i * 4;
+		int32x4_t frames01 = vcombine_s32(vld1_s32(src + 0), vld1_s32(src + 4));
+		int32x4_t frames23 = vcombine_s32(vld1_s32(src + 8), vld1_s32(src + 12));
+		vst1q_s16(sendBufferDownsampled + i * 2, vcombine_s16(vqmovn_s32(frames01), vqmovn_s32(frames23)));
+	}
+#endif
+	for (; i < grainSize / 2; i++) {
 		sendBufferDownsampled[i * 2] = clamp_s16(sendBuffer[i * 4]);
 		sendBufferDownsampled[i * 2 + 1] = clamp_s16(sendBuffer[i * 4 + 1]);
 	}
@@ -857,45 +1103,49 @@ void SasVoice::DoState(PointerWrap &p) {
 	atrac3.DoState(p);
 }
 
-void ADSREnvelope::WalkCurve(int type, int rate) {
+static inline void WalkEnvelopeCurve(s64 &height, int type, int rate) {
 	s64 expDelta;
 	switch (type) {
 	case PSP_SAS_ADSR_CURVE_MODE_LINEAR_INCREASE:
-		height_ += rate;
+		height += rate;
 		break;
 
 	case PSP_SAS_ADSR_CURVE_MODE_LINEAR_DECREASE:
-		height_ -= rate;
+		height -= rate;
 		break;
 
 	case PSP_SAS_ADSR_CURVE_MODE_LINEAR_BENT:
-		if (height_ <= (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX * 3 / 4) {
-			height_ += rate;
+		if (height <= (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX * 3 / 4) {
+			height += rate;
 		} else {
-			height_ += rate / 4;
+			height += rate / 4;
 		}
 		break;
 
 	case PSP_SAS_ADSR_CURVE_MODE_EXPONENT_DECREASE:
-		expDelta = height_ - PSP_SAS_ENVELOPE_HEIGHT_MAX;
+		expDelta = height - PSP_SAS_ENVELOPE_HEIGHT_MAX;
 		// Flipping the sign so that we can shift in the top bits.
 		expDelta += (-expDelta * rate) >> 32;
-		height_ = expDelta + PSP_SAS_ENVELOPE_HEIGHT_MAX - (rate + 3UL) / 4UL;
+		height = expDelta + PSP_SAS_ENVELOPE_HEIGHT_MAX - (rate + 3UL) / 4UL;
 		break;
 
 	case PSP_SAS_ADSR_CURVE_MODE_EXPONENT_INCREASE:
-		expDelta = height_ - PSP_SAS_ENVELOPE_HEIGHT_MAX;
+		expDelta = height - PSP_SAS_ENVELOPE_HEIGHT_MAX;
 		// Flipping the sign so that we can shift in the top bits.
 		expDelta += (-expDelta * rate) >> 32;
-		height_ = expDelta + 0x4000 + PSP_SAS_ENVELOPE_HEIGHT_MAX;
+		height = expDelta + 0x4000 + PSP_SAS_ENVELOPE_HEIGHT_MAX;
 		break;
 
 	case PSP_SAS_ADSR_CURVE_MODE_DIRECT:
-		height_ = rate;  // Simple :)
+		height = rate;  // Simple :)
 		break;
 	}
 }
 
+void ADSREnvelope::WalkCurve(int type, int rate) {
+	WalkEnvelopeCurve(height_, type, rate);
+}
+
 void ADSREnvelope::SetState(ADSRState state) {
 	if (height_ > PSP_SAS_ENVELOPE_HEIGHT_MAX) {
 		height_ = PSP_SAS_ENVELOPE_HEIGHT_MAX;
@@ -951,6 +1201,76 @@ inline void ADSREnvelope::Step() {
 	}
 }
 
+bool ADSREnvelope::StepBlock(int *values, int count) {
+	u32 outOfRange = 0;
+	auto emit = [&](int i) {
+		// The maximum envelope height (PSP_SAS_ENVELOPE_HEIGHT_MAX) is (1 << 30) - 1.
+		// Reduce it to 14 bits, by shifting off 15.  Round up by adding (1 << 14) first.
+		int value = (GetHeight() + (1 << 14)) >> 15;
+		values[i] = value;
+		outOfRange |= (u32)value > 0x8000;
+	};
+
+	// Same as calling Step() per sample, but with the state checks hoisted out of the inner loops.
+	int i = 0;
+	while (i < count) {
+		switch (state_) {
+		case STATE_ATTACK:
+			while (i < count) {
+				emit(i++);
+				WalkEnvelopeCurve(height_, attackType, attackRate);
+				if (height_ >= PSP_SAS_ENVELOPE_HEIGHT_MAX || height_ < 0) {
+					SetState(STATE_DECAY);
+					break;
+				}
+			}
+			break;
+		case STATE_DECAY:
+			while (i < count) {
+				emit(i++);
+				WalkEnvelopeCurve(height_, decayType, decayRate);
+				if (height_ < sustainLevel) {
+					SetState(STATE_SUSTAIN);
+					break;
+				}
+			}
+			break;
+		case STATE_SUSTAIN:
+			while (i < count) {
+				emit(i++);
+				WalkEnvelopeCurve(height_, sustainType, sustainRate);
+				if (height_ <= 0) {
+					height_ = 0;
+					SetState(STATE_RELEASE);
+					break;
+				}
+			}
+			break;
+		case STATE_RELEASE:
+			while (i < count) {
+				emit(i++);
+				WalkEnvelopeCurve(height_, releaseType, releaseRate);
+				if (height_ <= 0) {
+					height_ = 0;
+					SetState(STATE_OFF);
+					break;
+				}
+			}
+			break;
+		case STATE_OFF:
+			// Nothing changes anymore.
+			while (i < count)
+				emit(i++);
+			break;
+		default:
+			emit(i++);
+			Step();
+			break;
+		}
+	}
+	return outOfRange == 0;
+}
+
 void ADSREnvelope::KeyOn() {
 	SetState(STATE_KEYON);
 }
@@ -109,7 +109,8 @@ class VagDecoder {
 
 	void GetSamples(s16 *outSamples, int numSamples);
 
-	void DecodeBlock(const u8 *&readp);
+	// Decodes 28 samples to out and advances readp, unless the stream ends here.
+	void DecodeBlock(const u8 *&readp, s16 *out);
 	bool End() const { return end_; }
 
 	void DoState(PointerWrap &p);
@@ -170,6 +171,9 @@ class ADSREnvelope {
 	void End();
 
 	inline void Step();
+	// Steps count times, writing the envelope level for each sample scaled down to 0 - 0x8000.
+	// Returns false if any level was outside that range.
+	bool StepBlock(int *values, int count);
 
 	int GetHeight() const {
 		return (int)(height_ > (s64)PSP_SAS_ENVELOPE_HEIGHT_MAX ? PSP_SAS_ENVELOPE_HEIGHT_MAX : height_);
@@ -293,6 +297,15 @@ struct SasVoice {
 	SasAtrac3 atrac3;
 };
 
+// Mix timing, filled in by sceSas for the debug overlay.
+struct SasMixStats {
+	bool threaded = false;
+	int mixes = 0;
+	double mixSeconds = 0.0;
+	// Time the emu thread spent waiting for a mix, either running it or waiting on the SAS thread.
+	double stallSeconds = 0.0;
+};
+
 class SasInstance {
 public:
 	SasInstance();
@@ -301,6 +314,8 @@ class SasInstance {
 	void ClearGrainSize();
 	void SetGrainSize(int newGrainSize);
 	int GetGrainSize() const { return grainSize; }
+	// Bytes written per mix: interleaved stereo, or in raw mode four planes (dry L/R, send L/R).
+	int GetOutputSize() const { return grainSize * (outputMode == PSP_SAS_OUTPUTMODE_RAW ? 8 : 4); }
 	int EstimateMixUs();
 
 	int maxVoices = PSP_SAS_VOICES_MAX;
@@ -315,6 +330,8 @@ class SasInstance {
 	FILE *audioDump = nullptr;
 
 	void Mix(u32 outAddr, u32 inAddr = 0, int leftVol = 0, int rightVol = 0);
+	// Same as Mix, but with host buffers.  outp may be null, in which case voices only advance.
+	void MixTo(s16 *outp, const s16 *inp, int leftVol, int rightVol);
 	void MixVoice(SasVoice &voice);
 
 	// Applies reverb to send buffer, according to waveformEffect.
@@ -328,11 +345,15 @@ class SasInstance {
 
 	SasVoice voices[PSP_SAS_VOICES_MAX];
 	WaveformEffect waveformEffect;
+	SasMixStats mixStats;
 
 private:
 	SasReverb reverb_;
 	int grainSize = 0;
 	int16_t mixTemp_[PSP_SAS_MAX_GRAIN * 4 + 2 + 16];  // some extra margin for very high pitches.
+	// Per sample envelope values and enveloped samples of the voice being mixed.
+	int envelopeTemp_[PSP_SAS_MAX_GRAIN];
+	int16_t voiceTemp_[PSP_SAS_MAX_GRAIN];
 };
 
 const char *ADSRCurveModeAsString(SasADSRCurveMode mode);
@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -153,7 +154,7 @@ static const SasReverbData presets[10] = {
 	},
 };
 
-SasReverb::SasReverb() : preset_(-1), pos_(0) {
+SasReverb::SasReverb() : preset_(-1), pos_(0), silent_(true), silentSamples_(0) {
 	workspace_ = new int16_t[BUFSIZE];
 }
 
@@ -177,35 +178,26 @@ void SasReverb::SetPreset(int preset) {
 	} else {
 		pos_ = 0;
 	}
+	silent_ = true;
+	silentSamples_ = 0;
 }
 
-// Wraps around the upper part of a buffer.
-template<int bufsize>
-class BufferWrapper {
-public:
-	BufferWrapper(int16_t *buffer, int position, int usedSize) : buf_(buffer), pos_(position), end_(bufsize), base_(bufsize - usedSize), size_(usedSize) {}
-	int16_t &operator [](int index) {
-		int addr = pos_ + index;
-		if (addr >= end_) { addr -= size_; }
-		if (addr < base_) { addr += size_; }
-		return buf_[addr];
-	}
-
-	int GetPosition() { return pos_; }
-	void Next() {
-		pos_++;
-		if (pos_ >= end_) {
-			pos_ -= size_;
-		}
+bool SasReverb::IsWorkspaceSilent() const {
+	const int16_t *p = workspace_ + BUFSIZE - presets[preset_].size;
+	const int16_t *end = workspace_ + BUFSIZE;
+	for (; p < end; ++p) {
+		if (*p != 0)
+			return false;
 	}
+	return true;
+}
 
-private:
-	int16_t *buf_;
-	int pos_;
-	int end_;
-	int base_;
-	int size_;
-};
+static bool IsInputSilent(const int16_t *input, size_t count) {
+	int16_t bits = 0;
+	for (size_t i = 0; i < count; ++i)
+		bits |= input[i];
+	return bits == 0;
+}
 
 void SasReverb::ProcessReverb(int16_t *output, const int16_t *input, size_t inputSize, uint16_t volLeft, uint16_t volRight) {
 	// This means replicate the input signal in the processed buffer.
@@ -232,49 +224,100 @@ void SasReverb::ProcessReverb(int16_t *output, const int16_t *input, size_t inpu
 
 	const SasReverbData &d = presets[preset_];
 
-	// We put this on the stack instead of in the object to let the compiler optimize better (avoid mem r/w).
-	BufferWrapper<BUFSIZE> b(workspace_, pos_, d.size);
-
-	// This runs at 22khz.
-	// Very unoptimized, straight from the description. Can probably be reformulated into something way more efficient.
-	// Or we could actually template the whole thing with the parameters as template arguments, as the presets are fixed.
-	for (size_t i = 0; i < inputSize; i++) {
-		// Dividing by two here is an incorrect hack. Some multiplication factor is needed to prevent the reverb from getting too loud, though.
-		int16_t LeftInput = input[i * 2] >> 1;
-		int16_t RightInput = input[i * 2 + 1] >> 1;
-
-		int16_t Lin = LeftInput; //  (d.vLIN * LeftInput) >> 15;
-		int16_t Rin = RightInput; // (d.vRIN * RightInput) >> 15;
-
-		// ____Same Side Reflection(left - to - left and right - to - right)___________________
-		b[d.mLSAME] = clamp_s16(Lin + (b[d.dLSAME] * d.vWALL >> 15) - (b[d.mLSAME - 1]*d.vIIR >> 15) + b[d.mLSAME - 1]); // L - to - L
-		b[d.mRSAME] = clamp_s16(Rin + (b[d.dRSAME] * d.vWALL >> 15) - (b[d.mRSAME - 1]*d.vIIR >> 15) + b[d.mRSAME - 1]); // R - to - R
-		// ___Different Side Reflection(left - to - right and right - to - left)_______________
-		b[d.mLDIFF] = clamp_s16(Lin + (b[d.dRDIFF] * d.vWALL >> 15) - (b[d.mLDIFF - 1]*d.vIIR >> 15) + b[d.mLDIFF - 1]); // R - to - L
-		b[d.mRDIFF] = clamp_s16(Rin + (b[d.dLDIFF] * d.vWALL >> 15) - (b[d.mRDIFF - 1]*d.vIIR >> 15) + b[d.mRDIFF - 1]); // L - to - R
-		// ___Early Echo(Comb Filter, with input from buffer)__________________________
-		int32_t Lout = ((d.vCOMB1*b[d.mLCOMB1] + d.vCOMB2*b[d.mLCOMB2] + d.vCOMB3*b[d.mLCOMB3] + d.vCOMB4*b[d.mLCOMB4]) >> 15);
-		int32_t Rout = ((d.vCOMB1*b[d.mRCOMB1] + d.vCOMB2*b[d.mRCOMB2] + d.vCOMB3*b[d.mRCOMB3] + d.vCOMB4*b[d.mRCOMB4]) >> 15);
-		// ___Late Reverb APF1(All Pass Filter 1, with input from COMB)________________
-		b[d.mLAPF1] = clamp_s16(Lout - (d.vAPF1*b[(d.mLAPF1 - d.dAPF1)] >> 15));
-		Lout = b[(d.mLAPF1 - d.dAPF1)] + (b[d.mLAPF1] * d.vAPF1 >> 15);
-		b[d.mRAPF1] = clamp_s16(Rout - (d.vAPF1*b[(d.mRAPF1 - d.dAPF1)] >> 15));
-		Rout = b[(d.mRAPF1 - d.dAPF1)] + (b[d.mRAPF1] * d.vAPF1 >> 15);
-		// ___Late Reverb APF2(All Pass Filter 2, with input from APF1)________________
-		b[d.mLAPF2] = clamp_s16(Lout - (d.vAPF2*b[(d.mLAPF2 - d.dAPF2)] >> 15));
-		Lout = b[(d.mLAPF2 - d.dAPF2)] + (b[d.mLAPF2] * d.vAPF2 >> 15);
-		b[d.mRAPF2] = clamp_s16(Rout - (d.vAPF2*b[(d.mRAPF2 - d.dAPF2)] >> 15));
-		Rout = b[(d.mRAPF2 - d.dAPF2)] + (b[d.mRAPF2] * d.vAPF2 >> 15);
-		// ___Output to Mixer(Output volume multiplied with input from APF2)___________
-		output[i * 4 + 0] = clamp_s16((Lout * volLeft) >> finalShift);
-		output[i * 4 + 1] = clamp_s16((Rout * volRight) >> finalShift);
-		output[i * 4 + 2] = 0;
-		output[i * 4 + 3] = 0;
-
-		b.Next();
+	if (IsInputSilent(input, inputSize * 2)) {
+		if (!silent_) {
+			// Once it's been quiet for a whole trip around the buffer, check if the reverb has died out.
+			silentSamples_ += (int)inputSize;
+			if (silentSamples_ >= d.size) {
+				silentSamples_ = 0;
+				silent_ = IsWorkspaceSilent();
+			}
+		}
+		if (silent_) {
+			// Zeroes in, zeroes out, and the workspace stays zero.  Just move along.
+			memset(output, 0, inputSize * 4 * sizeof(int16_t));
+			pos_ += (int)inputSize;
+			if (pos_ >= BUFSIZE)
+				pos_ -= d.size;
+			return;
+		}
+	} else {
+		silent_ = false;
+		silentSamples_ = 0;
+	}
+
+	// The coefficients, as locals so the compiler knows they don't change when we write to the workspace.
+	const int vIIR = d.vIIR, vWALL = d.vWALL, vAPF1 = d.vAPF1, vAPF2 = d.vAPF2;
+	const int vCOMB1 = d.vCOMB1, vCOMB2 = d.vCOMB2, vCOMB3 = d.vCOMB3, vCOMB4 = d.vCOMB4;
+
+	// The workspace is a ring buffer in the upper d.size samples, and every tap is an offset from pos_.
+	// Instead of wrapping each tap on every sample, we resolve all the taps once and then run until
+	// the first of them reaches the end of the buffer.  That's usually the whole grain.
+	const int base = BUFSIZE - d.size;
+	int pos = pos_;
+	size_t i = 0;
+	while (i < inputSize) {
+		size_t run = inputSize - i;
+		auto tap = [&](int offset) {
+			int addr = pos + offset;
+			if (addr >= BUFSIZE) { addr -= d.size; }
+			if (addr < base) { addr += d.size; }
+			run = std::min(run, (size_t)(BUFSIZE - addr));
+			return workspace_ + addr;
+		};
+
+		int16_t *mLSAME = tap(d.mLSAME), *mLSAME1 = tap(d.mLSAME - 1), *dLSAME = tap(d.dLSAME);
+		int16_t *mRSAME = tap(d.mRSAME), *mRSAME1 = tap(d.mRSAME - 1), *dRSAME = tap(d.dRSAME);
+		int16_t *mLDIFF = tap(d.mLDIFF), *mLDIFF1 = tap(d.mLDIFF - 1), *dLDIFF = tap(d.dLDIFF);
+		int16_t *mRDIFF = tap(d.mRDIFF), *mRDIFF1 = tap(d.mRDIFF - 1), *dRDIFF = tap(d.dRDIFF);
+		const int16_t *mLCOMB1 = tap(d.mLCOMB1), *mLCOMB2 = tap(d.mLCOMB2), *mLCOMB3 = tap(d.mLCOMB3), *mLCOMB4 = tap(d.mLCOMB4);
+		const int16_t *mRCOMB1 = tap(d.mRCOMB1), *mRCOMB2 = tap(d.mRCOMB2), *mRCOMB3 = tap(d.mRCOMB3), *mRCOMB4 = tap(d.mRCOMB4);
+		int16_t *mLAPF1 = tap(d.mLAPF1), *mLAPF1d = tap(d.mLAPF1 - d.dAPF1);
+		int16_t *mRAPF1 = tap(d.mRAPF1), *mRAPF1d = tap(d.mRAPF1 - d.dAPF1);
+		int16_t *mLAPF2 = tap(d.mLAPF2), *mLAPF2d = tap(d.mLAPF2 - d.dAPF2);
+		int16_t *mRAPF2 = tap(d.mRAPF2), *mRAPF2d = tap(d.mRAPF2 - d.dAPF2);
+
+		// This runs at 22khz.  Straight from the description, every write feeds back into later reads
+		// (some only a sample later), so it has to be done in order, one sample at a time.
+		int16_t *out = output + i * 4;
+		const int16_t *in = input + i * 2;
+		for (size_t k = 0; k < run; ++k) {
+			// Dividing by two here is an incorrect hack. Some multiplication factor is needed to prevent the reverb from getting too loud, though.
+			int16_t Lin = in[k * 2] >> 1;  //  (d.vLIN * LeftInput) >> 15;
+			int16_t Rin = in[k * 2 + 1] >> 1;  // (d.vRIN * RightInput) >> 15;
+
+			// ____Same Side Reflection(left - to - left and right - to - right)___________________
+			mLSAME[k] = clamp_s16(Lin + (dLSAME[k] * vWALL >> 15) - (mLSAME1[k] * vIIR >> 15) + mLSAME1[k]); // L - to - L
+			mRSAME[k] = clamp_s16(Rin + (dRSAME[k] * vWALL >> 15) - (mRSAME1[k] * vIIR >> 15) + mRSAME1[k]); // R - to - R
+			// ___Different Side Reflection(left - to - right and right - to - left)_______________
+			mLDIFF[k] = clamp_s16(Lin + (dRDIFF[k] * vWALL >> 15) - (mLDIFF1[k] * vIIR >> 15) + mLDIFF1[k]); // R - to - L
+			mRDIFF[k] = clamp_s16(Rin + (dLDIFF[k] * vWALL >> 15) - (mRDIFF1[k] * vIIR >> 15) + mRDIFF1[k]); // L - to - R
+			// ___Early Echo(Comb Filter, with input from buffer)__________________________
+			int32_t Lout = ((vCOMB1 * mLCOMB1[k] + vCOMB2 * mLCOMB2[k] + vCOMB3 * mLCOMB3[k] + vCOMB4 * mLCOMB4[k]) >> 15);
+			int32_t Rout = ((vCOMB1 * mRCOMB1[k] + vCOMB2 * mRCOMB2[k] + vCOMB3 * mRCOMB3[k] + vCOMB4 * mRCOMB4[k]) >> 15);
+			// ___Late Reverb APF1(All Pass Filter 1, with input from COMB)________________
+			mLAPF1[k] = clamp_s16(Lout - (vAPF1 * mLAPF1d[k] >> 15));
+			Lout = mLAPF1d[k] + (mLAPF1[k] * vAPF1 >> 15);
+			mRAPF1[k] = clamp_s16(Rout - (vAPF1 * mRAPF1d[k] >> 15));
+			Rout = mRAPF1d[k] + (mRAPF1[k] * vAPF1 >> 15);
+			// ___Late Reverb APF2(All Pass Filter 2, with input from APF1)________________
+			mLAPF2[k] = clamp_s16(Lout - (vAPF2 * mLAPF2d[k] >> 15));
+			Lout = mLAPF2d[k] + (mLAPF2[k] * vAPF2 >> 15);
+			mRAPF2[k] = clamp_s16(Rout - (vAPF2 * mRAPF2d[k] >> 15));
+			Rout = mRAPF2d[k] + (mRAPF2[k] * vAPF2 >> 15);
+			// ___Output to Mixer(Output volume multiplied with input from APF2)___________
+			out[k * 4 + 0] = clamp_s16((Lout * volLeft) >> finalShift);
+			out[k * 4 + 1] = clamp_s16((Rout * volRight) >> finalShift);
+			out[k * 4 + 2] = 0;
+			out[k * 4 + 3] = 0;
+		}
+
+		i += run;
+		pos += (int)run;
+		if (pos >= BUFSIZE)
+			pos -= d.size;
 	}
 
 	// Save the state in the object.
-	pos_ = b.GetPosition();
+	pos_ = pos;
 }
-
@@ -38,7 +38,14 @@ class SasReverb {
 		BUFSIZE = 0x20000,
 	};
 
+	bool IsWorkspaceSilent() const;
+
 	int16_t *workspace_;
 	int preset_;
 	int pos_;
+	// True when the workspace is known to be all zeroes.  Silent input then leaves it that way,
+	// so there's nothing to compute.
+	bool silent_;
+	// Samples of silent input since we last checked if the reverb died out.
+	int silentSamples_;
 };
\ No newline at end of file
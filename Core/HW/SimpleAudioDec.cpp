@@ -28,6 +28,7 @@
 #include "Core/HW/Atrac3Standalone.h"
 
 #include "ext/minimp3/minimp3.h"
+#include "ext/xxhash.h"
 
 #ifdef USE_FFMPEG
 
@@ -76,6 +77,9 @@ class MiniMp3Audio : public AudioDecoder {
 		*outSamples = samplesWritten;
 		return true;
 	}
+	void FlushBuffers() override {
+		mp3dec_init(&mp3_);
+	}
 
 	bool IsOK() const override { return true; }
 	void SetChannels(int channels) override {
@@ -106,6 +110,7 @@ class FFmpegAudioDecoder : public AudioDecoder {
 	}
 
 	void SetChannels(int channels) override;
+	void FlushBuffers() override;
 
 	// These two are only here because of save states.
 	PSPAudioType GetAudioType() const override { return audioType; }
@@ -236,6 +241,13 @@ void FFmpegAudioDecoder::SetChannels(int channels) {
 #endif
 }
 
+void FFmpegAudioDecoder::FlushBuffers() {
+#ifdef USE_FFMPEG
+	if (codecOpen_)
+		avcodec_flush_buffers(codecCtx_);
+#endif
+}
+
 FFmpegAudioDecoder::~FFmpegAudioDecoder() {
 #ifdef USE_FFMPEG
 	swr_free(&swrCtx_);
@@ -356,6 +368,21 @@ bool FFmpegAudioDecoder::Decode(const uint8_t *inbuf, int inbytes, int *inbytesC
 #endif  // USE_FFMPEG
 }
 
+int AudioDecoder::DecodeFrames(const uint8_t *inbuf, int inbytes, int frameCount, int outputChannels, int16_t *outbuf, int *outSamples) {
+	int totalSamples = 0;
+	int frames = 0;
+	for (; frames < frameCount; ++frames) {
+		int frameSamples = 0;
+		int16_t *out = outbuf ? outbuf + totalSamples * outputChannels : nullptr;
+		if (!Decode(inbuf + frames * inbytes, inbytes, nullptr, outputChannels, out, &frameSamples))
+			break;
+		totalSamples += frameSamples;
+	}
+	if (outSamples)
+		*outSamples = totalSamples;
+	return frames;
+}
+
 void AudioClose(AudioDecoder **ctx) {
 #ifdef USE_FFMPEG
 	delete *ctx;
@@ -402,6 +429,32 @@ AuCtx::~AuCtx() {
 	}
 }
 
+// Enough for MP3's 511 byte bit reservoir and the frame before, AAC only needs the frame before.
+static const size_t CATCH_UP_INPUT_BYTES = 2048;
+
+void AuCtx::RememberServedInput(const u8 *data, int bytes) {
+	servedInput_.emplace_back(data, data + bytes);
+	servedInputBytes_ += bytes;
+	while (servedInput_.size() > 2 && servedInputBytes_ - servedInput_.front().size() >= CATCH_UP_INPUT_BYTES) {
+		servedInputBytes_ -= servedInput_.front().size();
+		servedInput_.pop_front();
+	}
+}
+
+// The decoder sat out the frames served from the cache. Like Atrac::PrimeDecoder, run the last of them
+// through it, so it's in the state it would have been in had it decoded them all.
+void AuCtx::CatchUpDecoder() {
+	decoder->FlushBuffers();
+	std::vector<int16_t> scratch(4096 * 2);
+	for (const std::vector<u8> &input : servedInput_) {
+		int inbytesConsumed = 0;
+		int outSamples = 0;
+		decoder->Decode(input.data(), (int)input.size(), &inbytesConsumed, 2, scratch.data(), &outSamples);
+	}
+	servedInput_.clear();
+	servedInputBytes_ = 0;
+}
+
 size_t AuCtx::FindNextMp3Sync() {
 	for (size_t i = 0; i < sourcebuff.size() - 2; ++i) {
 		if ((sourcebuff[i] & 0xFF) == 0xFF && (sourcebuff[i + 1] & 0xC0) == 0xC0) {
@@ -429,7 +482,32 @@ u32 AuCtx::AuDecode(u32 pcmAddr) {
 		}
 		int inbytesConsumed = 0;
 		int outSamples = 0;
-		decoder->Decode(&sourcebuff[nextSync], (int)sourcebuff.size() - nextSync, &inbytesConsumed, 2, (int16_t *)outbuf, &outSamples);
+		const uint8_t *inbuf = &sourcebuff[nextSync];
+		const int inbytes = (int)sourcebuff.size() - nextSync;
+		// Streamed, so check that the input is what the cached frame was decoded from.
+		const int16_t *cachedPcm = nullptr;
+		const DecodedAudioFrame *cachedFrame = loopCache_.PeekFrame(&cachedPcm);
+		if (cachedFrame && cachedFrame->inputBytes <= inbytes && XXH3_64bits(inbuf, cachedFrame->inputBytes) == cachedFrame->inputHash) {
+			if (outbuf != nullptr)
+				memcpy(outbuf, cachedPcm, cachedFrame->samples * 2 * sizeof(int16_t));
+			inbytesConsumed = cachedFrame->inputBytes;
+			outSamples = cachedFrame->samples;
+			RememberServedInput(inbuf, inbytesConsumed);
+			loopCache_.NextFrame();
+		} else {
+			if (loopCache_.Playing())
+				loopCache_.Abort();
+			// Also after a pass that was served from the cache, when the next one has to be decoded.
+			if (!servedInput_.empty())
+				CatchUpDecoder();
+			decoder->Decode(inbuf, inbytes, &inbytesConsumed, 2, (int16_t *)outbuf, &outSamples);
+			if (loopCache_.Recording()) {
+				if (outbuf != nullptr && outSamples > 0)
+					loopCache_.RecordFrame((const int16_t *)outbuf, outSamples, 2, inbytesConsumed, XXH3_64bits(inbuf, inbytesConsumed));
+				else
+					loopCache_.Abort();
+			}
+		}
 		outpcmbufsize = outSamples * 2 * sizeof(int16_t);
 
 		if (outpcmbufsize == 0) {
@@ -457,6 +535,17 @@ u32 AuCtx::AuDecode(u32 pcmAddr) {
 		readPos = startPos;
 		if (LoopNum > 0)
 			LoopNum--;
+
+		if (DecodedAudioCacheEnabled()) {
+			DecodedAudioKey key{};
+			key.codec = decoder->GetAudioType();
+			key.loopStart = startPos;
+			key.loopEnd = endPos;
+			key.channels = 2;
+			loopCache_.StartPass(key);
+		} else {
+			loopCache_.Abort();
+		}
 	}
 
 	if (outpcmbufsize == 0 && !end) {
@@ -571,6 +660,9 @@ u32 AuCtx::AuResetPlayPositionByFrame(int frame) {
 	SumDecodedSamples = frame * MaxOutputSample;
 	AuBufAvailable = 0;
 	sourcebuff.clear();
+	loopCache_.Abort();
+	if (!servedInput_.empty() && decoder)
+		CatchUpDecoder();
 	return 0;
 }
 
@@ -579,6 +671,9 @@ u32 AuCtx::AuResetPlayPosition() {
 	SumDecodedSamples = 0;
 	AuBufAvailable = 0;
 	sourcebuff.clear();
+	loopCache_.Abort();
+	if (!servedInput_.empty() && decoder)
+		CatchUpDecoder();
 	return 0;
 }
 
@@ -620,5 +715,8 @@ void AuCtx::DoState(PointerWrap &p) {
 
 	if (p.mode == p.MODE_READ) {
 		decoder = CreateAudioDecoder((PSPAudioType)audioType);
+		loopCache_.Abort();
+		servedInput_.clear();
+		servedInputBytes_ = 0;
 	}
 }
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
+#include "Core/HW/DecodedAudioCache.h"
 #include "Core/HW/MediaEngine.h"
 #include "Core/HLE/sceAudio.h"
 
@@ -41,6 +45,10 @@ class AudioDecoder {
 	// For Atrac3, if *outSamples != 0, it'll cap the number of samples to output. In this case, its value can only shrink.
 	// TODO: Implement that in the other decoders too, if needed.
 	virtual bool Decode(const uint8_t *inbuf, int inbytes, int *inbytesConsumed, int outputChannels, int16_t *outbuf, int *outSamples) = 0;
+	// Decodes frameCount consecutive frames of inbytes each, with the output of each following the previous one.
+	// outbuf can be null to just run the frames through the decoder, like when priming it after a seek.
+	// Stops at the first frame that fails. Returns the number of frames decoded, and *outSamples gets the total.
+	virtual int DecodeFrames(const uint8_t *inbuf, int inbytes, int frameCount, int outputChannels, int16_t *outbuf, int *outSamples);
 	virtual bool IsOK() const = 0;
 
 	virtual void SetChannels(int channels) = 0;
@@ -112,6 +120,8 @@ class AuCtx {
 
 private:
 	size_t FindNextMp3Sync();
+	void RememberServedInput(const u8 *data, int bytes);
+	void CatchUpDecoder();
 
 	std::vector<u8> sourcebuff; // source buffer
 
@@ -120,6 +130,12 @@ class AuCtx {
 	int readPos = 0; // read position in audio source file
 	int askedReadSize = 0; // the size of data requied to be read from file by the game
 	int nextOutputHalf = 0;
+
+	// Not saved, see DecodedAudioCache.h.
+	DecodedLoopCache loopCache_;
+	// Input of the last frames served from loopCache_, which the decoder hasn't seen.
+	std::deque<std::vector<u8>> servedInput_;
+	size_t servedInputBytes_ = 0;
 };
 
 
@@ -33,6 +33,7 @@
 #define CONTROL_AVG     32.0f
 
 #include "ppsspp_config.h"
+#include <cmath>
 #include <cstring>
 #include <atomic>
 
@@ -174,6 +175,128 @@ inline int16_t MixSingleSample(int16_t s1, int16_t s2, uint16_t frac) {
 		return (int16_t)value;
 }
 
+// The fraction is 16 bits, the top FILTER_PHASE_BITS of it pick the filter phase.
+static const int FILTER_PHASE_BITS = 8;
+static const int FILTER_PHASES = 1 << FILTER_PHASE_BITS;
+// Coefficients are 2.14 fixed point.
+static const int FILTER_SHIFT = 14;
+
+void StereoResampler::UpdateFilterBank(int taps, int sampleRate) {
+	if (taps == filterTaps_ && sampleRate == filterSampleRate_)
+		return;
+
+	// Cut off a bit below Nyquist of whichever side is lower, short filters have a wide transition band.
+	const double cutoff = std::min(1.0, sampleRate / 44100.0) * 0.9;
+	filterBank_.resize(FILTER_PHASES * taps);
+	std::vector<double> h(taps);
+	for (int phase = 0; phase < FILTER_PHASES; phase++) {
+		// Taps cover input frames -(taps/2 - 1) through taps/2, relative to the one we're at.
+		double sum = 0.0;
+		for (int k = 0; k < taps; k++) {
+			double x = (k - (taps / 2 - 1)) - (double)phase / FILTER_PHASES;
+			double t = M_PI * cutoff * x;
+			double sinc = t == 0.0 ? 1.0 : sin(t) / t;
+			// Blackman window over [-taps/2, taps/2].
+			double u = (x + taps / 2) / taps;
+			double window = 0.42 - 0.5 * cos(2.0 * M_PI * u) + 0.08 * cos(4.0 * M_PI * u);
+			h[k] = sinc * window;
+			sum += h[k];
+		}
+
+		// Normalize so each phase has unity gain, putting the rounding error on the largest tap.
+		int16_t *coefs = &filterBank_[phase * taps];
+		int total = 0;
+		int largest = 0;
+		for (int k = 0; k < taps; k++) {
+			coefs[k] = (int16_t)lrint(h[k] / sum * (1 << FILTER_SHIFT));
+			total += coefs[k];
+			if (abs(coefs[k]) > abs(coefs[largest]))
+				largest = k;
+		}
+		coefs[largest] += (1 << FILTER_SHIFT) - total;
+	}
+
+	filterTaps_ = taps;
+	filterSampleRate_ = sampleRate;
+}
+
+// Polyphase FIR version of the interpolation loop in Mix().
+unsigned int StereoResampler::MixSinc(short *samples, unsigned int numSamples, u32 ratio, u32 &indexR, u32 indexW) {
+	const int taps = filterTaps_;
+	const u32 bufSize = m_maxBufsize * 2;
+	const u32 INDEX_MASK = bufSize - 1;
+	// Stereo window, starting taps/2 - 1 frames back.
+	alignas(16) int16_t window[32 * 2];
+
+	u32 frac = m_frac;
+	unsigned int currentSample;
+	for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
+		// We need taps/2 frames ahead of the current one.
+		if (((indexW - indexR) & INDEX_MASK) <= (u32)taps) {
+			underrunCount_++;
+			break;
+		}
+
+		u32 start = (indexR - (taps - 2)) & INDEX_MASK;
+		const int16_t *src = &m_buffer[start];
+		if (start + taps * 2 > bufSize) {
+			// Wraps around the end of the buffer, gather it.
+			for (int i = 0; i < taps * 2; i++)
+				window[i] = m_buffer[(start + i) & INDEX_MASK];
+			src = window;
+		}
+		const int16_t *coefs = &filterBank_[(frac >> (16 - FILTER_PHASE_BITS)) * taps];
+
+#ifdef _M_SSE
+		__m128i acc = _mm_setzero_si128();
+		for (int k = 0; k < taps; k += 4) {
+			// Four frames, L0 R0 L1 R1 L2 R2 L3 R3, rearranged to L0 L1 R0 R1 L2 L3 R2 R3 for pairwise multiply-add.
+			__m128i frames = _mm_loadu_si128((const __m128i *)(src + k * 2));
+			frames = _mm_shufflehi_epi16(_mm_shufflelo_epi16(frames, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+			// And the coefficients to match, c0 c1 c0 c1 c2 c3 c2 c3.
+			__m128i c = _mm_loadl_epi64((const __m128i *)(coefs + k));
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(frames, _mm_unpacklo_epi32(c, c)));
+		}
+		// Now L01 R01 L23 R23, sum up the halves.
+		acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+		acc = _mm_srai_epi32(_mm_add_epi32(acc, _mm_set1_epi32(1 << (FILTER_SHIFT - 1))), FILTER_SHIFT);
+		int32_t out = _mm_cvtsi128_si32(_mm_packs_epi32(acc, acc));
+		memcpy(&samples[currentSample], &out, sizeof(out));
+#elif PPSSPP_ARCH(ARM_NEON)
+		int32x4_t accL = vdupq_n_s32(0);
+		int32x4_t accR = vdupq_n_s32(0);
+		for (int k = 0; k < taps; k += 8) {
+			int16x8x2_t frames = vld2q_s16(src + k * 2);
+			int16x8_t c = vld1q_s16(coefs + k);
+			accL = vmlal_s16(accL, vget_low_s16(frames.val[0]), vget_low_s16(c));
+			accL = vmlal_s16(accL, vget_high_s16(frames.val[0]), vget_high_s16(c));
+			accR = vmlal_s16(accR, vget_low_s16(frames.val[1]), vget_low_s16(c));
+			accR = vmlal_s16(accR, vget_high_s16(frames.val[1]), vget_high_s16(c));
+		}
+		int32x2_t sumL = vpadd_s32(vget_low_s32(accL), vget_high_s32(accL));
+		int32x2_t sumR = vpadd_s32(vget_low_s32(accR), vget_high_s32(accR));
+		int32x2_t sum = vpadd_s32(sumL, sumR);
+		int16x4_t out = vqrshrn_n_s32(vcombine_s32(sum, sum), FILTER_SHIFT);
+		samples[currentSample] = vget_lane_s16(out, 0);
+		samples[currentSample + 1] = vget_lane_s16(out, 1);
+#else
+		int sumL = 0, sumR = 0;
+		for (int k = 0; k < taps; k++) {
+			sumL += src[k * 2] * coefs[k];
+			sumR += src[k * 2 + 1] * coefs[k];
+		}
+		samples[currentSample] = clamp_s16((sumL + (1 << (FILTER_SHIFT - 1))) >> FILTER_SHIFT);
+		samples[currentSample + 1] = clamp_s16((sumR + (1 << (FILTER_SHIFT - 1))) >> FILTER_SHIFT);
+#endif
+
+		frac += ratio;
+		indexR += 2 * (frac >> 16);
+		frac &= 0xffff;
+	}
+	m_frac = frac;
+	return currentSample;
+}
+
 // Executed from sound stream thread, pulling sound out of the buffer.
 unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool consider_framelimit, int sample_rate) {
 	if (!samples)
@@ -219,29 +342,34 @@ unsigned int StereoResampler::Mix(short* samples, unsigned int numSamples, bool
 	output_sample_rate_ = (float)(m_input_sample_rate + offset);
 	const u32 ratio = (u32)(65536.0 * output_sample_rate_ / (double)sample_rate);
 	ratio_ = ratio;
-	// TODO: consider a higher-quality resampling algorithm.
 	// TODO: Add a fast path for 1:1.
-	u32 frac = m_frac;
-	for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
-		if (((indexW - indexR) & INDEX_MASK) <= 2) {
-			// Ran out!
-			// int missing = numSamples * 2 - currentSample;
-			// ILOG("Resampler underrun: %d (numSamples: %d, currentSample: %d)", missing, numSamples, currentSample / 2);
-			underrunCount_++;
-			break;
+	const int quality = g_Config.iAudioResampler;
+	if (quality == AUDIO_RESAMPLER_SINC8 || quality == AUDIO_RESAMPLER_SINC16) {
+		UpdateFilterBank(quality == AUDIO_RESAMPLER_SINC16 ? 16 : 8, sample_rate);
+		currentSample = MixSinc(samples, numSamples, ratio, indexR, indexW);
+	} else {
+		u32 frac = m_frac;
+		for (currentSample = 0; currentSample < numSamples * 2; currentSample += 2) {
+			if (((indexW - indexR) & INDEX_MASK) <= 2) {
+				// Ran out!
+				// int missing = numSamples * 2 - currentSample;
+				// ILOG("Resampler underrun: %d (numSamples: %d, currentSample: %d)", missing, numSamples, currentSample / 2);
+				underrunCount_++;
+				break;
+			}
+			u32 indexR2 = indexR + 2; //next sample
+			s16 l1 = m_buffer[indexR & INDEX_MASK]; //current
+			s16 r1 = m_buffer[(indexR + 1) & INDEX_MASK]; //current
+			s16 l2 = m_buffer[indexR2 & INDEX_MASK]; //next
+			s16 r2 = m_buffer[(indexR2 + 1) & INDEX_MASK]; //next
+			samples[currentSample] = MixSingleSample(l1, l2, (u16)frac);
+			samples[currentSample + 1] = MixSingleSample(r1, r2, (u16)frac);
+			frac += ratio;
+			indexR += 2 * (frac >> 16);
+			frac &= 0xffff;
 		}
-		u32 indexR2 = indexR + 2; //next sample
-		s16 l1 = m_buffer[indexR & INDEX_MASK]; //current
-		s16 r1 = m_buffer[(indexR + 1) & INDEX_MASK]; //current
-		s16 l2 = m_buffer[indexR2 & INDEX_MASK]; //next
-		s16 r2 = m_buffer[(indexR2 + 1) & INDEX_MASK]; //next
-		samples[currentSample] = MixSingleSample(l1, l2, (u16)frac);
-		samples[currentSample + 1] = MixSingleSample(r1, r2, (u16)frac);
-		frac += ratio;
-		indexR += 2 * (frac >> 16);
-		frac &= 0xffff;
+		m_frac = frac;
 	}
-	m_frac = frac;
 
 	// Let's not count the underrun padding here.
 	outputSampleCount_ += currentSample / 2;
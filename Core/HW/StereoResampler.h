@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <atomic>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -45,6 +46,8 @@ class StereoResampler {
 
 private:
 	void UpdateBufferSize();
+	void UpdateFilterBank(int taps, int sampleRate);
+	unsigned int MixSinc(short *samples, unsigned int numSamples, u32 ratio, u32 &indexR, u32 indexW);
 
 	int m_maxBufsize;
 	int m_targetBufsize;
@@ -56,6 +59,11 @@ class StereoResampler {
 	float m_numLeftI = 0.0f;
 
 	u32 m_frac = 0;
+
+	// Windowed sinc coefficients for the higher quality modes, filterTaps_ per phase.
+	std::vector<int16_t> filterBank_;
+	int filterTaps_ = 0;
+	int filterSampleRate_ = 0;
 	float output_sample_rate_ = 0.0;
 	int lastBufSize_ = 0;
 	int lastPushSize_ = 0;
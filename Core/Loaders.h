@@ -63,6 +63,8 @@ class FileLoader {
 		NONE,
 		// Not necessary to read from / store into cache.
 		HINT_UNCACHED,
+		// Read ahead of time by a cache, not asked for by the game.
+		HINT_PREFETCH,
 	};
 
 	virtual ~FileLoader() {}
@@ -86,6 +88,10 @@ class FileLoader {
 	// Cancel any operations that might block, if possible.
 	virtual void Cancel() {}
 
+	// The game is about to boot from this file. Caches only record and prefetch its reads after this.
+	// Call before the loader is used from other threads.
+	virtual void PrepareForBoot() {}
+
 	virtual std::string LatestError() const {
 		return "";
 	}
@@ -120,6 +126,9 @@ class ProxiedFileLoader : public FileLoader {
 	void Cancel() override {
 		backend_->Cancel();
 	}
+	void PrepareForBoot() override {
+		backend_->PrepareForBoot();
+	}
 	std::string LatestError() const override {
 		return backend_->LatestError();
 	}
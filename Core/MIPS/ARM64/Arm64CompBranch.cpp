@@ -718,6 +718,16 @@ void Arm64Jit::Comp_Syscall(MIPSOpcode op)
 	LoadStaticRegisters();
 	ApplyRoundingMode();
 
+	if (!js.inDelaySlot && IsPureSyscall(op)) {
+		// PC was already updated, so just bail if coreState changed and otherwise keep going in this block.
+		MOVP2R(SCRATCH1_64, &coreState);
+		LDR(INDEX_UNSIGNED, SCRATCH1, SCRATCH1_64, 0);
+		FixupBranch keepGoing = CBZ(SCRATCH1);
+		WriteSyscallExit();
+		SetJumpTarget(keepGoing);
+		return;
+	}
+
 	WriteSyscallExit();
 	js.compiling = false;
 }
@@ -22,6 +22,7 @@
 #include <algorithm>
 
 #include "Common/Data/Convert/SmallDataConvert.h"
+#include "Common/Math/CrossSIMD.h"
 #include "Common/Math/math_util.h"
 
 #include "Core/Compatibility.h"
@@ -181,6 +182,100 @@ static void RetainInvalidSwizzleST(float *d, VectorSize sz) {
 	}
 }
 
+// SIMD versions of common unprefixed 4x4 ops. These must stay bit-exact with the scalar
+// loops, so each lane does the same multiplies and adds in the same order.
+#if PPSSPP_ARCH(SSE2) || PPSSPP_ARCH(ARM64_NEON)
+#define VFPU_SIMD_PATHS
+#endif
+
+// GCC and Clang contract the scalar "sum += a * b" into a fused multiply-add on ARM64,
+// so the NEON paths need to fuse as well to give the same results.
+#if PPSSPP_ARCH(ARM64_NEON) && !defined(_MSC_VER)
+#define VFPU_MLA_LANE(acc, a, b, lane) vfmaq_laneq_f32(acc, a, b, lane)
+#elif PPSSPP_ARCH(ARM64_NEON)
+#define VFPU_MLA_LANE(acc, a, b, lane) vaddq_f32(acc, vmulq_laneq_f32(a, b, lane))
+#endif
+
+static bool vfpuSimdEnabled = true;
+
+static inline bool UseSimdPath() {
+	return vfpuSimdEnabled &&
+		currentMIPS->vfpuCtrl[VFPU_CTRL_SPREFIX] == 0xe4 &&
+		currentMIPS->vfpuCtrl[VFPU_CTRL_TPREFIX] == 0xe4 &&
+		currentMIPS->vfpuCtrl[VFPU_CTRL_DPREFIX] == 0;
+}
+
+#ifdef VFPU_SIMD_PATHS
+
+// d[a * 4 + b] = 0 + s[b * 4 + 0] * t[a * 4 + 0] + ... + s[b * 4 + 3] * t[a * 4 + 3], summed left to right.
+static void MatrixMul4x4(float *d, const float *s, const float *t) {
+#if PPSSPP_ARCH(SSE2)
+	__m128 c0 = _mm_loadu_ps(s);
+	__m128 c1 = _mm_loadu_ps(s + 4);
+	__m128 c2 = _mm_loadu_ps(s + 8);
+	__m128 c3 = _mm_loadu_ps(s + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	for (int a = 0; a < 4; a++) {
+		__m128 sum = _mm_setzero_ps();
+		sum = _mm_add_ps(sum, _mm_mul_ps(c0, _mm_set1_ps(t[a * 4 + 0])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(t[a * 4 + 1])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(t[a * 4 + 2])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(t[a * 4 + 3])));
+		_mm_storeu_ps(d + a * 4, sum);
+	}
+#else
+	float32x4x4_t c = vld4q_f32(s);
+	for (int a = 0; a < 4; a++) {
+		float32x4_t tv = vld1q_f32(t + a * 4);
+		float32x4_t sum = vdupq_n_f32(0.0f);
+		sum = VFPU_MLA_LANE(sum, c.val[0], tv, 0);
+		sum = VFPU_MLA_LANE(sum, c.val[1], tv, 1);
+		sum = VFPU_MLA_LANE(sum, c.val[2], tv, 2);
+		sum = VFPU_MLA_LANE(sum, c.val[3], tv, 3);
+		vst1q_f32(d + a * 4, sum);
+	}
+#endif
+}
+
+// d[i] = s[i * 4 + 0] * t[0] + ... + s[i * 4 + 3] * t[3], summed left to right.
+static void Transform4(float *d, const float *s, const float *t) {
+#if PPSSPP_ARCH(SSE2)
+	__m128 c0 = _mm_loadu_ps(s);
+	__m128 c1 = _mm_loadu_ps(s + 4);
+	__m128 c2 = _mm_loadu_ps(s + 8);
+	__m128 c3 = _mm_loadu_ps(s + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	__m128 sum = _mm_mul_ps(c0, _mm_set1_ps(t[0]));
+	sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(t[1])));
+	sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(t[2])));
+	sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(t[3])));
+	_mm_storeu_ps(d, sum);
+#else
+	float32x4x4_t c = vld4q_f32(s);
+	float32x4_t tv = vld1q_f32(t);
+	float32x4_t sum = vmulq_laneq_f32(c.val[0], tv, 0);
+	sum = VFPU_MLA_LANE(sum, c.val[1], tv, 1);
+	sum = VFPU_MLA_LANE(sum, c.val[2], tv, 2);
+	sum = VFPU_MLA_LANE(sum, c.val[3], tv, 3);
+	vst1q_f32(d, sum);
+#endif
+}
+
+static void Scale(float *d, const float *s, float t, int count) {
+#if PPSSPP_ARCH(SSE2)
+	__m128 tv = _mm_set1_ps(t);
+	for (int i = 0; i < count; i += 4) {
+		_mm_storeu_ps(d + i, _mm_mul_ps(_mm_loadu_ps(s + i), tv));
+	}
+#else
+	for (int i = 0; i < count; i += 4) {
+		vst1q_f32(d + i, vmulq_n_f32(vld1q_f32(s + i), t));
+	}
+#endif
+}
+
+#endif
+
 void EatPrefixes()
 {
 	currentMIPS->vfpuCtrl[VFPU_CTRL_SPREFIX] = 0xe4;  // passthru
@@ -190,6 +285,10 @@ void EatPrefixes()
 
 namespace MIPSInt
 {
+	void SetVFPUSimdEnabled(bool enabled) {
+		vfpuSimdEnabled = enabled;
+	}
+
 	void Int_VPFX(MIPSOpcode op)
 	{
 		int data = op & 0x000FFFFF;
@@ -478,6 +577,16 @@ namespace MIPSInt
 
 		// TODO: Always use the more accurate path in interpreter?
 		bool useAccurateDot = USE_VFPU_DOT || PSP_CoreParameter().compat.flags().MoreAccurateVMMUL;
+#ifdef VFPU_SIMD_PATHS
+		if (sz == M_4x4 && !useAccurateDot && UseSimdPath()) {
+			MatrixMul4x4(d, s, t);
+			WriteMatrix(d, sz, vd);
+			PC += 4;
+			EatPrefixes();
+			return;
+		}
+#endif
+
 		for (int a = 0; a < n; a++) {
 			for (int b = 0; b < n; b++) {
 				union { float f; uint32_t u; } sum = { 0.0f };
@@ -532,6 +641,17 @@ namespace MIPSInt
 		ReadMatrix(s, sz, vs);
 		ReadVector(t, V_Single, vt);
 
+#ifdef VFPU_SIMD_PATHS
+		if (sz == M_4x4 && UseSimdPath()) {
+			// Without a T prefix, the last row also uses x.
+			Scale(d, s, t[0], 16);
+			WriteMatrix(d, sz, vd);
+			PC += 4;
+			EatPrefixes();
+			return;
+		}
+#endif
+
 		for (int a = 0; a < n - 1; a++) {
 			for (int b = 0; b < n; b++) {
 				d[a * 4 + b] = s[a * 4 + b] * t[0];
@@ -1530,6 +1650,17 @@ namespace MIPSInt
 		int vt = _VT;
 		VectorSize sz = GetVecSize(op);
 		ReadVector(s, sz, vs);
+
+#ifdef VFPU_SIMD_PATHS
+		if (sz == V_Quad && UseSimdPath()) {
+			Scale(d, s, V(vt), 4);
+			WriteVector(d, sz, vd);
+			PC += 4;
+			EatPrefixes();
+			return;
+		}
+#endif
+
 		ApplySwizzleS(s, sz);
 
 		// T prefix forces swizzle (zzzz for some reason, so we force V_Quad.)
@@ -1668,6 +1799,20 @@ namespace MIPSInt
 		ReadMatrix(s, msz, vs);
 		ReadVector(t, sz, vt);
 
+#ifdef VFPU_SIMD_PATHS
+		// vtfm4 and vhtfm4. For the latter, the row's w is added as-is, same as multiplying by 1.
+		if (ins == 3 && n >= 3 && !USE_VFPU_DOT && UseSimdPath()) {
+			if (n == 3) {
+				t[3] = 1.0f;
+			}
+			Transform4(d.f, s, t);
+			WriteVector(d.f, sz, vd);
+			PC += 4;
+			EatPrefixes();
+			return;
+		}
+#endif
+
 		if (USE_VFPU_DOT) {
 			float t2[4];
 			for (int i = 0; i < 4; i++) {
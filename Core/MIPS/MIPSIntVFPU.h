@@ -78,4 +78,7 @@ namespace MIPSInt
 	void Int_Vwbn(MIPSOpcode op);
 	void Int_Vsbn(MIPSOpcode op);
 	void Int_Vsbz(MIPSOpcode op);
+
+	// For testing. The SIMD fast paths must give the same results as the scalar ones.
+	void SetVFPUSimdEnabled(bool enabled);
 }
@@ -22,6 +22,7 @@
 
 #include "Common/BitScan.h"
 #include "Common/CommonFuncs.h"
+#include "Common/Math/CrossSIMD.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/StringUtils.h"
 #include "Core/Reporting.h"
@@ -234,6 +235,33 @@ u32 VFPURewritePrefix(int ctrl, u32 remove, u32 add) {
 	return (prefix & ~remove) | add;
 }
 
+static void Transpose4x4(float *dst, const float *src) {
+#if PPSSPP_ARCH(SSE2)
+	__m128 r0 = _mm_loadu_ps(src);
+	__m128 r1 = _mm_loadu_ps(src + 4);
+	__m128 r2 = _mm_loadu_ps(src + 8);
+	__m128 r3 = _mm_loadu_ps(src + 12);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(dst, r0);
+	_mm_storeu_ps(dst + 4, r1);
+	_mm_storeu_ps(dst + 8, r2);
+	_mm_storeu_ps(dst + 12, r3);
+#elif PPSSPP_ARCH(ARM_NEON)
+	// De-interleaving load, so each val[] is a column.
+	float32x4x4_t cols = vld4q_f32(src);
+	vst1q_f32(dst, cols.val[0]);
+	vst1q_f32(dst + 4, cols.val[1]);
+	vst1q_f32(dst + 8, cols.val[2]);
+	vst1q_f32(dst + 12, cols.val[3]);
+#else
+	for (int j = 0; j < 4; j++) {
+		for (int i = 0; i < 4; i++) {
+			dst[j * 4 + i] = src[i * 4 + j];
+		}
+	}
+#endif
+}
+
 void ReadMatrix(float *rd, MatrixSize size, int reg) {
 	int row = 0;
 	int side = 0;
@@ -255,12 +283,8 @@ void ReadMatrix(float *rd, MatrixSize size, int reg) {
 	const float *v = currentMIPS->v + (size_t)mtx * 16;
 	if (transpose) {
 		if (side == 4 && col == 0 && row == 0) {
-			// Fast path: Simple 4x4 transpose. TODO: Optimize.
-			for (int j = 0; j < 4; j++) {
-				for (int i = 0; i < 4; i++) {
-					rd[j * 4 + i] = v[i * 4 + j];
-				}
-			}
+			// Fast path: Simple 4x4 transpose.
+			Transpose4x4(rd, v);
 		} else {
 			for (int j = 0; j < side; j++) {
 				for (int i = 0; i < side; i++) {
@@ -309,12 +333,8 @@ void WriteMatrix(const float *rd, MatrixSize size, int reg) {
 	float *v = currentMIPS->v + (size_t)mtx * 16;
 	if (transpose) {
 		if (side == 4 && row == 0 && col == 0 && currentMIPS->VfpuWriteMask() == 0x0) {
-			// Fast path: Simple 4x4 transpose. TODO: Optimize.
-			for (int j = 0; j < side; j++) {
-				for (int i = 0; i < side; i++) {
-					v[i * 4 + j] = rd[j * 4 + i];
-				}
-			}
+			// Fast path: Simple 4x4 transpose.
+			Transpose4x4(v, rd);
 		} else {
 			for (int j = 0; j < side; j++) {
 				for (int i = 0; i < side; i++) {
@@ -841,6 +841,11 @@ void Jit::Comp_Syscall(MIPSOpcode op)
 #endif
 
 	ApplyRoundingMode();
+	if (!js.inDelaySlot && IsPureSyscall(op)) {
+		// PC was already updated, so just check coreState and keep going in this block.
+		js.afterOp |= JitState::AFTER_CORE_STATE;
+		return;
+	}
 	WriteSyscallExit();
 	js.compiling = false;
 }
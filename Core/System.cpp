@@ -450,6 +450,7 @@ bool PSP_InitStart(const CoreParameter &coreParam, std::string *error_string) {
 		loadedFile = new RamCachingFileLoader(loadedFile);
 	}
 #endif
+	loadedFile->PrepareForBoot();
 
 	if (g_Config.bAchievementsEnable) {
 		// Need to re-identify after ResolveFileLoaderTarget - although in practice probably not,
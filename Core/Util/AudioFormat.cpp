@@ -151,3 +151,79 @@ void ConvertS16ToF32(float *out, const s16 *in, size_t size) {
 		out[i] = in[i] * (1.0f / 32767.0f);
 	}
 }
+
+void ConvertS16ToS32(s32 *out, const s16 *in, size_t size) {
+#ifdef _M_SSE
+	while (size >= 8) {
+		__m128i indata = _mm_loadu_si128((const __m128i *)in);
+		// Unpacking with itself puts each sample in the top half, so an arithmetic shift sign extends it.
+		_mm_storeu_si128((__m128i *)out, _mm_srai_epi32(_mm_unpacklo_epi16(indata, indata), 16));
+		_mm_storeu_si128((__m128i *)(out + 4), _mm_srai_epi32(_mm_unpackhi_epi16(indata, indata), 16));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	while (size >= 8) {
+		int16x8_t indata = vld1q_s16(in);
+		vst1q_s32(out, vmovl_s16(vget_low_s16(indata)));
+		vst1q_s32(out + 4, vmovl_s16(vget_high_s16(indata)));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#endif
+	for (size_t i = 0; i < size; i++) {
+		out[i] = in[i];
+	}
+}
+
+void AddS16ToS32(s32 *out, const s16 *in, size_t size) {
+#ifdef _M_SSE
+	while (size >= 8) {
+		__m128i indata = _mm_loadu_si128((const __m128i *)in);
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(indata, indata), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(indata, indata), 16);
+		_mm_storeu_si128((__m128i *)out, _mm_add_epi32(_mm_loadu_si128((const __m128i *)out), lo));
+		_mm_storeu_si128((__m128i *)(out + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(out + 4)), hi));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	while (size >= 8) {
+		int16x8_t indata = vld1q_s16(in);
+		vst1q_s32(out, vaddw_s16(vld1q_s32(out), vget_low_s16(indata)));
+		vst1q_s32(out + 4, vaddw_s16(vld1q_s32(out + 4), vget_high_s16(indata)));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#endif
+	for (size_t i = 0; i < size; i++) {
+		out[i] += in[i];
+	}
+}
+
+void ClampS32ToS16(s16 *out, const s32 *in, size_t size) {
+#ifdef _M_SSE
+	while (size >= 8) {
+		__m128i in1 = _mm_loadu_si128((const __m128i *)in);
+		__m128i in2 = _mm_loadu_si128((const __m128i *)(in + 4));
+		_mm_storeu_si128((__m128i *)out, _mm_packs_epi32(in1, in2));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	while (size >= 8) {
+		vst1q_s16(out, vcombine_s16(vqmovn_s32(vld1q_s32(in)), vqmovn_s32(vld1q_s32(in + 4))));
+		in += 8;
+		out += 8;
+		size -= 8;
+	}
+#endif
+	for (size_t i = 0; i < size; i++) {
+		out[i] = clamp_s16(in[i]);
+	}
+}
@@ -67,3 +67,10 @@ static inline s16 ApplySampleVolume20Bit(s16 sample, int vol20) {
 
 void AdjustVolumeBlock(s16 *out, s16 *in, size_t size, int leftVol, int rightVol);
 void ConvertS16ToF32(float *ou, const s16 *in, size_t size);
+
+// Sign extends s16 samples to s32, for the first channel of a mix.
+void ConvertS16ToS32(s32 *out, const s16 *in, size_t size);
+// Adds s16 samples into an s32 mix.
+void AddS16ToS32(s32 *out, const s16 *in, size_t size);
+// Saturates an s32 mix back down to s16.
+void ClampS32ToS16(s16 *out, const s32 *in, size_t size);
@@ -0,0 +1,222 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/Swap.h"
+#include "Core/Util/GameInfoIndex.h"
+
+static const char * const INDEX_MAGIC = "ppssppGI";
+
+struct GameInfoIndexHeader {
+	char magic[8];
+	u32_le version;
+	u32_le count;
+};
+
+struct GameInfoIndexEntry {
+	u64_le size;
+	u64_le mtime;
+	u64_le lastUsed;
+	u64_le uncompressedSize;
+	u32_le flags;
+	u32_le fileType;
+	u32_le keyLength;
+	u32_le paramSFOLength;
+	u32_le iconLength;
+};
+
+static u64 Now() {
+	return (u64)time(nullptr);
+}
+
+GameInfoIndex::GameInfoIndex(const Path &filename, size_t maxBytes) : filename_(filename), maxBytes_(maxBytes) {}
+
+bool GameInfoIndex::Lookup(const std::string &key, u64 size, u64 mtime, Entry *entry) {
+	std::lock_guard<std::mutex> guard(lock_);
+	LoadNoLock();
+	auto iter = entries_.find(key);
+	if (iter == entries_.end())
+		return false;
+	if (iter->second.entry.size != size || iter->second.entry.mtime != mtime) {
+		entries_.erase(iter);
+		dirty_ = true;
+		return false;
+	}
+	*entry = iter->second.entry;
+	// Not worth a write on its own, but kept if something else changes.
+	iter->second.lastUsed = Now();
+	return true;
+}
+
+void GameInfoIndex::Store(const std::string &key, const Entry &entry) {
+	std::lock_guard<std::mutex> guard(lock_);
+	LoadNoLock();
+	entries_[key] = StoredEntry{ entry, Now() };
+	dirty_ = true;
+}
+
+size_t GameInfoIndex::Count() {
+	std::lock_guard<std::mutex> guard(lock_);
+	LoadNoLock();
+	return entries_.size();
+}
+
+void GameInfoIndex::LoadNoLock() {
+	if (loaded_)
+		return;
+	loaded_ = true;
+
+	if (filename_.empty())
+		return;
+	std::string data;
+	if (!File::ReadBinaryFileToString(filename_, &data))
+		return;
+
+	GameInfoIndexHeader header;
+	bool valid = data.size() >= sizeof(header);
+	if (valid) {
+		memcpy(&header, data.data(), sizeof(header));
+		valid = memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 && header.version == INDEX_VERSION;
+	}
+
+	size_t pos = sizeof(header);
+	for (u32 i = 0; valid && i < header.count; ++i) {
+		GameInfoIndexEntry stored;
+		if (data.size() - pos < sizeof(stored)) {
+			valid = false;
+			break;
+		}
+		memcpy(&stored, data.data() + pos, sizeof(stored));
+		pos += sizeof(stored);
+		const u64 length = (u64)stored.keyLength + stored.paramSFOLength + stored.iconLength;
+		if (data.size() - pos < length) {
+			valid = false;
+			break;
+		}
+
+		std::string key = data.substr(pos, stored.keyLength);
+		pos += stored.keyLength;
+		StoredEntry &out = entries_[key];
+		out.entry.size = stored.size;
+		out.entry.mtime = stored.mtime;
+		out.entry.flags = stored.flags;
+		out.entry.fileType = stored.fileType;
+		out.entry.uncompressedSize = stored.uncompressedSize;
+		out.entry.paramSFO = data.substr(pos, stored.paramSFOLength);
+		pos += stored.paramSFOLength;
+		out.entry.icon = data.substr(pos, stored.iconLength);
+		pos += stored.iconLength;
+		out.lastUsed = stored.lastUsed;
+	}
+
+	if (valid) {
+		INFO_LOG(Log::Loader, "Loaded game info index: %d entries", (int)entries_.size());
+	} else {
+		WARN_LOG(Log::Loader, "Ignoring invalid game info index %s", filename_.c_str());
+		entries_.clear();
+	}
+}
+
+void GameInfoIndex::Save() {
+	// Separate from lock_, lookups can go on while it's being written.
+	std::lock_guard<std::mutex> saveGuard(saveLock_);
+	std::string data;
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		if (!dirty_ || filename_.empty())
+			return;
+		dirty_ = false;
+
+		std::vector<std::pair<u64, const std::string *>> order;
+		order.reserve(entries_.size());
+		for (const auto &iter : entries_)
+			order.emplace_back(iter.second.lastUsed, &iter.first);
+		std::sort(order.begin(), order.end(), [](const std::pair<u64, const std::string *> &a, const std::pair<u64, const std::string *> &b) {
+			return a.first > b.first;
+		});
+
+		size_t total = sizeof(GameInfoIndexHeader);
+		size_t count = 0;
+		for (const auto &iter : order) {
+			const Entry &entry = entries_[*iter.second].entry;
+			size_t length = sizeof(GameInfoIndexEntry) + iter.second->size() + entry.paramSFO.size() + entry.icon.size();
+			if (total + length > maxBytes_)
+				break;
+			total += length;
+			count++;
+		}
+		// The ones that didn't fit are gone for this session too, so what's in memory matches the file.
+		for (size_t i = count; i < order.size(); ++i) {
+			const std::string key = *order[i].second;
+			entries_.erase(key);
+		}
+		order.resize(count);
+
+		GameInfoIndexHeader header{};
+		memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+		header.version = INDEX_VERSION;
+		header.count = (u32)count;
+		data.reserve(total);
+		data.append((const char *)&header, sizeof(header));
+		for (const auto &iter : order) {
+			const std::string &key = *iter.second;
+			const StoredEntry &stored = entries_[key];
+			GameInfoIndexEntry out;
+			out.size = stored.entry.size;
+			out.mtime = stored.entry.mtime;
+			out.lastUsed = stored.lastUsed;
+			out.uncompressedSize = stored.entry.uncompressedSize;
+			out.flags = stored.entry.flags;
+			out.fileType = stored.entry.fileType;
+			out.keyLength = (u32)key.size();
+			out.paramSFOLength = (u32)stored.entry.paramSFO.size();
+			out.iconLength = (u32)stored.entry.icon.size();
+			data.append((const char *)&out, sizeof(out));
+			data.append(key);
+			data.append(stored.entry.paramSFO);
+			data.append(stored.entry.icon);
+		}
+	}
+
+	// Written to the side first, so a crash midway doesn't lose the whole index.
+	const Path tempPath = filename_.WithExtraExtension(".tmp");
+	if (!File::WriteDataToFile(false, data.data(), data.size(), tempPath)) {
+		ERROR_LOG(Log::Loader, "Failed to write game info index %s", filename_.c_str());
+		File::Delete(tempPath);
+		return;
+	}
+	// Only POSIX rename replaces the old index (atomically.) On Windows and with content URIs it
+	// fails if the file is there, so it has to go first.
+	bool renameReplaces = filename_.Type() == PathType::NATIVE;
+#ifdef _WIN32
+	renameReplaces = false;
+#endif
+	if (!renameReplaces && File::Exists(filename_))
+		File::Delete(filename_);
+	if (!File::Rename(tempPath, filename_)) {
+		ERROR_LOG(Log::Loader, "Failed to write game info index %s", filename_.c_str());
+		File::Delete(tempPath);
+		return;
+	}
+	INFO_LOG(Log::Loader, "Saved game info index: %d bytes", (int)data.size());
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
+
+// Remembers what the game list found inside each game file, so that browsing a big library
+// (possibly on network storage) doesn't have to open every image again. An entry is only used
+// while the file has the same size and modification time as when it was scanned.
+// Loaded on first use, so construction is free. With an empty filename it's only kept in memory.
+// All functions are thread safe.
+class GameInfoIndex {
+public:
+	struct Entry {
+		u64 size = 0;
+		u64 mtime = 0;
+		// Which parts the entry has, up to the user what the bits mean.
+		u32 flags = 0;
+		u32 fileType = 0;
+		u64 uncompressedSize = 0;
+		// PARAM.SFO as found in the file. It's small and quick to parse again.
+		std::string paramSFO;
+		// ICON0.PNG as found in the file, empty if there's none.
+		std::string icon;
+	};
+
+	enum {
+		// Icons are most of it, typically 10-30 KB each.
+		DEFAULT_MAX_BYTES = 48 * 1024 * 1024,
+	};
+
+	GameInfoIndex(const Path &filename, size_t maxBytes = DEFAULT_MAX_BYTES);
+
+	// Forgets the entry if the file has changed since it was stored.
+	bool Lookup(const std::string &key, u64 size, u64 mtime, Entry *entry);
+	void Store(const std::string &key, const Entry &entry);
+	size_t Count();
+
+	// Writes the index out if anything changed. Least recently used entries are dropped
+	// if it's grown too big.
+	void Save();
+
+private:
+	void LoadNoLock();
+
+	enum {
+		INDEX_VERSION = 1,
+	};
+
+	struct StoredEntry {
+		Entry entry;
+		// Seconds since the epoch.
+		u64 lastUsed;
+	};
+
+	Path filename_;
+	size_t maxBytes_;
+	std::mutex lock_;
+	std::mutex saveLock_;
+	std::unordered_map<std::string, StoredEntry> entries_;
+	bool loaded_ = false;
+	bool dirty_ = false;
+};
@@ -40,6 +40,7 @@
 #include "Common/File/FileUtil.h"
 #include "Common/StringUtils.h"
 #include "Common/Thread/ThreadUtil.h"
+#include "Common/TimeUtil.h"
 #include "Core/Config.h"
 #include "Core/Loaders.h"
 #include "Core/ELF/ParamSFO.h"
@@ -47,6 +48,7 @@
 #include "Core/System.h"
 #include "Core/FileSystems/ISOFileSystem.h"
 #include "Core/Util/GameManager.h"
+#include "Core/Util/ZipExtractor.h"
 #include "Common/Data/Text/I18n.h"
 
 GameManager g_GameManager;
@@ -447,14 +449,14 @@ void GameManager::InstallZipContents(ZipFileTask task) {
 		Path pspGame = GetSysDirectory(DIRECTORY_GAME);
 		INFO_LOG(Log::HLE, "Installing '%s' into '%s'", task.fileName.c_str(), pspGame.c_str());
 		// InstallZipContents contains code to close z.
-		success = ExtractZipContents(z, pspGame, zipInfo, false);
+		success = ExtractZipContents(z, task.fileName, pspGame, zipInfo, false);
 		break;
 	}
 	case ZipFileContents::ISO_FILE:
 	{
 		INFO_LOG(Log::HLE, "Installing '%s' into '%s'", task.fileName.c_str(), task.destination.c_str());
 		// InstallZippedISO contains code to close z.
-		success = InstallZippedISO(z, zipInfo.isoFileIndex, task.destination);
+		success = InstallZippedISO(z, zipInfo.isoFileIndex, task.fileName, task.destination);
 		break;
 	}
 	case ZipFileContents::TEXTURE_PACK:
@@ -470,7 +472,7 @@ void GameManager::InstallZipContents(ZipFileTask task) {
 			} else {
 				// TODO: Can probably remove this, as we now put .nomedia in /TEXTURES directly.
 				File::CreateEmptyFile(dest / ".nomedia");
-				success = ExtractZipContents(z, dest, zipInfo, true);
+				success = ExtractZipContents(z, task.fileName, dest, zipInfo, true);
 			}
 		} else {
 			zip_close(z);
@@ -481,7 +483,7 @@ void GameManager::InstallZipContents(ZipFileTask task) {
 	case ZipFileContents::SAVE_DATA:
 	{
 		Path pspSaveData = GetSysDirectory(DIRECTORY_SAVEDATA);
-		success = ExtractZipContents(z, pspSaveData, zipInfo, false);
+		success = ExtractZipContents(z, task.fileName, pspSaveData, zipInfo, false);
 		break;
 	}
 	default:
@@ -653,72 +655,24 @@ bool ZipExtractFileToMemory(struct zip *z, int fileIndex, std::string *data) {
 	}
 }
 
-bool GameManager::ExtractFile(struct zip *z, int file_index, const Path &outFilename, size_t *bytesCopied, size_t allBytes) {
-	struct zip_stat zstat;
-	zip_stat_index(z, file_index, 0, &zstat);
-	size_t size = zstat.size;
-	zip_file *zf = zip_fopen_index(z, file_index, 0);
-	if (!zf) {
-		ERROR_LOG(Log::HLE, "Failed to open file by index (%d) (%s)", file_index, outFilename.c_str());
-		return false;
+// Shows how fast it's going, mostly useful for big installs.
+static std::string InstallingMessage(double megabytesPerSecond) {
+	auto di = GetI18NCategory(I18NCat::DIALOG);
+	std::string message(di->T("Installing..."));
+	if (megabytesPerSecond > 0.0) {
+		message += StringFromFormat(" %0.1f MB/s", megabytesPerSecond);
 	}
+	return message;
+}
 
-	FILE *f = File::OpenCFile(outFilename, "wb");
-	if (f) {
-		// Don't spam the log.
-		if (file_index < 10) {
-			INFO_LOG(Log::HLE, "Writing %d bytes to '%s'", (int)size, outFilename.c_str());
-		}
-		size_t pos = 0;
-		const size_t blockSize = 1024 * 128;
-		u8 *buffer = new u8[blockSize];
-		while (pos < size) {
-			size_t readSize = std::min(blockSize, size - pos);
-			zip_int64_t retval = zip_fread(zf, buffer, readSize);
-			if (retval < 0 || (size_t)retval < readSize) {
-				ERROR_LOG(Log::HLE, "Failed to read %d bytes from zip (%d) - archive corrupt?", (int)readSize, (int)retval);
-				delete[] buffer;
-				fclose(f);
-				zip_fclose(zf);
-				File::Delete(outFilename);
-				return false;
-			}
-			size_t written = fwrite(buffer, 1, readSize, f);
-			if (written != readSize) {
-				ERROR_LOG(Log::HLE, "Wrote %d bytes out of %d - Disk full?", (int)written, (int)readSize);
-				delete[] buffer;
-				fclose(f);
-				zip_fclose(zf);
-				File::Delete(outFilename);
-				return false;
-			}
-			pos += readSize;
-
-			*bytesCopied += readSize;
-			installProgress_ = (float)*bytesCopied / (float)allBytes;
-		}
-
-		zip_fclose(zf);
-		fclose(f);
-
-		// Copy the mtime, too. May not be possible on Android?
-		if (zstat.mtime) {
-			File::ChangeMTime(outFilename, zstat.mtime);
-		}
-		delete[] buffer;
-		return true;
-	} else {
-		auto iz = GetI18NCategory(I18NCat::INSTALLZIP);
-		g_OSD.Show(OSDType::MESSAGE_ERROR, iz->T("Installation failed"), outFilename.ToVisualString());
-		ERROR_LOG(Log::HLE, "Failed to open file for writing: %s", outFilename.c_str());
-		return false;
-	}
+static int ExtractThreadCount() {
+	// Decompression is what takes the time, but storage usually doesn't like much more than this.
+	return std::max(1, std::min(4, (int)std::thread::hardware_concurrency()));
 }
 
 // Doesn't care what it is, just extracts the whole ZIP to the requested location.
-bool GameManager::ExtractZipContents(struct zip *z, const Path &dest, const ZipFileInfo &info, bool allowRoot) {
+bool GameManager::ExtractZipContents(struct zip *z, const Path &zipFile, const Path &dest, const ZipFileInfo &info, bool allowRoot) {
 	size_t allBytes = 0;
-	size_t bytesCopied = 0;
 
 	auto sy = GetI18NCategory(I18NCat::SYSTEM);
 
@@ -773,8 +727,8 @@ bool GameManager::ExtractZipContents(struct zip *z, const Path &dest, const ZipF
 
 	INFO_LOG(Log::HLE, "Created %d directories", (int)createdDirs.size());
 
-	// Now, loop through again in a second pass, writing files.
-	std::vector<Path> createdFiles;
+	// Now, a second pass to write the files, several at a time.
+	ZipExtractor extractor([&zipFile]() { return ZipOpenPath(zipFile); });
 	for (int i = 0; i < info.numFiles; i++) {
 		const char *fn = zip_get_name(z, i, 0);
 		// Note that we do NOT write files that are not in a directory, to avoid random
@@ -787,27 +741,29 @@ bool GameManager::ExtractZipContents(struct zip *z, const Path &dest, const ZipF
 			if (isDir)
 				continue;
 
-			if (!ExtractFile(z, i, outFilename, &bytesCopied, allBytes)) {
-				ERROR_LOG(Log::HLE, "Bailing: Failed to extract file: %s -> %s", zippedName.c_str(), outFilename.c_str());
-				goto bail;
-			} else {
-				createdFiles.push_back(outFilename);
+			struct zip_stat zstat;
+			if (zip_stat_index(z, i, 0, &zstat) >= 0) {
+				extractor.Add(i, outFilename, zstat.size);
 			}
 		}
-		g_OSD.SetProgressBar("install", di->T("Installing..."), 0.0f, 1.0f, 0.1f + (i + 1) / (float)info.numFiles * 0.9f, 0.1f);
 	}
-
-	INFO_LOG(Log::HLE, "Unzipped %d files (%d bytes / %d).", info.numFiles, (int)bytesCopied, (int)allBytes);
 	zip_close(z);
 	z = nullptr;
-	return true;
 
-bail:
+	bool success = extractor.Run(ExtractThreadCount(), [&](u64 bytesDone, u64 bytesTotal, double megabytesPerSecond) {
+		installProgress_ = bytesTotal == 0 ? 1.0f : (float)bytesDone / (float)bytesTotal;
+		g_OSD.SetProgressBar("install", InstallingMessage(megabytesPerSecond), 0.0f, 1.0f, 0.1f + installProgress_ * 0.9f, 0.1f);
+	});
+	if (success) {
+		INFO_LOG(Log::HLE, "Unzipped %d files (%d bytes).", info.numFiles, (int)allBytes);
+		return true;
+	}
+
 	// We end up here if disk is full or couldn't write to storage for some other reason.
-	zip_close(z);
+	ERROR_LOG(Log::HLE, "Bailing: Failed to extract file: %s", extractor.FailedFile().c_str());
 	// We don't delete the original in this case. Try to delete the files we created so far.
-	for (size_t i = 0; i < createdFiles.size(); i++) {
-		File::Delete(createdFiles[i]);
+	for (const Path &createdFile : extractor.Extracted()) {
+		File::Delete(createdFile);
 	}
 	for (auto const &iter : createdDirs) {
 		File::DeleteDir(iter);
@@ -839,10 +795,9 @@ bool GameManager::InstallMemstickZip(struct zip *z, const Path &zipfile, const P
 		return false;
 	}
 
-	auto di = GetI18NCategory(I18NCat::DIALOG);
-
-	const size_t blockSize = 1024 * 128;
+	const size_t blockSize = ZipExtractor::CHUNK_SIZE;
 	u8 *buffer = new u8[blockSize];
+	const double startTime = time_now_d();
 	while (bytesCopied < allBytes) {
 		size_t readSize = std::min(blockSize, allBytes - bytesCopied);
 		if (fread(buffer, readSize, 1, inf) != 1)
@@ -851,7 +806,8 @@ bool GameManager::InstallMemstickZip(struct zip *z, const Path &zipfile, const P
 			break;
 		bytesCopied += readSize;
 		installProgress_ = (float)bytesCopied / (float)allBytes;
-		g_OSD.SetProgressBar("install", di->T("Installing..."), 0.0f, 1.0f, installProgress_, 0.1f);
+		const double elapsed = time_now_d() - startTime;
+		g_OSD.SetProgressBar("install", InstallingMessage(elapsed > 0.0 ? bytesCopied / (elapsed * 1024.0 * 1024.0) : 0.0), 0.0f, 1.0f, installProgress_, 0.1f);
 	}
 
 	delete[] buffer;
@@ -872,7 +828,7 @@ bool GameManager::InstallMemstickZip(struct zip *z, const Path &zipfile, const P
 	return true;
 }
 
-bool GameManager::InstallZippedISO(struct zip *z, int isoFileIndex, const Path &destDir) {
+bool GameManager::InstallZippedISO(struct zip *z, int isoFileIndex, const Path &zipFile, const Path &destDir) {
 	// Let's place the output file in the currently selected Games directory.
 	std::string fn = zip_get_name(z, isoFileIndex, 0);
 	size_t nameOffset = fn.rfind('/');
@@ -881,11 +837,8 @@ bool GameManager::InstallZippedISO(struct zip *z, int isoFileIndex, const Path &
 	} else {
 		nameOffset++;
 	}
-	size_t allBytes = 1;
-	struct zip_stat zstat;
-	if (zip_stat_index(z, isoFileIndex, 0, &zstat) >= 0) {
-		allBytes += zstat.size;
-	}
+	struct zip_stat zstat{};
+	zip_stat_index(z, isoFileIndex, 0, &zstat);
 
 	std::string name = fn.substr(nameOffset);
 
@@ -902,18 +855,25 @@ bool GameManager::InstallZippedISO(struct zip *z, int isoFileIndex, const Path &
 	}
 	outputISOFilename = outputISOFilename / name;
 
-	size_t bytesCopied = 0;
-	bool success = false;
-	auto di = GetI18NCategory(I18NCat::DIALOG);
-	g_OSD.SetProgressBar("install", di->T("Installing..."), 0.0f, 0.0f, 0.0f, 0.1f);
-	if (ExtractFile(z, isoFileIndex, outputISOFilename, &bytesCopied, allBytes)) {
+	g_OSD.SetProgressBar("install", InstallingMessage(0.0), 0.0f, 0.0f, 0.0f, 0.1f);
+	zip_close(z);
+	z = 0;
+
+	// A single file, so no parallelism, but decompression and writing still overlap.
+	ZipExtractor extractor([&zipFile]() { return ZipOpenPath(zipFile); });
+	extractor.Add(isoFileIndex, outputISOFilename, zstat.size);
+	bool success = extractor.Run(1, [&](u64 bytesDone, u64 bytesTotal, double megabytesPerSecond) {
+		installProgress_ = bytesTotal == 0 ? 1.0f : (float)bytesDone / (float)bytesTotal;
+		g_OSD.SetProgressBar("install", InstallingMessage(megabytesPerSecond), 0.0f, 1.0f, installProgress_, 0.1f);
+	});
+	if (success) {
 		INFO_LOG(Log::IO, "Successfully unzipped ISO file to '%s'", outputISOFilename.c_str());
-		success = true;
+	} else {
+		auto iz = GetI18NCategory(I18NCat::INSTALLZIP);
+		g_OSD.Show(OSDType::MESSAGE_ERROR, iz->T("Installation failed"), outputISOFilename.ToVisualString());
 	}
-	zip_close(z);
 	g_OSD.RemoveProgressBar("install", success, 0.5f);
 
-	z = 0;
 	installProgress_ = 1.0f;
 	InstallDone();
 	ResetInstallError();
@@ -0,0 +1,259 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <thread>
+
+#ifdef SHARED_LIBZIP
+#include <zip.h>
+#else
+#include "ext/libzip/zip.h"
+#endif
+
+// Android only has it from API 21.
+#if PPSSPP_PLATFORM(LINUX) && !(defined(__ANDROID__) && __ANDROID_API__ < 21)
+#include <fcntl.h>
+#define HAVE_FALLOCATE
+#endif
+
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/Thread/ThreadUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/Util/ZipExtractor.h"
+
+// Reserves the space up front, so the file isn't fragmented and a full disk shows up right away.
+// Not posix_fallocate, that falls back to writing zeros where it's not supported.
+static void Preallocate(FILE *f, u64 size) {
+#ifdef HAVE_FALLOCATE
+	fallocate(fileno(f), 0, 0, (off_t)size);
+#endif
+}
+
+// Hands chunks to a thread that writes them out, while the caller decompresses the next one
+// into the other buffer.
+class ChunkWriter {
+public:
+	ChunkWriter(FILE *f, std::vector<u8> buffers[2]) : f_(f), buffers_(buffers) {
+		thread_ = std::thread(&ChunkWriter::Run, this);
+	}
+	~ChunkWriter() {
+		Finish();
+	}
+
+	// Waits for the other buffer to be written, then starts on this one. False if a write failed.
+	bool Submit(int buffer, size_t size) {
+		std::unique_lock<std::mutex> guard(lock_);
+		cond_.wait(guard, [&] { return pending_ < 0; });
+		if (failed_)
+			return false;
+		pending_ = buffer;
+		pendingSize_ = size;
+		cond_.notify_all();
+		return true;
+	}
+
+	bool Finish() {
+		if (thread_.joinable()) {
+			{
+				std::unique_lock<std::mutex> guard(lock_);
+				cond_.wait(guard, [&] { return pending_ < 0; });
+				done_ = true;
+				cond_.notify_all();
+			}
+			thread_.join();
+		}
+		return !failed_;
+	}
+
+private:
+	void Run() {
+		SetCurrentThreadName("ZipWriter");
+		std::unique_lock<std::mutex> guard(lock_);
+		while (true) {
+			cond_.wait(guard, [&] { return pending_ >= 0 || done_; });
+			if (pending_ < 0)
+				break;
+			const u8 *data = buffers_[pending_].data();
+			const size_t size = pendingSize_;
+			guard.unlock();
+			bool success = fwrite(data, 1, size, f_) == size;
+			guard.lock();
+			failed_ = failed_ || !success;
+			// Only now can the caller fill this buffer again.
+			pending_ = -1;
+			cond_.notify_all();
+		}
+	}
+
+	FILE *f_;
+	std::vector<u8> *buffers_;
+	std::thread thread_;
+	std::mutex lock_;
+	std::condition_variable cond_;
+	int pending_ = -1;
+	size_t pendingSize_ = 0;
+	bool done_ = false;
+	bool failed_ = false;
+};
+
+void ZipExtractor::Add(int index, const Path &dest, u64 size) {
+	entries_.push_back(Entry{ index, dest, size });
+	totalBytes_ += size;
+}
+
+bool ZipExtractor::Run(int maxThreads, ProgressFunc progress) {
+	// Biggest first, so one huge file doesn't end up alone at the end.
+	std::stable_sort(entries_.begin(), entries_.end(), [](const Entry &a, const Entry &b) {
+		return a.size > b.size;
+	});
+
+	const int numThreads = std::max(1, std::min(maxThreads, (int)entries_.size()));
+	const double startTime = time_now_d();
+	std::vector<std::thread> workers;
+	std::atomic<int> running{ numThreads };
+	for (int i = 0; i < numThreads; ++i) {
+		workers.emplace_back([this, &running] {
+			Worker();
+			running--;
+		});
+	}
+
+	while (running > 0) {
+		sleep_ms(50, "zip-extract-progress");
+		if (progress) {
+			const double elapsed = time_now_d() - startTime;
+			progress(bytesDone_, totalBytes_, elapsed > 0.0 ? bytesDone_ / (elapsed * 1024.0 * 1024.0) : 0.0);
+		}
+	}
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+
+	const double elapsed = time_now_d() - startTime;
+	INFO_LOG(Log::HLE, "Extracted %d files, %lld bytes in %0.2f s on %d threads", (int)entries_.size(), (long long)bytesDone_, elapsed, numThreads);
+	return !failed_;
+}
+
+void ZipExtractor::Worker() {
+	SetCurrentThreadName("ZipExtract");
+	struct zip *z = openZip_();
+	if (!z) {
+		Fail(Path());
+		return;
+	}
+
+	std::vector<u8> buffers[2];
+	while (!failed_) {
+		int i = next_++;
+		if (i >= (int)entries_.size())
+			break;
+		if (!ExtractEntry(z, entries_[i], buffers)) {
+			Fail(entries_[i].dest);
+			break;
+		}
+		std::lock_guard<std::mutex> guard(lock_);
+		extracted_.push_back(entries_[i].dest);
+	}
+	zip_close(z);
+}
+
+bool ZipExtractor::ExtractEntry(struct zip *z, const Entry &entry, std::vector<u8> buffers[2]) {
+	zip_file *zf = zip_fopen_index(z, entry.index, 0);
+	if (!zf) {
+		ERROR_LOG(Log::HLE, "Failed to open file by index (%d) (%s)", entry.index, entry.dest.c_str());
+		return false;
+	}
+	FILE *f = File::OpenCFile(entry.dest, "wb");
+	if (!f) {
+		ERROR_LOG(Log::HLE, "Failed to open file for writing: %s", entry.dest.c_str());
+		zip_fclose(zf);
+		return false;
+	}
+	// Everything is written in big chunks, stdio's buffer would only add a copy.
+	setvbuf(f, nullptr, _IONBF, 0);
+
+	const size_t chunkSize = (size_t)std::min(entry.size, (u64)CHUNK_SIZE);
+	bool success = true;
+	if (entry.size <= CHUNK_SIZE) {
+		// Small enough to not bother with another thread.
+		buffers[0].resize(std::max(buffers[0].size(), chunkSize));
+		zip_int64_t retval = chunkSize == 0 ? 0 : zip_fread(zf, buffers[0].data(), chunkSize);
+		success = retval == (zip_int64_t)chunkSize && fwrite(buffers[0].data(), 1, chunkSize, f) == chunkSize;
+		bytesDone_ += chunkSize;
+	} else {
+		Preallocate(f, entry.size);
+		buffers[0].resize(CHUNK_SIZE);
+		buffers[1].resize(CHUNK_SIZE);
+		ChunkWriter writer(f, buffers);
+		u64 pos = 0;
+		int cur = 0;
+		while (success && pos < entry.size) {
+			size_t readSize = (size_t)std::min(entry.size - pos, (u64)CHUNK_SIZE);
+			zip_int64_t retval = zip_fread(zf, buffers[cur].data(), readSize);
+			if (retval < 0 || (size_t)retval < readSize) {
+				ERROR_LOG(Log::HLE, "Failed to read %d bytes from zip (%d) - archive corrupt?", (int)readSize, (int)retval);
+				success = false;
+				break;
+			}
+			success = writer.Submit(cur, readSize);
+			pos += readSize;
+			bytesDone_ += readSize;
+			cur ^= 1;
+		}
+		success = writer.Finish() && success;
+		if (!success) {
+			ERROR_LOG(Log::HLE, "Failed writing %s - Disk full?", entry.dest.c_str());
+		}
+	}
+
+	zip_fclose(zf);
+	success = fclose(f) == 0 && success;
+	if (!success) {
+		File::Delete(entry.dest);
+		return false;
+	}
+
+	// Copy the mtime, too. May not be possible on Android?
+	struct zip_stat zstat;
+	if (zip_stat_index(z, entry.index, 0, &zstat) >= 0 && zstat.mtime) {
+		File::ChangeMTime(entry.dest, zstat.mtime);
+	}
+	return true;
+}
+
+void ZipExtractor::Fail(const Path &path) {
+	std::lock_guard<std::mutex> guard(lock_);
+	if (!failed_) {
+		failedFile_ = path;
+	}
+	failed_ = true;
+}
+
+std::vector<Path> ZipExtractor::Extracted() {
+	std::lock_guard<std::mutex> guard(lock_);
+	return extracted_;
+}
+
+Path ZipExtractor::FailedFile() {
+	std::lock_guard<std::mutex> guard(lock_);
+	return failedFile_;
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
+
+struct zip;
+
+// Extracts files from a zip, several at a time since a libzip handle can only be used by one
+// thread, each worker opens its own. Within a file, decompressing the next chunk overlaps with
+// writing the last one, and the output is preallocated where the platform can do it.
+class ZipExtractor {
+public:
+	// Called on each worker thread, must return a new handle to the same zip (or null.)
+	typedef std::function<struct zip *()> OpenFunc;
+	// bytesDone, bytesTotal, MB/s so far.
+	typedef std::function<void(u64, u64, double)> ProgressFunc;
+
+	ZipExtractor(OpenFunc openZip) : openZip_(openZip) {}
+
+	void Add(int index, const Path &dest, u64 size);
+
+	// Blocks until everything is written or something failed, calling progress on this thread
+	// every now and then. Files that failed partway are deleted.
+	bool Run(int maxThreads, ProgressFunc progress);
+
+	// Everything that was fully written, to clean up after a failure.
+	std::vector<Path> Extracted();
+	// The file that failed, if any.
+	Path FailedFile();
+
+	enum {
+		CHUNK_SIZE = 4 * 1024 * 1024,
+	};
+
+private:
+	struct Entry {
+		int index;
+		Path dest;
+		u64 size;
+	};
+
+	void Worker();
+	bool ExtractEntry(struct zip *z, const Entry &entry, std::vector<u8> buffers[2]);
+	void Fail(const Path &path);
+
+	OpenFunc openZip_;
+	std::vector<Entry> entries_;
+	u64 totalBytes_ = 0;
+
+	std::atomic<int> next_{};
+	std::atomic<u64> bytesDone_{};
+	std::atomic<bool> failed_{};
+
+	std::mutex lock_;
+	std::vector<Path> extracted_;
+	Path failedFile_;
+};
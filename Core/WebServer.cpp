@@ -50,6 +50,10 @@ static std::thread serverThread;
 static ServerStatus serverStatus;
 static std::mutex serverStatusLock;
 static int serverFlags;
+static http::Server *activeServer;
+
+// Debugger websockets hold on to a thread each, so keep some headroom over the expected disc clients.
+static const int MAX_CONNECTION_THREADS = 16;
 
 // NOTE: These *only* encode spaces, which is almost enough.
 
@@ -213,7 +217,7 @@ static void DiscHandler(const http::ServerRequest &request, const Path &filename
 
 	std::string range;
 	if (request.Method() == http::RequestHeader::HEAD) {
-		request.WriteHttpResponseHeader("1.0", 200, sz, "application/octet-stream", "Accept-Ranges: bytes\r\n");
+		request.WriteHttpResponseHeader("1.1", 200, sz, "application/octet-stream", "Accept-Ranges: bytes\r\n");
 	} else if (request.GetHeader("range", &range)) {
 		s64 begin = 0, last = 0;
 		if (sscanf(range.c_str(), "bytes=%lld-%lld", &begin, &last) != 2) {
@@ -229,31 +233,22 @@ static void DiscHandler(const http::ServerRequest &request, const Path &filename
 		}
 
 		FILE *fp = File::OpenCFile(filename, "rb");
-		if (!fp || fseek(fp, begin, SEEK_SET) != 0) {
+		if (!fp) {
 			request.WriteHttpResponseHeader("1.0", 500, -1, "text/plain");
 			request.Out()->Push("File access failed.");
-			if (fp) {
-				fclose(fp);
-			}
 			return;
 		}
 
 		s64 len = last - begin + 1;
 		char contentRange[1024];
 		snprintf(contentRange, sizeof(contentRange), "Content-Range: bytes %lld-%lld/%lld\r\n", begin, last, sz);
-		request.WriteHttpResponseHeader("1.0", 206, len, "application/octet-stream", contentRange);
-
-		const size_t CHUNK_SIZE = 16 * 1024;
-		char *buf = new char[CHUNK_SIZE];
-		for (s64 pos = 0; pos < len; pos += CHUNK_SIZE) {
-			s64 chunklen = std::min(len - pos, (s64)CHUNK_SIZE);
-			if (fread(buf, chunklen, 1, fp) != 1)
-				break;
-			request.Out()->Push(buf, chunklen);
+		// 1.1 so the client can reuse the connection for the next range.
+		request.WriteHttpResponseHeader("1.1", 206, len, "application/octet-stream", contentRange);
+
+		if (!request.SendFileRange(fp, begin, len)) {
+			WARN_LOG(Log::Loader, "Failed to send range %lld-%lld of %s", begin, last, filename.c_str());
 		}
 		fclose(fp);
-		delete[] buf;
-		request.Out()->Flush();
 	} else {
 		request.WriteHttpResponseHeader("1.0", 418, -1, "text/plain");
 		request.Out()->Push("This server only supports range requests.");
@@ -407,7 +402,11 @@ static void ExecuteWebServer() {
 
 	AndroidJNIThreadContext context;  // Destructor detaches.
 
-	auto http = new http::Server(new NewThreadExecutor());
+	auto http = new http::Server(new ThreadPoolExecutor(MAX_CONNECTION_THREADS));
+	{
+		std::lock_guard<std::mutex> guard(serverStatusLock);
+		activeServer = http;
+	}
 	http->RegisterHandler("/", &HandleListing);
 	// This lists all the (current) recent ISOs.
 	http->SetFallbackHandler(&HandleFallback);
@@ -437,6 +436,14 @@ static void ExecuteWebServer() {
 
 	http->Stop();
 	StopAllDebuggers();
+
+	http::ServerStats stats = http->GetStats();
+	INFO_LOG(Log::Loader, "HTTP server stopped: %lld connections (peak %d concurrent), %lld requests, %lld on kept-alive connections",
+		(long long)stats.totalConnections, stats.peakConnections, (long long)stats.totalRequests, (long long)stats.keepAliveRequests);
+	{
+		std::lock_guard<std::mutex> guard(serverStatusLock);
+		activeServer = nullptr;
+	}
 	delete http;
 
 	UpdateStatus(ServerStatus::FINISHED);
@@ -492,6 +499,15 @@ bool WebServerStopped(WebServerFlags flags) {
 	return serverStatus == ServerStatus::STOPPED || serverStatus == ServerStatus::FINISHED;
 }
 
+bool WebServerGetStats(http::ServerStats *stats) {
+	std::lock_guard<std::mutex> guard(serverStatusLock);
+	if (!activeServer) {
+		return false;
+	}
+	*stats = activeServer->GetStats();
+	return true;
+}
+
 void ShutdownWebServer() {
 	StopWebServer(WebServerFlags::ALL);
 
@@ -17,6 +17,10 @@
 
 #pragma once
 
+namespace http {
+struct ServerStats;
+}
+
 enum class WebServerFlags {
 	DISCS = 1,
 	DEBUGGER = 2,
@@ -29,5 +33,7 @@ bool StopWebServer(WebServerFlags flags);
 bool WebServerStopping(WebServerFlags flags);
 bool WebServerStopped(WebServerFlags flags);
 void ShutdownWebServer();
+// Connection counters of the running server, false if not running.
+bool WebServerGetStats(http::ServerStats *stats);
 
 bool RemoteISOFileSupported(const std::string &filename);
@@ -23,8 +23,10 @@
 
 #include "ext/basis_universal/basisu_transcoder.h"
 #include "ext/basis_universal/basisu_file_headers.h"
+#include "ext/xxhash.h"
 
 #include "GPU/Common/ReplacedTexture.h"
+#include "GPU/Common/ReplacementTranscoder.h"
 #include "GPU/Common/TextureReplacer.h"
 
 #include "Common/Data/Format/IniFile.h"
@@ -205,6 +207,8 @@ void ReplacedTexture::Prepare(VFSBackend *vfs) {
 	std::unique_lock<std::mutex> lock(lock_);
 
 	fmt = Draw::DataFormat::UNDEFINED;
+	// Transcodes queued last time may have finished since.
+	useTranscodeCache_ = true;
 
 	Draw::DataFormat pixelFormat;
 	LoadLevelResult result = LoadLevelResult::LOAD_ERROR;
@@ -249,6 +253,18 @@ void ReplacedTexture::Prepare(VFSBackend *vfs) {
 				fmt = pixelFormat;
 			} else {
 				if (fmt != pixelFormat) {
+					levels_.pop_back();
+					data_[i].clear();
+					int blockSize;
+					if (useTranscodeCache_ && (Draw::DataFormatIsBlockCompressed(fmt, &blockSize) || Draw::DataFormatIsBlockCompressed(pixelFormat, &blockSize))) {
+						// Only part of the chain was transcoded. Start over from the PNGs, so the levels match.
+						useTranscodeCache_ = false;
+						levels_.clear();
+						data_.clear();
+						alphaStatus_ = ReplacedTextureAlpha::UNKNOWN;
+						i = -1;
+						continue;
+					}
 					ERROR_LOG(Log::TexReplacement, "Replacement mipmap %d doesn't have the same pixel format as mipmap 0. Stopping.", i);
 					break;
 				}
@@ -658,6 +674,20 @@ ReplacedTexture::LoadLevelResult ReplacedTexture::LoadLevelData(VFSFileReference
 		pngdata.resize(fileSize);
 		pngdata.resize(vfs_->Read(openFile, &pngdata[0], fileSize));
 		vfs_->CloseFile(openFile);
+
+		// A block compressed copy from an earlier session saves decoding, and memory.
+		uint64_t pngHash = 0;
+		if (!desc_.transcodeDir.empty()) {
+			pngHash = XXH3_64bits(pngdata.data(), pngdata.size());
+			if (useTranscodeCache_ && ReplacementTranscoder::LoadCached(desc_.transcodeDir, pngHash, level.w, level.h, &data_[mipLevel], pixelFormat)) {
+				if (mipLevel == 0) {
+					alphaStatus_ = *pixelFormat == Draw::DataFormat::BC1_RGBA_UNORM_BLOCK ? ReplacedTextureAlpha::FULL : ReplacedTextureAlpha::UNKNOWN;
+				}
+				levels_.push_back(level);
+				return LoadLevelResult::CONTINUE;
+			}
+		}
+
 		if (!png_image_begin_read_from_memory(&png, &pngdata[0], pngdata.size())) {
 			ERROR_LOG(Log::TexReplacement, "Could not load texture replacement info: %s - %s (zip)", filename.c_str(), png.message);
 			return LoadLevelResult::LOAD_ERROR;
@@ -688,12 +718,20 @@ ReplacedTexture::LoadLevelResult ReplacedTexture::LoadLevelData(VFSFileReference
 		}
 		png_image_free(&png);
 
+		bool opaque = checkedAlpha;
 		if (!checkedAlpha) {
 			// This will only check the hashed bits.
 			CheckAlphaResult res = CheckAlpha32Rect((u32 *)&out[0], level.w, png.width, png.height, 0xFF000000);
 			if (res == CHECKALPHA_ANY || mipLevel == 0) {
 				alphaStatus_ = ReplacedTextureAlpha(res);
 			}
+			opaque = res == CHECKALPHA_FULL;
+		}
+
+		// Block compression needs whole blocks, and odd sizes would need the padding checked too.
+		const bool wholeBlocks = (level.w & 3) == 0 && (level.h & 3) == 0 && png.width == (uint32_t)level.w && png.height == (uint32_t)level.h;
+		if (!desc_.transcodeDir.empty() && wholeBlocks) {
+			ReplacementTranscoder::QueueTranscode(desc_.transcodeDir, pngHash, level.w, level.h, &out[0], opaque);
 		}
 
 		levels_.push_back(level);
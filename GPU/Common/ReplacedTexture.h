@@ -82,6 +82,8 @@ struct ReplacementDesc {
 	std::vector<std::string> filenames;
 	std::string logId;
 	GPUFormatSupport formatSupport;
+	// Where block compressed copies of PNG levels are kept, empty if not.
+	Path transcodeDir;
 };
 
 class ReplacedTexture;
@@ -197,6 +199,8 @@ class ReplacedTexture {
 	std::mutex lock_;
 	Draw::DataFormat fmt = Draw::DataFormat::UNDEFINED;  // NOTE: Right now, the only supported format is Draw::DataFormat::R8G8B8A8_UNORM.
 	ReplacedTextureAlpha alphaStatus_ = ReplacedTextureAlpha::UNKNOWN;
+	// Cleared when only part of the mip chain has a block compressed copy, so the PNGs are decoded instead.
+	bool useTranscodeCache_ = true;
 	double lastUsed = 0.0;
 
 	std::atomic<ReplacementState> state_ = ReplacementState::UNLOADED;
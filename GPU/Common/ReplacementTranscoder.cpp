@@ -0,0 +1,382 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Common/Data/Format/DDSLoad.h"
+#include "Common/File/DirListing.h"
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/StringUtils.h"
+#include "Common/Thread/ThreadManager.h"
+#include "GPU/Common/ReplacementTranscoder.h"
+
+namespace ReplacementTranscoder {
+
+static const uint32_t FOURCC_DXT1 = 0x31545844;
+static const uint32_t FOURCC_DXT5 = 0x35545844;
+static const uint32_t DDS_MAGIC = 0x20534444;
+
+// Each one holds a copy of a decoded level, so don't let them pile up.
+static const int MAX_PENDING_TRANSCODES = 4;
+static std::atomic<int> pendingTranscodes;
+// Tasks can be writing the same entry, so each one gets its own temp file.
+static std::atomic<uint32_t> tempFileCounter;
+
+static Path CachePath(const Path &dir, uint64_t pngHash) {
+	return dir / StringFromFormat("%016llx.dds", (unsigned long long)pngHash);
+}
+
+static uint16_t To565(const int *rgb) {
+	int r = std::clamp(rgb[0], 0, 255);
+	int g = std::clamp(rgb[1], 0, 255);
+	int b = std::clamp(rgb[2], 0, 255);
+	return (uint16_t)((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void From565(uint16_t c, int *rgb) {
+	int r = (c >> 11) & 31;
+	int g = (c >> 5) & 63;
+	int b = c & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Endpoints from the extremes along the principal axis of the block's colors, slightly inset,
+// then the nearest of the four palette colors for each pixel. Always uses the four color mode.
+static void EncodeColorBlock(const uint8_t *pixels[16], uint8_t *out) {
+	float mean[3]{};
+	for (int i = 0; i < 16; ++i) {
+		for (int c = 0; c < 3; ++c)
+			mean[c] += pixels[i][c];
+	}
+	for (int c = 0; c < 3; ++c)
+		mean[c] /= 16.0f;
+
+	float cov[6]{};
+	for (int i = 0; i < 16; ++i) {
+		float r = pixels[i][0] - mean[0];
+		float g = pixels[i][1] - mean[1];
+		float b = pixels[i][2] - mean[2];
+		cov[0] += r * r;
+		cov[1] += r * g;
+		cov[2] += r * b;
+		cov[3] += g * g;
+		cov[4] += g * b;
+		cov[5] += b * b;
+	}
+
+	// A few rounds of power iteration are plenty for 3x3.
+	float axis[3] = { 1.0f, 1.0f, 1.0f };
+	for (int iter = 0; iter < 4; ++iter) {
+		float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+		float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+		float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+		float len = std::max(std::max(fabsf(x), fabsf(y)), fabsf(z));
+		if (len < 1e-6f)
+			break;
+		axis[0] = x / len;
+		axis[1] = y / len;
+		axis[2] = z / len;
+	}
+
+	int minIndex = 0, maxIndex = 0;
+	float minDot = 1e30f, maxDot = -1e30f;
+	for (int i = 0; i < 16; ++i) {
+		float dot = pixels[i][0] * axis[0] + pixels[i][1] * axis[1] + pixels[i][2] * axis[2];
+		if (dot < minDot) {
+			minDot = dot;
+			minIndex = i;
+		}
+		if (dot > maxDot) {
+			maxDot = dot;
+			maxIndex = i;
+		}
+	}
+
+	int hi[3], lo[3];
+	for (int c = 0; c < 3; ++c) {
+		int inset = (pixels[maxIndex][c] - pixels[minIndex][c]) / 16;
+		hi[c] = pixels[maxIndex][c] - inset;
+		lo[c] = pixels[minIndex][c] + inset;
+	}
+
+	uint16_t c0 = To565(hi);
+	uint16_t c1 = To565(lo);
+	if (c0 < c1)
+		std::swap(c0, c1);
+
+	uint32_t indices = 0;
+	if (c0 != c1) {
+		int palette[4][3];
+		From565(c0, palette[0]);
+		From565(c1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		for (int i = 0; i < 16; ++i) {
+			int best = 0, bestDist = 0x7FFFFFFF;
+			for (int p = 0; p < 4; ++p) {
+				int dr = pixels[i][0] - palette[p][0];
+				int dg = pixels[i][1] - palette[p][1];
+				int db = pixels[i][2] - palette[p][2];
+				int dist = dr * dr + dg * dg + db * db;
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = p;
+				}
+			}
+			indices |= (uint32_t)best << (i * 2);
+		}
+	}
+
+	out[0] = (uint8_t)c0;
+	out[1] = (uint8_t)(c0 >> 8);
+	out[2] = (uint8_t)c1;
+	out[3] = (uint8_t)(c1 >> 8);
+	for (int i = 0; i < 4; ++i)
+		out[4 + i] = (uint8_t)(indices >> (i * 8));
+}
+
+// The eight value mode between the lowest and highest alpha, which keeps 0 and 255 exact.
+static void EncodeAlphaBlock(const uint8_t *pixels[16], uint8_t *out) {
+	int a0 = 0, a1 = 255;
+	for (int i = 0; i < 16; ++i) {
+		a0 = std::max(a0, (int)pixels[i][3]);
+		a1 = std::min(a1, (int)pixels[i][3]);
+	}
+
+	uint64_t indices = 0;
+	if (a0 != a1) {
+		int palette[8];
+		palette[0] = a0;
+		palette[1] = a1;
+		for (int p = 1; p < 7; ++p)
+			palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+		for (int i = 0; i < 16; ++i) {
+			int best = 0, bestDist = 256;
+			for (int p = 0; p < 8; ++p) {
+				int dist = abs(pixels[i][3] - palette[p]);
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = p;
+				}
+			}
+			indices |= (uint64_t)best << (i * 3);
+		}
+	}
+
+	out[0] = (uint8_t)a0;
+	out[1] = (uint8_t)a1;
+	for (int i = 0; i < 6; ++i)
+		out[2 + i] = (uint8_t)(indices >> (i * 8));
+}
+
+template <bool withAlpha>
+static void EncodeBlocks(const uint8_t *rgba, int w, int h, int pitch, uint8_t *out) {
+	const uint8_t *pixels[16];
+	for (int by = 0; by < h; by += 4) {
+		for (int bx = 0; bx < w; bx += 4) {
+			for (int y = 0; y < 4; ++y) {
+				for (int x = 0; x < 4; ++x)
+					pixels[y * 4 + x] = rgba + ((size_t)(by + y) * pitch + bx + x) * 4;
+			}
+			if (withAlpha) {
+				EncodeAlphaBlock(pixels, out);
+				out += 8;
+			}
+			EncodeColorBlock(pixels, out);
+			out += 8;
+		}
+	}
+}
+
+void EncodeBC1(const uint8_t *rgba, int w, int h, int pitch, uint8_t *out) {
+	EncodeBlocks<false>(rgba, w, h, pitch, out);
+}
+
+void EncodeBC3(const uint8_t *rgba, int w, int h, int pitch, uint8_t *out) {
+	EncodeBlocks<true>(rgba, w, h, pitch, out);
+}
+
+bool LoadCached(const Path &dir, uint64_t pngHash, int w, int h, std::vector<uint8_t> *data, Draw::DataFormat *fmt) {
+	FILE *fp = File::OpenCFile(CachePath(dir, pngHash), "rb");
+	if (!fp)
+		return false;
+
+	DDSHeader header;
+	bool good = fread(&header, sizeof(header), 1, fp) == 1;
+	good = good && header.dwMagic == DDS_MAGIC && (int)header.dwWidth == w && (int)header.dwHeight == h;
+	good = good && (header.ddspf.dwFourCC == FOURCC_DXT1 || header.ddspf.dwFourCC == FOURCC_DXT5);
+	if (good) {
+		const bool bc3 = header.ddspf.dwFourCC == FOURCC_DXT5;
+		data->resize((size_t)(w / 4) * (h / 4) * (bc3 ? 16 : 8));
+		good = fread(&(*data)[0], data->size(), 1, fp) == 1;
+		*fmt = bc3 ? Draw::DataFormat::BC3_UNORM_BLOCK : Draw::DataFormat::BC1_RGBA_UNORM_BLOCK;
+	}
+	fclose(fp);
+
+	if (!good) {
+		WARN_LOG(Log::TexReplacement, "Ignoring bad transcoded texture %016llx", (unsigned long long)pngHash);
+		data->clear();
+	}
+	return good;
+}
+
+bool TranscodeToCache(const Path &dir, uint64_t pngHash, int w, int h, const uint8_t *rgba, bool opaque) {
+	_dbg_assert_((w & 3) == 0 && (h & 3) == 0);
+	const size_t size = (size_t)(w / 4) * (h / 4) * (opaque ? 8 : 16);
+	std::vector<uint8_t> blocks(size);
+	if (opaque)
+		EncodeBC1(rgba, w, h, w, &blocks[0]);
+	else
+		EncodeBC3(rgba, w, h, w, &blocks[0]);
+
+	DDSHeader header{};
+	header.dwMagic = DDS_MAGIC;
+	header.dwSize = 124;
+	// CAPS | HEIGHT | WIDTH | PIXELFORMAT | LINEARSIZE
+	header.dwFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x80000;
+	header.dwHeight = h;
+	header.dwWidth = w;
+	header.dwPitchOrLinearSize = (uint32_t)size;
+	header.dwMipMapCount = 1;
+	header.ddspf.dwSize = 32;
+	header.ddspf.dwFlags = DDPF_FOURCC;
+	header.ddspf.dwFourCC = opaque ? FOURCC_DXT1 : FOURCC_DXT5;
+	header.dwCaps = DDSCAPS_TEXTURE;
+
+	if (!File::Exists(dir))
+		File::CreateFullPath(dir);
+	// Written under another name first, so a half written one is never loaded.
+	const Path path = CachePath(dir, pngHash);
+	const Path tempPath = path.WithReplacedExtension(StringFromFormat(".%u.tmp", ++tempFileCounter));
+	FILE *fp = File::OpenCFile(tempPath, "wb");
+	if (!fp)
+		return false;
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	success = success && fwrite(&blocks[0], blocks.size(), 1, fp) == 1;
+	fclose(fp);
+
+	// An entry that's there already was for another size, or bad. Windows won't rename over it.
+	bool renameReplaces = dir.Type() == PathType::NATIVE;
+#ifdef _WIN32
+	renameReplaces = false;
+#endif
+	if (success && !renameReplaces && File::Exists(path))
+		File::Delete(path);
+	if (!success || !File::Rename(tempPath, path)) {
+		File::Delete(tempPath);
+		return false;
+	}
+	return true;
+}
+
+bool TrimCache(const Path &dir, uint64_t maxBytes) {
+	std::vector<File::FileInfo> files;
+	if (!File::GetFilesInDir(dir, &files))
+		return false;
+
+	std::vector<File::FileInfo> entries;
+	uint64_t totalBytes = 0;
+	for (const auto &file : files) {
+		if (file.isDirectory)
+			continue;
+		if (endsWith(file.name, ".tmp")) {
+			// Left behind by a session that ended in the middle of a write.
+			File::Delete(file.fullName);
+		} else {
+			entries.push_back(file);
+			totalBytes += file.size;
+		}
+	}
+
+	// Oldest first. Entries aren't touched when loaded, so this goes by when they were written.
+	std::sort(entries.begin(), entries.end(), [](const File::FileInfo &a, const File::FileInfo &b) {
+		return a.mtime < b.mtime;
+	});
+	for (size_t i = 0; i < entries.size() && totalBytes > maxBytes; ++i) {
+		if (File::Delete(entries[i].fullName))
+			totalBytes -= entries[i].size;
+	}
+	return totalBytes <= maxBytes;
+}
+
+class TranscodeTask : public Task {
+public:
+	TranscodeTask(const Path &dir, uint64_t pngHash, int w, int h, const uint8_t *rgba, bool opaque)
+		: dir_(dir), pngHash_(pngHash), w_(w), h_(h), rgba_(rgba, rgba + (size_t)w * h * 4), opaque_(opaque) {}
+	~TranscodeTask() {
+		pendingTranscodes--;
+	}
+
+	// Writes files, and Android storage needs the thread attached to JNI.
+	TaskType Type() const override { return TaskType::IO_BLOCKING; }
+	TaskPriority Priority() const override { return TaskPriority::LOW; }
+
+	void Run() override {
+		if (!TranscodeToCache(dir_, pngHash_, w_, h_, &rgba_[0], opaque_)) {
+			WARN_LOG(Log::TexReplacement, "Failed to write transcoded texture to %s", dir_.c_str());
+		}
+	}
+
+private:
+	Path dir_;
+	uint64_t pngHash_;
+	int w_;
+	int h_;
+	std::vector<uint8_t> rgba_;
+	bool opaque_;
+};
+
+void QueueTranscode(const Path &dir, uint64_t pngHash, int w, int h, const uint8_t *rgba, bool opaque) {
+	if (++pendingTranscodes > MAX_PENDING_TRANSCODES) {
+		pendingTranscodes--;
+		return;
+	}
+	g_threadManager.EnqueueTask(new TranscodeTask(dir, pngHash, w, h, rgba, opaque));
+}
+
+class TrimCacheTask : public Task {
+public:
+	TrimCacheTask(const Path &dir, uint64_t maxBytes) : dir_(dir), maxBytes_(maxBytes) {}
+
+	TaskType Type() const override { return TaskType::IO_BLOCKING; }
+	TaskPriority Priority() const override { return TaskPriority::LOW; }
+
+	void Run() override {
+		if (!TrimCache(dir_, maxBytes_)) {
+			WARN_LOG(Log::TexReplacement, "Failed to trim transcoded textures in %s", dir_.c_str());
+		}
+	}
+
+private:
+	Path dir_;
+	uint64_t maxBytes_;
+};
+
+void QueueTrimCache(const Path &dir, uint64_t maxBytes) {
+	g_threadManager.EnqueueTask(new TrimCacheTask(dir, maxBytes));
+}
+
+}  // namespace ReplacementTranscoder
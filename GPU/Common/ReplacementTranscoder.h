@@ -0,0 +1,55 @@
+// Copyright (c) 2026- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Common/File/Path.h"
+#include "Common/GPU/DataFormat.h"
+
+// Keeps BC1/BC3 copies of PNG replacement textures in a cache directory, so that later sessions can
+// upload those instead of decoding the PNGs again, using a quarter to an eighth of the memory.
+// Entries are named after a hash of the PNG file, so changes to a pack are picked up.
+namespace ReplacementTranscoder {
+
+// Fills data and fmt if there's a cached copy of this PNG level of the given size.
+bool LoadCached(const Path &dir, uint64_t pngHash, int w, int h, std::vector<uint8_t> *data, Draw::DataFormat *fmt);
+
+// Compresses a decoded level in the background and writes it to the cache. w and h must be multiples of 4.
+// Skipped if too many are already waiting, as the next session will get another chance.
+void QueueTranscode(const Path &dir, uint64_t pngHash, int w, int h, const uint8_t *rgba, bool opaque);
+
+// The synchronous version of the above.
+bool TranscodeToCache(const Path &dir, uint64_t pngHash, int w, int h, const uint8_t *rgba, bool opaque);
+
+// Per game directory.
+const uint64_t DEFAULT_MAX_CACHE_BYTES = 512ULL * 1024 * 1024;
+
+// Deletes files left by interrupted writes, then the oldest entries until the directory holds no
+// more than maxBytes. In the background.
+void QueueTrimCache(const Path &dir, uint64_t maxBytes = DEFAULT_MAX_CACHE_BYTES);
+
+// The synchronous version of the above. False if the directory couldn't be listed or still holds too much.
+bool TrimCache(const Path &dir, uint64_t maxBytes);
+
+// RGBA8888 in, blocks out. w and h must be multiples of 4, pitch is in pixels.
+void EncodeBC1(const uint8_t *rgba, int w, int h, int pitch, uint8_t *out);
+void EncodeBC3(const uint8_t *rgba, int w, int h, int pitch, uint8_t *out);
+
+}  // namespace ReplacementTranscoder
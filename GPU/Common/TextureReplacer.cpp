@@ -46,6 +46,7 @@
 #include "Core/System.h"
 #include "Core/ThreadPools.h"
 #include "Core/ELF/ParamSFO.h"
+#include "GPU/Common/ReplacementTranscoder.h"
 #include "GPU/Common/TextureReplacer.h"
 #include "GPU/Common/TextureDecoder.h"
 
@@ -102,6 +103,15 @@ void TextureReplacer::NotifyConfigChanged() {
 		g_OSD.Show(OSDType::MESSAGE_INFO, std::string(d->T("Save new textures")) + ": " + std::string(di->T("Enabled")), 2.0f);
 	}
 
+	// The transcoder only makes BC1 and BC3, so it's no use where those can't be uploaded.
+	if (replaceEnabled_ && g_Config.bTranscodeReplacementTextures && formatSupport_.bc123) {
+		transcodeDir_ = GetSysDirectory(DIRECTORY_CACHE) / "textures" / gameID_;
+		if (File::Exists(transcodeDir_))
+			ReplacementTranscoder::QueueTrimCache(transcodeDir_);
+	} else {
+		transcodeDir_.clear();
+	}
+
 	if (!replaceEnabled_ && wasReplaceEnabled) {
 		delete vfs_;
 		vfs_ = nullptr;
@@ -648,6 +658,7 @@ ReplacedTexture *TextureReplacer::FindReplacement(u64 cachekey, u32 hash, int w,
 	// Final path - we actually need a new replacement texture, because we haven't seen "hashfiles" before.
 	desc.basePath = basePath_;
 	desc.formatSupport = formatSupport_;
+	desc.transcodeDir = transcodeDir_;
 
 	ReplacedTexture *texture = new ReplacedTexture(vfs_, desc);
 
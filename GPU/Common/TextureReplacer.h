@@ -157,6 +157,7 @@ class TextureReplacer {
 	std::string gameID_;
 	Path basePath_;
 	Path newTextureDir_;
+	Path transcodeDir_;
 	ReplacedTextureHash hash_ = ReplacedTextureHash::QUICK;
 
 	VFSBackend *vfs_ = nullptr;
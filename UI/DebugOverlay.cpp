@@ -11,6 +11,7 @@
 #include "Core/HLE/scePower.h"
 #include "Core/HLE/Plugins.h"
 #include "Core/ControlMapper.h"
+#include "Core/AVIDump.h"
 #include "Core/Config.h"
 #include "Core/MemFault.h"
 #include "Core/Reporting.h"
@@ -44,6 +45,13 @@ static void DrawDebugStats(UIContext *ctx, const Bounds &bounds) {
 	ctx->Draw()->SetFontScale(.7f, .7f);
 
 	__DisplayGetDebugStats(statbuf, sizeof(statbuf));
+#ifndef MOBILE_DEVICE
+	if (AVIDump::IsRecording()) {
+		AVIDumpStats dumpStats = AVIDump::GetStats();
+		size_t len = strlen(statbuf);
+		snprintf(statbuf + len, sizeof(statbuf) - len, "AVI dump: queue %d (max %d), %d frames dropped\n", dumpStats.queueDepth, dumpStats.maxQueueDepth, dumpStats.framesDropped);
+	}
+#endif
 	ctx->Draw()->DrawTextRect(ubuntu24, statbuf, bounds.x + 11, bounds.y + 31, left, bounds.h - 30, 0xc0000000, FLAG_DYNAMIC_ASCII);
 	ctx->Draw()->DrawTextRect(ubuntu24, statbuf, bounds.x + 10, bounds.y + 30, left, bounds.h - 30, 0xFFFFFFFF, FLAG_DYNAMIC_ASCII);
 
@@ -38,6 +38,7 @@
 #include "Common/Data/Text/I18n.h"
 #include "Common/Data/Encoding/Utf8.h"
 #include "Common/Net/HTTPClient.h"
+#include "Common/Net/HTTPServer.h"
 #include "Common/UI/Context.h"
 #include "Common/UI/View.h"
 #include "Common/UI/ViewGroup.h"
@@ -56,6 +57,7 @@
 #include "Core/System.h"
 #include "Core/Reporting.h"
 #include "Core/CoreParameter.h"
+#include "Core/WebServer.h"
 #include "Core/HLE/sceKernel.h"  // GPI/GPO
 #include "Core/MIPS/MIPSTables.h"
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
@@ -667,6 +669,15 @@ void SystemInfoScreen::CreateTabs() {
 	versionInfo->Add(new InfoItem("Moga", moga));
 #endif
 
+	http::ServerStats serverStats;
+	if (WebServerGetStats(&serverStats)) {
+		// Only while sharing games or the remote debugger is running.
+		CollapsibleSection *webServerInfo = deviceSpecs->Add(new CollapsibleSection(si->T("Web Server Information")));
+		webServerInfo->Add(new InfoItem(si->T("Active connections"), StringFromFormat("%d (peak %d)", serverStats.activeConnections, serverStats.peakConnections)));
+		webServerInfo->Add(new InfoItem(si->T("Total connections"), StringFromFormat("%lld", (long long)serverStats.totalConnections)));
+		webServerInfo->Add(new InfoItem(si->T("Requests"), StringFromFormat("%lld (%lld keep-alive)", (long long)serverStats.totalRequests, (long long)serverStats.keepAliveRequests)));
+	}
+
 	if (gstate_c.GetUseFlags()) {
 		// We're in-game, and can determine these.
 		// TODO: Call a static version of GPUCommon::CheckGPUFeatures() and derive them here directly.
@@ -38,6 +38,7 @@
 #include "Core/SaveState.h"
 #include "Core/System.h"
 #include "Core/Loaders.h"
+#include "Core/Util/GameInfoIndex.h"
 #include "Core/Util/GameManager.h"
 #include "Core/Config.h"
 #include "UI/GameInfoCache.h"
@@ -453,13 +454,62 @@ static bool ReadVFSToString(const char *filename, std::string *contents, std::mu
 	return true;
 }
 
+// For games without an icon of their own: a screenshot of the game if there is one, otherwise
+// the generic icon.
+static bool ReadFallbackIcon(const std::string &id, std::string *contents, std::mutex *mtx) {
+	Path screenshot_jpg = GetSysDirectory(DIRECTORY_SCREENSHOT) / (id + "_00000.jpg");
+	Path screenshot_png = GetSysDirectory(DIRECTORY_SCREENSHOT) / (id + "_00000.png");
+	// Try using png/jpg screenshots first
+	if (File::Exists(screenshot_png))
+		return ReadLocalFileToString(screenshot_png, contents, mtx);
+	if (File::Exists(screenshot_jpg))
+		return ReadLocalFileToString(screenshot_jpg, contents, mtx);
+	DEBUG_LOG(Log::Loader, "Loading unknown.png because no icon was found");
+	return ReadVFSToString("unknown.png", contents, mtx);
+}
+
+class GameInfoWorkItem;
+
+// Scans of game files wait their turn here, so that a big library on slow storage doesn't take
+// up all the I/O threads. The latest requests go first, as those are the games on screen.
+class GameInfoScanQueue {
+public:
+	GameInfoScanQueue(const std::shared_ptr<GameInfoIndex> &index) : index_(index) {}
+
+	void Enqueue(GameInfoWorkItem *item);
+	void Finished();
+	// Forgets the ones that haven't started.
+	void DropWaiting();
+
+	const std::shared_ptr<GameInfoIndex> &Index() const {
+		return index_;
+	}
+
+private:
+	enum {
+		// There are at least four I/O threads, this leaves one for everything else.
+		MAX_RUNNING = 3,
+		// In seconds.
+		SAVE_INTERVAL = 10,
+	};
+
+	std::shared_ptr<GameInfoIndex> index_;
+	std::mutex lock_;
+	std::vector<GameInfoWorkItem *> waiting_;
+	int running_ = 0;
+	double lastSave_ = 0.0;
+};
+
 class GameInfoWorkItem : public Task {
 public:
-	GameInfoWorkItem(const Path &gamePath, std::shared_ptr<GameInfo> &info, GameInfoFlags flags)
-		: gamePath_(gamePath), info_(info), flags_(flags) {}
+	GameInfoWorkItem(const Path &gamePath, std::shared_ptr<GameInfo> &info, GameInfoFlags flags, const std::shared_ptr<GameInfoScanQueue> &queue)
+		: gamePath_(gamePath), info_(info), flags_(flags), queue_(queue) {}
 
 	~GameInfoWorkItem() {
 		info_->DisposeFileLoader();
+		if (started_) {
+			queue_->Finished();
+		}
 	}
 
 	TaskType Type() const override {
@@ -479,14 +529,122 @@ class GameInfoWorkItem : public Task {
 	}
 
 	void Run() override {
+		started_ = true;
+
+		// Most of what the game list asks for can come from the index, without opening the file.
+		// Only plain files, as a directory's modification time doesn't tell if what's inside changed.
+		File::FileInfo fileInfo;
+		const bool indexable = File::GetFileInfo(gamePath_, &fileInfo) && !fileInfo.isDirectory;
+		GameInfoIndex::Entry entry;
+		const bool inIndex = indexable && queue_->Index()->Lookup(gamePath_.ToString(), fileInfo.size, fileInfo.mtime, &entry);
+		if (inIndex) {
+			ReadFromIndex(entry);
+		}
+
 		// An early-return will result in the destructor running, where we can set
 		// flags like working and pending.
+		const GameInfoFlags scanFlags = GameInfoFlags::FILE_TYPE | GameInfoFlags::PARAM_SFO | GameInfoFlags::ICON | GameInfoFlags::BG | GameInfoFlags::SND;
+		if (((int)flags_ & (int)scanFlags) != 0 && !ScanFile()) {
+			return;
+		}
+
+		if (flags_ & GameInfoFlags::SIZE) {
+			std::lock_guard<std::mutex> lock(info_->lock);
+			info_->gameSizeOnDisk = indexable ? fileInfo.size : info_->GetSizeOnDiskInBytes();
+			switch (info_->fileType) {
+			case IdentifiedFileType::PSP_ISO:
+			case IdentifiedFileType::PSP_ISO_NP:
+			case IdentifiedFileType::PSP_DISC_DIRECTORY:
+			case IdentifiedFileType::PSP_PBP:
+			case IdentifiedFileType::PSP_PBP_DIRECTORY:
+				info_->saveDataSize = info_->GetGameSavedataSizeInBytes();
+				info_->installDataSize = info_->GetInstallDataSizeInBytes();
+				break;
+			default:
+				info_->saveDataSize = 0;
+				info_->installDataSize = 0;
+				break;
+			}
+		}
+		if (flags_ & GameInfoFlags::UNCOMPRESSED_SIZE) {
+			info_->gameSizeUncompressed = info_->GetSizeUncompressedInBytes();
+			indexEntry_.uncompressedSize = info_->gameSizeUncompressed;
+			indexEntry_.flags |= (u32)GameInfoFlags::UNCOMPRESSED_SIZE;
+		}
+
+		if (indexable && indexEntry_.flags != 0 && IsIndexedType(info_->fileType)) {
+			// Adds to what was there, if it's still valid.
+			if (!inIndex) {
+				entry = GameInfoIndex::Entry();
+			}
+			entry.size = fileInfo.size;
+			entry.mtime = fileInfo.mtime;
+			entry.fileType = (u32)info_->fileType;
+			if (indexEntry_.flags & (u32)GameInfoFlags::PARAM_SFO) {
+				entry.paramSFO = std::move(indexEntry_.paramSFO);
+			}
+			if (indexEntry_.flags & (u32)GameInfoFlags::ICON) {
+				entry.icon = std::move(indexEntry_.icon);
+			}
+			if (indexEntry_.flags & (u32)GameInfoFlags::UNCOMPRESSED_SIZE) {
+				entry.uncompressedSize = indexEntry_.uncompressedSize;
+			}
+			entry.flags |= indexEntry_.flags;
+			queue_->Index()->Store(gamePath_.ToString(), entry);
+		}
+
+		// Time to update the flags.
+		std::unique_lock<std::mutex> lock(info_->lock);
+		info_->MarkReadyNoLock(flags_);
+		// INFO_LOG(Log::System, "Completed writing info for %s", info_->GetTitle().c_str());
+	}
+
+private:
+	static bool IsIndexedType(IdentifiedFileType type) {
+		// The ones where everything comes from inside the file. Directories aren't indexed anyway.
+		return type == IdentifiedFileType::PSP_ISO || type == IdentifiedFileType::PSP_ISO_NP || type == IdentifiedFileType::PSP_PBP;
+	}
+
+	// Clears what it filled in from flags_.
+	void ReadFromIndex(const GameInfoIndex::Entry &entry) {
+		const int restored = ((int)GameInfoFlags::FILE_TYPE | (int)entry.flags) & (int)flags_;
+		{
+			std::lock_guard<std::mutex> lock(info_->lock);
+			info_->fileType = (IdentifiedFileType)entry.fileType;
+			if ((restored & (int)GameInfoFlags::PARAM_SFO) && !entry.paramSFO.empty()) {
+				info_->paramSFO.ReadSFO((const u8 *)entry.paramSFO.data(), entry.paramSFO.size());
+				info_->ParseParamSFO();
+			}
+			if (restored & (int)GameInfoFlags::UNCOMPRESSED_SIZE) {
+				info_->gameSizeUncompressed = entry.uncompressedSize;
+			}
+		}
+		if (restored & (int)GameInfoFlags::PARAM_SFO) {
+			info_->hasConfig = g_Config.hasGameConfig(info_->id);
+		}
+		if (restored & (int)GameInfoFlags::ICON) {
+			if (!entry.icon.empty()) {
+				std::lock_guard<std::mutex> lock(info_->lock);
+				info_->icon.data = entry.icon;
+				info_->icon.dataLoaded = true;
+			} else {
+				info_->icon.dataLoaded = ReadFallbackIcon(info_->id, &info_->icon.data, &info_->lock);
+			}
+		}
+
+		std::unique_lock<std::mutex> lock(info_->lock);
+		info_->MarkReadyNoLock((GameInfoFlags)restored);
+		flags_ = (GameInfoFlags)((int)flags_ & ~restored);
+	}
+
+	// Opens the file to get what's in flags_. Returns false if it's not readable, after marking everything done.
+	bool ScanFile() {
 		if (!info_->CreateLoader() || !info_->GetFileLoader() || !info_->GetFileLoader()->Exists()) {
 			// Mark everything requested as done, so 
 			std::unique_lock<std::mutex> lock(info_->lock);
 			info_->MarkReadyNoLock(flags_);
 			ERROR_LOG(Log::Loader, "Failed getting game info for %s", info_->GetFilePath().ToVisualString().c_str());
-			return;
+			return false;
 		}
 
 		std::string errorString;
@@ -517,13 +675,15 @@ class GameInfoWorkItem : public Task {
 					// handle the missing data.
 					std::unique_lock<std::mutex> lock(info_->lock);
 					info_->MarkReadyNoLock(flags_);
-					return;
+					return false;
 				}
 
 				// First, PARAM.SFO.
 				if (flags_ & GameInfoFlags::PARAM_SFO) {
 					std::vector<u8> sfoData;
+					indexEntry_.flags |= (u32)GameInfoFlags::PARAM_SFO;
 					if (pbp.GetSubFile(PBP_PARAM_SFO, &sfoData)) {
+						indexEntry_.paramSFO.assign((const char *)sfoData.data(), sfoData.size());
 						std::lock_guard<std::mutex> lock(info_->lock);
 						info_->paramSFO.ReadSFO(sfoData);
 						info_->ParseParamSFO();
@@ -542,20 +702,13 @@ class GameInfoWorkItem : public Task {
 
 				// Then, ICON0.PNG.
 				if (flags_ & GameInfoFlags::ICON) {
+					indexEntry_.flags |= (u32)GameInfoFlags::ICON;
 					if (pbp.GetSubFileSize(PBP_ICON0_PNG) > 0) {
 						std::lock_guard<std::mutex> lock(info_->lock);
 						pbp.GetSubFileAsString(PBP_ICON0_PNG, &info_->icon.data);
+						indexEntry_.icon = info_->icon.data;
 					} else {
-						Path screenshot_jpg = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.jpg");
-						Path screenshot_png = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.png");
-						// Try using png/jpg screenshots first
-						if (File::Exists(screenshot_png))
-							ReadLocalFileToString(screenshot_png, &info_->icon.data, &info_->lock);
-						else if (File::Exists(screenshot_jpg))
-							ReadLocalFileToString(screenshot_jpg, &info_->icon.data, &info_->lock);
-						else
-							// Read standard icon
-							ReadVFSToString("unknown.png", &info_->icon.data, &info_->lock);
+						ReadFallbackIcon(info_->id, &info_->icon.data, &info_->lock);
 					}
 					info_->icon.dataLoaded = true;
 				}
@@ -719,21 +872,23 @@ class GameInfoWorkItem : public Task {
 					ERROR_LOG(Log::Loader, "Failed getting game info for ISO %s", info_->GetFilePath().ToVisualString().c_str());
 					std::unique_lock<std::mutex> lock(info_->lock);
 					info_->MarkReadyNoLock(flags_);
-					return;
+					return false;
 				}
 				BlockDevice *bd = constructBlockDevice(info_->GetFileLoader().get());
 				if (!bd) {
 					ERROR_LOG(Log::Loader, "Failed constructing block device for ISO %s", info_->GetFilePath().ToVisualString().c_str());
 					std::unique_lock<std::mutex> lock(info_->lock);
 					info_->MarkReadyNoLock(flags_);
-					return;
+					return false;
 				}
 				ISOFileSystem umd(&handles, bd);
 
 				// Alright, let's fetch the PARAM.SFO.
 				if (flags_ & GameInfoFlags::PARAM_SFO) {
 					std::string paramSFOcontents;
+					indexEntry_.flags |= (u32)GameInfoFlags::PARAM_SFO;
 					if (ReadFileToString(&umd, "/PSP_GAME/PARAM.SFO", &paramSFOcontents, nullptr)) {
+						indexEntry_.paramSFO = paramSFOcontents;
 						{
 							std::lock_guard<std::mutex> lock(info_->lock);
 							info_->paramSFO.ReadSFO((const u8 *)paramSFOcontents.data(), paramSFOcontents.size());
@@ -756,19 +911,12 @@ class GameInfoWorkItem : public Task {
 
 				// Fall back to unknown icon if ISO is broken/is a homebrew ISO, override is allowed though
 				if (flags_ & GameInfoFlags::ICON) {
+					indexEntry_.flags |= (u32)GameInfoFlags::ICON;
 					if (!ReadFileToString(&umd, "/PSP_GAME/ICON0.PNG", &info_->icon.data, &info_->lock)) {
-						Path screenshot_jpg = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.jpg");
-						Path screenshot_png = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.png");
-						// Try using png/jpg screenshots first
-						if (File::Exists(screenshot_png))
-							info_->icon.dataLoaded = ReadLocalFileToString(screenshot_png, &info_->icon.data, &info_->lock);
-						else if (File::Exists(screenshot_jpg))
-							info_->icon.dataLoaded = ReadLocalFileToString(screenshot_jpg, &info_->icon.data, &info_->lock);
-						else {
-							DEBUG_LOG(Log::Loader, "Loading unknown.png because no icon was found");
-							info_->icon.dataLoaded = ReadVFSToString("unknown.png", &info_->icon.data, &info_->lock);
-						}
+						info_->icon.dataLoaded = ReadFallbackIcon(info_->id, &info_->icon.data, &info_->lock);
 					} else {
+						std::lock_guard<std::mutex> lock(info_->lock);
+						indexEntry_.icon = info_->icon.data;
 						info_->icon.dataLoaded = true;
 					}
 				}
@@ -805,43 +953,68 @@ class GameInfoWorkItem : public Task {
 			// We fetch the hasConfig together with the params, since that's what fills out the id.
 			info_->hasConfig = g_Config.hasGameConfig(info_->id);
 		}
-
-		if (flags_ & GameInfoFlags::SIZE) {
-			std::lock_guard<std::mutex> lock(info_->lock);
-			info_->gameSizeOnDisk = info_->GetSizeOnDiskInBytes();
-			switch (info_->fileType) {
-			case IdentifiedFileType::PSP_ISO:
-			case IdentifiedFileType::PSP_ISO_NP:
-			case IdentifiedFileType::PSP_DISC_DIRECTORY:
-			case IdentifiedFileType::PSP_PBP:
-			case IdentifiedFileType::PSP_PBP_DIRECTORY:
-				info_->saveDataSize = info_->GetGameSavedataSizeInBytes();
-				info_->installDataSize = info_->GetInstallDataSizeInBytes();
-				break;
-			default:
-				info_->saveDataSize = 0;
-				info_->installDataSize = 0;
-				break;
-			}
-		}
-		if (flags_ & GameInfoFlags::UNCOMPRESSED_SIZE) {
-			info_->gameSizeUncompressed = info_->GetSizeUncompressedInBytes();
-		}
-
-		// Time to update the flags.
-		std::unique_lock<std::mutex> lock(info_->lock);
-		info_->MarkReadyNoLock(flags_);
-		// INFO_LOG(Log::System, "Completed writing info for %s", info_->GetTitle().c_str());
+		return true;
 	}
 
-private:
 	Path gamePath_;
 	std::shared_ptr<GameInfo> info_;
 	GameInfoFlags flags_{};
+	std::shared_ptr<GameInfoScanQueue> queue_;
+	bool started_ = false;
+	// What was found inside the file, for the index.
+	GameInfoIndex::Entry indexEntry_;
 
 	DISALLOW_COPY_AND_ASSIGN(GameInfoWorkItem);
 };
 
+void GameInfoScanQueue::Enqueue(GameInfoWorkItem *item) {
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		if (running_ >= MAX_RUNNING) {
+			waiting_.push_back(item);
+			return;
+		}
+		running_++;
+	}
+	g_threadManager.EnqueueTask(item);
+}
+
+void GameInfoScanQueue::Finished() {
+	GameInfoWorkItem *next = nullptr;
+	bool idle = false;
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		if (!waiting_.empty()) {
+			next = waiting_.back();
+			waiting_.pop_back();
+		} else {
+			running_--;
+			// Whatever was on screen has been scanned, a good time to write down what was found.
+			// But not every time while scrolling through a big library.
+			idle = running_ == 0 && time_now_d() - lastSave_ >= SAVE_INTERVAL;
+			if (idle) {
+				lastSave_ = time_now_d();
+			}
+		}
+	}
+	if (next) {
+		g_threadManager.EnqueueTask(next);
+	} else if (idle) {
+		index_->Save();
+	}
+}
+
+void GameInfoScanQueue::DropWaiting() {
+	std::vector<GameInfoWorkItem *> waiting;
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		waiting.swap(waiting_);
+	}
+	for (GameInfoWorkItem *item : waiting) {
+		delete item;
+	}
+}
+
 GameInfoCache::GameInfoCache() {
 	Init();
 }
@@ -851,10 +1024,20 @@ GameInfoCache::~GameInfoCache() {
 	Shutdown();
 }
 
-void GameInfoCache::Init() {}
+void GameInfoCache::Init() {
+	// Without a memstick, there's nowhere to keep it yet.
+	Path indexPath;
+	if (!g_Config.memStickDirectory.empty()) {
+		indexPath = GetSysDirectory(DIRECTORY_CACHE) / "gameinfo.ppgi";
+	}
+	index_ = std::make_shared<GameInfoIndex>(indexPath);
+	scanQueue_ = std::make_shared<GameInfoScanQueue>(index_);
+}
 
 void GameInfoCache::Shutdown() {
+	scanQueue_->DropWaiting();
 	CancelAll();
+	index_->Save();
 }
 
 void GameInfoCache::Clear() {
@@ -960,8 +1143,8 @@ std::shared_ptr<GameInfo> GameInfoCache::GetInfo(Draw::DrawContext *draw, const
 		}
 		if (wanted != (GameInfoFlags)0) {
 			// We're missing info that we want. Go get it!
-			GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wanted);
-			g_threadManager.EnqueueTask(item);
+			GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wanted, scanQueue_);
+			scanQueue_->Enqueue(item);
 		}
 		return info;
 	}
@@ -973,7 +1156,7 @@ std::shared_ptr<GameInfo> GameInfoCache::GetInfo(Draw::DrawContext *draw, const
 	mapLock_.unlock();
 
 	// Just get all the stuff we wanted.
-	GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wantFlags);
-	g_threadManager.EnqueueTask(item);
+	GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wantFlags, scanQueue_);
+	scanQueue_->Enqueue(item);
 	return info;
 }
@@ -62,6 +62,8 @@ enum class GameInfoFlags {
 ENUM_CLASS_BITOPS(GameInfoFlags);
 
 class FileLoader;
+class GameInfoIndex;
+class GameInfoScanQueue;
 enum class IdentifiedFileType;
 
 struct GameInfoTex {
@@ -220,6 +222,10 @@ class GameInfoCache {
 	// and if they get destructed while being in use, that's bad.
 	std::map<std::string, std::shared_ptr<GameInfo> > info_;
 	std::mutex mapLock_;
+
+	// Shared with the work items, which can outlive the cache.
+	std::shared_ptr<GameInfoIndex> index_;
+	std::shared_ptr<GameInfoScanQueue> scanQueue_;
 };
 
 // This one can be global, no good reason not to.
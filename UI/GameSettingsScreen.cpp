@@ -667,6 +667,14 @@ void GameSettingsScreen::CreateAudioSettings(UI::ViewGroup *audioSettings) {
 	achievementVolume->SetEnabledPtr(&g_Config.bEnableSound);
 	achievementVolume->SetZeroLabel(a->T("Mute"));
 
+	static const char *resampler[] = { "Linear (fast)", "Sinc, 8 taps", "Sinc, 16 taps" };
+	PopupMultiChoice *resamplerChoice = audioSettings->Add(new PopupMultiChoice(&g_Config.iAudioResampler, a->T("Resampler quality"), resampler, 0, ARRAY_SIZE(resampler), I18NCat::AUDIO, screenManager()));
+	resamplerChoice->SetEnabledPtr(&g_Config.bEnableSound);
+
+	PopupSliderChoice *decodedAudioCache = audioSettings->Add(new PopupSliderChoice(&g_Config.iDecodedAudioCacheMB, 0, 128, 0, a->T("Cache decoded music loops"), 8, screenManager(), "MB"));
+	decodedAudioCache->SetEnabledPtr(&g_Config.bEnableSound);
+	decodedAudioCache->SetZeroLabel(a->T("Disabled"));
+
 	// Hide the backend selector in UWP builds (we only support XAudio2 there).
 #if PPSSPP_PLATFORM(WINDOWS) && !PPSSPP_PLATFORM(UWP)
 	if (IsVistaOrHigher()) {
@@ -1219,6 +1227,7 @@ void GameSettingsScreen::CreateSystemSettings(UI::ViewGroup *systemSettings) {
 #endif
 #endif
 	systemSettings->Add(new CheckBox(&g_Config.bMemStickInserted, sy->T("Memory Stick inserted")));
+	systemSettings->Add(new CheckBox(&g_Config.bMemStickWriteCache, sy->T("Cache Memory Stick writes")));
 	UI::PopupSliderChoice *sizeChoice = systemSettings->Add(new PopupSliderChoice(&g_Config.iMemStickSizeGB, 1, 32, 16, sy->T("Memory Stick size", "Memory Stick size"), screenManager(), "GB"));
 	sizeChoice->SetFormat("%d GB");
 
@@ -1272,6 +1281,9 @@ void GameSettingsScreen::CreateSystemSettings(UI::ViewGroup *systemSettings) {
 		systemSettings->Add(new CheckBox(&g_Config.bBypassOSKWithKeyboard, sy->T("Use system native keyboard")));
 
 	systemSettings->Add(new CheckBox(&g_Config.bCacheFullIsoInRam, sy->T("Cache ISO in RAM", "Cache full ISO in RAM")))->SetEnabled(!PSP_IsInited());
+#if PPSSPP_PLATFORM(LINUX) && PPSSPP_ARCH(64BIT)
+	systemSettings->Add(new CheckBox(&g_Config.bMemoryMapDiscImages, sy->T("Memory-map disc images")))->SetEnabled(!PSP_IsInited());
+#endif
 	systemSettings->Add(new CheckBox(&g_Config.bCheckForNewVersion, sy->T("VersionCheck", "Check for new versions of PPSSPP")));
 	systemSettings->Add(new CheckBox(&g_Config.bScreenshotsAsPNG, sy->T("Screenshots as PNG")));
 	// TODO: Make this setting available on Mac too.
@@ -1801,6 +1813,8 @@ void DeveloperToolsScreen::CreateViews() {
 	list->Add(new ItemHeader(dev->T("Texture Replacement")));
 	list->Add(new CheckBox(&g_Config.bSaveNewTextures, dev->T("Save new textures")));
 	list->Add(new CheckBox(&g_Config.bReplaceTextures, dev->T("Replace textures")));
+	CheckBox *transcode = list->Add(new CheckBox(&g_Config.bTranscodeReplacementTextures, dev->T("Compress PNG replacements to cache (lossy)")));
+	transcode->SetEnabledPtr(&g_Config.bReplaceTextures);
 
 	Choice *createTextureIni = list->Add(new Choice(dev->T("Create/Open textures.ini file for current game")));
 	createTextureIni->OnClick.Handle(this, &DeveloperToolsScreen::OnOpenTexturesIniFile);
@@ -89,6 +89,7 @@
 #include "Core/Config.h"
 #include "Core/ConfigValues.h"
 #include "Core/Core.h"
+#include "Core/FileLoaders/AccessProfile.h"
 #include "Core/FileLoaders/DiskCachingFileLoader.h"
 #include "Core/FrameTiming.h"
 #include "Core/KeyMap.h"
@@ -516,6 +517,7 @@ void NativeInit(int argc, const char *argv[], const char *savegame_dir, const ch
 	if (cache_dir && strlen(cache_dir)) {
 		g_Config.appCacheDirectory = Path(cache_dir);
 		DiskCachingFileLoaderCache::SetCacheDir(g_Config.appCacheDirectory);
+		AccessProfile::SetProfileDir(g_Config.appCacheDirectory);
 	}
 
 	g_logManager.Init(&g_Config.bEnableLogging);
@@ -546,6 +546,7 @@ EXEC_AND_LIB_FILES := \
   $(SRC)/GPU/Common/GeometryShaderGenerator.cpp \
   $(SRC)/GPU/Common/TextureReplacer.cpp \
   $(SRC)/GPU/Common/ReplacedTexture.cpp \
+  $(SRC)/GPU/Common/ReplacementTranscoder.cpp \
   $(SRC)/GPU/Debugger/Breakpoints.cpp \
   $(SRC)/GPU/Debugger/Debugger.cpp \
   $(SRC)/GPU/Debugger/GECommandTable.cpp \
@@ -587,6 +588,7 @@ EXEC_AND_LIB_FILES := \
   $(SRC)/Core/HW/MediaEngine.cpp.arm \
   $(SRC)/Core/HW/SasAudio.cpp.arm \
   $(SRC)/Core/HW/SasReverb.cpp.arm \
+  $(SRC)/Core/HW/DecodedAudioCache.cpp \
   $(SRC)/Core/HW/StereoResampler.cpp.arm \
   $(SRC)/Core/ControlMapper.cpp \
   $(SRC)/Core/Core.cpp \
@@ -602,6 +604,7 @@ EXEC_AND_LIB_FILES := \
   $(SRC)/Core/KeyMapDefaults.cpp \
   $(SRC)/Core/Loaders.cpp \
   $(SRC)/Core/PSPLoaders.cpp \
+  $(SRC)/Core/FileLoaders/AccessProfile.cpp \
   $(SRC)/Core/FileLoaders/CachingFileLoader.cpp \
   $(SRC)/Core/FileLoaders/DiskCachingFileLoader.cpp \
   $(SRC)/Core/FileLoaders/HTTPFileLoader.cpp \
@@ -748,6 +751,8 @@ EXEC_AND_LIB_FILES := \
   $(SRC)/Core/Util/PortManager.cpp \
   $(SRC)/Core/Util/GameDB.cpp \
   $(SRC)/Core/Util/GameManager.cpp \
+  $(SRC)/Core/Util/GameInfoIndex.cpp \
+  $(SRC)/Core/Util/ZipExtractor.cpp \
   $(SRC)/Core/Util/BlockAllocator.cpp \
   $(SRC)/Core/Util/PPGeDraw.cpp \
   $(SRC)/git-version.cpp
@@ -981,6 +986,26 @@ ifeq ($(UNITTEST),1)
     $(SRC)/unittest/TestThreadManager.cpp \
     $(SRC)/unittest/TestVertexJit.cpp \
     $(SRC)/unittest/TestVFS.cpp \
+    $(SRC)/unittest/TestAdhocServer.cpp \
+    $(SRC)/unittest/TestHTTPFileLoader.cpp \
+    $(SRC)/unittest/TestVFPUSimd.cpp \
+    $(SRC)/unittest/TestSasMixer.cpp \
+    $(SRC)/unittest/TestSasReverb.cpp \
+    $(SRC)/unittest/TestAudioResampler.cpp \
+    $(SRC)/unittest/TestVideoConvert.cpp \
+    $(SRC)/unittest/TestAtrac3Decoder.cpp \
+    $(SRC)/unittest/TestDecodedAudioCache.cpp \
+    $(SRC)/unittest/TestMpegDemux.cpp \
+    $(SRC)/unittest/TestVagDecoder.cpp \
+    $(SRC)/unittest/TestPathCaseCache.cpp \
+    $(SRC)/unittest/TestISOFileSystem.cpp \
+    $(SRC)/unittest/TestLocalFileLoader.cpp \
+    $(SRC)/unittest/TestAccessProfile.cpp \
+    $(SRC)/unittest/TestReplacementTranscoder.cpp \
+    $(SRC)/unittest/TestGameInfoIndex.cpp \
+    $(SRC)/unittest/TestZipExtractor.cpp \
+    $(SRC)/unittest/TestBlockDeviceReads.cpp \
+    $(SRC)/unittest/TestMemStickWriteCache.cpp \
     $(TESTARMEMITTER_FILE) \
     $(SRC)/unittest/UnitTest.cpp
 
@@ -14,13 +14,20 @@ struct ATRAC3PContext;
 
 // If the block_align passed in is 0, tries to audio detect.
 // flush_buffers should be called when seeking before the next decode_frame.
+//
+// decode_frames decodes num_frames consecutive frames of buf_size bytes each, with the output of each
+// frame following the previous one in out_data, which needs room for num_frames * 1024 (Atrac3) or
+// 2048 (Atrac3+) samples per channel. Stops at the first bad frame. Returns the number of bytes
+// consumed, or the error if the very first frame failed, and *nb_samples gets the total per channel.
 
 ATRAC3Context *atrac3_alloc(int channels, int *block_align, const uint8_t *extra_data, int extra_data_size);
 void atrac3_free(ATRAC3Context *ctx);
 void atrac3_flush_buffers(ATRAC3Context *ctx);
 int atrac3_decode_frame(ATRAC3Context *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size);
+int atrac3_decode_frames(ATRAC3Context *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size, int num_frames);
 
 ATRAC3PContext *atrac3p_alloc(int channels, int *block_align);
 void atrac3p_free(ATRAC3PContext *ctx);
 void atrac3p_flush_buffers(ATRAC3PContext *ctx);
 int atrac3p_decode_frame(ATRAC3PContext *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size);
+int atrac3p_decode_frames(ATRAC3PContext *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size, int num_frames);
@@ -25,6 +25,22 @@
  * @file
  */
 
+#include "ppsspp_config.h"
+
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+
+#include <emmintrin.h>
+
+#elif PPSSPP_ARCH(ARM_NEON)
+
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+
+#endif
+
 #include <math.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -80,6 +96,45 @@ void ff_atrac_init_gain_compensation(AtracGCContext *gctx, int id2exp_offset,
         gctx->gain_tab2[i + 15] = powf(2.0, -1.0f / gctx->loc_size * i);
 }
 
+/* out = (in * gc_scale + prev) * lev, for the stretches with a constant gain level. */
+static void overlap_scaled(float *out, const float *in, const float *prev,
+                           float gc_scale, float lev, int count)
+{
+    int pos = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    const __m128 scale = _mm_set1_ps(gc_scale);
+    const __m128 level = _mm_set1_ps(lev);
+    for (; pos + 4 <= count; pos += 4) {
+        __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + pos), scale), _mm_loadu_ps(prev + pos));
+        _mm_storeu_ps(out + pos, _mm_mul_ps(sum, level));
+    }
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; pos + 4 <= count; pos += 4) {
+        float32x4_t sum = vaddq_f32(vmulq_n_f32(vld1q_f32(in + pos), gc_scale), vld1q_f32(prev + pos));
+        vst1q_f32(out + pos, vmulq_n_f32(sum, lev));
+    }
+#endif
+    for (; pos < count; pos++)
+        out[pos] = (in[pos] * gc_scale + prev[pos]) * lev;
+}
+
+/* Same without the gain level, out = in * gc_scale + prev. */
+static void overlap(float *out, const float *in, const float *prev,
+                    float gc_scale, int count)
+{
+    int pos = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    const __m128 scale = _mm_set1_ps(gc_scale);
+    for (; pos + 4 <= count; pos += 4)
+        _mm_storeu_ps(out + pos, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + pos), scale), _mm_loadu_ps(prev + pos)));
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; pos + 4 <= count; pos += 4)
+        vst1q_f32(out + pos, vaddq_f32(vmulq_n_f32(vld1q_f32(in + pos), gc_scale), vld1q_f32(prev + pos)));
+#endif
+    for (; pos < count; pos++)
+        out[pos] = in[pos] * gc_scale + prev[pos];
+}
+
 void ff_atrac_gain_compensation(AtracGCContext *gctx, float *in, float *prev,
                                 AtracGainInfo *gc_now, AtracGainInfo *gc_next,
                                 int num_samples, float *out)
@@ -91,8 +146,7 @@ void ff_atrac_gain_compensation(AtracGCContext *gctx, float *in, float *prev,
                                    : 1.0f;
 
     if (!gc_now->num_points) {
-        for (pos = 0; pos < num_samples; pos++)
-            out[pos] = in[pos] * gc_scale + prev[pos];
+        overlap(out, in, prev, gc_scale, num_samples);
     } else {
         pos = 0;
 
@@ -105,8 +159,10 @@ void ff_atrac_gain_compensation(AtracGCContext *gctx, float *in, float *prev,
                                        gc_now->lev_code[i] + 15];
 
             /* apply constant gain level and overlap */
-            for (; pos < lastpos; pos++)
-                out[pos] = (in[pos] * gc_scale + prev[pos]) * lev;
+            if (pos < lastpos) {
+                overlap_scaled(out + pos, in + pos, prev + pos, gc_scale, lev, lastpos - pos);
+                pos = lastpos;
+            }
 
             /* interpolate between two different gain levels */
             for (; pos < lastpos + gctx->loc_size; pos++) {
@@ -115,8 +171,8 @@ void ff_atrac_gain_compensation(AtracGCContext *gctx, float *in, float *prev,
             }
         }
 
-        for (; pos < num_samples; pos++)
-            out[pos] = in[pos] * gc_scale + prev[pos];
+        if (pos < num_samples)
+            overlap(out + pos, in + pos, prev + pos, gc_scale, num_samples - pos);
     }
 
     /* copy the overlapping part into the delay buffer */
@@ -134,7 +190,27 @@ void ff_atrac_iqmf(float *inlo, float *inhi, unsigned int nIn, float *pOut,
     p3 = temp + 46;
 
     /* loop1 */
-    for(i=0; i<(int)nIn; i+=2){
+    i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    for (; i + 4 <= (int)nIn; i += 4) {
+        __m128 lo = _mm_loadu_ps(inlo + i);
+        __m128 hi = _mm_loadu_ps(inhi + i);
+        __m128 sum = _mm_add_ps(lo, hi);
+        __m128 diff = _mm_sub_ps(lo, hi);
+        _mm_storeu_ps(p3 + 2 * i, _mm_unpacklo_ps(sum, diff));
+        _mm_storeu_ps(p3 + 2 * i + 4, _mm_unpackhi_ps(sum, diff));
+    }
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 4 <= (int)nIn; i += 4) {
+        float32x4_t lo = vld1q_f32(inlo + i);
+        float32x4_t hi = vld1q_f32(inhi + i);
+        float32x4x2_t sumdiff;
+        sumdiff.val[0] = vaddq_f32(lo, hi);
+        sumdiff.val[1] = vsubq_f32(lo, hi);
+        vst2q_f32(p3 + 2 * i, sumdiff);
+    }
+#endif
+    for(; i<(int)nIn; i+=2){
         p3[2*i+0] = inlo[i  ] + inhi[i  ];
         p3[2*i+1] = inlo[i  ] - inhi[i  ];
         p3[2*i+2] = inlo[i+1] + inhi[i+1];
@@ -143,7 +219,49 @@ void ff_atrac_iqmf(float *inlo, float *inhi, unsigned int nIn, float *pOut,
 
     /* loop2 */
     p1 = temp;
-    for (j = (int)nIn; j != 0; j--) {
+    j = (int)nIn;
+    /* Four output pairs at a time, each sum still accumulated in the same order. */
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    for (; j >= 4; j -= 4) {
+        __m128 s1 = _mm_setzero_ps();
+        __m128 s2 = _mm_setzero_ps();
+
+        for (i = 0; i < 48; i += 2) {
+            __m128 a = _mm_loadu_ps(p1 + i);
+            __m128 b = _mm_loadu_ps(p1 + i + 4);
+            __m128 even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(even, _mm_set1_ps(qmf_window[i])));
+            s2 = _mm_add_ps(s2, _mm_mul_ps(odd, _mm_set1_ps(qmf_window[i+1])));
+        }
+
+        _mm_storeu_ps(pOut, _mm_unpacklo_ps(s2, s1));
+        _mm_storeu_ps(pOut + 4, _mm_unpackhi_ps(s2, s1));
+
+        p1 += 8;
+        pOut += 8;
+    }
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; j >= 4; j -= 4) {
+        float32x4_t s1 = vdupq_n_f32(0.0f);
+        float32x4_t s2 = vdupq_n_f32(0.0f);
+
+        for (i = 0; i < 48; i += 2) {
+            float32x4x2_t p = vld2q_f32(p1 + i);
+            s1 = vaddq_f32(s1, vmulq_n_f32(p.val[0], qmf_window[i]));
+            s2 = vaddq_f32(s2, vmulq_n_f32(p.val[1], qmf_window[i+1]));
+        }
+
+        float32x4x2_t out;
+        out.val[0] = s2;
+        out.val[1] = s1;
+        vst2q_f32(pOut, out);
+
+        p1 += 8;
+        pOut += 8;
+    }
+#endif
+    for (; j != 0; j--) {
         float s1 = 0.0;
         float s2 = 0.0;
 
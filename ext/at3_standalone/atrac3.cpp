@@ -301,8 +301,7 @@ static int decode_spectrum(GetBitContext *gb, float *output)
                            inv_max_quant[subband_vlc_index[i]];
 
             /* inverse quantize the coefficients */
-            for (j = 0; first < last; first++, j++)
-                output[first] = mantissas[j] * scale_factor;
+            int32_to_float_fmul_scalar(output + first, mantissas, scale_factor, subband_size);
         } else {
             /* this subband was not coded, so zero the entire subband */
             memset(output + first, 0, subband_size * sizeof(*output));
@@ -763,6 +762,26 @@ int atrac3_decode_frame(ATRAC3Context *ctx, float *out_data[2], int *nb_samples,
     return block_align;
 }
 
+int atrac3_decode_frames(ATRAC3Context *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size, int num_frames)
+{
+    float *out[2] = { out_data[0], out_data[1] };
+    int consumed = 0;
+
+    *nb_samples = 0;
+    for (int i = 0; i < num_frames; i++) {
+        int frame_samples;
+        int ret = atrac3_decode_frame(ctx, out, &frame_samples, buf + consumed, buf_size);
+        if (ret < 0)
+            return i == 0 ? ret : consumed;
+        consumed += ret;
+        *nb_samples += frame_samples;
+        out[0] += frame_samples;
+        if (out[1])
+            out[1] += frame_samples;
+    }
+    return consumed;
+}
+
 void atrac3_flush_buffers(ATRAC3Context *c) {
 	// There's no known correct way to do this, so let's just reset some stuff.
 	memset(c->temp_buf, 0, sizeof(c->temp_buf));
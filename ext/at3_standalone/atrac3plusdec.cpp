@@ -214,8 +214,7 @@ static void decode_residual_spectrum(Atrac3pChanUnitCtx *ctx,
             if (ctx->channels[ch].qu_wordlen[qu] > 0) {
                 q = av_atrac3p_sf_tab[ctx->channels[ch].qu_sf_idx[qu]] *
                     av_atrac3p_mant_tab[ctx->channels[ch].qu_wordlen[qu]];
-                for (i = 0; i < nspeclines; i++)
-                    dst[i] = src[i] * q;
+                int16_to_float_fmul_scalar(dst, src, q, nspeclines);
             }
         }
 
@@ -358,6 +357,26 @@ int atrac3p_decode_frame(ATRAC3PContext *ctx, float *out_data[2], int *nb_sample
     return FFMIN(ctx->block_align, indata_size);
 }
 
+int atrac3p_decode_frames(ATRAC3PContext *ctx, float *out_data[2], int *nb_samples, const uint8_t *buf, int buf_size, int num_frames)
+{
+    float *out[2] = { out_data[0], out_data[1] };
+    int consumed = 0;
+
+    *nb_samples = 0;
+    for (int i = 0; i < num_frames; i++) {
+        int frame_samples;
+        int ret = atrac3p_decode_frame(ctx, out, &frame_samples, buf + consumed, buf_size);
+        if (ret < 0)
+            return i == 0 ? ret : consumed;
+        consumed += ret;
+        *nb_samples += frame_samples;
+        out[0] += frame_samples;
+        if (out[1])
+            out[1] += frame_samples;
+    }
+    return consumed;
+}
+
 void atrac3p_flush_buffers(ATRAC3PContext *ctx) {
 	// TODO: Not sure what should be zeroed here.
 }
@@ -630,8 +630,6 @@ void ff_atrac3p_ipqf(FFTContext *dct_ctx, Atrac3pIPQFChannelCtx *hist,
     float idct_in [ATRAC3P_SUBBANDS];
     float idct_out[ATRAC3P_SUBBANDS];
 
-    memset(out, 0, ATRAC3P_FRAME_SAMPLES * sizeof(*out));
-
     for (s = 0; s < ATRAC3P_SUBBAND_SAMPLES; s++) {
         /* pick up one sample from each subband */
         for (sb = 0; sb < ATRAC3P_SUBBANDS; sb++)
@@ -652,62 +650,99 @@ void ff_atrac3p_ipqf(FFTContext *dct_ctx, Atrac3pIPQFChannelCtx *hist,
         pos_now  = hist->pos;
         pos_next = mod23_lut[pos_now + 2]; // pos_next = (pos_now + 1) % 23;
 
+        float *outp = out + s * 16;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+        auto _mm_reverse = [](__m128 x) -> __m128 {
+            return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+        };
+        // Accumulate all the taps in registers, in the same order as the plain loop.
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
         for (t = 0; t < ATRAC3P_PQF_FIR_LEN; t++) {
             const float *buf1 = hist->buf1[pos_now];
             const float *buf2 = hist->buf2[pos_next];
             const float *coeffs1 = ipqf_coeffs1[t];
             const float *coeffs2 = ipqf_coeffs2[t];
 
-            float *outp = out + s * 16;
-#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
-            auto _mm_reverse = [](__m128 x) -> __m128 {
-                return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
-            };
-            _mm_storeu_ps(outp, _mm_add_ps(_mm_loadu_ps(outp), _mm_add_ps(
-                _mm_mul_ps(_mm_loadu_ps(buf1), _mm_loadu_ps(coeffs1)),
-                _mm_mul_ps(_mm_loadu_ps(buf2), _mm_loadu_ps(coeffs2)))));
-            _mm_storeu_ps(outp + 4, _mm_add_ps(_mm_loadu_ps(outp + 4), _mm_add_ps(
-                _mm_mul_ps(_mm_loadu_ps(buf1 + 4), _mm_loadu_ps(coeffs1 + 4)),
-                _mm_mul_ps(_mm_loadu_ps(buf2 + 4), _mm_loadu_ps(coeffs2 + 4)))));
-
-            _mm_storeu_ps(outp + 8, _mm_add_ps(_mm_loadu_ps(outp + 8), _mm_add_ps(
-                _mm_mul_ps(_mm_reverse(_mm_loadu_ps(buf1 + 4)), _mm_loadu_ps(coeffs1 + 8)),
-                _mm_mul_ps(_mm_reverse(_mm_loadu_ps(buf2 + 4)), _mm_loadu_ps(coeffs2 + 8)))));
-            _mm_storeu_ps(outp + 12, _mm_add_ps(_mm_loadu_ps(outp + 12), _mm_add_ps(
-                _mm_mul_ps(_mm_reverse(_mm_loadu_ps(buf1)), _mm_loadu_ps(coeffs1 + 12)),
-                _mm_mul_ps(_mm_reverse(_mm_loadu_ps(buf2)), _mm_loadu_ps(coeffs2 + 12)))));
+            __m128 b1lo = _mm_loadu_ps(buf1), b1hi = _mm_loadu_ps(buf1 + 4);
+            __m128 b2lo = _mm_loadu_ps(buf2), b2hi = _mm_loadu_ps(buf2 + 4);
+            acc0 = _mm_add_ps(acc0, _mm_add_ps(
+                _mm_mul_ps(b1lo, _mm_loadu_ps(coeffs1)),
+                _mm_mul_ps(b2lo, _mm_loadu_ps(coeffs2))));
+            acc1 = _mm_add_ps(acc1, _mm_add_ps(
+                _mm_mul_ps(b1hi, _mm_loadu_ps(coeffs1 + 4)),
+                _mm_mul_ps(b2hi, _mm_loadu_ps(coeffs2 + 4))));
+            acc2 = _mm_add_ps(acc2, _mm_add_ps(
+                _mm_mul_ps(_mm_reverse(b1hi), _mm_loadu_ps(coeffs1 + 8)),
+                _mm_mul_ps(_mm_reverse(b2hi), _mm_loadu_ps(coeffs2 + 8))));
+            acc3 = _mm_add_ps(acc3, _mm_add_ps(
+                _mm_mul_ps(_mm_reverse(b1lo), _mm_loadu_ps(coeffs1 + 12)),
+                _mm_mul_ps(_mm_reverse(b2lo), _mm_loadu_ps(coeffs2 + 12))));
+
+            pos_now  = mod23_lut[pos_next + 2]; // pos_now  = (pos_now  + 2) % 23;
+            pos_next = mod23_lut[pos_now + 2];  // pos_next = (pos_next + 2) % 23;
+        }
+        _mm_storeu_ps(outp, acc0);
+        _mm_storeu_ps(outp + 4, acc1);
+        _mm_storeu_ps(outp + 8, acc2);
+        _mm_storeu_ps(outp + 12, acc3);
 #elif PPSSPP_ARCH(ARM_NEON)
-            auto vreverseq_f32 = [](float32x4_t x) -> float32x4_t {
-                float32x4_t rev = vrev64q_f32(x);
-                float32x2_t high = vget_high_f32(rev); //{4,3}
-                float32x2_t low = vget_low_f32(rev); //{1,2}
-                return vcombine_f32(high, low); //{4,3,2,1}
-            };
-            vst1q_f32(outp, vaddq_f32(vld1q_f32(outp), vaddq_f32(
-                vmulq_f32(vld1q_f32(buf1), vld1q_f32(coeffs1)),
-                vmulq_f32(vld1q_f32(buf2), vld1q_f32(coeffs2)))));
-            vst1q_f32(outp + 4, vaddq_f32(vld1q_f32(outp + 4), vaddq_f32(
-                vmulq_f32(vld1q_f32(buf1 + 4), vld1q_f32(coeffs1 + 4)),
-                vmulq_f32(vld1q_f32(buf2 + 4), vld1q_f32(coeffs2 + 4)))));
-
-            vst1q_f32(outp + 8, vaddq_f32(vld1q_f32(outp + 8), vaddq_f32(
-                vmulq_f32(vreverseq_f32(vld1q_f32(buf1 + 4)), vld1q_f32(coeffs1 + 8)),
-                vmulq_f32(vreverseq_f32(vld1q_f32(buf2 + 4)), vld1q_f32(coeffs2 + 8)))));
-            vst1q_f32(outp + 12, vaddq_f32(vld1q_f32(outp + 12), vaddq_f32(
-                vmulq_f32(vreverseq_f32(vld1q_f32(buf1)), vld1q_f32(coeffs1 + 12)),
-                vmulq_f32(vreverseq_f32(vld1q_f32(buf2)), vld1q_f32(coeffs2 + 12)))));
+        auto vreverseq_f32 = [](float32x4_t x) -> float32x4_t {
+            float32x4_t rev = vrev64q_f32(x);
+            float32x2_t high = vget_high_f32(rev); //{4,3}
+            float32x2_t low = vget_low_f32(rev); //{1,2}
+            return vcombine_f32(high, low); //{4,3,2,1}
+        };
+        // Accumulate all the taps in registers, in the same order as the plain loop.
+        float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+        float32x4_t acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+        for (t = 0; t < ATRAC3P_PQF_FIR_LEN; t++) {
+            const float *buf1 = hist->buf1[pos_now];
+            const float *buf2 = hist->buf2[pos_next];
+            const float *coeffs1 = ipqf_coeffs1[t];
+            const float *coeffs2 = ipqf_coeffs2[t];
+
+            float32x4_t b1lo = vld1q_f32(buf1), b1hi = vld1q_f32(buf1 + 4);
+            float32x4_t b2lo = vld1q_f32(buf2), b2hi = vld1q_f32(buf2 + 4);
+            acc0 = vaddq_f32(acc0, vaddq_f32(
+                vmulq_f32(b1lo, vld1q_f32(coeffs1)),
+                vmulq_f32(b2lo, vld1q_f32(coeffs2))));
+            acc1 = vaddq_f32(acc1, vaddq_f32(
+                vmulq_f32(b1hi, vld1q_f32(coeffs1 + 4)),
+                vmulq_f32(b2hi, vld1q_f32(coeffs2 + 4))));
+            acc2 = vaddq_f32(acc2, vaddq_f32(
+                vmulq_f32(vreverseq_f32(b1hi), vld1q_f32(coeffs1 + 8)),
+                vmulq_f32(vreverseq_f32(b2hi), vld1q_f32(coeffs2 + 8))));
+            acc3 = vaddq_f32(acc3, vaddq_f32(
+                vmulq_f32(vreverseq_f32(b1lo), vld1q_f32(coeffs1 + 12)),
+                vmulq_f32(vreverseq_f32(b2lo), vld1q_f32(coeffs2 + 12))));
+
+            pos_now  = mod23_lut[pos_next + 2]; // pos_now  = (pos_now  + 2) % 23;
+            pos_next = mod23_lut[pos_now + 2];  // pos_next = (pos_next + 2) % 23;
+        }
+        vst1q_f32(outp, acc0);
+        vst1q_f32(outp + 4, acc1);
+        vst1q_f32(outp + 8, acc2);
+        vst1q_f32(outp + 12, acc3);
 #else
+        memset(outp, 0, 16 * sizeof(*outp));
+        for (t = 0; t < ATRAC3P_PQF_FIR_LEN; t++) {
+            const float *buf1 = hist->buf1[pos_now];
+            const float *buf2 = hist->buf2[pos_next];
+            const float *coeffs1 = ipqf_coeffs1[t];
+            const float *coeffs2 = ipqf_coeffs2[t];
+
             for (i = 0; i < 8; i++) {
                 outp[i] += buf1[i] * coeffs1[i] + buf2[i] * coeffs2[i];
             }
             for (i = 0; i < 8; i++) {
                 outp[i + 8] += buf1[7 - i] * coeffs1[i + 8] + buf2[7 - i] * coeffs2[i + 8];
             }
-#endif
 
             pos_now  = mod23_lut[pos_next + 2]; // pos_now  = (pos_now  + 2) % 23;
             pos_next = mod23_lut[pos_now + 2];  // pos_next = (pos_next + 2) % 23;
         }
+#endif
 
         hist->pos = mod23_lut[hist->pos]; // hist->pos = (hist->pos - 1) % 23;
     }
@@ -18,10 +18,34 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include "ppsspp_config.h"
 #include "compat.h"
 
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+#include <emmintrin.h>
+#elif PPSSPP_ARCH(ARM_NEON)
+#if defined(_MSC_VER) && PPSSPP_ARCH(ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+// The SIMD paths below do the exact same operations per element as the plain loops,
+// so the output doesn't change.
+
 inline void vector_fmul(float * av_restrict dst, const float * av_restrict src, int len) {
-    for (int i = 0; i < len; i++)
+    int i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    for (; i + 4 <= len; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 4 <= len; i += 4)
+        vst1q_f32(dst + i, vmulq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+#endif
+    for (; i < len; i++)
         dst[i] = dst[i] * src[i];
 }
 
@@ -30,7 +54,16 @@ inline void vector_fmul(float * av_restrict dst, const float * av_restrict src,
 * destination vectors must overlap exactly or not at all.
 */
 inline void vector_fmul_scalar(float *dst, float mul, int len) {
-    for (int i = 0; i < len; i++)
+    int i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    const __m128 m = _mm_set1_ps(mul);
+    for (; i + 4 <= len; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), m));
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 4 <= len; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), mul));
+#endif
+    for (; i < len; i++)
         dst[i] *= mul;
 }
 
@@ -47,7 +80,61 @@ inline void vector_fmul_scalar(float *dst, float mul, int len) {
 *             constraints: multiple of 16
 */
 inline void vector_fmul_reverse(float * av_restrict dst, const float * av_restrict src, int len) {
-    src += len - 1;
-    for (int i = 0; i < len; i++)
-        dst[i] *= src[-i];
+    int i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    for (; i + 4 <= len; i += 4) {
+        __m128 s = _mm_loadu_ps(src + len - 4 - i);
+        s = _mm_shuffle_ps(s, s, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), s));
+    }
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 4 <= len; i += 4) {
+        float32x4_t s = vrev64q_f32(vld1q_f32(src + len - 4 - i));
+        s = vcombine_f32(vget_high_f32(s), vget_low_f32(s));
+        vst1q_f32(dst + i, vmulq_f32(vld1q_f32(dst + i), s));
+    }
+#endif
+    for (; i < len; i++)
+        dst[i] *= src[len - 1 - i];
+}
+
+/**
+* Convert integer samples (quantized spectral lines) to float and multiply
+* them by a scalar, dst[i] = src[i] * mul.
+*/
+inline void int32_to_float_fmul_scalar(float *dst, const int *src, float mul, int len) {
+    int i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    const __m128 m = _mm_set1_ps(mul);
+    for (; i + 4 <= len; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(src + i))), m));
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 4 <= len; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), mul));
+#endif
+    for (; i < len; i++)
+        dst[i] = src[i] * mul;
+}
+
+inline void int16_to_float_fmul_scalar(float *dst, const int16_t *src, float mul, int len) {
+    int i = 0;
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64)
+    const __m128 m = _mm_set1_ps(mul);
+    for (; i + 8 <= len; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        // Sign extend by unpacking into the high halves and shifting back down.
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), m));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), m));
+    }
+#elif PPSSPP_ARCH(ARM_NEON)
+    for (; i + 8 <= len; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), mul));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), mul));
+    }
+#endif
+    for (; i < len; i++)
+        dst[i] = src[i] * mul;
 }
@@ -0,0 +1,153 @@
+// Records a boot's worth of reads through RamCachingFileLoader, and checks that the saved profile
+// merges them into ranges in the order they were read, leaves out the cache's own read-ahead, and
+// that on the next "boot" read-ahead fetches those ranges first. The benchmark times the bookkeeping
+// for a game reading sector by sector.
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "Common/File/FileUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/FileLoaders/AccessProfile.h"
+#include "Core/FileLoaders/RamCachingFileLoader.h"
+
+#include "UnitTest.h"
+
+static const int PROFILE_TEST_BLOCKS = 64;
+
+// Keeps track of which blocks were asked for, in order.
+class RecordingFileLoader : public FileLoader {
+public:
+	RecordingFileLoader(const Path &path) : path_(path) {}
+
+	bool Exists() override { return true; }
+	bool IsDirectory() override { return false; }
+	s64 FileSize() override { return (s64)PROFILE_TEST_BLOCKS << AccessProfile::BLOCK_SHIFT; }
+	Path GetPath() const override { return path_; }
+
+	size_t ReadAt(s64 absolutePos, size_t bytes, size_t count, void *data, Flags flags = Flags::NONE) override {
+		std::lock_guard<std::mutex> guard(lock_);
+		reads_.push_back((int)(absolutePos >> AccessProfile::BLOCK_SHIFT));
+		size_t size = bytes * count;
+		if (absolutePos + (s64)size > FileSize())
+			size = (size_t)(FileSize() - absolutePos);
+		memset(data, 0x11, size);
+		return size / bytes;
+	}
+
+	std::vector<int> Reads() {
+		std::lock_guard<std::mutex> guard(lock_);
+		return reads_;
+	}
+
+private:
+	Path path_;
+	std::mutex lock_;
+	std::vector<int> reads_;
+};
+
+static void ReadBlock(FileLoader *loader, int block, size_t bytes = 2048) {
+	std::vector<u8> buffer(bytes);
+	loader->ReadAt((s64)block << AccessProfile::BLOCK_SHIFT, bytes, &buffer[0]);
+}
+
+static bool SameEntries(const std::vector<AccessProfile::Entry> &entries, std::vector<std::pair<u32, u32>> expected) {
+	bool same = entries.size() == expected.size();
+	for (size_t i = 0; same && i < entries.size(); ++i)
+		same = entries[i].block == expected[i].first && entries[i].count == expected[i].second;
+	if (!same) {
+		printf("Got %d ranges:", (int)entries.size());
+		for (const AccessProfile::Entry &entry : entries)
+			printf(" %d+%d", entry.block, entry.count);
+		printf("\n");
+	}
+	return same;
+}
+
+// Read-ahead runs on its own thread, this waits until it's read enough (or it's clearly stuck.)
+static std::vector<int> WaitForReads(RecordingFileLoader *backend, size_t count) {
+	double start = time_now_d();
+	std::vector<int> reads = backend->Reads();
+	while (reads.size() < count && time_now_d() - start < 5.0) {
+		sleep_ms(1, "profile-test");
+		reads = backend->Reads();
+	}
+	return reads;
+}
+
+bool TestAccessProfile() {
+	const Path dir("accessprofile_test");
+	// Left behind by an earlier run that failed.
+	File::DeleteDirRecursively(dir);
+	if (!File::CreateFullPath(dir)) {
+		printf("Couldn't create the test directory\n");
+		return false;
+	}
+	AccessProfile::SetProfileDir(dir);
+	const Path imagePath = dir / "GAME.ISO";
+
+	// First boot: nothing to go on yet.
+	{
+		RecordingFileLoader *backend = new RecordingFileLoader(imagePath);
+		RamCachingFileLoader loader(backend);
+		ReadBlock(&loader, 40);
+		ReadBlock(&loader, 3, 3 * AccessProfile::BLOCK_SIZE);
+		ReadBlock(&loader, 6);
+		ReadBlock(&loader, 40);
+		ReadBlock(&loader, 20);
+		// A read that ends past the last block only counts what's there.
+		std::vector<u8> tail(1000);
+		loader.ReadAt(((s64)PROFILE_TEST_BLOCKS << AccessProfile::BLOCK_SHIFT) - 100, 1, tail.size(), &tail[0]);
+		EXPECT_EQ_INT(backend->Reads().front(), 40);
+		WaitForReads(backend, 8);
+	}
+
+	// The loader was the last user, so it was saved when it went away.
+	std::shared_ptr<AccessProfile> profile = AccessProfile::Get(imagePath, (s64)PROFILE_TEST_BLOCKS << AccessProfile::BLOCK_SHIFT);
+	EXPECT_TRUE(SameEntries(profile->Previous(), { { 40, 1 }, { 3, 4 }, { 20, 1 }, { PROFILE_TEST_BLOCKS - 1, 1 } }));
+	profile.reset();
+
+	// Second boot: after the first read, read-ahead follows the profile.
+	{
+		RecordingFileLoader *backend = new RecordingFileLoader(imagePath);
+		RamCachingFileLoader loader(backend);
+		ReadBlock(&loader, 40);
+		std::vector<int> reads = WaitForReads(backend, 4);
+		EXPECT_TRUE(reads.size() >= 4);
+		EXPECT_EQ_INT(reads[0], 40);
+		EXPECT_EQ_INT(reads[1], 3);
+		EXPECT_EQ_INT(reads[2], 20);
+		EXPECT_EQ_INT(reads[3], PROFILE_TEST_BLOCKS - 1);
+	}
+
+	// A file of another size (another dump of the game) doesn't use it.
+	profile = AccessProfile::Get(imagePath, (s64)(PROFILE_TEST_BLOCKS + 1) << AccessProfile::BLOCK_SHIFT);
+	EXPECT_TRUE(profile->Previous().empty());
+	profile.reset();
+
+	File::DeleteDirRecursively(dir);
+	return true;
+}
+
+bool TestAccessProfileBenchmark() {
+	const Path dir("accessprofile_benchmark");
+	File::DeleteDirRecursively(dir);
+	if (!File::CreateFullPath(dir)) {
+		printf("Couldn't create the test directory\n");
+		return false;
+	}
+	AccessProfile::SetProfileDir(dir);
+
+	std::shared_ptr<AccessProfile> profile = AccessProfile::Get(dir / "BIG.ISO", (s64)1800 << 20);
+	const int sectors = 1000000;
+	double start = time_now_d();
+	for (int i = 0; i < sectors; ++i)
+		profile->RecordRead((s64)i * 2048, 2048);
+	printf("AccessProfile: %0.1f ns per recorded sector read\n", (time_now_d() - start) * 1e9 / sectors);
+	profile.reset();
+
+	File::DeleteDirRecursively(dir);
+	return true;
+}
@@ -0,0 +1,236 @@
+// Logs clients into the built-in ad hoc matchmaking server on the local box, each with its own
+// loopback IP (the server refuses duplicate IPs), and checks that scans and group joins are answered.
+// The benchmark simulates a LAN party worth of clients and reports login/scan/join latencies.
+
+#include "ppsspp_config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if PPSSPP_PLATFORM(LINUX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#include "Common/TimeUtil.h"
+#include "Core/HLE/proAdhocServer.h"
+
+#include "UnitTest.h"
+
+#if PPSSPP_PLATFORM(LINUX)
+
+static const int LOAD_TEST_CLIENTS = 12;
+static const int LOAD_BENCHMARK_CLIENTS = 256;
+static const int LOAD_TEST_GROUP_SIZE = 4;
+
+static int PacketSize(uint8_t opcode) {
+	switch (opcode) {
+	case OPCODE_CONNECT: return sizeof(SceNetAdhocctlConnectPacketS2C);
+	case OPCODE_DISCONNECT: return sizeof(SceNetAdhocctlDisconnectPacketS2C);
+	case OPCODE_SCAN: return sizeof(SceNetAdhocctlScanPacketS2C);
+	case OPCODE_SCAN_COMPLETE: return 1;
+	case OPCODE_CONNECT_BSSID: return sizeof(SceNetAdhocctlConnectBSSIDPacketS2C);
+	case OPCODE_CHAT: return sizeof(SceNetAdhocctlChatPacketS2C);
+	default: return -1;
+	}
+}
+
+static bool RecvAll(int fd, uint8_t *buf, int size) {
+	while (size > 0) {
+		int r = (int)recv(fd, (char *)buf, size, 0);
+		if (r <= 0)
+			return false;
+		buf += r;
+		size -= r;
+	}
+	return true;
+}
+
+// Reads server packets until one with the wanted opcode arrives. Returns the number of
+// other packets with the opcode countOpcode seen on the way, or -1 on error/timeout.
+static int WaitForOpcode(int fd, uint8_t wanted, uint8_t countOpcode) {
+	uint8_t buf[1024];
+	int counted = 0;
+	while (true) {
+		if (!RecvAll(fd, buf, 1))
+			return -1;
+		int size = PacketSize(buf[0]);
+		if (size < 0 || !RecvAll(fd, buf + 1, size - 1))
+			return -1;
+		if (buf[0] == wanted)
+			return counted;
+		if (buf[0] == countOpcode)
+			counted++;
+	}
+}
+
+// Lets the system pick a port nobody is listening on.
+static uint16_t FindFreePort() {
+	int fd = (int)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0)
+		return 0;
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t len = sizeof(addr);
+	uint16_t port = 0;
+	if (bind(fd, (sockaddr *)&addr, sizeof(addr)) == 0 && getsockname(fd, (sockaddr *)&addr, &len) == 0)
+		port = ntohs(addr.sin_port);
+	close(fd);
+	return port;
+}
+
+static int ConnectClient(uint16_t port, int index) {
+	int fd = (int)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0)
+		return -1;
+
+	int on = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char *)&on, sizeof(on));
+	timeval tv{ 5, 0 };
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, (char *)&tv, sizeof(tv));
+
+	// All of 127.0.0.0/8 is loopback on Linux, so every client can get a unique IP.
+	sockaddr_in local{};
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(0x7F010000 | (index + 1));
+	sockaddr_in server{};
+	server.sin_family = AF_INET;
+	server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	server.sin_port = htons(port);
+	if (bind(fd, (sockaddr *)&local, sizeof(local)) != 0 || connect(fd, (sockaddr *)&server, sizeof(server)) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	SceNetAdhocctlLoginPacketC2S login{};
+	login.base.opcode = OPCODE_LOGIN;
+	login.mac.data[0] = 0x02;
+	login.mac.data[4] = (uint8_t)(index >> 8);
+	login.mac.data[5] = (uint8_t)index;
+	snprintf((char *)login.name.data, sizeof(login.name.data), "load%d", index);
+	memcpy(login.game.data, "ULUS10000", PRODUCT_CODE_LENGTH);
+	if (send(fd, (const char *)&login, sizeof(login), 0) != (ssize_t)sizeof(login)) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+struct LatencyStats {
+	double total = 0.0;
+	double worst = 0.0;
+	int count = 0;
+
+	void Add(double t) {
+		total += t;
+		worst = std::max(worst, t);
+		count++;
+	}
+	void Print(const char *what) const {
+		printf("%s: %d requests, avg %0.3f ms, max %0.3f ms\n", what, count, count ? total * 1000.0 / count : 0.0, worst * 1000.0);
+	}
+};
+
+static bool RunClients(int clientCount, bool printStats) {
+	const uint16_t port = FindFreePort();
+	if (port == 0) {
+		printf("Couldn't find a free port\n");
+		return false;
+	}
+
+	__AdhocServerInit();
+	adhocServerWriteStatus = false;
+	std::thread server(&proAdhocServerThread, port);
+
+	double start = time_now_d();
+	while (!adhocServerRunning && time_now_d() - start < 2.0)
+		sleep_ms(1, "adhoc-test-start");
+	if (!adhocServerRunning) {
+		server.join();
+		adhocServerWriteStatus = true;
+		printf("Failed to start server on port %d\n", port);
+		return false;
+	}
+
+	std::vector<int> clients;
+	bool ok = true;
+	double loginStart = time_now_d();
+	for (int i = 0; i < clientCount && ok; i++) {
+		int fd = ConnectClient(port, i);
+		ok = fd >= 0;
+		if (ok)
+			clients.push_back(fd);
+	}
+	if (printStats)
+		printf("Connected and logged in %d clients in %0.3f ms\n", (int)clients.size(), (time_now_d() - loginStart) * 1000.0);
+
+	// Every client scans once before joining. Each round trip used to cost up to a 10ms poll tick.
+	LatencyStats scans;
+	for (size_t i = 0; i < clients.size() && ok; i++) {
+		double t = time_now_d();
+		uint8_t opcode = OPCODE_SCAN;
+		ok = send(clients[i], (const char *)&opcode, 1, 0) == 1 && WaitForOpcode(clients[i], OPCODE_SCAN_COMPLETE, OPCODE_SCAN) >= 0;
+		scans.Add(time_now_d() - t);
+	}
+
+	// Join groups of LOAD_TEST_GROUP_SIZE. The joining client is told about every peer already in the group.
+	LatencyStats joins;
+	for (size_t i = 0; i < clients.size() && ok; i++) {
+		SceNetAdhocctlConnectPacketC2S connect{};
+		connect.base.opcode = OPCODE_CONNECT;
+		snprintf((char *)connect.group.data, sizeof(connect.group.data), "G%d", (int)(i / LOAD_TEST_GROUP_SIZE));
+
+		double t = time_now_d();
+		ok = send(clients[i], (const char *)&connect, sizeof(connect), 0) == (ssize_t)sizeof(connect);
+		int peers = ok ? WaitForOpcode(clients[i], OPCODE_CONNECT_BSSID, OPCODE_CONNECT) : -1;
+		joins.Add(time_now_d() - t);
+		if (peers != (int)(i % LOAD_TEST_GROUP_SIZE)) {
+			printf("Client %d saw %d peers joining its group\n", (int)i, peers);
+			ok = false;
+		}
+	}
+
+	if (printStats) {
+		scans.Print("Scan");
+		joins.Print("Join");
+	}
+
+	for (int fd : clients)
+		close(fd);
+	adhocServerRunning = false;
+	server.join();
+	adhocServerWriteStatus = true;
+
+	EXPECT_TRUE(ok);
+	EXPECT_EQ_INT((int)clients.size(), clientCount);
+	return true;
+}
+
+bool TestAdhocServer() {
+	return RunClients(LOAD_TEST_CLIENTS, false);
+}
+
+bool TestAdhocServerBenchmark() {
+	return RunClients(LOAD_BENCHMARK_CLIENTS, true);
+}
+
+#else
+
+bool TestAdhocServer() {
+	// Needs a unique loopback IP per simulated client.
+	printf("AdhocServer test is only supported on Linux.\n");
+	return true;
+}
+
+bool TestAdhocServerBenchmark() {
+	return true;
+}
+
+#endif
@@ -0,0 +1,215 @@
+// Checks batch decoding in the standalone Atrac3/Atrac3+ decoder against frame by frame decoding.
+// The benchmark times both. There are no sample files in the tree, so the Atrac3 frames are synthesized with
+// valid headers and random spectra, and the Atrac3+ frames are random data that happens to decode.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/HW/Atrac3Standalone.h"
+#include "Core/HW/SimpleAudioDec.h"
+#include "ext/at3_standalone/at3_decoders.h"
+
+#include "UnitTest.h"
+
+static const int AT3_TEST_BLOCK_ALIGN = 384;
+static const int AT3PLUS_TEST_BLOCK_ALIGN = 0x230;
+static const int ATRAC_TEST_FRAMES = 400;
+// The bit readers may look a little past the end of a frame.
+static const int ATRAC_TEST_PADDING = 4096;
+
+static GMRng atracRng;
+
+struct AtracBitWriter {
+	uint8_t *p;
+	int pos;
+
+	void Put(uint32_t value, int bits) {
+		for (int i = bits - 1; i >= 0; --i) {
+			uint8_t mask = 0x80 >> (pos & 7);
+			if ((value >> i) & 1)
+				p[pos >> 3] |= mask;
+			else
+				p[pos >> 3] &= ~mask;
+			pos++;
+		}
+	}
+};
+
+// A stereo Atrac3 frame: gain control points, no tonal components, and random CLC coded spectra.
+static void MakeAt3Frame(uint8_t *frame, int blockAlign) {
+	for (int i = 0; i < blockAlign; ++i)
+		frame[i] = (uint8_t)atracRng.R32();
+	for (int ch = 0; ch < 2; ++ch) {
+		AtracBitWriter w{ frame + ch * blockAlign / 2, 0 };
+		w.Put(0x28, 6);
+		w.Put(3, 2);
+		for (int band = 0; band < 4; ++band) {
+			int points = atracRng.R32() % 3;
+			w.Put(points, 3);
+			int loc = 0;
+			for (int j = 0; j < points; ++j) {
+				loc += 1 + atracRng.R32() % 8;
+				w.Put(atracRng.R32() % 16, 4);
+				w.Put(loc, 5);
+			}
+		}
+		// No tonal components.
+		w.Put(0, 5);
+		int subbands = 20 + atracRng.R32() % 12;
+		w.Put(subbands, 5);
+		// CLC.
+		w.Put(1, 1);
+		for (int i = 0; i <= subbands; ++i)
+			w.Put(1 + atracRng.R32() % 7, 3);
+		for (int i = 0; i <= subbands; ++i)
+			w.Put(10 + atracRng.R32() % 20, 6);
+	}
+}
+
+static std::vector<uint8_t> MakeAt3Stream() {
+	atracRng.Init(1);
+	std::vector<uint8_t> data(AT3_TEST_BLOCK_ALIGN * ATRAC_TEST_FRAMES + ATRAC_TEST_PADDING);
+	for (int i = 0; i < ATRAC_TEST_FRAMES; ++i)
+		MakeAt3Frame(&data[i * AT3_TEST_BLOCK_ALIGN], AT3_TEST_BLOCK_ALIGN);
+	return data;
+}
+
+static std::vector<uint8_t> MakeAt3PlusStream() {
+	// Random frames rarely decode, so find a few and repeat them.
+	const int uniqueFrames = 40;
+	atracRng.Init(7);
+	std::vector<uint8_t> data(AT3PLUS_TEST_BLOCK_ALIGN * ATRAC_TEST_FRAMES + ATRAC_TEST_PADDING);
+	std::vector<float> left(2048), right(2048);
+	float *out[2] = { &left[0], &right[0] };
+	int blockAlign = AT3PLUS_TEST_BLOCK_ALIGN;
+	ATRAC3PContext *ctx = atrac3p_alloc(2, &blockAlign);
+	int frames = 0;
+	int samples;
+	while (frames < uniqueFrames) {
+		uint8_t *frame = &data[frames * AT3PLUS_TEST_BLOCK_ALIGN];
+		do {
+			for (int j = 0; j < AT3PLUS_TEST_BLOCK_ALIGN; ++j)
+				frame[j] = (uint8_t)atracRng.R32();
+			frame[0] = (frame[0] & 0x1F) | 0x20;
+		} while (atrac3p_decode_frame(ctx, out, &samples, frame, AT3PLUS_TEST_BLOCK_ALIGN) <= 0);
+		frames++;
+
+		if (frames == uniqueFrames) {
+			// Whether a frame decodes depends a bit on the ones before it, and the rejected ones
+			// were decoded too. Replay the whole stream from scratch and redo from the first failure.
+			for (int i = uniqueFrames; i < ATRAC_TEST_FRAMES; ++i)
+				memcpy(&data[i * AT3PLUS_TEST_BLOCK_ALIGN], &data[(i % uniqueFrames) * AT3PLUS_TEST_BLOCK_ALIGN], AT3PLUS_TEST_BLOCK_ALIGN);
+			atrac3p_free(ctx);
+			ctx = atrac3p_alloc(2, &blockAlign);
+			for (int i = 0; i < ATRAC_TEST_FRAMES; ++i) {
+				if (atrac3p_decode_frame(ctx, out, &samples, &data[i * AT3PLUS_TEST_BLOCK_ALIGN], AT3PLUS_TEST_BLOCK_ALIGN) <= 0) {
+					frames = std::min(i, uniqueFrames - 1);
+					break;
+				}
+			}
+		}
+	}
+	atrac3p_free(ctx);
+	return data;
+}
+
+static AudioDecoder *CreateTestDecoder(bool plus) {
+	if (plus)
+		return CreateAtrac3PlusAudio(2, AT3PLUS_TEST_BLOCK_ALIGN);
+	// Stereo, 1024 samples per frame, no joint stereo, frame factor 1.
+	static const uint8_t extraData[14] = { 1, 0, 0, 0x10, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0 };
+	return CreateAtrac3Audio(2, AT3_TEST_BLOCK_ALIGN, extraData, sizeof(extraData));
+}
+
+// Decodes the stream once frame by frame and once in batches of various sizes, which must match.
+static bool CompareBatchDecode(bool plus, const std::vector<uint8_t> &data) {
+	const char *name = plus ? "Atrac3+" : "Atrac3";
+	const int blockAlign = plus ? AT3PLUS_TEST_BLOCK_ALIGN : AT3_TEST_BLOCK_ALIGN;
+	const int frameSamples = plus ? 2048 : 1024;
+	std::vector<int16_t> single(ATRAC_TEST_FRAMES * frameSamples * 2);
+	std::vector<int16_t> batched(single.size());
+
+	AudioDecoder *decoder = CreateTestDecoder(plus);
+	EXPECT_TRUE(decoder->IsOK());
+	int totalSamples = 0;
+	for (int i = 0; i < ATRAC_TEST_FRAMES; ++i) {
+		int samples = 0;
+		EXPECT_TRUE(decoder->Decode(&data[i * blockAlign], blockAlign, nullptr, 2, &single[totalSamples * 2], &samples));
+		totalSamples += samples;
+	}
+	delete decoder;
+	EXPECT_EQ_INT(totalSamples, ATRAC_TEST_FRAMES * frameSamples);
+
+	decoder = CreateTestDecoder(plus);
+	int batchedSamples = 0;
+	int frames = 0;
+	for (int batch = 1; frames < ATRAC_TEST_FRAMES; batch = batch % 13 + 1) {
+		int count = std::min(batch, ATRAC_TEST_FRAMES - frames);
+		int samples = 0;
+		EXPECT_EQ_INT(decoder->DecodeFrames(&data[frames * blockAlign], blockAlign, count, 2, &batched[batchedSamples * 2], &samples), count);
+		frames += count;
+		batchedSamples += samples;
+	}
+	delete decoder;
+	EXPECT_EQ_INT(batchedSamples, totalSamples);
+
+	if (memcmp(&single[0], &batched[0], single.size() * sizeof(int16_t)) != 0) {
+		printf("%s: batched output differs\n", name);
+		return false;
+	}
+
+	// Mono output and priming without output have to leave the decoder in the same state.
+	std::vector<int16_t> mono(frameSamples * 2);
+	decoder = CreateTestDecoder(plus);
+	EXPECT_EQ_INT(decoder->DecodeFrames(&data[0], blockAlign, 10, 2, nullptr, nullptr), 10);
+	int samples = 0;
+	EXPECT_EQ_INT(decoder->DecodeFrames(&data[10 * blockAlign], blockAlign, 1, 1, &mono[0], &samples), 1);
+	delete decoder;
+	EXPECT_EQ_INT(samples, frameSamples);
+	for (int i = 0; i < frameSamples; ++i)
+		EXPECT_EQ_INT(mono[i], single[(10 * frameSamples + i) * 2]);
+	return true;
+}
+
+bool TestAtrac3Decoder() {
+	std::vector<uint8_t> at3 = MakeAt3Stream();
+	std::vector<uint8_t> at3plus = MakeAt3PlusStream();
+	EXPECT_TRUE(CompareBatchDecode(false, at3));
+	EXPECT_TRUE(CompareBatchDecode(true, at3plus));
+	return true;
+}
+
+static void TimeDecode(bool plus, const std::vector<uint8_t> &data) {
+	const int blockAlign = plus ? AT3PLUS_TEST_BLOCK_ALIGN : AT3_TEST_BLOCK_ALIGN;
+	const int frameSamples = plus ? 2048 : 1024;
+	std::vector<int16_t> output(ATRAC_TEST_FRAMES * frameSamples * 2);
+
+	AudioDecoder *decoder = CreateTestDecoder(plus);
+	int totalSamples = 0;
+	double start = time_now_d();
+	for (int i = 0; i < ATRAC_TEST_FRAMES; ++i) {
+		int samples = 0;
+		decoder->Decode(&data[i * blockAlign], blockAlign, nullptr, 2, &output[totalSamples * 2], &samples);
+		totalSamples += samples;
+	}
+	double singleTime = time_now_d() - start;
+	delete decoder;
+
+	decoder = CreateTestDecoder(plus);
+	start = time_now_d();
+	decoder->DecodeFrames(&data[0], blockAlign, ATRAC_TEST_FRAMES, 2, &output[0], nullptr);
+	double batchTime = time_now_d() - start;
+	delete decoder;
+
+	printf("%s: %d frames, %0.1f us/frame single, %0.1f us/frame batched\n", plus ? "Atrac3+" : "Atrac3", ATRAC_TEST_FRAMES, singleTime * 1e6 / ATRAC_TEST_FRAMES, batchTime * 1e6 / ATRAC_TEST_FRAMES);
+}
+
+bool TestAtrac3DecoderBenchmark() {
+	TimeDecode(false, MakeAt3Stream());
+	TimeDecode(true, MakeAt3PlusStream());
+	return true;
+}
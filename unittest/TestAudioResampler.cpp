@@ -0,0 +1,130 @@
+// Checks the SIMD mixing kernels against plain loops, and compares the output resampler modes.
+// A tone above the output Nyquist should mostly vanish instead of aliasing back down, which is
+// where linear interpolation falls short. The benchmark times each mode.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/Math/math_util.h"
+#include "Common/TimeUtil.h"
+#include "Core/Config.h"
+#include "Core/ConfigValues.h"
+#include "Core/HW/StereoResampler.h"
+#include "Core/Util/AudioFormat.h"
+
+#include "UnitTest.h"
+
+static GMRng audioRng;
+
+static bool TestMixKernels() {
+	std::vector<s16> in(67);
+	std::vector<s32> mix(67), expected(67);
+	std::vector<s16> clamped(67);
+	for (size_t size = 0; size <= in.size(); ++size) {
+		for (size_t i = 0; i < size; ++i)
+			in[i] = (s16)audioRng.R32();
+		in[0] = -32768;
+
+		ConvertS16ToS32(&mix[0], &in[0], size);
+		for (size_t i = 0; i < size; ++i)
+			expected[i] = in[i];
+		EXPECT_TRUE(std::equal(mix.begin(), mix.begin() + size, expected.begin()));
+
+		for (int pass = 0; pass < 3; ++pass) {
+			AddS16ToS32(&mix[0], &in[0], size);
+			for (size_t i = 0; i < size; ++i)
+				expected[i] += in[i];
+		}
+		EXPECT_TRUE(std::equal(mix.begin(), mix.begin() + size, expected.begin()));
+
+		ClampS32ToS16(&clamped[0], &mix[0], size);
+		for (size_t i = 0; i < size; ++i)
+			EXPECT_EQ_INT(clamped[i], clamp_s16(expected[i]));
+	}
+	return true;
+}
+
+// Resamples a stereo tone from 44100 Hz, and returns the RMS of what comes out. elapsed can be null.
+static double ResampleTone(int quality, double toneHz, int outputRate, int frames, double *elapsed) {
+	g_Config.iAudioResampler = quality;
+	StereoResampler resampler;
+
+	const int pushFrames = 735;
+	const int pullFrames = pushFrames * outputRate / 44100;
+	std::vector<s32> input(pushFrames * 2);
+	std::vector<s16> output(pullFrames * 2);
+	double phase = 0.0;
+	double sumSquares = 0.0;
+	int measured = 0;
+	if (elapsed)
+		*elapsed = 0.0;
+	for (int done = 0; done < frames; done += pullFrames) {
+		for (int i = 0; i < pushFrames; ++i) {
+			s32 sample = (s32)(sin(phase) * 16000.0);
+			input[i * 2] = sample;
+			input[i * 2 + 1] = -sample;
+			phase += 2.0 * M_PI * toneHz / 44100.0;
+		}
+		resampler.PushSamples(&input[0], pushFrames);
+
+		double start = elapsed ? time_now_d() : 0.0;
+		resampler.Mix(&output[0], pullFrames, false, outputRate);
+		if (elapsed)
+			*elapsed += time_now_d() - start;
+
+		// Skip the start, while the buffer fills up.
+		if (done >= frames / 4) {
+			for (int i = 0; i < pullFrames * 2; ++i)
+				sumSquares += (double)output[i] * output[i];
+			measured += pullFrames * 2;
+		}
+	}
+	return sqrt(sumSquares / std::max(measured, 1));
+}
+
+bool TestAudioResampler() {
+	if (!TestMixKernels())
+		return false;
+
+	int oldResampler = g_Config.iAudioResampler;
+	int oldVolume = g_Config.iGlobalVolume;
+	g_Config.iGlobalVolume = VOLUME_FULL;
+
+	double passband[3], stopband[3];
+	for (int quality = AUDIO_RESAMPLER_LINEAR; quality <= AUDIO_RESAMPLER_SINC16; ++quality) {
+		// 1 kHz should get through all of them, 16 kHz doesn't fit at 22050 Hz.
+		passband[quality] = ResampleTone(quality, 1000.0, 22050, 22050 * 4, nullptr);
+		stopband[quality] = ResampleTone(quality, 16000.0, 22050, 22050 * 4, nullptr);
+	}
+
+	g_Config.iAudioResampler = oldResampler;
+	g_Config.iGlobalVolume = oldVolume;
+
+	for (int quality = AUDIO_RESAMPLER_LINEAR; quality <= AUDIO_RESAMPLER_SINC16; ++quality) {
+		// A 16000 amplitude sine has an RMS of about 11314.
+		EXPECT_TRUE(passband[quality] > 10000.0 && passband[quality] < 12000.0);
+	}
+	EXPECT_TRUE(stopband[AUDIO_RESAMPLER_SINC8] < stopband[AUDIO_RESAMPLER_LINEAR] / 4.0);
+	EXPECT_TRUE(stopband[AUDIO_RESAMPLER_SINC16] < stopband[AUDIO_RESAMPLER_SINC8]);
+	return true;
+}
+
+bool TestAudioResamplerBenchmark() {
+	int oldResampler = g_Config.iAudioResampler;
+	int oldVolume = g_Config.iGlobalVolume;
+	g_Config.iGlobalVolume = VOLUME_FULL;
+
+	static const char *const names[] = { "linear", "sinc8", "sinc16" };
+	for (int quality = AUDIO_RESAMPLER_LINEAR; quality <= AUDIO_RESAMPLER_SINC16; ++quality) {
+		double elapsed;
+		ResampleTone(quality, 1000.0, 48000, 48000 * 20, &elapsed);
+		printf("Resampler %s: 20 s to 48000 Hz in %0.3f ms\n", names[quality], elapsed * 1000.0);
+	}
+
+	g_Config.iAudioResampler = oldResampler;
+	g_Config.iGlobalVolume = oldVolume;
+	return true;
+}
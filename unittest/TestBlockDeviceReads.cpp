@@ -0,0 +1,193 @@
+// Builds a CSO in memory with runs of compressed and uncompressed frames, and checks that
+// ReadBlocks gives back the original image whichever way it reads, that long uncompressed runs
+// aren't copied on the way, and that CachingFileLoader's reads straight into place still fill
+// the cache. The benchmark times full passes over the CSO.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "zlib.h"
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/FileLoaders/CachingFileLoader.h"
+#include "Core/FileSystems/BlockDevices.h"
+
+#include "UnitTest.h"
+
+static const u32 READS_TEST_BLOCKS = 8192;
+
+static GMRng readsRng;
+
+class MemoryFileLoader : public FileLoader {
+public:
+	MemoryFileLoader(const std::vector<u8> &data) : data_(data) {}
+
+	bool Exists() override { return true; }
+	bool IsDirectory() override { return false; }
+	s64 FileSize() override { return (s64)data_.size(); }
+	Path GetPath() const override { return Path("memory.cso"); }
+
+	size_t ReadAt(s64 absolutePos, size_t bytes, size_t count, void *data, Flags flags = Flags::NONE) override {
+		reads_++;
+		size_t size = bytes * count;
+		if (absolutePos >= (s64)data_.size())
+			return 0;
+		size = std::min(size, data_.size() - (size_t)absolutePos);
+		memcpy(data, &data_[(size_t)absolutePos], size);
+		return size / bytes;
+	}
+
+	std::atomic<int> reads_{};
+
+private:
+	std::vector<u8> data_;
+};
+
+// Runs of sectors that compress well, and runs of noise that are stored as they are.
+static std::vector<u8> MakeImage() {
+	std::vector<u8> image((size_t)READS_TEST_BLOCKS * 2048);
+	readsRng.Init(13);
+	u32 block = 0;
+	bool noise = false;
+	while (block < READS_TEST_BLOCKS) {
+		u32 run = std::min(1 + readsRng.R32() % 80, READS_TEST_BLOCKS - block);
+		for (u32 i = 0; i < run * 2048; i += 4) {
+			u32 v = noise ? readsRng.R32() : (block + i / 2048) * (i % 64 == 0 ? 1 : 0);
+			memcpy(&image[(size_t)block * 2048 + i], &v, 4);
+		}
+		block += run;
+		noise = !noise;
+	}
+	return image;
+}
+
+static void Put32(std::vector<u8> &data, size_t offset, u32 v) {
+	for (int i = 0; i < 4; ++i)
+		data[offset + i] = (u8)(v >> (i * 8));
+}
+
+// Frames of one sector, no alignment.
+static std::vector<u8> MakeCSO(const std::vector<u8> &image) {
+	const u32 frames = (u32)(image.size() / 2048);
+	const size_t headerEnd = 0x18 + (frames + 1) * 4;
+	std::vector<u8> cso(headerEnd);
+	memcpy(&cso[0], "CISO", 4);
+	Put32(cso, 4, 0x18);
+	Put32(cso, 8, (u32)image.size());
+	Put32(cso, 16, 2048);
+	cso[20] = 1;
+
+	std::vector<u8> compressed(4096);
+	for (u32 frame = 0; frame < frames; ++frame) {
+		z_stream z{};
+		deflateInit2(&z, 9, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+		z.next_in = (Bytef *)&image[(size_t)frame * 2048];
+		z.avail_in = 2048;
+		z.next_out = &compressed[0];
+		z.avail_out = (uInt)compressed.size();
+		deflate(&z, Z_FINISH);
+		const size_t size = compressed.size() - z.avail_out;
+		deflateEnd(&z);
+
+		const bool plain = size >= 2048;
+		Put32(cso, 0x18 + frame * 4, (u32)cso.size() | (plain ? 0x80000000 : 0));
+		if (plain)
+			cso.insert(cso.end(), image.begin() + (size_t)frame * 2048, image.begin() + (size_t)(frame + 1) * 2048);
+		else
+			cso.insert(cso.end(), compressed.begin(), compressed.begin() + size);
+	}
+	Put32(cso, 0x18 + frames * 4, (u32)cso.size());
+	return cso;
+}
+
+static bool TestCISOReads(const std::vector<u8> &image) {
+	MemoryFileLoader loader(MakeCSO(image));
+	BlockDevice *device = constructBlockDevice(&loader);
+	EXPECT_EQ_INT((int)device->GetNumBlocks(), (int)READS_TEST_BLOCKS);
+
+	std::vector<u8> buffer((size_t)READS_TEST_BLOCKS * 2048);
+	for (int i = 0; i < 500; ++i) {
+		u32 minBlock = readsRng.R32() % READS_TEST_BLOCKS;
+		int count = 1 + (int)(readsRng.R32() % std::min(READS_TEST_BLOCKS - minBlock, 300U));
+		EXPECT_TRUE(device->ReadBlocks(minBlock, count, &buffer[0]));
+		EXPECT_TRUE(memcmp(&buffer[0], &image[(size_t)minBlock * 2048], (size_t)count * 2048) == 0);
+	}
+	for (u32 block = 0; block < READS_TEST_BLOCKS; block += 7) {
+		EXPECT_TRUE(device->ReadBlock(block, &buffer[0]));
+		EXPECT_TRUE(memcmp(&buffer[0], &image[(size_t)block * 2048], 2048) == 0);
+	}
+
+	// Find a long run of noise, that should come straight from the file.
+	u32 runStart = 0;
+	u32 runLength = 0;
+	for (u32 block = 0, length = 0; block < READS_TEST_BLOCKS; ++block) {
+		u32 v;
+		memcpy(&v, &image[(size_t)block * 2048 + 4], 4);
+		length = v != 0 ? length + 1 : 0;
+		if (length > runLength) {
+			runLength = length;
+			runStart = block + 1 - length;
+		}
+	}
+	EXPECT_TRUE(runLength >= 32);
+	u64 copiedBefore = device->BytesCopied();
+	EXPECT_TRUE(device->ReadBlocks(runStart, runLength, &buffer[0]));
+	EXPECT_TRUE(memcmp(&buffer[0], &image[(size_t)runStart * 2048], (size_t)runLength * 2048) == 0);
+	EXPECT_EQ_INT((int)(device->BytesCopied() - copiedBefore), 0);
+
+	delete device;
+	return true;
+}
+
+static bool TestCachingReads(const std::vector<u8> &image) {
+	MemoryFileLoader *backend = new MemoryFileLoader(image);
+	CachingFileLoader loader(backend);
+	std::vector<u8> buffer(1024 * 1024);
+
+	// Straight into place, then from the cache.
+	for (int pass = 0; pass < 2; ++pass) {
+		const int readsBefore = backend->reads_;
+		EXPECT_EQ_INT((int)loader.ReadAt(65536 * 3, buffer.size(), &buffer[0]), (int)buffer.size());
+		EXPECT_TRUE(memcmp(&buffer[0], &image[65536 * 3], buffer.size()) == 0);
+		if (pass == 1) {
+			EXPECT_EQ_INT(backend->reads_ - readsBefore, 0);
+		}
+	}
+
+	// Odd sizes and offsets, partly cached.
+	for (int i = 0; i < 200; ++i) {
+		size_t pos = readsRng.R32() % (image.size() - buffer.size());
+		size_t size = 1 + readsRng.R32() % buffer.size();
+		EXPECT_EQ_INT((int)loader.ReadAt(pos, size, &buffer[0]), (int)size);
+		EXPECT_TRUE(memcmp(&buffer[0], &image[pos], size) == 0);
+	}
+	return true;
+}
+
+bool TestBlockDeviceReads() {
+	const std::vector<u8> image = MakeImage();
+	if (!TestCISOReads(image))
+		return false;
+	return TestCachingReads(image);
+}
+
+bool TestBlockDeviceReadsBenchmark() {
+	MemoryFileLoader loader(MakeCSO(MakeImage()));
+	BlockDevice *device = constructBlockDevice(&loader);
+	std::vector<u8> buffer((size_t)READS_TEST_BLOCKS * 2048);
+
+	const int passes = 20;
+	double start = time_now_d();
+	for (int i = 0; i < passes; ++i)
+		device->ReadBlocks(0, READS_TEST_BLOCKS, &buffer[0]);
+	const double seconds = time_now_d() - start;
+	const double megabytes = (double)passes * READS_TEST_BLOCKS * 2048 / (1024.0 * 1024.0);
+	printf("CSO ReadBlocks: %0.0f MB/s, %0.3f bytes copied per byte\n", megabytes / seconds, device->BytesCopied() / (megabytes * 1024.0 * 1024.0));
+
+	delete device;
+	return true;
+}
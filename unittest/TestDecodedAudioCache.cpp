@@ -0,0 +1,105 @@
+// Checks the pass logic of the decoded audio cache: a pass is only committed when the next one
+// starts with the same key, playback hands back exactly what was recorded, and the memory budget
+// evicts the least recently used track.
+
+#include <cstdio>
+#include <vector>
+
+#include "Core/Config.h"
+#include "Core/HW/DecodedAudioCache.h"
+
+#include "UnitTest.h"
+
+static DecodedAudioKey TestKey(uint64_t hash) {
+	DecodedAudioKey key{};
+	key.hash = hash;
+	key.codec = 0x1000;
+	key.loopStart = 0;
+	key.loopEnd = 44100;
+	key.channels = 2;
+	return key;
+}
+
+// Records a pass of frames * 1024 stereo samples, starting from value.
+static void RecordPass(DecodedLoopCache &cache, int frames, int16_t value) {
+	std::vector<int16_t> pcm(2048);
+	for (int f = 0; f < frames; ++f) {
+		for (size_t i = 0; i < pcm.size(); ++i)
+			pcm[i] = (int16_t)(value + f * 7 + i);
+		cache.RecordFrame(&pcm[0], 1024, 2, 384, f);
+	}
+}
+
+static bool CheckPlayback(DecodedLoopCache &cache, int frames, int16_t value) {
+	for (int f = 0; f < frames; ++f) {
+		const int16_t *pcm = nullptr;
+		const DecodedAudioFrame *frame = cache.PeekFrame(&pcm);
+		EXPECT_TRUE(frame != nullptr);
+		EXPECT_EQ_INT(frame->samples, 1024);
+		EXPECT_EQ_INT(frame->inputBytes, 384);
+		EXPECT_EQ_INT((int)frame->inputHash, f);
+		for (int i = 0; i < 2048; ++i)
+			EXPECT_EQ_INT(pcm[i], (int16_t)(value + f * 7 + i));
+		cache.NextFrame();
+	}
+	const int16_t *pcm = nullptr;
+	EXPECT_TRUE(cache.PeekFrame(&pcm) == nullptr);
+	return true;
+}
+
+bool TestDecodedAudioCache() {
+	int oldSize = g_Config.iDecodedAudioCacheMB;
+	g_Config.iDecodedAudioCacheMB = 1;
+	DecodedAudioCacheClear();
+
+	bool ok = true;
+	DecodedLoopCache cache;
+	// First pass records, a different key afterwards (data changed) throws it away.
+	ok = ok && !cache.StartPass(TestKey(1)) && cache.Recording();
+	RecordPass(cache, 10, 100);
+	ok = ok && !cache.StartPass(TestKey(2));
+	RecordPass(cache, 10, 200);
+	// Now the same key again, so the pass just recorded is committed and played back.
+	ok = ok && cache.StartPass(TestKey(2)) && cache.Playing();
+	EXPECT_TRUE(ok);
+	EXPECT_TRUE(CheckPlayback(cache, 10, 200));
+	EXPECT_TRUE(cache.StartPass(TestKey(2)));
+	// Leaving a pass early after serving frames means the decoder needs priming, before doesn't.
+	EXPECT_FALSE(cache.Abort());
+	EXPECT_TRUE(cache.StartPass(TestKey(2)));
+	cache.NextFrame();
+	EXPECT_TRUE(cache.Abort());
+	EXPECT_FALSE(cache.Playing());
+
+	// An aborted recording is never committed.
+	EXPECT_FALSE(cache.StartPass(TestKey(1)));
+	RecordPass(cache, 10, 100);
+	cache.Abort();
+	EXPECT_FALSE(cache.StartPass(TestKey(1)));
+
+	// Each of these is about 160 KB, so only a few fit in 1 MB. Key 2 keeps getting used.
+	for (uint64_t hash = 10; hash < 20; ++hash) {
+		cache.StartPass(TestKey(hash));
+		RecordPass(cache, 40, (int16_t)hash);
+		cache.StartPass(TestKey(hash));
+		EXPECT_TRUE(cache.Playing());
+		EXPECT_TRUE(cache.StartPass(TestKey(2)));
+	}
+	EXPECT_TRUE(cache.StartPass(TestKey(19)));
+	EXPECT_TRUE(cache.StartPass(TestKey(2)));
+	EXPECT_FALSE(cache.StartPass(TestKey(10)));
+
+	// Passes too large for the budget are given up on while recording.
+	cache.StartPass(TestKey(30));
+	RecordPass(cache, 600, 0);
+	EXPECT_FALSE(cache.Recording());
+
+	// Turned off, nothing is served.
+	g_Config.iDecodedAudioCacheMB = 0;
+	EXPECT_FALSE(cache.StartPass(TestKey(2)));
+	EXPECT_FALSE(cache.Recording());
+
+	g_Config.iDecodedAudioCacheMB = oldSize;
+	DecodedAudioCacheClear();
+	return true;
+}
@@ -0,0 +1,118 @@
+// Stores game list entries in a GameInfoIndex, checks that they survive a save and load, that a
+// changed file is forgotten, that a damaged index is ignored and that it's kept below its size
+// limit. The benchmark times saving and lookups in a big library.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Common/File/FileUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/Util/GameInfoIndex.h"
+
+#include "UnitTest.h"
+
+static GameInfoIndex::Entry MakeEntry(int n, size_t iconSize = 8000) {
+	GameInfoIndex::Entry entry;
+	entry.size = 1800000000ULL + n;
+	entry.mtime = 1700000000ULL + n * 60;
+	entry.flags = 0x06;
+	entry.fileType = 3;
+	entry.uncompressedSize = entry.size * 2;
+	entry.paramSFO = "PSF" + std::to_string(n);
+	entry.icon = std::string(iconSize, (char)n);
+	return entry;
+}
+
+static std::string GamePath(int n) {
+	return "/mnt/nas/PSP/ISO/Game " + std::to_string(n) + ".cso";
+}
+
+bool TestGameInfoIndex() {
+	const Path indexPath("gameinfo_test.ppgi");
+	File::Delete(indexPath);
+
+	{
+		GameInfoIndex index(indexPath);
+		for (int i = 0; i < 3; ++i)
+			index.Store(GamePath(i), MakeEntry(i));
+		index.Save();
+	}
+
+	GameInfoIndex::Entry entry;
+	{
+		GameInfoIndex index(indexPath);
+		EXPECT_EQ_INT((int)index.Count(), 3);
+		const GameInfoIndex::Entry expected = MakeEntry(1);
+		EXPECT_TRUE(index.Lookup(GamePath(1), expected.size, expected.mtime, &entry));
+		EXPECT_TRUE(entry.paramSFO == expected.paramSFO && entry.icon == expected.icon);
+		EXPECT_TRUE(entry.flags == expected.flags && entry.fileType == expected.fileType && entry.uncompressedSize == expected.uncompressedSize);
+		EXPECT_FALSE(index.Lookup(GamePath(5), expected.size, expected.mtime, &entry));
+
+		// Copied over with a new date: the old entry is no use anymore, even if it's unchanged after all.
+		EXPECT_FALSE(index.Lookup(GamePath(1), expected.size, expected.mtime + 1, &entry));
+		EXPECT_FALSE(index.Lookup(GamePath(1), expected.size, expected.mtime, &entry));
+		EXPECT_EQ_INT((int)index.Count(), 2);
+		index.Save();
+	}
+	{
+		GameInfoIndex index(indexPath);
+		EXPECT_EQ_INT((int)index.Count(), 2);
+	}
+
+	// Cut short, like after a full disk.
+	std::string data;
+	EXPECT_TRUE(File::ReadBinaryFileToString(indexPath, &data));
+	data.resize(data.size() - 100);
+	File::WriteDataToFile(false, data.data(), data.size(), indexPath);
+	{
+		GameInfoIndex index(indexPath);
+		EXPECT_EQ_INT((int)index.Count(), 0);
+	}
+
+	// Gets rid of what doesn't fit.
+	{
+		GameInfoIndex index(indexPath, 64 * 1024);
+		for (int i = 0; i < 60; ++i)
+			index.Store(GamePath(i), MakeEntry(i, 4096));
+		index.Save();
+		EXPECT_TRUE(index.Count() < 60);
+		EXPECT_TRUE(File::GetFileSize(indexPath) <= 64 * 1024);
+	}
+	{
+		GameInfoIndex index(indexPath, 64 * 1024);
+		EXPECT_TRUE(index.Count() > 0 && index.Count() < 60);
+	}
+	File::Delete(indexPath);
+	return true;
+}
+
+bool TestGameInfoIndexBenchmark() {
+	const Path indexPath("gameinfo_benchmark.ppgi");
+	File::Delete(indexPath);
+
+	// A big library, with the icons making up most of it.
+	const int games = 5000;
+	GameInfoIndex::Entry entry;
+	{
+		GameInfoIndex index(indexPath);
+		for (int i = 0; i < games; ++i)
+			index.Store(GamePath(i), MakeEntry(i));
+		double start = time_now_d();
+		index.Save();
+		printf("GameInfoIndex: %d entries saved in %0.1f ms\n", games, (time_now_d() - start) * 1000.0);
+	}
+	{
+		GameInfoIndex index(indexPath);
+		double start = time_now_d();
+		int found = 0;
+		for (int i = 0; i < games; ++i) {
+			const GameInfoIndex::Entry expected = MakeEntry(i, 0);
+			found += index.Lookup(GamePath(i), expected.size, expected.mtime, &entry) ? 1 : 0;
+		}
+		printf("GameInfoIndex: %d entries loaded and looked up in %0.1f ms\n", games, (time_now_d() - start) * 1000.0);
+		EXPECT_EQ_INT(found, games);
+	}
+	File::Delete(indexPath);
+	return true;
+}
@@ -0,0 +1,152 @@
+// Checks HTTPFileLoader reads against a local stand-in for a remote ISO server, and that reads get
+// batched into fewer requests over reused connections. The benchmark delays every response to
+// simulate LAN/WAN round trip latency, which is what used to bound loading speed when each read
+// was a separate blocking range request, and reports the throughput.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "Common/Net/HTTPServer.h"
+#include "Common/Net/Sinks.h"
+#include "Common/StringUtils.h"
+#include "Common/TimeUtil.h"
+#include "Core/FileLoaders/HTTPFileLoader.h"
+
+#include "UnitTest.h"
+
+static const int TEST_FILE_SIZE = 1024 * 1024 + 1234;
+static const int BENCHMARK_FILE_SIZE = 8 * 1024 * 1024 + 1234;
+static const int BENCHMARK_LATENCY_MS = 20;
+static const size_t TEST_READ_SIZE = 64 * 1024;
+
+// What ServeTestFile serves, set before the server starts.
+static int testFileSize;
+static int testLatencyMs;
+
+static u8 TestFileByte(s64 pos) {
+	return (u8)((pos * 7) ^ (pos >> 11));
+}
+
+static void ServeTestFile(const http::ServerRequest &request) {
+	char headers[1024];
+	if (request.Method() == http::RequestHeader::HEAD) {
+		request.WriteHttpResponseHeader("1.1", 200, testFileSize, "application/octet-stream", "Accept-Ranges: bytes\r\n");
+		return;
+	}
+
+	std::string range;
+	long long begin = 0, last = 0;
+	if (!request.GetHeader("range", &range) || sscanf(range.c_str(), "bytes=%lld-%lld", &begin, &last) != 2 || begin > last || last >= testFileSize) {
+		request.WriteHttpResponseHeader("1.0", 416, -1, "text/plain");
+		return;
+	}
+
+	if (testLatencyMs > 0)
+		sleep_ms(testLatencyMs, "http-test-latency");
+
+	snprintf(headers, sizeof(headers), "Content-Range: bytes %lld-%lld/%d\r\n", begin, last, testFileSize);
+	request.WriteHttpResponseHeader("1.1", 206, last - begin + 1, "application/octet-stream", headers);
+	std::vector<char> data;
+	data.reserve((size_t)(last - begin + 1));
+	for (long long pos = begin; pos <= last; ++pos) {
+		data.push_back((char)TestFileByte(pos));
+	}
+	request.Out()->Push(&data[0], data.size());
+}
+
+static bool CheckTestData(s64 pos, const u8 *data, size_t size) {
+	for (size_t i = 0; i < size; ++i) {
+		if (data[i] != TestFileByte(pos + i)) {
+			printf("Mismatch at %lld\n", (long long)(pos + i));
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool RunHTTPFileLoader(int fileSize, int latencyMs, bool printStats) {
+	testFileSize = fileSize;
+	testLatencyMs = latencyMs;
+	http::Server server(new ThreadPoolExecutor(8));
+	server.RegisterHandler("/test.iso", &ServeTestFile);
+	if (!server.Listen(0, net::DNSType::IPV4)) {
+		printf("Failed to start HTTP server\n");
+		return false;
+	}
+
+	std::atomic<bool> running(true);
+	std::thread serverThread([&] {
+		while (running)
+			server.RunSlice(0.1);
+	});
+
+	bool ok = true;
+	int reads = 0;
+	http::ServerStats stats{};
+	size_t tailRead = 0, pastEndRead = 0;
+	bool readAfterCancel = false;
+	std::vector<u8> buf(TEST_READ_SIZE * 4);
+	{
+		HTTPFileLoader loader(Path(StringFromFormat("http://127.0.0.1:%d/test.iso", server.Port())));
+		ok = loader.FileSize() == testFileSize;
+
+		// Sequential, like the caching loaders above us do.
+		double start = time_now_d();
+		for (s64 pos = 0; pos < testFileSize && ok; pos += TEST_READ_SIZE) {
+			size_t expected = (size_t)std::min((s64)TEST_READ_SIZE, testFileSize - pos);
+			ok = loader.ReadAt(pos, TEST_READ_SIZE, &buf[0]) == expected && CheckTestData(pos, &buf[0], expected);
+			reads++;
+		}
+		double elapsed = time_now_d() - start;
+		stats = server.GetStats();
+		if (printStats)
+			printf("Sequential: %d reads in %0.3f s, %0.2f MB/s (%lld requests on %lld connections, one blocking request per read would take >= %0.3f s)\n",
+			reads, elapsed, testFileSize / elapsed / (1024.0 * 1024.0), (long long)stats.totalRequests, (long long)stats.totalConnections, reads * testLatencyMs / 1000.0);
+
+		// Scattered reads of varying size, some cached and some not.
+		start = time_now_d();
+		uint32_t seed = 12345;
+		for (int i = 0; i < 64 && ok; ++i) {
+			seed = seed * 1103515245 + 12345;
+			s64 pos = (seed >> 4) % testFileSize;
+			size_t size = 1 + (seed % buf.size());
+			size_t expected = (size_t)std::min((s64)size, testFileSize - pos);
+			ok = loader.ReadAt(pos, size, &buf[0]) == expected && CheckTestData(pos, &buf[0], expected);
+		}
+		if (printStats)
+			printf("Random: 64 reads in %0.3f s\n", time_now_d() - start);
+
+		// A cancel only stops the reads going on at the time.
+		loader.Cancel();
+		readAfterCancel = loader.ReadAt(TEST_READ_SIZE * 7, TEST_READ_SIZE, &buf[0]) == TEST_READ_SIZE && CheckTestData(TEST_READ_SIZE * 7, &buf[0], TEST_READ_SIZE);
+
+		// Reads spanning the end of the file get cut short.
+		tailRead = loader.ReadAt(testFileSize - 10, 100, &buf[0]);
+		pastEndRead = loader.ReadAt(testFileSize, 100, &buf[0]);
+	}
+
+	running = false;
+	serverThread.join();
+	server.Stop();
+
+	EXPECT_TRUE(ok);
+	EXPECT_TRUE(readAfterCancel);
+	// Reads were batched into larger requests, and connections were reused.
+	EXPECT_TRUE(stats.totalRequests < reads);
+	EXPECT_TRUE(stats.totalConnections < stats.totalRequests);
+	EXPECT_EQ_INT((int)tailRead, 10);
+	EXPECT_EQ_INT((int)pastEndRead, 0);
+	return true;
+}
+
+bool TestHTTPFileLoader() {
+	return RunHTTPFileLoader(TEST_FILE_SIZE, 0, false);
+}
+
+bool TestHTTPFileLoaderBenchmark() {
+	return RunHTTPFileLoader(BENCHMARK_FILE_SIZE, BENCHMARK_LATENCY_MS, true);
+}
@@ -0,0 +1,232 @@
+// Builds a small ISO9660 image in memory with one directory spanning several sectors, and checks
+// that ISOFileSystem only reads the directories a lookup passes through, and finds every file with
+// the right sector and size. The benchmark times lookups in a directory of 20000 files.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "Core/FileSystems/ISOFileSystem.h"
+
+#include "UnitTest.h"
+
+// About 40 records fit in a sector, so this is enough for records to have to skip to the next one.
+static const int ISO_TEST_BIG_DIR_FILES = 300;
+static const int ISO_BENCHMARK_BIG_DIR_FILES = 20000;
+static const u32 ISO_TEST_BLOCKS = 200000;
+// Files don't have contents, except the one at this sector.
+static const u32 ISO_TEST_DATA_SECTOR = 190000;
+
+class MemoryBlockDevice : public BlockDevice {
+public:
+	MemoryBlockDevice(const std::vector<u8> &image) : BlockDevice(nullptr), image_(image) {}
+
+	bool ReadBlock(int blockNumber, u8 *outPtr, bool uncached = false) override {
+		reads_.push_back(blockNumber);
+		size_t offset = (size_t)blockNumber * 2048;
+		if (offset + 2048 <= image_.size())
+			memcpy(outPtr, &image_[offset], 2048);
+		else
+			memset(outPtr, blockNumber == ISO_TEST_DATA_SECTOR ? 0x5A : 0, 2048);
+		return true;
+	}
+	u32 GetNumBlocks() const override { return ISO_TEST_BLOCKS; }
+	bool IsDisc() const override { return true; }
+
+	std::vector<int> reads_;
+
+private:
+	std::vector<u8> image_;
+};
+
+struct IsoTestRecord {
+	std::string name;
+	bool isDirectory;
+	u32 sector;
+	u32 size;
+};
+
+static void PutBoth32(u8 *p, u32 v) {
+	for (int i = 0; i < 4; ++i) {
+		p[i] = (u8)(v >> (i * 8));
+		p[7 - i] = (u8)(v >> (i * 8));
+	}
+}
+
+static int RecordSize(const std::string &name) {
+	int size = 33 + (int)name.size();
+	return size + (size & 1);
+}
+
+static void PutRecord(u8 *p, const IsoTestRecord &record) {
+	int size = RecordSize(record.name);
+	memset(p, 0, size);
+	p[0] = (u8)size;
+	PutBoth32(p + 2, record.sector);
+	PutBoth32(p + 10, record.size);
+	p[25] = record.isDirectory ? 2 : 0;
+	p[28] = 1;
+	p[31] = 1;
+	p[32] = (u8)record.name.size();
+	memcpy(p + 33, record.name.data(), record.name.size());
+}
+
+// The size of a directory's records in bytes, whole sectors as records can't cross them.
+static u32 DirectoryBytes(const std::vector<IsoTestRecord> &records) {
+	u32 sectors = 1;
+	int offset = 0;
+	for (const IsoTestRecord &record : records) {
+		int size = RecordSize(record.name);
+		if (offset + size > 2048) {
+			sectors++;
+			offset = 0;
+		}
+		offset += size;
+	}
+	return sectors * 2048;
+}
+
+static void WriteDirectory(std::vector<u8> &image, u32 sector, const std::vector<IsoTestRecord> &records) {
+	u32 offset = 0;
+	for (const IsoTestRecord &record : records) {
+		int size = RecordSize(record.name);
+		if ((offset & 2047) + size > 2048)
+			offset = (offset + 2047) & ~2047;
+		size_t pos = (size_t)sector * 2048 + offset;
+		if (image.size() < pos + 2048)
+			image.resize((pos + 2048 + 2047) & ~(size_t)2047);
+		PutRecord(&image[pos], record);
+		offset += size;
+	}
+}
+
+// "\0" and "\1" are how ISO9660 names . and ..
+static std::vector<IsoTestRecord> DirectoryWithDots(u32 self, u32 selfSize, u32 parent, u32 parentSize) {
+	return { { std::string(1, '\0'), true, self, selfSize }, { std::string(1, '\1'), true, parent, parentSize } };
+}
+
+static std::string BigDirFileName(int i) {
+	char name[32];
+	snprintf(name, sizeof(name), "FILE%05d.DAT", i);
+	return name;
+}
+
+static std::vector<u8> MakeImage(int bigDirFiles, u32 *bigDirSector) {
+	const u32 rootSector = 20;
+	const u32 gameSector = 21;
+	const u32 sysdirSector = 22;
+	const u32 bigSector = 23;
+
+	std::vector<IsoTestRecord> big = DirectoryWithDots(bigSector, 0, rootSector, 2048);
+	for (int i = 0; i < bigDirFiles; ++i)
+		big.push_back({ BigDirFileName(i), false, 1000 + (u32)i, (u32)i * 3 });
+	const u32 bigSize = DirectoryBytes(big);
+	big[0].size = bigSize;
+
+	std::vector<IsoTestRecord> root = DirectoryWithDots(rootSector, 2048, rootSector, 2048);
+	root.push_back({ "BIG", true, bigSector, bigSize });
+	root.push_back({ "PSP_GAME", true, gameSector, 2048 });
+	root.push_back({ "UMD_DATA.BIN", false, ISO_TEST_DATA_SECTOR, 3000 });
+
+	std::vector<IsoTestRecord> game = DirectoryWithDots(gameSector, 2048, rootSector, 2048);
+	game.push_back({ "SYSDIR", true, sysdirSector, 2048 });
+
+	std::vector<IsoTestRecord> sysdir = DirectoryWithDots(sysdirSector, 2048, gameSector, 2048);
+	sysdir.push_back({ "EBOOT.BIN", false, 500, 123456 });
+
+	std::vector<u8> image(16 * 2048 + 2048);
+	u8 *desc = &image[16 * 2048];
+	desc[0] = 1;
+	memcpy(desc + 1, "CD001", 5);
+	PutRecord(desc + 156, { std::string(1, '\0'), true, rootSector, 2048 });
+
+	WriteDirectory(image, rootSector, root);
+	WriteDirectory(image, gameSector, game);
+	WriteDirectory(image, sysdirSector, sysdir);
+	WriteDirectory(image, bigSector, big);
+	*bigDirSector = bigSector;
+	return image;
+}
+
+static bool ReadOnlyDirectories(const std::vector<int> &reads, std::vector<int> expected) {
+	if (reads != expected) {
+		printf("Read %d sectors:", (int)reads.size());
+		for (int sector : reads)
+			printf(" %d", sector);
+		printf("\n");
+		return false;
+	}
+	return true;
+}
+
+bool TestISOFileSystem() {
+	u32 bigSector = 0;
+	std::vector<u8> image = MakeImage(ISO_TEST_BIG_DIR_FILES, &bigSector);
+	MemoryBlockDevice *device = new MemoryBlockDevice(image);
+	SequentialHandleAllocator handles;
+	ISOFileSystem fs(&handles, device);
+
+	// Mounting only reads the volume descriptor, and a lookup only the directories on the way.
+	EXPECT_TRUE(ReadOnlyDirectories(device->reads_, { 16 }));
+	PSPFileInfo info = fs.GetFileInfo("/PSP_GAME/SYSDIR/EBOOT.BIN");
+	EXPECT_TRUE(info.exists);
+	EXPECT_EQ_INT((int)info.size, 123456);
+	EXPECT_EQ_INT((int)info.startSector, 500);
+	EXPECT_TRUE(ReadOnlyDirectories(device->reads_, { 16, 20, 21, 22 }));
+
+	// Looking at a directory doesn't read it, listing it does.
+	device->reads_.clear();
+	info = fs.GetFileInfo("/BIG");
+	EXPECT_TRUE(info.exists && info.type == FILETYPE_DIRECTORY);
+	EXPECT_TRUE(device->reads_.empty());
+	bool exists = false;
+	std::vector<PSPFileInfo> listing = fs.GetDirListing("/BIG", &exists);
+	EXPECT_TRUE(exists);
+	EXPECT_EQ_INT((int)listing.size(), ISO_TEST_BIG_DIR_FILES);
+	EXPECT_EQ_INT(device->reads_.front(), (int)bigSector);
+
+	EXPECT_FALSE(fs.GetFileInfo("/BIG/NOPE.DAT").exists);
+	EXPECT_FALSE(fs.GetFileInfo("/NOPE/FILE00001.DAT").exists);
+	EXPECT_FALSE(fs.GetFileInfo("/UMD_DATA.BIN/FILE00001.DAT").exists);
+	EXPECT_TRUE(fs.GetFileInfo("PSP_GAME/SYSDIR/").exists);
+	EXPECT_TRUE(fs.GetFileInfo("/BIG/./FILE00007.DAT").exists);
+	EXPECT_TRUE(fs.GetFileInfo("/BIG/../PSP_GAME").exists);
+
+	// Every file in the big directory, and reading one.
+	device->reads_.clear();
+	for (int i = 0; i < ISO_TEST_BIG_DIR_FILES; ++i) {
+		info = fs.GetFileInfo("/BIG/" + BigDirFileName(i));
+		if (!info.exists || info.startSector != 1000 + (u32)i || info.size != (s64)i * 3) {
+			printf("Wrong info for %s\n", BigDirFileName(i).c_str());
+			return false;
+		}
+	}
+	EXPECT_TRUE(device->reads_.empty());
+
+	int fd = fs.OpenFile("/UMD_DATA.BIN", FILEACCESS_READ, "disc0:");
+	EXPECT_TRUE(fd > 0);
+	std::vector<u8> data(4096);
+	EXPECT_EQ_INT((int)fs.ReadFile(fd, &data[0], (s64)data.size()), 3000);
+	EXPECT_EQ_INT(data[0], 0x5A);
+	EXPECT_EQ_INT(data[2047], 0x5A);
+	fs.CloseFile(fd);
+	return true;
+}
+
+bool TestISOFileSystemBenchmark() {
+	u32 bigSector = 0;
+	SequentialHandleAllocator handles;
+	ISOFileSystem fs(&handles, new MemoryBlockDevice(MakeImage(ISO_BENCHMARK_BIG_DIR_FILES, &bigSector)));
+
+	const int passes = 20;
+	double start = time_now_d();
+	for (int pass = 0; pass < passes; ++pass) {
+		for (int i = 0; i < ISO_BENCHMARK_BIG_DIR_FILES; ++i)
+			fs.GetFileInfo("/BIG/" + BigDirFileName(i));
+	}
+	double elapsed = time_now_d() - start;
+	printf("ISOFileSystem: %0.1f ns per lookup in a directory of %d files\n", elapsed * 1e9 / (passes * ISO_BENCHMARK_BIG_DIR_FILES), ISO_BENCHMARK_BIG_DIR_FILES);
+	return true;
+}
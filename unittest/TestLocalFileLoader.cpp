@@ -0,0 +1,136 @@
+// Reads a small image through FileBlockDevice with LocalFileLoader both mapped and using pread,
+// and checks that they return the same data, including reads running past the end. The benchmark
+// times sequential and random reads of a 64 MB image with each.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/File/FileUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/Config.h"
+#include "Core/FileLoaders/LocalFileLoader.h"
+#include "Core/FileSystems/BlockDevices.h"
+
+#include "UnitTest.h"
+
+#ifdef LOCAL_FILE_LOADER_MMAP
+
+#include <unistd.h>
+
+static const int LOADER_TEST_BLOCKS = 512;
+static const int LOADER_BENCHMARK_BLOCKS = 32768;
+
+static GMRng loaderRng;
+
+struct LoaderTestResult {
+	uint64_t checksum = 0;
+	double sequentialSeconds = 0.0;
+	double randomSeconds = 0.0;
+	std::vector<u8> tail;
+};
+
+static LoaderTestResult ReadImage(const Path &path, int blocks, bool mapped) {
+	g_Config.bMemoryMapDiscImages = mapped;
+	LocalFileLoader loader(path);
+	FileBlockDevice device(&loader);
+	LoaderTestResult result;
+
+	// Like a video or the loading of a big file: 16 sectors at a time, front to back.
+	std::vector<u8> buffer(16 * 2048);
+	double start = time_now_d();
+	for (int block = 0; block < blocks; block += 16) {
+		device.ReadBlocks(block, 16, &buffer[0]);
+		result.checksum = result.checksum * 31 + buffer[0] + buffer[buffer.size() - 1];
+	}
+	result.sequentialSeconds = time_now_d() - start;
+
+	// Like lookups and small files spread over the disc.
+	loaderRng.Init(5);
+	start = time_now_d();
+	for (int i = 0; i < blocks; ++i) {
+		device.ReadBlock(loaderRng.R32() % blocks, &buffer[0]);
+		result.checksum = result.checksum * 31 + buffer[i & 2047];
+	}
+	result.randomSeconds = time_now_d() - start;
+
+	// Past the end, only what's there is read.
+	result.tail.resize(8192, 0xEE);
+	size_t got = loader.ReadAt((s64)blocks * 2048 - 3000, 1, 8192, &result.tail[0]);
+	result.checksum = result.checksum * 31 + got;
+	return result;
+}
+
+static bool WriteImage(int blocks, Path *path, std::vector<u8> *data) {
+	char name[] = "/tmp/ppsspp_loader_XXXXXX";
+	int fd = mkstemp(name);
+	if (fd < 0) {
+		printf("Couldn't create a temp file, skipping\n");
+		return false;
+	}
+	close(fd);
+	*path = Path(name);
+
+	data->resize((size_t)blocks * 2048);
+	loaderRng.Init(1);
+	for (size_t i = 0; i < data->size(); i += 4) {
+		uint32_t v = loaderRng.R32();
+		memcpy(&(*data)[i], &v, 4);
+	}
+	File::WriteDataToFile(false, &(*data)[0], data->size(), *path);
+	return true;
+}
+
+bool TestLocalFileLoader() {
+	Path path;
+	std::vector<u8> data;
+	if (!WriteImage(LOADER_TEST_BLOCKS, &path, &data))
+		return true;
+
+	const bool oldMapped = g_Config.bMemoryMapDiscImages;
+	LoaderTestResult readResult = ReadImage(path, LOADER_TEST_BLOCKS, false);
+	LoaderTestResult mappedResult = ReadImage(path, LOADER_TEST_BLOCKS, true);
+	g_Config.bMemoryMapDiscImages = oldMapped;
+	File::Delete(path);
+
+	EXPECT_TRUE(readResult.checksum == mappedResult.checksum);
+	EXPECT_TRUE(readResult.tail == mappedResult.tail);
+	EXPECT_EQ_INT(mappedResult.tail[2999], data[data.size() - 1]);
+	EXPECT_EQ_INT(mappedResult.tail[3000], 0xEE);
+	return true;
+}
+
+bool TestLocalFileLoaderBenchmark() {
+	Path path;
+	std::vector<u8> data;
+	if (!WriteImage(LOADER_BENCHMARK_BLOCKS, &path, &data))
+		return true;
+
+	const bool oldMapped = g_Config.bMemoryMapDiscImages;
+	// Once so both find it in the page cache, then for real.
+	ReadImage(path, LOADER_BENCHMARK_BLOCKS, false);
+	LoaderTestResult readResult = ReadImage(path, LOADER_BENCHMARK_BLOCKS, false);
+	LoaderTestResult mappedResult = ReadImage(path, LOADER_BENCHMARK_BLOCKS, true);
+	g_Config.bMemoryMapDiscImages = oldMapped;
+	File::Delete(path);
+
+	const double megabytes = data.size() / (1024.0 * 1024.0);
+	printf("LocalFileLoader with pread: %0.0f MB/s sequential, %0.0f ns per random sector\n", megabytes / readResult.sequentialSeconds, readResult.randomSeconds * 1e9 / LOADER_BENCHMARK_BLOCKS);
+	printf("LocalFileLoader mapped: %0.0f MB/s sequential, %0.0f ns per random sector\n", megabytes / mappedResult.sequentialSeconds, mappedResult.randomSeconds * 1e9 / LOADER_BENCHMARK_BLOCKS);
+	return true;
+}
+
+#else
+
+bool TestLocalFileLoader() {
+	// Files are never mapped on this host.
+	return true;
+}
+
+bool TestLocalFileLoaderBenchmark() {
+	return true;
+}
+
+#endif
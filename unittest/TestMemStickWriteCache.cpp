@@ -0,0 +1,131 @@
+// Checks the memory stick write cache in DirectoryFileSystem: small writes that follow each other
+// reach the host in one go, and are written out before a seek, read, close, sync or save state,
+// so the host file and the restored handle agree with what the game wrote.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/File/FileUtil.h"
+#include "Common/Serialize/Serializer.h"
+#include "Core/Config.h"
+#include "Core/FileSystems/DirectoryFileSystem.h"
+
+#include "UnitTest.h"
+
+static const FileAccess WRITE_CACHE_TEST_ACCESS = (FileAccess)(FILEACCESS_READ | FILEACCESS_WRITE | FILEACCESS_CREATE);
+
+static std::string HostContents(const Path &path) {
+	std::string data;
+	File::ReadBinaryFileToString(path, &data);
+	return data;
+}
+
+static bool WriteString(DirectoryFileSystem &fs, u32 handle, const std::string &str) {
+	return fs.WriteFile(handle, (const u8 *)str.data(), (s64)str.size()) == str.size();
+}
+
+static bool CheckWriteCache(const Path &dir) {
+	SequentialHandleAllocator handles;
+	DirectoryFileSystem fs(&handles, dir, FileSystemFlags::CARD);
+	const Path hostPath = dir / "DATA.BIN";
+
+	// Adjacent writes are held back, then go out in one host write on close.
+	int handle = fs.OpenFile("DATA.BIN", WRITE_CACHE_TEST_ACCESS);
+	EXPECT_TRUE(handle > 0);
+	std::string expected;
+	for (int i = 0; i < 10; ++i) {
+		std::string piece = "piece" + std::to_string(i) + ";";
+		EXPECT_TRUE(WriteString(fs, handle, piece));
+		expected += piece;
+	}
+	EXPECT_EQ_INT((int)File::GetFileSize(hostPath), 0);
+	fs.CloseFile(handle);
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+	EXPECT_EQ_INT((int)fs.WriteBackStats().writes, 10);
+	EXPECT_EQ_INT((int)fs.WriteBackStats().flushes, 1);
+	EXPECT_EQ_INT((int)fs.WriteBackStats().bytes, (int)expected.size());
+
+	// A seek writes it out first, and then goes from where the game thinks it is.
+	handle = fs.OpenFile("DATA.BIN", WRITE_CACHE_TEST_ACCESS);
+	EXPECT_TRUE(WriteString(fs, handle, "SEEK"));
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+	EXPECT_EQ_INT((int)fs.SeekFile(handle, 0, FILEMOVE_CURRENT), 4);
+	expected.replace(0, 4, "SEEK");
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+
+	// So does a read, which continues after the data.
+	EXPECT_TRUE(WriteString(fs, handle, "READ"));
+	char buffer[8]{};
+	EXPECT_EQ_INT((int)fs.ReadFile(handle, (u8 *)buffer, 4), 4);
+	expected.replace(4, 4, "READ");
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+	EXPECT_TRUE(memcmp(buffer, expected.data() + 8, 4) == 0);
+
+	// And sceIoSync.
+	EXPECT_TRUE(WriteString(fs, handle, "SYNC"));
+	fs.Flush();
+	expected.replace(12, 4, "SYNC");
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+
+	// Other handles see what was written, as does stat.
+	EXPECT_TRUE(WriteString(fs, handle, "OPEN"));
+	int other = fs.OpenFile("DATA.BIN", FILEACCESS_READ);
+	EXPECT_TRUE(other > 0);
+	expected.replace(16, 4, "OPEN");
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+	EXPECT_EQ_INT((int)fs.ReadFile(other, (u8 *)buffer, 4), 4);
+	EXPECT_TRUE(memcmp(buffer, "SEEK", 4) == 0);
+	fs.CloseFile(other);
+	EXPECT_TRUE(WriteString(fs, handle, "STAT!"));
+	expected.replace(20, 5, "STAT!");
+	EXPECT_EQ_INT((int)fs.GetFileInfo("DATA.BIN").size, (int)expected.size());
+	EXPECT_EQ_STR(HostContents(hostPath), expected);
+	fs.CloseFile(handle);
+	return true;
+}
+
+static bool CheckWriteCacheState(const Path &dir) {
+	SequentialHandleAllocator handles;
+	const Path hostPath = dir / "STATE.BIN";
+	std::vector<u8> state;
+	u32 handle = 0;
+	{
+		DirectoryFileSystem fs(&handles, dir, FileSystemFlags::CARD);
+		handle = (u32)fs.OpenFile("STATE.BIN", WRITE_CACHE_TEST_ACCESS);
+		EXPECT_TRUE(WriteString(fs, handle, "before "));
+		// Still pending when the state is saved, which has to write it so the two agree.
+		EXPECT_EQ_INT((int)File::GetFileSize(hostPath), 0);
+		EXPECT_TRUE(CChunkFileReader::MeasureAndSavePtr(fs, &state) == CChunkFileReader::ERROR_NONE);
+		EXPECT_EQ_STR(HostContents(hostPath), std::string("before "));
+		// Written after the state, so loading it continues from the old position.
+		EXPECT_TRUE(WriteString(fs, handle, "lost!!"));
+	}
+	EXPECT_EQ_STR(HostContents(hostPath), std::string("before lost!!"));
+
+	DirectoryFileSystem fs(&handles, dir, FileSystemFlags::CARD);
+	std::string error;
+	EXPECT_TRUE(CChunkFileReader::LoadPtr(&state[0], fs, &error) == CChunkFileReader::ERROR_NONE);
+	EXPECT_TRUE(fs.OwnsHandle(handle));
+	EXPECT_EQ_INT((int)fs.SeekFile(handle, 0, FILEMOVE_CURRENT), 7);
+	EXPECT_TRUE(WriteString(fs, handle, "after!"));
+	EXPECT_EQ_STR(HostContents(hostPath), std::string("before lost!!"));
+	fs.CloseFile(handle);
+	EXPECT_EQ_STR(HostContents(hostPath), std::string("before after!"));
+	return true;
+}
+
+bool TestMemStickWriteCache() {
+	const Path dir("memstick_cache_test");
+	File::DeleteDirRecursively(dir);
+	File::CreateFullPath(dir);
+	const bool oldWriteCache = g_Config.bMemStickWriteCache;
+	g_Config.bMemStickWriteCache = true;
+
+	bool success = CheckWriteCache(dir) && CheckWriteCacheState(dir);
+
+	g_Config.bMemStickWriteCache = oldWriteCache;
+	File::DeleteDirRecursively(dir);
+	return success;
+}
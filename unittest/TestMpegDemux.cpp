@@ -0,0 +1,157 @@
+// Runs a synthetic PSMF stream through MpegDemux in uneven pieces and checks that every audio frame
+// comes out intact, including ones that wrap around the end of the audio ring buffer. The benchmark
+// times a much longer stream.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/HW/MpegDemux.h"
+
+#include "UnitTest.h"
+
+static const int DEMUX_TEST_FRAMES = 300;
+static const int DEMUX_BENCHMARK_FRAMES = 30000;
+static const int DEMUX_TEST_BUFFER = 0x10000;
+// An Atrac3+ frame header as found in PSMF files: 0x5C gives a frame of 0x2F0 bytes with the header.
+static const u8 DEMUX_TEST_CODE1 = 0x28;
+static const u8 DEMUX_TEST_CODE2 = 0x5C;
+
+static GMRng demuxRng;
+
+static void PutStartCode(std::vector<u8> &out, u8 code) {
+	out.push_back(0);
+	out.push_back(0);
+	out.push_back(1);
+	out.push_back(code);
+}
+
+static void PutPackHeader(std::vector<u8> &out) {
+	static const u8 pack[10] = { 0x44, 0x00, 0x04, 0x00, 0x04, 0x01, 0x01, 0x89, 0xC3, 0xF8 };
+	PutStartCode(out, 0xBA);
+	out.insert(out.end(), pack, pack + sizeof(pack));
+}
+
+static void PutVideoPacket(std::vector<u8> &out, int size) {
+	PutStartCode(out, 0xE0);
+	out.push_back((u8)((size + 3) >> 8));
+	out.push_back((u8)(size + 3));
+	out.push_back(0x81);
+	out.push_back(0x00);
+	out.push_back(0x00);
+	// Random payload, which may well contain start codes of its own.
+	for (int i = 0; i < size; ++i)
+		out.push_back((u8)demuxRng.R32());
+}
+
+static void PutAudioPacket(std::vector<u8> &out, const u8 *payload, int size, s64 pts) {
+	PutStartCode(out, 0xBD);
+	int length = 3 + 5 + 4 + size;
+	out.push_back((u8)(length >> 8));
+	out.push_back((u8)length);
+	out.push_back(0x81);
+	out.push_back(0x80);
+	out.push_back(5);
+	out.push_back((u8)(0x21 | ((pts >> 29) & 0x0E)));
+	out.push_back((u8)(pts >> 22));
+	out.push_back((u8)((pts >> 14) | 1));
+	out.push_back((u8)(pts >> 7));
+	out.push_back((u8)((pts << 1) | 1));
+	// Channel, then the extra PSP audio header.
+	out.push_back(0x00);
+	out.push_back(0xFF);
+	out.push_back(0xFF);
+	out.push_back(0xFF);
+	out.insert(out.end(), payload, payload + size);
+}
+
+static bool RunDemux(int frameCount, double *elapsed) {
+	const int frameSize = ((DEMUX_TEST_CODE1 & 0x03) << 8 | (DEMUX_TEST_CODE2 * 8)) + 0x10;
+	demuxRng.Init(3);
+
+	// The audio elementary stream: frames with random contents that never look like a frame header.
+	std::vector<u8> audio(frameCount * frameSize);
+	for (int f = 0; f < frameCount; ++f) {
+		u8 *frame = &audio[f * frameSize];
+		for (int i = 0; i < frameSize; ++i) {
+			u8 c = (u8)demuxRng.R32();
+			frame[i] = c == 0x0F ? 0x1F : c;
+		}
+		frame[0] = 0x0F;
+		frame[1] = 0xD0;
+		frame[2] = DEMUX_TEST_CODE1;
+		frame[3] = DEMUX_TEST_CODE2;
+	}
+
+	// Packed into audio packets of varying size, with video and stuffing in between.
+	std::vector<u8> stream;
+	size_t audioPos = 0;
+	s64 pts = 90000;
+	while (audioPos < audio.size()) {
+		PutPackHeader(stream);
+		for (uint32_t zeros = demuxRng.R32() % 4; zeros > 0; --zeros)
+			stream.push_back(0);
+		PutVideoPacket(stream, 200 + demuxRng.R32() % 1800);
+		int size = std::min((int)(audio.size() - audioPos), 500 + (int)(demuxRng.R32() % 1500));
+		PutAudioPacket(stream, &audio[audioPos], size, pts);
+		audioPos += size;
+		pts += 4180;
+	}
+
+	MpegDemux demux(DEMUX_TEST_BUFFER, 0);
+	size_t streamPos = 0;
+	int frames = 0;
+	double start = time_now_d();
+	while (frames < frameCount) {
+		// Fill it up like sceMpegRingbufferPut would, then take out the frames like the audio decode.
+		while (streamPos < stream.size()) {
+			int size = std::min((int)(stream.size() - streamPos), 1 + (int)(demuxRng.R32() % 4096));
+			if (!demux.addStreamData(&stream[streamPos], size))
+				break;
+			streamPos += size;
+		}
+		demux.demux(-1);
+
+		const u8 *frame = nullptr;
+		int headerCode1 = 0, headerCode2 = 0;
+		int gotsize = 0;
+		bool any = false;
+		// A frame whose next header hasn't arrived yet takes all that's there, so leave that one for later.
+		while (demux.hasNextAudioFrame(&gotsize, nullptr, nullptr, nullptr) && (gotsize >= frameSize + 2 || streamPos == stream.size())) {
+			int size = demux.getNextAudioFrame(&frame, &headerCode1, &headerCode2);
+			EXPECT_EQ_INT(size, frameSize - 8);
+			EXPECT_EQ_INT(headerCode1, DEMUX_TEST_CODE1);
+			EXPECT_EQ_INT(headerCode2, DEMUX_TEST_CODE2);
+			EXPECT_TRUE(frames < frameCount);
+			if (memcmp(frame, &audio[frames * frameSize + 8], size) != 0) {
+				printf("Audio frame %d differs\n", frames);
+				return false;
+			}
+			frames++;
+			any = true;
+		}
+		EXPECT_TRUE(any || streamPos < stream.size());
+	}
+	if (elapsed)
+		*elapsed = time_now_d() - start;
+
+	EXPECT_EQ_INT(frames, frameCount);
+	EXPECT_TRUE(!demux.hasNextAudioFrame(nullptr, nullptr, nullptr, nullptr));
+	return true;
+}
+
+bool TestMpegDemux() {
+	return RunDemux(DEMUX_TEST_FRAMES, nullptr);
+}
+
+bool TestMpegDemuxBenchmark() {
+	double elapsed = 0.0;
+	if (!RunDemux(DEMUX_BENCHMARK_FRAMES, &elapsed))
+		return false;
+	const int frameSize = ((DEMUX_TEST_CODE1 & 0x03) << 8 | (DEMUX_TEST_CODE2 * 8)) + 0x10;
+	printf("MpegDemux: %d KB of audio in %0.2f ms\n", DEMUX_BENCHMARK_FRAMES * frameSize / 1024, elapsed * 1000.0);
+	return true;
+}
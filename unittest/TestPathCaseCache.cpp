@@ -0,0 +1,203 @@
+// Builds a small memstick-like tree in a temp directory and checks that PathCaseCache fixes the case
+// of paths exactly like FixPathCase, also after files are added, renamed and deleted behind its back.
+// The benchmark times both on a tree of 100k files. Only does anything on hosts with case sensitive
+// file systems.
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/File/FileUtil.h"
+#include "Common/File/Path.h"
+#include "Common/TimeUtil.h"
+
+#include "UnitTest.h"
+
+#if HOST_IS_CASE_SENSITIVE
+
+struct CaseTestSize {
+	int dirs;
+	int filesPerDir;
+	int lookups;
+};
+
+// Enough for lowercase and uppercase directories and file names, and a few that don't exist.
+static const CaseTestSize CASE_TEST_SMALL = { 10, 20, 1000 };
+static const CaseTestSize CASE_TEST_BENCHMARK = { 500, 200, 20000 };
+
+static GMRng caseRng;
+
+// Some games use lowercase names, most uppercase.
+static std::string CaseTestDirName(int d) {
+	char name[32];
+	snprintf(name, sizeof(name), d % 7 == 0 ? "ulus%05d_save" : "ULUS%05dDATA%02d", 10000 + d, d % 100);
+	return name;
+}
+
+static std::string CaseTestFileName(int f) {
+	char name[32];
+	if (f == 0)
+		return "PARAM.SFO";
+	if (f == 1)
+		return "ICON0.PNG";
+	snprintf(name, sizeof(name), f % 5 == 0 ? "Data%04d.bin" : "DATA%04d.BIN", f);
+	return name;
+}
+
+static std::string Scramble(const std::string &path) {
+	std::string result = path;
+	for (char &c : result) {
+		if (isalpha((unsigned char)c) && (caseRng.R32() & 1))
+			c ^= 0x20;
+	}
+	return result;
+}
+
+static bool SameResult(PathCaseCache &cache, const Path &root, const std::string &path, FixPathCaseBehavior behavior) {
+	std::string uncached = path;
+	std::string cached = path;
+	bool uncachedResult = FixPathCase(root, uncached, behavior);
+	bool cachedResult = cache.FixPathCase(root, cached, behavior);
+	if (uncachedResult != cachedResult || (uncachedResult && uncached != cached)) {
+		printf("%s: got %d %s, expected %d %s\n", path.c_str(), cachedResult, cached.c_str(), uncachedResult, uncached.c_str());
+		return false;
+	}
+	return true;
+}
+
+// Checks one lookup that should (or shouldn't) resolve to expected.
+static bool Resolves(PathCaseCache &cache, const Path &root, const std::string &path, const char *expected) {
+	std::string fixed = path;
+	bool result = cache.FixPathCase(root, fixed, FPC_FILE_MUST_EXIST);
+	if (!expected)
+		return !result;
+	return result && fixed == expected;
+}
+
+static std::vector<std::string> MakeLookups(const CaseTestSize &size) {
+	std::vector<std::string> lookups;
+	caseRng.Init(7);
+	for (int i = 0; i < size.lookups; ++i) {
+		int d = caseRng.R32() % size.dirs;
+		// A few that don't exist, as games check for saves that aren't there.
+		int f = caseRng.R32() % (size.filesPerDir + 10);
+		lookups.push_back(Scramble("PSP/SAVEDATA/" + CaseTestDirName(d) + "/" + CaseTestFileName(f)));
+	}
+	return lookups;
+}
+
+static bool MakeTree(const CaseTestSize &size, Path *root) {
+	char rootName[] = "/tmp/ppsspp_casecache_XXXXXX";
+	if (!mkdtemp(rootName)) {
+		printf("Couldn't create a temp directory, skipping\n");
+		return false;
+	}
+	*root = Path(rootName);
+
+	const Path saveData = *root / "PSP/SAVEDATA";
+	File::CreateFullPath(saveData);
+	File::CreateFullPath(*root / "PSP/GAME");
+	for (int d = 0; d < size.dirs; ++d) {
+		const Path dir = saveData / CaseTestDirName(d);
+		File::CreateDir(dir);
+		for (int f = 0; f < size.filesPerDir; ++f)
+			File::CreateEmptyFile(dir / CaseTestFileName(f));
+	}
+	return true;
+}
+
+bool TestPathCaseCache() {
+	Path root;
+	if (!MakeTree(CASE_TEST_SMALL, &root))
+		return true;
+
+	bool ok = true;
+	const std::vector<std::string> lookups = MakeLookups(CASE_TEST_SMALL);
+	{
+		PathCaseCache cache;
+		for (const std::string &path : lookups) {
+			ok = ok && SameResult(cache, root, path, FPC_FILE_MUST_EXIST);
+			ok = ok && SameResult(cache, root, path, FPC_PATH_MUST_EXIST);
+		}
+		ok = ok && SameResult(cache, root, "psp/savedata/NOPE/data0002.bin", FPC_PATH_MUST_EXIST);
+		ok = ok && SameResult(cache, root, "psp/savedata/NOPE/data0002.bin", FPC_PARTIAL_ALLOWED);
+		ok = ok && SameResult(cache, root, "psp/game/", FPC_FILE_MUST_EXIST);
+
+		// Changes made behind its back have to show up.
+		const std::string dir = "PSP/SAVEDATA/" + CaseTestDirName(1);
+		ok = ok && Resolves(cache, root, "psp/savedata/" + CaseTestDirName(1) + "/newfile.bin", nullptr);
+		File::CreateEmptyFile(root / dir / "NewFile.Bin");
+		ok = ok && Resolves(cache, root, "psp/savedata/" + CaseTestDirName(1) + "/newfile.bin", (dir + "/NewFile.Bin").c_str());
+		File::Delete(root / dir / "NewFile.Bin");
+		ok = ok && Resolves(cache, root, dir + "/NEWFILE.BIN", nullptr);
+
+		File::Rename(root / dir, root / "PSP/SAVEDATA/Moved");
+		ok = ok && Resolves(cache, root, dir + "/param.sfo", nullptr);
+		ok = ok && Resolves(cache, root, "psp/savedata/moved/param.sfo", "PSP/SAVEDATA/Moved/PARAM.SFO");
+		File::Rename(root / "PSP/SAVEDATA/Moved", root / dir);
+		ok = ok && Resolves(cache, root, "psp/savedata/moved/param.sfo", nullptr);
+		ok = ok && Resolves(cache, root, dir + "/param.sfo", (dir + "/PARAM.SFO").c_str());
+
+		// A second file that differs only in case: it must pick the same one as FixPathCase.
+		File::CreateEmptyFile(root / dir / "param.sfo");
+		ok = ok && SameResult(cache, root, dir + "/Param.sfo", FPC_FILE_MUST_EXIST);
+		ok = ok && Resolves(cache, root, dir + "/param.sfo", (dir + "/param.sfo").c_str());
+		ok = ok && Resolves(cache, root, dir + "/PARAM.SFO", (dir + "/PARAM.SFO").c_str());
+	}
+	File::DeleteDirRecursively(root);
+	EXPECT_TRUE(ok);
+	return true;
+}
+
+bool TestPathCaseCacheBenchmark() {
+	const CaseTestSize &size = CASE_TEST_BENCHMARK;
+	double start = time_now_d();
+	Path root;
+	if (!MakeTree(size, &root))
+		return true;
+	printf("Created %d files in %0.2f s\n", size.dirs * size.filesPerDir, time_now_d() - start);
+	const std::vector<std::string> lookups = MakeLookups(size);
+
+	// Uncached, a lookup lists every directory on the way. The cache only lists them once.
+	const int uncachedLookups = size.lookups / 4;
+	start = time_now_d();
+	for (int i = 0; i < uncachedLookups; ++i) {
+		std::string path = lookups[i];
+		FixPathCase(root, path, FPC_FILE_MUST_EXIST);
+	}
+	double uncachedTime = (time_now_d() - start) / uncachedLookups;
+
+	PathCaseCache cache;
+	start = time_now_d();
+	for (const std::string &path : lookups) {
+		std::string fixed = path;
+		cache.FixPathCase(root, fixed, FPC_FILE_MUST_EXIST);
+	}
+	double firstTime = (time_now_d() - start) / size.lookups;
+	start = time_now_d();
+	for (const std::string &path : lookups) {
+		std::string fixed = path;
+		cache.FixPathCase(root, fixed, FPC_FILE_MUST_EXIST);
+	}
+	double cachedTime = (time_now_d() - start) / size.lookups;
+	printf("FixPathCase: %0.2f us uncached, %0.2f us cached on the first pass, %0.2f us after\n", uncachedTime * 1e6, firstTime * 1e6, cachedTime * 1e6);
+
+	File::DeleteDirRecursively(root);
+	return true;
+}
+
+#else
+
+bool TestPathCaseCache() {
+	// Nothing to fix on this host.
+	return true;
+}
+
+bool TestPathCaseCacheBenchmark() {
+	return true;
+}
+
+#endif
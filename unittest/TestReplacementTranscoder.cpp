@@ -0,0 +1,182 @@
+// Compresses replacement-like images with the BC1/BC3 encoder, decodes them again with a plain
+// reference decoder and checks the error, that alpha 0 and 255 stay exact, that the cache round trips
+// and can be trimmed, and times encoding.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/File/DirListing.h"
+#include "Common/File/FileUtil.h"
+#include "Common/TimeUtil.h"
+#include "GPU/Common/ReplacementTranscoder.h"
+
+#include "UnitTest.h"
+
+static const int TRANSCODE_TEST_SIZE = 256;
+
+static GMRng transcodeRng;
+
+// Smooth shading with a bit of noise and some hard edges, like upscaled game art. Alpha is either
+// opaque, or cut out with a soft edge.
+static std::vector<uint8_t> MakeImage(int size, bool withAlpha) {
+	std::vector<uint8_t> rgba((size_t)size * size * 4);
+	transcodeRng.Init(3);
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			uint8_t *p = &rgba[((size_t)y * size + x) * 4];
+			bool stripe = ((x / 24) & 1) != 0;
+			p[0] = (uint8_t)std::min(255, (int)(128 + 100 * sin(x * 0.05)) + (int)(transcodeRng.R32() % 5));
+			p[1] = (uint8_t)std::min(255, y * 255 / size + (int)(transcodeRng.R32() % 5));
+			p[2] = stripe ? 40 : 200;
+			int dx = x - size / 2, dy = y - size / 2;
+			int dist = (int)sqrt((double)(dx * dx + dy * dy));
+			p[3] = !withAlpha ? 255 : (uint8_t)std::max(0, std::min(255, (size / 3 - dist) * 32));
+		}
+	}
+	return rgba;
+}
+
+static void Decode565(uint16_t c, int *rgb) {
+	rgb[0] = ((c >> 11) & 31) * 255 / 31;
+	rgb[1] = ((c >> 5) & 63) * 255 / 63;
+	rgb[2] = (c & 31) * 255 / 31;
+}
+
+// Straight from the format description, four color mode only.
+static std::vector<uint8_t> Decode(const std::vector<uint8_t> &blocks, int size, bool withAlpha) {
+	std::vector<uint8_t> rgba((size_t)size * size * 4);
+	const uint8_t *src = &blocks[0];
+	for (int by = 0; by < size; by += 4) {
+		for (int bx = 0; bx < size; bx += 4) {
+			int alpha[8]{ 255, 255, 255, 255, 255, 255, 255, 255 };
+			uint64_t alphaBits = 0;
+			if (withAlpha) {
+				alpha[0] = src[0];
+				alpha[1] = src[1];
+				for (int i = 1; i < 7; ++i)
+					alpha[i + 1] = ((7 - i) * alpha[0] + i * alpha[1]) / 7;
+				for (int i = 0; i < 6; ++i)
+					alphaBits |= (uint64_t)src[2 + i] << (i * 8);
+				src += 8;
+			}
+			int colors[4][3];
+			Decode565((uint16_t)(src[0] | (src[1] << 8)), colors[0]);
+			Decode565((uint16_t)(src[2] | (src[3] << 8)), colors[1]);
+			for (int c = 0; c < 3; ++c) {
+				colors[2][c] = (2 * colors[0][c] + colors[1][c]) / 3;
+				colors[3][c] = (colors[0][c] + 2 * colors[1][c]) / 3;
+			}
+			uint32_t bits = src[4] | (src[5] << 8) | (src[6] << 16) | ((uint32_t)src[7] << 24);
+			src += 8;
+			for (int i = 0; i < 16; ++i) {
+				uint8_t *p = &rgba[((size_t)(by + i / 4) * size + bx + i % 4) * 4];
+				const int *color = colors[(bits >> (i * 2)) & 3];
+				p[0] = (uint8_t)color[0];
+				p[1] = (uint8_t)color[1];
+				p[2] = (uint8_t)color[2];
+				p[3] = (uint8_t)alpha[(alphaBits >> (i * 3)) & 7];
+			}
+		}
+	}
+	return rgba;
+}
+
+static double PSNR(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, int channel) {
+	double sum = 0.0;
+	for (size_t i = channel; i < a.size(); i += 4) {
+		double d = (double)a[i] - b[i];
+		sum += d * d;
+	}
+	double mse = sum / (a.size() / 4);
+	return mse == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / mse);
+}
+
+static bool CheckQuality(const char *name, bool withAlpha) {
+	const int size = TRANSCODE_TEST_SIZE;
+	std::vector<uint8_t> image = MakeImage(size, withAlpha);
+	std::vector<uint8_t> blocks((size_t)(size / 4) * (size / 4) * (withAlpha ? 16 : 8));
+
+	const int passes = 20;
+	double start = time_now_d();
+	for (int pass = 0; pass < passes; ++pass) {
+		if (withAlpha)
+			ReplacementTranscoder::EncodeBC3(&image[0], size, size, size, &blocks[0]);
+		else
+			ReplacementTranscoder::EncodeBC1(&image[0], size, size, size, &blocks[0]);
+	}
+	double elapsed = time_now_d() - start;
+
+	std::vector<uint8_t> decoded = Decode(blocks, size, withAlpha);
+	double psnr = 0.0;
+	for (int c = 0; c < 3; ++c)
+		psnr += PSNR(image, decoded, c) / 3.0;
+	printf("%s: %0.1f dB color, %0.1f dB alpha, %0.1f MPixel/s\n", name, psnr, PSNR(image, decoded, 3), size * size * passes / (elapsed * 1e6));
+	if (psnr < 32.0)
+		return false;
+
+	for (size_t i = 3; i < image.size(); i += 4) {
+		if ((image[i] == 0 || image[i] == 255) && decoded[i] != image[i]) {
+			printf("%s: alpha %d became %d\n", name, image[i], decoded[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TestReplacementTranscoder() {
+	EXPECT_TRUE(CheckQuality("BC1", false));
+	EXPECT_TRUE(CheckQuality("BC3", true));
+
+	// A flat block has equal endpoints, which must still decode to the color.
+	std::vector<uint8_t> flat(16 * 4, 0x80);
+	std::vector<uint8_t> block(8);
+	ReplacementTranscoder::EncodeBC1(&flat[0], 4, 4, 4, &block[0]);
+	std::vector<uint8_t> flatDecoded = Decode(block, 4, false);
+	EXPECT_TRUE(abs(flatDecoded[0] - 0x80) <= 4);
+
+	const Path dir = Path("transcode_test");
+	const std::vector<uint8_t> image = MakeImage(64, true);
+	EXPECT_TRUE(ReplacementTranscoder::TranscodeToCache(dir, 0x1234, 64, 64, &image[0], false));
+	std::vector<uint8_t> data;
+	Draw::DataFormat fmt = Draw::DataFormat::UNDEFINED;
+	EXPECT_TRUE(ReplacementTranscoder::LoadCached(dir, 0x1234, 64, 64, &data, &fmt));
+	EXPECT_TRUE(fmt == Draw::DataFormat::BC3_UNORM_BLOCK);
+	EXPECT_EQ_INT((int)data.size(), 16 * 16 * 16);
+	// Only used when the size still matches, and not for other hashes.
+	EXPECT_FALSE(ReplacementTranscoder::LoadCached(dir, 0x1234, 128, 128, &data, &fmt));
+	EXPECT_FALSE(ReplacementTranscoder::LoadCached(dir, 0x1235, 64, 64, &data, &fmt));
+
+	// A new size replaces the old entry.
+	const std::vector<uint8_t> bigImage = MakeImage(128, false);
+	EXPECT_TRUE(ReplacementTranscoder::TranscodeToCache(dir, 0x1234, 128, 128, &bigImage[0], true));
+	EXPECT_TRUE(ReplacementTranscoder::LoadCached(dir, 0x1234, 128, 128, &data, &fmt));
+	EXPECT_TRUE(fmt == Draw::DataFormat::BC1_RGBA_UNORM_BLOCK);
+
+	File::DeleteDirRecursively(dir);
+
+	// Trimming drops leftover temp files, and entries until the rest fit.
+	const Path trimDir = Path("transcode_trim_test");
+	for (uint64_t hash = 1; hash <= 4; ++hash)
+		EXPECT_TRUE(ReplacementTranscoder::TranscodeToCache(trimDir, hash, 64, 64, &image[0], false));
+	FILE *fp = File::OpenCFile(trimDir / "0000000000000001.7.tmp", "wb");
+	EXPECT_TRUE(fp != nullptr);
+	fclose(fp);
+	const uint64_t entryBytes = File::GetFileSize(trimDir / "0000000000000001.dds");
+	EXPECT_TRUE(ReplacementTranscoder::TrimCache(trimDir, entryBytes * 3));
+	EXPECT_FALSE(File::Exists(trimDir / "0000000000000001.7.tmp"));
+	std::vector<File::FileInfo> files;
+	File::GetFilesInDir(trimDir, &files);
+	EXPECT_EQ_INT((int)files.size(), 3);
+	EXPECT_TRUE(ReplacementTranscoder::TrimCache(trimDir, 0));
+	files.clear();
+	File::GetFilesInDir(trimDir, &files);
+	EXPECT_EQ_INT((int)files.size(), 0);
+
+	File::DeleteDirRecursively(trimDir);
+	return true;
+}
@@ -0,0 +1,279 @@
+// Golden output test for the SAS mixer.
+// Plays back deterministic pseudo-random SAS command streams (voice setup, envelopes, pitches,
+// volumes, key on/off, reverb) and hashes every mixed grain. The hashes were recorded with the
+// original scalar mixer, so any optimization of the mixing paths has to stay bit-exact.
+// The benchmark times the streams and a mix with every voice playing.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/Config.h"
+#include "Core/MemMap.h"
+#include "Core/HW/SasAudio.h"
+
+#include "UnitTest.h"
+
+static const u32 SAS_TEST_VAG_ADDR = 0x08800000;
+static const u32 SAS_TEST_VAG_BLOCKS = 2048;
+static const u32 SAS_TEST_PCM_ADDR = 0x08900000;
+static const u32 SAS_TEST_PCM_SAMPLES = 0x8000;
+static const u32 SAS_TEST_IN_ADDR = 0x08A00000;
+static const u32 SAS_TEST_OUT_ADDR = 0x08B00000;
+
+static GMRng sasRng;
+
+static int SasRandRange(int lo, int hi) {
+	return lo + (int)(sasRng.R32() % (uint32_t)(hi - lo + 1));
+}
+
+static void WriteTestSamples() {
+	u8 *vag = Memory::GetPointerWriteUnchecked(SAS_TEST_VAG_ADDR);
+	for (u32 block = 0; block < SAS_TEST_VAG_BLOCKS; ++block) {
+		u8 *p = vag + block * 16;
+		// Mostly the documented filters, with a few of the odd ones.
+		int predict = (sasRng.R32() % 8) == 0 ? SasRandRange(0, 15) : SasRandRange(0, 4);
+		p[0] = (u8)((predict << 4) | SasRandRange(0, 12));
+		// Sprinkle loop start/end markers, and an occasional end block.
+		switch (sasRng.R32() % 64) {
+		case 0: p[1] = 6; break;
+		case 1: p[1] = 3; break;
+		case 2: p[1] = (block & 1) ? 7 : 0; break;
+		default: p[1] = 0; break;
+		}
+		for (int i = 2; i < 16; ++i)
+			p[i] = (u8)sasRng.R32();
+	}
+
+	s16 *pcm = (s16 *)Memory::GetPointerWriteUnchecked(SAS_TEST_PCM_ADDR);
+	for (u32 i = 0; i < SAS_TEST_PCM_SAMPLES; ++i)
+		pcm[i] = (s16)sasRng.R32();
+
+	s16 *in = (s16 *)Memory::GetPointerWriteUnchecked(SAS_TEST_IN_ADDR);
+	for (int i = 0; i < PSP_SAS_MAX_GRAIN * 2; ++i)
+		in[i] = (s16)sasRng.R32();
+}
+
+static int RandomVolume() {
+	switch (sasRng.R32() % 4) {
+	case 0: return PSP_SAS_VOL_MAX;
+	case 1: return -PSP_SAS_VOL_MAX;
+	default: return SasRandRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+	}
+}
+
+static int RandomPitch() {
+	switch (sasRng.R32() % 4) {
+	case 0: return PSP_SAS_PITCH_BASE;
+	case 1: return PSP_SAS_PITCH_MAX;
+	default: return SasRandRange(PSP_SAS_PITCH_MIN, PSP_SAS_PITCH_MAX);
+	}
+}
+
+static void RandomCommand(SasInstance &sas) {
+	SasVoice &v = sas.voices[sasRng.R32() % PSP_SAS_VOICES_MAX];
+	switch (sasRng.R32() % 12) {
+	case 0:
+	case 1:
+	{
+		// sceSasSetVoice
+		u32 start = sasRng.R32() % (SAS_TEST_VAG_BLOCKS - 16);
+		u32 blocks = SasRandRange(1, std::min(SAS_TEST_VAG_BLOCKS - start, (u32)256));
+		v.type = VOICETYPE_VAG;
+		v.vagAddr = SAS_TEST_VAG_ADDR + start * 16;
+		v.vagSize = blocks * 16;
+		v.loop = (sasRng.R32() & 1) != 0;
+		if (v.on)
+			v.playing = true;
+		v.vag.Start(v.vagAddr, v.vagSize, v.loop);
+		break;
+	}
+	case 2:
+	{
+		// sceSasSetVoicePCM
+		int size = SasRandRange(1, 0x2000);
+		int loopPos = SasRandRange(-1, size - 1);
+		v.type = VOICETYPE_PCM;
+		v.pcmAddr = SAS_TEST_PCM_ADDR + 2 * (sasRng.R32() % (SAS_TEST_PCM_SAMPLES - size));
+		v.pcmSize = size;
+		v.pcmIndex = 0;
+		v.pcmLoopPos = loopPos >= 0 ? loopPos : 0;
+		v.loop = loopPos >= 0;
+		v.playing = true;
+		break;
+	}
+	case 3:
+	case 4:
+		if (v.type != VOICETYPE_OFF)
+			v.KeyOn();
+		break;
+	case 5:
+		v.KeyOff();
+		break;
+	case 6:
+		v.pitch = RandomPitch();
+		break;
+	case 7:
+		v.volumeLeft = RandomVolume();
+		v.volumeRight = RandomVolume();
+		v.effectLeft = RandomVolume();
+		v.effectRight = RandomVolume();
+		break;
+	case 8:
+		v.envelope.SetSimpleEnvelope(sasRng.R32() & 0xFFFF, sasRng.R32() & 0xDFFF);
+		break;
+	case 9:
+	{
+		static const int attackModes[] = { 0, 2, 4 };
+		static const int otherModes[] = { 1, 3, 5 };
+		v.envelope.SetEnvelope(0xF, attackModes[sasRng.R32() % 3], otherModes[sasRng.R32() % 3], SasRandRange(0, 5), otherModes[sasRng.R32() % 3]);
+		v.envelope.SetRate(0xF, sasRng.R32() & 0x7FFFFFFF, sasRng.R32() & 0x7FFFFFFF, sasRng.R32() >> SasRandRange(1, 31), sasRng.R32() >> SasRandRange(1, 31));
+		v.envelope.SetSustainLevel(sasRng.R32() & 0x3FFFFFFF);
+		break;
+	}
+	case 10:
+		v.paused = (sasRng.R32() % 4) == 0;
+		break;
+	case 11:
+		sas.SetWaveformEffectType(SasRandRange(PSP_SAS_EFFECT_TYPE_OFF, PSP_SAS_EFFECT_TYPE_MAX));
+		sas.waveformEffect.isDryOn = sasRng.R32() % 4 != 0;
+		sas.waveformEffect.isWetOn = sasRng.R32() % 2;
+		sas.waveformEffect.leftVol = SasRandRange(0, 0x1000);
+		sas.waveformEffect.rightVol = SasRandRange(0, 0x1000);
+		break;
+	}
+}
+
+static uint32_t HashBytes(uint32_t hash, const u8 *data, size_t size) {
+	// FNV-1a.
+	for (size_t i = 0; i < size; ++i)
+		hash = (hash ^ data[i]) * 16777619U;
+	return hash;
+}
+
+struct SasTestStream {
+	uint32_t seed;
+	int grainSize;
+	int outputMode;
+	uint32_t expectedHash;
+};
+
+// Recorded with the scalar mixer.
+static const SasTestStream sasTestStreams[] = {
+	{ 0x00C0FFEE, 0x100, PSP_SAS_OUTPUTMODE_MIXED, 0x47DADD5C },
+	{ 0x12345678, 0x40, PSP_SAS_OUTPUTMODE_MIXED, 0xEFEE7850 },
+	{ 0x0BADF00D, 0x800, PSP_SAS_OUTPUTMODE_MIXED, 0xE8F8C55D },
+	{ 0x5A5A5A5A, 0x2E0, PSP_SAS_OUTPUTMODE_MIXED, 0xFAB064D9 },
+	{ 0x31415926, 0x200, PSP_SAS_OUTPUTMODE_RAW, 0xDDCAD663 },
+};
+
+// mixTime can be null.
+static uint32_t RunSasStream(const SasTestStream &stream, int grains, double *mixTime) {
+	sasRng.Init(stream.seed);
+	WriteTestSamples();
+
+	SasInstance *sas = new SasInstance();
+	sas->SetGrainSize(stream.grainSize);
+	sas->outputMode = stream.outputMode;
+
+	uint32_t hash = 2166136261U;
+	size_t outSize = sas->GetOutputSize();
+	if (mixTime)
+		*mixTime = 0.0;
+	for (int grain = 0; grain < grains; ++grain) {
+		int commands = SasRandRange(0, 6);
+		for (int i = 0; i < commands; ++i)
+			RandomCommand(*sas);
+
+		int leftVol = RandomVolume();
+		int rightVol = RandomVolume();
+		bool withInput = (sasRng.R32() % 4) == 0;
+
+		double start = mixTime ? time_now_d() : 0.0;
+		sas->Mix(SAS_TEST_OUT_ADDR, withInput ? SAS_TEST_IN_ADDR : 0, leftVol, rightVol);
+		if (mixTime)
+			*mixTime += time_now_d() - start;
+
+		hash = HashBytes(hash, Memory::GetPointerUnchecked(SAS_TEST_OUT_ADDR), outSize);
+		for (int v = 0; v < PSP_SAS_VOICES_MAX; ++v) {
+			int height = sas->voices[v].envelope.GetHeight();
+			hash = HashBytes(hash, (const u8 *)&height, sizeof(height));
+		}
+	}
+
+	delete sas;
+	return hash;
+}
+
+// Every voice playing the whole time, the worst case for the mixer.
+static double TimeFullMix(int grains) {
+	SasInstance *sas = new SasInstance();
+	sas->SetGrainSize(0x100);
+	for (int i = 0; i < PSP_SAS_VOICES_MAX; ++i) {
+		SasVoice &v = sas->voices[i];
+		v.type = VOICETYPE_VAG;
+		v.vagAddr = SAS_TEST_VAG_ADDR;
+		v.vagSize = 256 * 16;
+		v.loop = true;
+		// Half at the native rate, half resampled.
+		v.pitch = (i & 1) ? PSP_SAS_PITCH_BASE : 0x0C00 + i * 37;
+		v.envelope.SetSimpleEnvelope(0x000F, 0x1FC0);
+		v.KeyOn();
+	}
+	// Keep the voices from ending.
+	u8 *vag = Memory::GetPointerWriteUnchecked(SAS_TEST_VAG_ADDR);
+	for (int block = 0; block < 256; ++block)
+		vag[block * 16 + 1] = block == 0 ? 6 : (block == 255 ? 3 : 0);
+
+	double start = time_now_d();
+	for (int grain = 0; grain < grains; ++grain)
+		sas->Mix(SAS_TEST_OUT_ADDR);
+	double elapsed = time_now_d() - start;
+	delete sas;
+	return elapsed;
+}
+
+bool TestSasMixer() {
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+	// The reverb output depends on this, use the default.
+	int oldReverbVolume = g_Config.iReverbVolume;
+	g_Config.iReverbVolume = VOLUME_FULL;
+
+	bool ok = true;
+	for (const SasTestStream &stream : sasTestStreams) {
+		uint32_t hash = RunSasStream(stream, 400, nullptr);
+		if (hash != stream.expectedHash) {
+			printf("SAS stream %08x grain %d: hash %08x, expected %08x\n", stream.seed, stream.grainSize, hash, stream.expectedHash);
+			ok = false;
+		}
+	}
+
+	g_Config.iReverbVolume = oldReverbVolume;
+	Memory::Shutdown();
+
+	EXPECT_TRUE(ok);
+	return true;
+}
+
+bool TestSasMixerBenchmark() {
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+	int oldReverbVolume = g_Config.iReverbVolume;
+	g_Config.iReverbVolume = VOLUME_FULL;
+
+	for (const SasTestStream &stream : sasTestStreams) {
+		double mixTime;
+		RunSasStream(stream, 400, &mixTime);
+		printf("SAS stream %08x grain %d: %0.3f ms mixing\n", stream.seed, stream.grainSize, mixTime * 1000.0);
+	}
+
+	double elapsed = TimeFullMix(2000);
+	printf("32 voices x 2000 grains of 256: %0.3f ms\n", elapsed * 1000.0);
+
+	g_Config.iReverbVolume = oldReverbVolume;
+	Memory::Shutdown();
+	return true;
+}
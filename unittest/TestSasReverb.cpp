@@ -0,0 +1,125 @@
+// Golden output test for the SAS reverb.
+// Runs every preset over bursts of noise separated by silences of various lengths (long enough for
+// some presets to die out completely) and hashes the output. The hashes were recorded with the
+// original per-sample implementation, so the block based one has to stay bit-exact. The benchmark
+// times every preset on noise and on silence.
+
+#include <cstdio>
+#include <cstring>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/Config.h"
+#include "Core/HW/SasAudio.h"
+#include "Core/HW/SasReverb.h"
+
+#include "UnitTest.h"
+
+static GMRng reverbRng;
+
+static uint32_t HashReverbOutput(uint32_t hash, const int16_t *data, size_t count) {
+	// FNV-1a.
+	const uint8_t *p = (const uint8_t *)data;
+	for (size_t i = 0; i < count * sizeof(int16_t); ++i)
+		hash = (hash ^ p[i]) * 16777619U;
+	return hash;
+}
+
+struct SasReverbTestCase {
+	int preset;
+	uint32_t expectedHash;
+};
+
+// Recorded with the per-sample implementation, at the default reverb volume.
+static const SasReverbTestCase reverbTestCases[] = {
+	{ PSP_SAS_EFFECT_TYPE_OFF, 0x65AF2585 },
+	{ PSP_SAS_EFFECT_TYPE_ROOM, 0x0BF2206C },
+	{ PSP_SAS_EFFECT_TYPE_STUDIO_SMALL, 0x4F6B0E7A },
+	{ PSP_SAS_EFFECT_TYPE_STUDIO_MEDIUM, 0x75D2658E },
+	{ PSP_SAS_EFFECT_TYPE_STUDIO_LARGE, 0x36915FC0 },
+	{ PSP_SAS_EFFECT_TYPE_HALL, 0xFB4F8E68 },
+	{ PSP_SAS_EFFECT_TYPE_SPACE, 0x77124AF6 },
+	{ PSP_SAS_EFFECT_TYPE_ECHO, 0x6C29506D },
+	{ PSP_SAS_EFFECT_TYPE_DELAY, 0x4AF97DF4 },
+	{ PSP_SAS_EFFECT_TYPE_PIPE, 0xC82153EC },
+};
+
+static uint32_t RunReverbTest(int preset) {
+	static int16_t input[PSP_SAS_MAX_GRAIN];
+	static int16_t output[PSP_SAS_MAX_GRAIN * 2];
+
+	reverbRng.Init(0x5EB0 + preset * 77);
+	SasReverb reverb;
+	reverb.SetPreset(preset);
+
+	uint32_t hash = 2166136261U;
+	for (int burst = 0; burst < 12; ++burst) {
+		// Noise, then silence.  Some of the silences are longer than any of the reverb buffers.
+		int noiseGrains = 1 + reverbRng.R32() % 8;
+		int silentGrains = (burst % 3) == 2 ? 400 : (int)(reverbRng.R32() % 40);
+		int amplitude = (burst & 1) ? 0xFFFF : 0x7FF;
+		for (int grain = 0; grain < noiseGrains + silentGrains; ++grain) {
+			// Grain sizes are multiples of 32 from 0x40 to 0x800, and the reverb gets half.
+			size_t size = (2 + reverbRng.R32() % 63) * 16;
+			for (size_t i = 0; i < size * 2; ++i)
+				input[i] = grain < noiseGrains ? (int16_t)((int)(reverbRng.R32() & amplitude) - amplitude / 2) : 0;
+
+			uint16_t volLeft = (uint16_t)((reverbRng.R32() % 0x1001) << 3);
+			uint16_t volRight = (uint16_t)((reverbRng.R32() % 0x1001) << 3);
+			reverb.ProcessReverb(output, input, size, volLeft, volRight);
+			hash = HashReverbOutput(hash, output, size * 4);
+		}
+	}
+	return hash;
+}
+
+bool TestSasReverb() {
+	int oldReverbVolume = g_Config.iReverbVolume;
+	g_Config.iReverbVolume = VOLUME_FULL;
+
+	bool ok = true;
+	for (const SasReverbTestCase &test : reverbTestCases) {
+		uint32_t hash = RunReverbTest(test.preset);
+		if (hash != test.expectedHash) {
+			printf("Reverb %s: hash %08x, expected %08x\n", SasReverb::GetPresetName(test.preset), hash, test.expectedHash);
+			ok = false;
+		}
+	}
+
+	g_Config.iReverbVolume = oldReverbVolume;
+
+	EXPECT_TRUE(ok);
+	return true;
+}
+
+bool TestSasReverbBenchmark() {
+	int oldReverbVolume = g_Config.iReverbVolume;
+	g_Config.iReverbVolume = VOLUME_FULL;
+
+	// A full grain of noise, over and over.
+	static int16_t input[PSP_SAS_MAX_GRAIN];
+	static int16_t output[PSP_SAS_MAX_GRAIN * 2];
+	reverbRng.Init(1);
+	for (int i = 0; i < PSP_SAS_MAX_GRAIN; ++i)
+		input[i] = (int16_t)reverbRng.R32();
+	for (int preset = PSP_SAS_EFFECT_TYPE_ROOM; preset <= PSP_SAS_EFFECT_TYPE_MAX; ++preset) {
+		SasReverb reverb;
+		reverb.SetPreset(preset);
+		double start = time_now_d();
+		for (int grain = 0; grain < 2000; ++grain)
+			reverb.ProcessReverb(output, input, PSP_SAS_MAX_GRAIN / 4, 0x8000, 0x8000);
+		printf("Reverb %s, 2000 grains of 512: %0.3f ms\n", SasReverb::GetPresetName(preset), (time_now_d() - start) * 1000.0);
+	}
+
+	// Reverb enabled, but nothing sent to it.
+	memset(input, 0, sizeof(input));
+	SasReverb reverb;
+	reverb.SetPreset(PSP_SAS_EFFECT_TYPE_HALL);
+	double start = time_now_d();
+	for (int grain = 0; grain < 2000; ++grain)
+		reverb.ProcessReverb(output, input, PSP_SAS_MAX_GRAIN / 4, 0x8000, 0x8000);
+	printf("Reverb %s, 2000 silent grains of 512: %0.3f ms\n", SasReverb::GetPresetName(PSP_SAS_EFFECT_TYPE_HALL), (time_now_d() - start) * 1000.0);
+
+	g_Config.iReverbVolume = oldReverbVolume;
+	return true;
+}
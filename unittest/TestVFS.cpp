@@ -1,8 +1,13 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "Common/Log.h"
+#include "Common/File/FileUtil.h"
 #include "Common/File/VFS/ZipFileReader.h"
+#include "Common/TimeUtil.h"
 
 #include "UnitTest.h"
 
@@ -87,8 +92,175 @@ bool TestZipFile() {
 	return true;
 }
 
+static const int ZIP_PACK_TEST_FILES = 200;
+static const int ZIP_PACK_BENCHMARK_FILES = 20000;
+
+static std::string PackTestName(int i) {
+	char name[64];
+	snprintf(name, sizeof(name), "%016llx%08x.%s", 0x08800000ULL + i * 64, (unsigned)i * 2654435761U, i % 3 == 0 ? "PNG" : "png");
+	return name;
+}
+
+static std::string PackTestContents(int i) {
+	return std::string(100 + i % 2000, (char)('A' + i % 26)) + std::to_string(i);
+}
+
+// Like a texture pack: lots of small files, mostly stored as they're already compressed.
+static bool MakePackZip(const Path &path, int fileCount) {
+	int error = 0;
+	zip *za = zip_open(path.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &error);
+	if (!za)
+		return false;
+	std::vector<std::string> contents(fileCount);
+	for (int i = 0; i < fileCount; ++i) {
+		contents[i] = PackTestContents(i);
+		zip_source_t *source = zip_source_buffer(za, contents[i].data(), contents[i].size(), 0);
+		zip_int64_t index = zip_file_add(za, PackTestName(i).c_str(), source, ZIP_FL_ENC_UTF_8);
+		if (index < 0) {
+			zip_source_free(source);
+			zip_discard(za);
+			return false;
+		}
+		if (i % 4 != 0)
+			zip_set_file_compression(za, index, ZIP_CM_STORE, 0);
+	}
+	return zip_close(za) == 0;
+}
+
+static bool ReadPackFile(ZipFileReader *dir, int i) {
+	VFSFileReference *ref = dir->GetFile(PackTestName(i).c_str());
+	if (!ref)
+		return false;
+	size_t size = 0;
+	VFSOpenFile *file = dir->OpenFileForRead(ref, &size);
+	std::string data(size, '\0');
+	bool good = file && dir->Read(file, &data[0], size) == size;
+	if (file)
+		dir->CloseFile(file);
+	dir->ReleaseFile(ref);
+	return good && data == PackTestContents(i);
+}
+
+static bool ReadPackFiles(ZipFileReader *dir, int fileCount, int threadCount) {
+	std::atomic<int> failures{};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t) {
+		threads.push_back(std::thread([&, t] {
+			for (int i = t; i < fileCount; i += threadCount) {
+				if (!ReadPackFile(dir, i))
+					failures++;
+			}
+		}));
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+	return failures == 0;
+}
+
+static std::string UpperCase(std::string str) {
+	for (char &c : str)
+		c = (char)toupper((unsigned char)c);
+	return str;
+}
+
+// Leaves nothing open on failure, so the caller can always delete the reader.
+static bool CheckZipTexturePack(ZipFileReader *dir) {
+	for (int i = 0; i < ZIP_PACK_TEST_FILES; i += 7) {
+		VFSFileReference *ref = dir->GetFile(UpperCase(PackTestName(i)).c_str());
+		EXPECT_TRUE(ref != nullptr);
+		dir->ReleaseFile(ref);
+	}
+	EXPECT_TRUE(dir->GetFile("0000000000000000deadbeef.png") == nullptr);
+
+	size_t size = 0;
+	uint8_t *data = dir->ReadFile(UpperCase(PackTestName(5)).c_str(), &size);
+	const bool readFileMatches = data && std::string((const char *)data, size) == PackTestContents(5);
+	delete[] data;
+	EXPECT_TRUE(readFileMatches);
+	EXPECT_TRUE(dir->ReadFile("0000000000000000deadbeef.png", &size) == nullptr);
+
+	EXPECT_TRUE(ReadPackFiles(dir, ZIP_PACK_TEST_FILES, 8));
+
+	// Lookups and listings still work while this thread has a file open on every handle.
+	std::vector<VFSFileReference *> refs;
+	std::vector<VFSOpenFile *> files;
+	for (int i = 0; i < 4; ++i) {
+		refs.push_back(dir->GetFile(PackTestName(i).c_str()));
+		files.push_back(refs.back() ? dir->OpenFileForRead(refs.back(), &size) : nullptr);
+	}
+	File::FileInfo refInfo;
+	const bool refInfoFound = refs[0] && dir->GetFileInfo(refs[0], &refInfo);
+	File::FileInfo pathInfo;
+	const bool pathInfoFound = dir->GetFileInfo(PackTestName(9).c_str(), &pathInfo);
+	std::vector<File::FileInfo> listing;
+	const bool listed = dir->GetFileListing("", &listing, nullptr);
+	for (size_t i = 0; i < refs.size(); ++i) {
+		if (files[i])
+			dir->CloseFile(files[i]);
+		if (refs[i])
+			dir->ReleaseFile(refs[i]);
+	}
+
+	EXPECT_TRUE(refInfoFound);
+	EXPECT_EQ_INT((int)refInfo.size, (int)PackTestContents(0).size());
+	EXPECT_TRUE(pathInfoFound);
+	EXPECT_EQ_INT((int)pathInfo.size, (int)PackTestContents(9).size());
+	EXPECT_TRUE(listed);
+	EXPECT_EQ_INT((int)listing.size(), ZIP_PACK_TEST_FILES);
+	return true;
+}
+
+// Lookups ignore case, go by the index, and several threads have to be able to read at once.
+static bool TestZipTexturePack() {
+	const Path tempDir("ziptest_pack");
+	File::DeleteDirRecursively(tempDir);
+	File::CreateFullPath(tempDir);
+	const Path zipPath = tempDir / "pack.zip";
+	if (!MakePackZip(zipPath, ZIP_PACK_TEST_FILES)) {
+		printf("Couldn't create %s, skipping\n", zipPath.c_str());
+		File::DeleteDirRecursively(tempDir);
+		return true;
+	}
+
+	ZipFileReader *dir = ZipFileReader::Create(zipPath, "", true);
+	const bool ok = dir && CheckZipTexturePack(dir);
+	delete dir;
+	File::DeleteDirRecursively(tempDir);
+	return ok;
+}
+
 bool TestVFS() {
 	if (!TestZipFile())
 		return false;
+	if (!TestZipTexturePack())
+		return false;
 	return true;
 }
+
+bool TestVFSBenchmark() {
+	const Path tempDir("ziptest_pack_benchmark");
+	File::DeleteDirRecursively(tempDir);
+	File::CreateFullPath(tempDir);
+	const Path zipPath = tempDir / "pack.zip";
+	ZipFileReader *dir = MakePackZip(zipPath, ZIP_PACK_BENCHMARK_FILES) ? ZipFileReader::Create(zipPath, "", true) : nullptr;
+	if (!dir) {
+		printf("Couldn't create %s\n", zipPath.c_str());
+		File::DeleteDirRecursively(tempDir);
+		return false;
+	}
+
+	const int lookups = 100000;
+	double start = time_now_d();
+	for (int i = 0; i < lookups; ++i)
+		dir->ReleaseFile(dir->GetFile(PackTestName(i % ZIP_PACK_BENCHMARK_FILES).c_str()));
+	printf("Zip pack: %0.2f us per lookup among %d files\n", (time_now_d() - start) * 1e6 / lookups, ZIP_PACK_BENCHMARK_FILES);
+
+	const int threadCount = 8;
+	start = time_now_d();
+	const bool read = ReadPackFiles(dir, ZIP_PACK_BENCHMARK_FILES, threadCount);
+	printf("Zip pack: read %d files on %d threads in %0.1f ms\n", ZIP_PACK_BENCHMARK_FILES, threadCount, (time_now_d() - start) * 1e3);
+
+	delete dir;
+	File::DeleteDirRecursively(tempDir);
+	return read;
+}
@@ -0,0 +1,201 @@
+// Checks VagDecoder against a plain per-sample decode of the same blocks, with reads of every size so
+// both the whole-block path and the partial one get used. The benchmark times it in ns per sample.
+// There are no captured VAG files in the tree, so besides random blocks this encodes a tone with a
+// simple ADPCM encoder, which gets the filter and shift mix of real sound effects.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/MemMap.h"
+#include "Core/HW/SasAudio.h"
+
+#include "UnitTest.h"
+
+static const u32 VAG_TEST_ADDR = 0x08800000;
+static const int VAG_TEST_BLOCKS = 4096;
+
+// The first five filters, which are the ones the encoder uses.
+static const int vagTestFilters[5][2] = { { 0, 0 }, { 60, 0 }, { 115, -52 }, { 98, -55 }, { 122, -60 } };
+
+static GMRng vagRng;
+
+static s16 ClampTestSample(int v) {
+	return (s16)std::max(-32768, std::min(32767, v));
+}
+
+// Header flags are left at 0, the caller sets loop and end flags.
+static void MakeRandomBlocks(u8 *vag, int blocks) {
+	for (int b = 0; b < blocks; ++b) {
+		u8 *block = vag + b * 16;
+		block[0] = (u8)(((vagRng.R32() % 5) << 4) | (vagRng.R32() % 13));
+		block[1] = 0;
+		for (int i = 2; i < 16; ++i)
+			block[i] = (u8)vagRng.R32();
+	}
+}
+
+// Picks the filter and shift with the least error for each block, like common VAG encoders do.
+static void MakeToneBlocks(u8 *vag, int blocks) {
+	int s1 = 0, s2 = 0;
+	for (int b = 0; b < blocks; ++b) {
+		s16 input[28];
+		for (int i = 0; i < 28; ++i) {
+			double t = (b * 28 + i) / 44100.0;
+			double v = sin(t * 440.0 * 6.2831853) * 12000.0 + sin(t * 1234.5 * 6.2831853) * 4000.0 * sin(t * 3.0);
+			input[i] = (s16)v;
+		}
+
+		u8 best[16]{};
+		int bestError = -1, bestS1 = 0, bestS2 = 0;
+		for (int filter = 0; filter < 5; ++filter) {
+			for (int shift = 0; shift <= 12; ++shift) {
+				u8 block[16]{};
+				block[0] = (u8)((filter << 4) | shift);
+				int t1 = s1, t2 = s2, error = 0;
+				for (int i = 0; i < 28; ++i) {
+					int predicted = (t1 * vagTestFilters[filter][0] + t2 * vagTestFilters[filter][1]) >> 6;
+					int nibble = (int)lround((input[i] - predicted) / (double)(1 << (12 - shift)));
+					nibble = std::max(-8, std::min(7, nibble));
+					block[2 + i / 2] |= (u8)((nibble & 0xF) << ((i & 1) * 4));
+					int decoded = ClampTestSample(((s16)((nibble & 0xF) << 12) >> shift) + predicted);
+					error += abs(decoded - input[i]);
+					t2 = t1;
+					t1 = decoded;
+				}
+				if (bestError < 0 || error < bestError) {
+					bestError = error;
+					memcpy(best, block, 16);
+					bestS1 = t1;
+					bestS2 = t2;
+				}
+			}
+		}
+		memcpy(vag + b * 16, best, 16);
+		s1 = bestS1;
+		s2 = bestS2;
+	}
+}
+
+// The straightforward decode of a stream without loops, one sample at a time.
+static std::vector<s16> ReferenceDecode(const u8 *vag, int blocks) {
+	std::vector<s16> out;
+	int s1 = 0, s2 = 0;
+	for (int b = 0; b < blocks && vag[b * 16 + 1] != 7; ++b) {
+		const u8 *block = vag + b * 16;
+		int filter = block[0] >> 4;
+		int shift = block[0] & 0xF;
+		for (int i = 0; i < 28; ++i) {
+			int nibble = (block[2 + i / 2] >> ((i & 1) * 4)) & 0xF;
+			int sample = (s16)(nibble << 12) >> shift;
+			s16 decoded = ClampTestSample(sample + ((s1 * vagTestFilters[filter][0] + s2 * vagTestFilters[filter][1]) >> 6));
+			out.push_back(decoded);
+			s2 = s1;
+			s1 = decoded;
+		}
+	}
+	return out;
+}
+
+// Decodes count samples with reads of varying size. maxRead 1 never decodes straight to the output.
+static std::vector<s16> DecodeInPieces(int blocks, bool loop, int count, int maxRead) {
+	VagDecoder vag;
+	vag.Start(VAG_TEST_ADDR, blocks * 16, loop);
+	std::vector<s16> out(count);
+	vagRng.Init(99);
+	int pos = 0;
+	while (pos < count) {
+		int size = std::min(count - pos, 1 + (int)(vagRng.R32() % maxRead));
+		vag.GetSamples(&out[pos], size);
+		pos += size;
+	}
+	return out;
+}
+
+static bool CheckStream(const char *name, int blocks) {
+	u8 *vag = Memory::GetPointerWriteUnchecked(VAG_TEST_ADDR);
+	std::vector<s16> reference = ReferenceDecode(vag, blocks);
+	int count = (int)reference.size() + 100;
+
+	std::vector<s16> pieces = DecodeInPieces(blocks, false, count, 300);
+	std::vector<s16> single = DecodeInPieces(blocks, false, count, 1);
+	for (int i = 0; i < count; ++i) {
+		s16 expected = i < (int)reference.size() ? reference[i] : 0;
+		if (pieces[i] != expected || single[i] != expected) {
+			printf("%s: sample %d is %d / %d, expected %d\n", name, i, pieces[i], single[i], expected);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Times decoding it all in mixer sized pieces.
+static void TimeStream(const char *name, int blocks) {
+	const int grain = 256;
+	const int passes = 20;
+	std::vector<s16> buffer(grain);
+	double start = time_now_d();
+	for (int pass = 0; pass < passes; ++pass) {
+		VagDecoder decoder;
+		decoder.Start(VAG_TEST_ADDR, blocks * 16, false);
+		while (!decoder.End())
+			decoder.GetSamples(&buffer[0], grain);
+	}
+	double elapsed = time_now_d() - start;
+	const size_t samples = ReferenceDecode(Memory::GetPointerWriteUnchecked(VAG_TEST_ADDR), blocks).size();
+	printf("%s: %0.2f ns/sample\n", name, elapsed * 1e9 / ((double)samples * passes));
+}
+
+bool TestVagDecoder() {
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+	u8 *vag = Memory::GetPointerWriteUnchecked(VAG_TEST_ADDR);
+
+	vagRng.Init(1);
+	MakeRandomBlocks(vag, VAG_TEST_BLOCKS);
+	EXPECT_TRUE(CheckStream("Random VAG", VAG_TEST_BLOCKS));
+
+	MakeToneBlocks(vag, VAG_TEST_BLOCKS);
+	EXPECT_TRUE(CheckStream("Tone VAG", VAG_TEST_BLOCKS));
+
+	// An end flag in the middle stops it there.
+	vag[1000 * 16 + 1] = 7;
+	EXPECT_TRUE(CheckStream("Tone VAG with end flag", VAG_TEST_BLOCKS));
+	vag[1000 * 16 + 1] = 0;
+
+	// With a loop, reads of any size have to give the same result, and the loop repeats exactly.
+	const int loopStart = 100, loopEnd = 199;
+	vag[loopStart * 16 + 1] = 6;
+	vag[loopEnd * 16 + 1] = 3;
+	const int count = 28 * 1000;
+	std::vector<s16> pieces = DecodeInPieces(VAG_TEST_BLOCKS, true, count, 300);
+	std::vector<s16> single = DecodeInPieces(VAG_TEST_BLOCKS, true, count, 1);
+	EXPECT_TRUE(pieces == single);
+	const int loopSamples = (loopEnd - loopStart + 1) * 28;
+	// The filter state carries over the loop point, so compare from the second pass on.
+	const int secondPass = (loopEnd + 1) * 28;
+	for (int i = secondPass + 28; i < count - loopSamples; ++i)
+		EXPECT_EQ_INT(pieces[i], pieces[i + loopSamples]);
+
+	Memory::Shutdown();
+	return true;
+}
+
+bool TestVagDecoderBenchmark() {
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+	u8 *vag = Memory::GetPointerWriteUnchecked(VAG_TEST_ADDR);
+
+	vagRng.Init(1);
+	MakeRandomBlocks(vag, VAG_TEST_BLOCKS);
+	TimeStream("Random VAG", VAG_TEST_BLOCKS);
+	MakeToneBlocks(vag, VAG_TEST_BLOCKS);
+	TimeStream("Tone VAG", VAG_TEST_BLOCKS);
+
+	Memory::Shutdown();
+	return true;
+}
@@ -0,0 +1,116 @@
+// Checks the YUV 4:2:0 to PSP pixel format conversion used for decoded videos against a floating
+// point BT.601 reference, with odd sizes and offsets to cover the non-SIMD edges. The benchmark
+// times a 480x272 frame in each format.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/TimeUtil.h"
+#include "Core/HW/MediaEngine.h"
+#include "GPU/ge_constants.h"
+
+#include "UnitTest.h"
+
+static GMRng videoRng;
+
+static int ReferenceComponent(double v) {
+	return v < 0.0 ? 0 : (v > 255.0 ? 255 : (int)floor(v + 0.5));
+}
+
+static bool CheckConversion(int width, int height) {
+	// Padded strides, like the decoder uses.
+	const int yStride = width + 13;
+	const int uvStride = (width + 1) / 2 + 7;
+	std::vector<u8> yPlane(yStride * height), uPlane(uvStride * ((height + 1) / 2)), vPlane(uvStride * ((height + 1) / 2));
+	for (u8 &p : yPlane)
+		p = (u8)videoRng.R32();
+	for (size_t i = 0; i < uPlane.size(); ++i) {
+		uPlane[i] = (u8)videoRng.R32();
+		vPlane[i] = (u8)videoRng.R32();
+	}
+
+	const int stride = width + 5;
+	std::vector<u32> rgba(stride * height);
+	std::vector<u16> rgb16(stride * height);
+	ConvertYUV420ToPSPFormat((u8 *)&rgba[0], stride * 4, &yPlane[0], yStride, &uPlane[0], &vPlane[0], uvStride, width, height, GE_CMODE_32BIT_ABGR8888);
+
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			double luma = 1.164383 * (yPlane[y * yStride + x] - 16);
+			double u = uPlane[(y / 2) * uvStride + x / 2] - 128.0;
+			double v = vPlane[(y / 2) * uvStride + x / 2] - 128.0;
+			const int expected[3] = {
+				ReferenceComponent(luma + 1.596027 * v),
+				ReferenceComponent(luma - 0.391762 * u - 0.812968 * v),
+				ReferenceComponent(luma + 2.017232 * u),
+			};
+			u32 pixel = rgba[y * stride + x];
+			for (int c = 0; c < 3; ++c) {
+				int actual = (pixel >> (c * 8)) & 0xFF;
+				if (abs(actual - expected[c]) > 1) {
+					printf("%dx%d: pixel %d,%d component %d is %d, expected %d\n", width, height, x, y, c, actual, expected[c]);
+					return false;
+				}
+			}
+			EXPECT_EQ_HEX(pixel >> 24, 0U);
+		}
+	}
+
+	// The 16-bit formats are the same colors, truncated.
+	static const int formats[] = { GE_CMODE_16BIT_BGR5650, GE_CMODE_16BIT_ABGR5551, GE_CMODE_16BIT_ABGR4444 };
+	for (int format : formats) {
+		ConvertYUV420ToPSPFormat((u8 *)&rgb16[0], stride * 2, &yPlane[0], yStride, &uPlane[0], &vPlane[0], uvStride, width, height, format);
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				u32 pixel = rgba[y * stride + x];
+				u32 r = pixel & 0xFF, g = (pixel >> 8) & 0xFF, b = (pixel >> 16) & 0xFF;
+				u32 expected;
+				if (format == GE_CMODE_16BIT_BGR5650)
+					expected = (r >> 3) | ((g >> 2) << 5) | ((b >> 3) << 11);
+				else if (format == GE_CMODE_16BIT_ABGR5551)
+					expected = (r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10);
+				else
+					expected = (r >> 4) | ((g >> 4) << 4) | ((b >> 4) << 8);
+				if (rgb16[y * stride + x] != expected) {
+					printf("%dx%d format %d: pixel %d,%d is %04x, expected %04x\n", width, height, format, x, y, rgb16[y * stride + x], expected);
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool TestVideoConvert() {
+	static const int sizes[][2] = { { 1, 1 }, { 7, 3 }, { 8, 2 }, { 17, 5 }, { 33, 9 }, { 480, 272 } };
+	for (const auto &size : sizes) {
+		if (!CheckConversion(size[0], size[1]))
+			return false;
+	}
+	return true;
+}
+
+bool TestVideoConvertBenchmark() {
+	const int width = 480, height = 272;
+	std::vector<u8> yPlane(width * height), uPlane(width * height / 4), vPlane(width * height / 4);
+	for (u8 &p : yPlane)
+		p = (u8)videoRng.R32();
+	for (size_t i = 0; i < uPlane.size(); ++i) {
+		uPlane[i] = (u8)videoRng.R32();
+		vPlane[i] = (u8)videoRng.R32();
+	}
+	std::vector<u32> out(512 * height);
+	static const int formats[] = { GE_CMODE_16BIT_BGR5650, GE_CMODE_16BIT_ABGR5551, GE_CMODE_16BIT_ABGR4444, GE_CMODE_32BIT_ABGR8888 };
+	static const char *const names[] = { "5650", "5551", "4444", "8888" };
+	for (int i = 0; i < 4; ++i) {
+		int stride = formats[i] == GE_CMODE_32BIT_ABGR8888 ? 512 * 4 : 512 * 2;
+		double start = time_now_d();
+		for (int frame = 0; frame < 1000; ++frame)
+			ConvertYUV420ToPSPFormat((u8 *)&out[0], stride, &yPlane[0], width, &uPlane[0], &vPlane[0], width / 2, width, height, formats[i]);
+		printf("YUV420 to %s, 1000 frames of 480x272: %0.3f ms\n", names[i], (time_now_d() - start) * 1000.0);
+	}
+	return true;
+}
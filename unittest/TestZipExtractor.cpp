@@ -0,0 +1,135 @@
+// Extracts a zip with one big compressed file and many small ones with ZipExtractor, on one
+// thread and on four, checks that everything comes out the same and that a file that can't be
+// written is reported. The benchmark does the same with a bigger zip and prints the throughput.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef SHARED_LIBZIP
+#include <zip.h>
+#else
+#include "ext/libzip/zip.h"
+#endif
+
+#include "Common/Data/Random/Rng.h"
+#include "Common/File/FileUtil.h"
+#include "Common/TimeUtil.h"
+#include "Core/Util/ZipExtractor.h"
+
+#include "UnitTest.h"
+
+struct ExtractTestSize {
+	size_t bigFile;
+	int smallFiles;
+};
+
+// The big file still spans a few of ZipExtractor's chunks in the quick version.
+static const ExtractTestSize EXTRACT_TEST_SMALL = { 8 * 1024 * 1024 + 1000, 100 };
+static const ExtractTestSize EXTRACT_TEST_BENCHMARK = { 96 * 1024 * 1024 + 1000, 300 };
+
+static GMRng extractRng;
+
+// Something that compresses about like a disc image: runs of padding between noisy data.
+static std::string MakeContents(size_t size) {
+	std::string data(size, '\0');
+	for (size_t i = 0; i < size; i += 4) {
+		uint32_t v = (i / 65536) % 3 == 0 ? 0 : extractRng.R32() & 0x0F0F0F0F;
+		memcpy(&data[i], &v, std::min((size_t)4, size - i));
+	}
+	return data;
+}
+
+static bool MakeZip(const Path &path, const ExtractTestSize &size, std::vector<std::string> *contents) {
+	int error = 0;
+	zip *za = zip_open(path.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &error);
+	if (!za)
+		return false;
+	extractRng.Init(7);
+	contents->clear();
+	contents->push_back(MakeContents(size.bigFile));
+	for (int i = 0; i < size.smallFiles; ++i)
+		contents->push_back(MakeContents(extractRng.R32() % 300000));
+	for (size_t i = 0; i < contents->size(); ++i) {
+		zip_source_t *source = zip_source_buffer(za, (*contents)[i].data(), (*contents)[i].size(), 0);
+		if (zip_file_add(za, ("file" + std::to_string(i)).c_str(), source, 0) < 0) {
+			zip_source_free(source);
+			zip_discard(za);
+			return false;
+		}
+	}
+	return zip_close(za) == 0;
+}
+
+static bool Extract(const Path &zipPath, const Path &dir, const std::vector<std::string> &contents, int threads, std::vector<Path> *extracted, bool printStats) {
+	File::CreateFullPath(dir);
+	ZipExtractor extractor([&zipPath]() {
+		int error = 0;
+		return zip_open(zipPath.c_str(), 0, &error);
+	});
+	for (size_t i = 0; i < contents.size(); ++i) {
+		Path dest = dir / ("file" + std::to_string(i));
+		// Without a list to fill, the last one can't be written.
+		if (i == contents.size() - 1 && !extracted)
+			dest = dir / "missing" / "file";
+		extractor.Add((int)i, dest, contents[i].size());
+	}
+
+	u64 bytesTotal = 0;
+	double lastSpeed = 0.0;
+	double start = time_now_d();
+	bool success = extractor.Run(threads, [&](u64 done, u64 total, double megabytesPerSecond) {
+		bytesTotal = total;
+		lastSpeed = megabytesPerSecond;
+	});
+	const double megabytes = bytesTotal / (1024.0 * 1024.0);
+	if (extracted)
+		*extracted = extractor.Extracted();
+	if (printStats)
+		printf("ZipExtractor on %d threads: %0.0f MB/s (reported %0.0f MB/s)\n", threads, megabytes / (time_now_d() - start), lastSpeed);
+	return success;
+}
+
+static bool CheckExtract(const Path &zipPath, const Path &dir, const std::vector<std::string> &contents, bool printStats) {
+	for (int threads : { 1, 4 }) {
+		std::vector<Path> extracted;
+		EXPECT_TRUE(Extract(zipPath, dir, contents, threads, &extracted, printStats));
+		EXPECT_EQ_INT((int)extracted.size(), (int)contents.size());
+		for (size_t i = 0; i < contents.size(); ++i) {
+			std::string data;
+			EXPECT_TRUE(File::ReadBinaryFileToString(dir / ("file" + std::to_string(i)), &data));
+			EXPECT_TRUE(data == contents[i]);
+		}
+		File::DeleteDirRecursively(dir);
+	}
+
+	// One file that can't be written fails the lot.
+	EXPECT_FALSE(Extract(zipPath, dir, contents, 4, nullptr, false));
+	return true;
+}
+
+static bool RunZipExtractor(const ExtractTestSize &size, const char *name, bool printStats) {
+	const Path zipPath(std::string(name) + ".zip");
+	const Path dir(name);
+	std::vector<std::string> contents;
+	if (!MakeZip(zipPath, size, &contents)) {
+		printf("Couldn't create the test zip\n");
+		File::Delete(zipPath);
+		return false;
+	}
+
+	bool success = CheckExtract(zipPath, dir, contents, printStats);
+	File::DeleteDirRecursively(dir);
+	File::Delete(zipPath);
+	return success;
+}
+
+bool TestZipExtractor() {
+	return RunZipExtractor(EXTRACT_TEST_SMALL, "zipextract_test", false);
+}
+
+bool TestZipExtractorBenchmark() {
+	return RunZipExtractor(EXTRACT_TEST_BENCHMARK, "zipextract_benchmark", true);
+}
@@ -1109,6 +1109,44 @@ bool TestSoftwareGPUJit();
 bool TestIRPassSimplify();
 bool TestThreadManager();
 bool TestVFS();
+bool TestAdhocServer();
+bool TestHTTPFileLoader();
+bool TestVFPUSimd();
+bool TestSasMixer();
+bool TestSasReverb();
+bool TestAudioResampler();
+bool TestVideoConvert();
+bool TestAtrac3Decoder();
+bool TestDecodedAudioCache();
+bool TestMpegDemux();
+bool TestVagDecoder();
+bool TestPathCaseCache();
+bool TestISOFileSystem();
+bool TestLocalFileLoader();
+bool TestAccessProfile();
+bool TestReplacementTranscoder();
+bool TestGameInfoIndex();
+bool TestZipExtractor();
+bool TestBlockDeviceReads();
+bool TestMemStickWriteCache();
+bool TestAdhocServerBenchmark();
+bool TestHTTPFileLoaderBenchmark();
+bool TestGameInfoIndexBenchmark();
+bool TestVFSBenchmark();
+bool TestPathCaseCacheBenchmark();
+bool TestISOFileSystemBenchmark();
+bool TestLocalFileLoaderBenchmark();
+bool TestAccessProfileBenchmark();
+bool TestVFPUSimdBenchmark();
+bool TestSasMixerBenchmark();
+bool TestSasReverbBenchmark();
+bool TestAudioResamplerBenchmark();
+bool TestVideoConvertBenchmark();
+bool TestAtrac3DecoderBenchmark();
+bool TestVagDecoderBenchmark();
+bool TestMpegDemuxBenchmark();
+bool TestZipExtractorBenchmark();
+bool TestBlockDeviceReadsBenchmark();
 
 TestItem availableTests[] = {
 #if PPSSPP_ARCH(ARM64) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
@@ -1127,6 +1165,24 @@ TestItem availableTests[] = {
 	TEST_ITEM(Asin),
 	TEST_ITEM(SinCos),
 	TEST_ITEM(VFPUSinCos),
+	TEST_ITEM(VFPUSimd),
+	TEST_ITEM(SasMixer),
+	TEST_ITEM(SasReverb),
+	TEST_ITEM(AudioResampler),
+	TEST_ITEM(VideoConvert),
+	TEST_ITEM(Atrac3Decoder),
+	TEST_ITEM(DecodedAudioCache),
+	TEST_ITEM(MpegDemux),
+	TEST_ITEM(VagDecoder),
+	TEST_ITEM(PathCaseCache),
+	TEST_ITEM(ISOFileSystem),
+	TEST_ITEM(LocalFileLoader),
+	TEST_ITEM(AccessProfile),
+	TEST_ITEM(ReplacementTranscoder),
+	TEST_ITEM(GameInfoIndex),
+	TEST_ITEM(ZipExtractor),
+	TEST_ITEM(BlockDeviceReads),
+	TEST_ITEM(MemStickWriteCache),
 	TEST_ITEM(MathUtil),
 	TEST_ITEM(Parsers),
 	TEST_ITEM(IRPassSimplify),
@@ -1154,6 +1210,30 @@ TestItem availableTests[] = {
 	TEST_ITEM(ColorConv),
 	TEST_ITEM(CharQueue),
 	TEST_ITEM(Buffer),
+	TEST_ITEM(AdhocServer),
+	TEST_ITEM(HTTPFileLoader),
+};
+
+// Timings on big fixtures, too slow to run every time. Not part of "all", run them by name.
+TestItem availableBenchmarks[] = {
+	TEST_ITEM(AdhocServerBenchmark),
+	TEST_ITEM(HTTPFileLoaderBenchmark),
+	TEST_ITEM(GameInfoIndexBenchmark),
+	TEST_ITEM(VFSBenchmark),
+	TEST_ITEM(PathCaseCacheBenchmark),
+	TEST_ITEM(ISOFileSystemBenchmark),
+	TEST_ITEM(LocalFileLoaderBenchmark),
+	TEST_ITEM(AccessProfileBenchmark),
+	TEST_ITEM(VFPUSimdBenchmark),
+	TEST_ITEM(SasMixerBenchmark),
+	TEST_ITEM(SasReverbBenchmark),
+	TEST_ITEM(AudioResamplerBenchmark),
+	TEST_ITEM(VideoConvertBenchmark),
+	TEST_ITEM(Atrac3DecoderBenchmark),
+	TEST_ITEM(VagDecoderBenchmark),
+	TEST_ITEM(MpegDemuxBenchmark),
+	TEST_ITEM(ZipExtractorBenchmark),
+	TEST_ITEM(BlockDeviceReadsBenchmark),
 };
 
 int main(int argc, const char *argv[]) {
@@ -1182,6 +1262,12 @@ int main(int argc, const char *argv[]) {
 				break;
 			}
 		}
+		for (auto f : availableBenchmarks) {
+			if (!strcasecmp(argv[1], f.name)) {
+				testFunc = f.func;
+				break;
+			}
+		}
 	}
 
 	if (allTests) {
@@ -1209,6 +1295,11 @@ int main(int argc, const char *argv[]) {
 		for (auto f : availableTests) {
 			fprintf(stderr, "  * %s\n", f.name);
 		}
+		fprintf(stderr, "\n");
+		fprintf(stderr, "Benchmarks, not included in \"all\":\n");
+		for (auto f : availableBenchmarks) {
+			fprintf(stderr, "  * %s\n", f.name);
+		}
 		return 1;
 	} else {
 		if (!testFunc()) {